@@ -81,6 +81,55 @@ class LinuxCookieManager extends PlatformCookieManager {
     return result ?? false;
   }
 
+  /// Sets all [cookies] for [url] in one batch, much faster than one
+  /// [setCookie] call per cookie.
+  ///
+  /// Returns `true` if every cookie was set.
+  Future<bool> setCookies({
+    required WebUri url,
+    required List<Cookie> cookies,
+  }) async {
+    final result = await _channel.invokeMethod<bool>('setCookies', {
+      'url': url.toString(),
+      'cookies': cookies.map(_cookieToMap).toList(),
+    });
+
+    return result ?? false;
+  }
+
+  /// Replaces all the stored cookies with [cookies], set for [url].
+  ///
+  /// With WebKit 2.42 or later this is a single cookie store operation, so
+  /// requests never see a mix of old and new cookies. Older versions delete
+  /// all cookies, then set [cookies] in one batch.
+  ///
+  /// Returns `true` if every cookie was set.
+  Future<bool> replaceAllCookies({
+    required WebUri url,
+    required List<Cookie> cookies,
+  }) async {
+    final result = await _channel.invokeMethod<bool>('replaceAllCookies', {
+      'url': url.toString(),
+      'cookies': cookies.map(_cookieToMap).toList(),
+    });
+
+    return result ?? false;
+  }
+
+  Map<String, dynamic> _cookieToMap(Cookie cookie) {
+    return {
+      'name': cookie.name,
+      'value': cookie.value?.toString() ?? '',
+      'path': cookie.path ?? '/',
+      if (cookie.domain != null) 'domain': cookie.domain,
+      if (cookie.expiresDate != null) 'expiresDate': cookie.expiresDate,
+      if (cookie.isSecure != null) 'isSecure': cookie.isSecure,
+      if (cookie.isHttpOnly != null) 'isHttpOnly': cookie.isHttpOnly,
+      if (cookie.sameSite != null)
+        'sameSite': cookie.sameSite.toString().split('.').last,
+    };
+  }
+
   @override
   Future<List<Cookie>> getCookies({
     required WebUri url,
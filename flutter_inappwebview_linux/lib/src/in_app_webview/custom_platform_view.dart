@@ -1,5 +1,7 @@
 import 'package:flutter/services.dart';
 import 'dart:async';
+import 'dart:convert';
+import 'dart:typed_data';
 import 'dart:ui';
 
 import 'package:flutter/gestures.dart';
@@ -108,6 +110,114 @@ PointerButton _getButton(int value) {
 
 const MethodChannel _pluginChannel = IN_APP_WEBVIEW_STATIC_CHANNEL;
 
+/// Record types of the binary input channel (see `custom_platform_view.cc`).
+const int _kInputRecordCursorPos = 1;
+const int _kInputRecordPointerButton = 2;
+const int _kInputRecordScrollDelta = 3;
+const int _kInputRecordKeyEvent = 4;
+const int _kInputRecordTouchEvent = 5;
+
+/// Packs input events into the fixed-layout little-endian records read by
+/// `CustomPlatformView::DispatchInputRecords`. Every record starts on an
+/// 8 byte boundary with an 8 byte header: type, arg0, arg1, reserved (uint8
+/// each) and arg2 (int32).
+class _InputEventWriter {
+  ByteData _data = ByteData(512);
+  int _length = 0;
+
+  bool get isEmpty => _length == 0;
+
+  void _reserve(int size) {
+    if (_length + size <= _data.lengthInBytes) {
+      return;
+    }
+    int capacity = _data.lengthInBytes * 2;
+    while (capacity < _length + size) {
+      capacity *= 2;
+    }
+    final grown = ByteData(capacity);
+    grown.buffer.asUint8List().setRange(0, _length, _data.buffer.asUint8List());
+    _data = grown;
+  }
+
+  void _header(int type, {int arg0 = 0, int arg1 = 0, int arg2 = 0}) {
+    _data.setUint8(_length, type);
+    _data.setUint8(_length + 1, arg0);
+    _data.setUint8(_length + 2, arg1);
+    _data.setUint8(_length + 3, 0);
+    _data.setInt32(_length + 4, arg2, Endian.little);
+    _length += 8;
+  }
+
+  void _int32(int value) {
+    _data.setInt32(_length, value, Endian.little);
+    _length += 4;
+  }
+
+  void _float64(double value) {
+    _data.setFloat64(_length, value, Endian.little);
+    _length += 8;
+  }
+
+  void cursorPos(double x, double y) {
+    _reserve(24);
+    _header(_kInputRecordCursorPos);
+    _float64(x);
+    _float64(y);
+  }
+
+  void pointerButton(int kind, int button, int clickCount) {
+    _reserve(8);
+    _header(_kInputRecordPointerButton,
+        arg0: kind, arg1: button, arg2: clickCount);
+  }
+
+  void scrollDelta(double dx, double dy) {
+    _reserve(24);
+    _header(_kInputRecordScrollDelta);
+    _float64(dx);
+    _float64(dy);
+  }
+
+  void keyEvent(int type, int keyCode, int scanCode, int modifiers,
+      String? characters) {
+    final encoded = characters != null ? utf8.encode(characters) : <int>[];
+    final paddedLength = (encoded.length + 7) & ~7;
+    _reserve(24 + paddedLength);
+    _header(_kInputRecordKeyEvent, arg0: type, arg2: scanCode);
+    _data.setInt64(_length, keyCode, Endian.little);
+    _length += 8;
+    _int32(modifiers);
+    _int32(encoded.length);
+    _data.buffer.asUint8List().setRange(_length, _length + encoded.length, encoded);
+    _length += paddedLength;
+  }
+
+  void touchEvent(int type, int id, double x, double y,
+      List<Map<String, dynamic>> touchPoints) {
+    _reserve(32 + touchPoints.length * 24);
+    _header(_kInputRecordTouchEvent, arg0: type, arg2: id);
+    _float64(x);
+    _float64(y);
+    _int32(touchPoints.length);
+    _int32(0);
+    for (final point in touchPoints) {
+      _int32(point['id'] ?? 0);
+      _int32(point['type'] ?? 0);
+      _float64((point['x'] as num?)?.toDouble() ?? 0.0);
+      _float64((point['y'] as num?)?.toDouble() ?? 0.0);
+    }
+  }
+
+  /// Returns the pending records and starts a new batch.
+  ByteData take() {
+    final records = ByteData.sublistView(_data, 0, _length);
+    _data = ByteData(_data.lengthInBytes);
+    _length = 0;
+    return records;
+  }
+}
+
 class CustomFlutterViewControllerValue {
   const CustomFlutterViewControllerValue({required this.isInitialized});
 
@@ -135,6 +245,12 @@ class CustomPlatformViewController
   late EventChannel _eventChannel;
   StreamSubscription? _eventStreamSubscription;
 
+  /// Binary channel for pointer/keyboard/touch events. Events queued while
+  /// handling the same input packet are sent together in one message.
+  late BasicMessageChannel<ByteData> _inputChannel;
+  final _InputEventWriter _inputEvents = _InputEventWriter();
+  bool _inputFlushScheduled = false;
+
   final StreamController<SystemMouseCursor> _cursorStreamController =
       StreamController<SystemMouseCursor>.broadcast();
 
@@ -163,6 +279,10 @@ class CustomPlatformViewController
     _eventChannel = EventChannel(
       'com.pichillilorenzo/custom_platform_view_${_textureId}_events',
     );
+    _inputChannel = BasicMessageChannel<ByteData>(
+      'com.pichillilorenzo/custom_platform_view_${_textureId}_input',
+      const BinaryCodec(),
+    );
     _eventStreamSubscription = _eventChannel.receiveBroadcastStream().listen((
       event,
     ) {
@@ -196,6 +316,28 @@ class CustomPlatformViewController
     super.dispose();
   }
 
+  /// Queues input event records, flushed together in a microtask so all
+  /// events of the same pointer data packet are sent in a single message.
+  void _queueInputEvent(void Function(_InputEventWriter writer) write) {
+    if (_isDisposed) {
+      return;
+    }
+    assert(value.isInitialized);
+    write(_inputEvents);
+    if (!_inputFlushScheduled) {
+      _inputFlushScheduled = true;
+      scheduleMicrotask(_flushInputEvents);
+    }
+  }
+
+  void _flushInputEvents() {
+    _inputFlushScheduled = false;
+    if (_isDisposed || _inputEvents.isEmpty) {
+      return;
+    }
+    _inputChannel.send(_inputEvents.take());
+  }
+
   /// Sets the surface size to the provided [size].
   Future<void> _setSize(Size size, double scaleFactor) async {
     if (_isDisposed) {
@@ -223,14 +365,7 @@ class CustomPlatformViewController
 
   /// Moves the virtual cursor to [position].
   Future<void> _setCursorPos(Offset position) async {
-    if (_isDisposed) {
-      return;
-    }
-    assert(value.isInitialized);
-    return _methodChannel.invokeMethod('setCursorPos', [
-      position.dx,
-      position.dy,
-    ]);
+    _queueInputEvent((writer) => writer.cursorPos(position.dx, position.dy));
   }
 
   /// Indicates whether the specified [button] is currently down.
@@ -238,15 +373,9 @@ class CustomPlatformViewController
     InAppWebViewPointerEventKind kind,
     PointerButton button,
   ) async {
-    if (_isDisposed) {
-      return;
-    }
-    assert(value.isInitialized);
-    return _methodChannel.invokeMethod('setPointerButton', <String, dynamic>{
-      'kind': kind.index,
-      'button': button.index,
-      'clickCount': 1,
-    });
+    _queueInputEvent(
+      (writer) => writer.pointerButton(kind.index, button.index, 1),
+    );
   }
 
   /// Indicates whether the specified [button] is currently down with click count.
@@ -255,24 +384,14 @@ class CustomPlatformViewController
     PointerButton button,
     int clickCount,
   ) async {
-    if (_isDisposed) {
-      return;
-    }
-    assert(value.isInitialized);
-    return _methodChannel.invokeMethod('setPointerButton', <String, dynamic>{
-      'kind': kind.index,
-      'button': button.index,
-      'clickCount': clickCount,
-    });
+    _queueInputEvent(
+      (writer) => writer.pointerButton(kind.index, button.index, clickCount),
+    );
   }
 
   /// Sets the horizontal and vertical scroll delta.
   Future<void> _setScrollDelta(double dx, double dy) async {
-    if (_isDisposed) {
-      return;
-    }
-    assert(value.isInitialized);
-    return _methodChannel.invokeMethod('setScrollDelta', [dx, dy]);
+    _queueInputEvent((writer) => writer.scrollDelta(dx, dy));
   }
 
   /// Sends a key event to the webview.
@@ -283,17 +402,11 @@ class CustomPlatformViewController
     int modifiers,
     String? characters,
   ) async {
-    if (_isDisposed) {
-      return;
-    }
-    assert(value.isInitialized);
-    return _methodChannel.invokeMethod('sendKeyEvent', <String, dynamic>{
-      'type': type, // 0=press, 1=release
-      'keyCode': keyCode,
-      'scanCode': scanCode,
-      'modifiers': modifiers,
-      'characters': characters,
-    });
+    // type: 0=press, 1=release
+    _queueInputEvent(
+      (writer) =>
+          writer.keyEvent(type, keyCode, scanCode, modifiers, characters),
+    );
   }
 
   /// Sends a touch event to the webview.
@@ -306,17 +419,9 @@ class CustomPlatformViewController
     double y,
     List<Map<String, dynamic>> touchPoints,
   ) async {
-    if (_isDisposed) {
-      return;
-    }
-    assert(value.isInitialized);
-    return _methodChannel.invokeMethod('sendTouchEvent', <String, dynamic>{
-      'type': type,
-      'id': id,
-      'x': x,
-      'y': y,
-      'touchPoints': touchPoints,
-    });
+    _queueInputEvent(
+      (writer) => writer.touchEvent(type, id, x, y, touchPoints),
+    );
   }
 
   /// Sets the focus state of the webview.
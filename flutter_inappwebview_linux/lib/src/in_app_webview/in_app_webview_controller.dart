@@ -1,3 +1,4 @@
+import 'dart:async';
 import 'dart:collection';
 import 'dart:convert';
 import 'dart:core';
@@ -40,6 +41,346 @@ class LinuxInAppWebViewControllerCreationParams
   }
 }
 
+/// How the result of [LinuxInAppWebViewController.evaluateJavascriptWithResultMode]
+/// is transferred from the native side.
+enum LinuxEvaluateJavascriptResultMode {
+  /// The result is serialized to a JSON string natively and decoded in Dart.
+  JSON,
+
+  /// The result is converted natively into standard message codec values
+  /// (maps, lists, typed data) without a JSON round-trip. Cyclic results, and
+  /// results with more than about a million values, throw a
+  /// [PlatformException] instead.
+  VALUE,
+
+  /// The result is serialized to JSON and streamed in chunks, avoiding a single
+  /// huge platform channel message for very large results. Chunks are decoded
+  /// as they arrive, so the Dart side never holds the whole JSON string.
+  CHUNKED_JSON,
+}
+
+/// What happens to a JavaScript handler call when
+/// [LinuxInAppWebViewController.setJavaScriptHandlerReplyOptions] `maxInFlight`
+/// calls are already waiting for a reply.
+enum LinuxJavaScriptHandlerOverflowPolicy {
+  /// The call is rejected immediately on the JavaScript side.
+  REJECT,
+
+  /// The call waits until one of the in-flight calls is answered.
+  QUEUE,
+}
+
+/// What a [LinuxInterceptRequestRule] does with a matching request.
+enum LinuxInterceptRequestRuleAction {
+  /// The request is aborted.
+  BLOCK,
+
+  /// The request is sent unchanged, without calling
+  /// `shouldInterceptFetchRequest`/`shouldInterceptAjaxRequest`.
+  ALLOW,
+
+  /// The request URL and/or headers are rewritten and the request is sent,
+  /// without calling `shouldInterceptFetchRequest`/`shouldInterceptAjaxRequest`.
+  MODIFY,
+}
+
+/// Kind of JavaScript request a [LinuxInterceptRequestRule] applies to.
+enum LinuxInterceptRequestType {
+  /// Requests made with `fetch()`.
+  FETCH,
+
+  /// Requests made with `XMLHttpRequest`.
+  AJAX,
+}
+
+/// A fetch/AJAX interception rule evaluated natively, see
+/// [LinuxInAppWebViewController.setInterceptRequestRules].
+class LinuxInterceptRequestRule {
+  /// ECMAScript regular expression searched in the request URL.
+  final String urlPattern;
+
+  /// HTTP methods the rule applies to. Empty means every method.
+  final List<String> methods;
+
+  /// Request kinds the rule applies to. Empty means both.
+  final List<LinuxInterceptRequestType> requestTypes;
+
+  /// What to do with a matching request.
+  final LinuxInterceptRequestRuleAction action;
+
+  /// Replacement for the part of the URL matched by [urlPattern] (`$1`... refer
+  /// to its groups). Only used with [LinuxInterceptRequestRuleAction.MODIFY].
+  final String? urlReplacement;
+
+  /// Headers set on the request. Only used with [LinuxInterceptRequestRuleAction.MODIFY].
+  final Map<String, String>? headers;
+
+  LinuxInterceptRequestRule({
+    required this.urlPattern,
+    this.methods = const [],
+    this.requestTypes = const [],
+    this.action = LinuxInterceptRequestRuleAction.ALLOW,
+    this.urlReplacement,
+    this.headers,
+  });
+
+  Map<String, dynamic> toMap() {
+    return {
+      'urlPattern': urlPattern,
+      'methods': methods,
+      'requestTypes': requestTypes.map((e) => e.index).toList(),
+      'action': action.index,
+      'urlReplacement': urlReplacement,
+      'headers': headers,
+    };
+  }
+}
+
+/// A [CustomSchemeResponse] whose body is streamed to the WebView instead of
+/// being returned as a single [data] buffer.
+///
+/// Chunks are pulled from [body] only as fast as the WebView reads them, so
+/// large resources are never fully held in memory. Range requests are only
+/// answered natively for buffered [CustomSchemeResponse]s; for a streamed body,
+/// check the `Range` header of the [WebResourceRequest] and reply with
+/// [statusCode] `206` and a `Content-Range` header.
+class LinuxCustomSchemeStreamResponse extends CustomSchemeResponse {
+  /// The response body.
+  final Stream<Uint8List> body;
+
+  /// HTTP status code of the response.
+  final int statusCode;
+
+  /// HTTP reason phrase of the response.
+  final String? reasonPhrase;
+
+  /// HTTP response headers.
+  final Map<String, String>? headers;
+
+  /// Length of the whole body in bytes, or `-1` if unknown.
+  final int contentLength;
+
+  LinuxCustomSchemeStreamResponse({
+    required String contentType,
+    required this.body,
+    String contentEncoding = 'utf-8',
+    this.statusCode = 200,
+    this.reasonPhrase,
+    this.headers,
+    this.contentLength = -1,
+  }) : super(
+          contentType: contentType,
+          contentEncoding: contentEncoding,
+          data: Uint8List(0),
+        );
+
+  @override
+  Map<String, dynamic> toMap({EnumMethod? enumMethod}) {
+    return {
+      ...super.toMap(enumMethod: enumMethod),
+      'stream': true,
+      'statusCode': statusCode,
+      'reasonPhrase': reasonPhrase,
+      'headers': headers,
+      'contentLength': contentLength,
+    };
+  }
+}
+
+/// Why a content blocker rule was dropped.
+class LinuxContentBlockerRuleDiagnostic {
+  /// Position of the rule in the list passed to the WebView.
+  final int index;
+
+  /// What is wrong with the rule.
+  final String message;
+
+  LinuxContentBlockerRuleDiagnostic({required this.index, required this.message});
+
+  static LinuxContentBlockerRuleDiagnostic fromMap(Map<String, dynamic> map) {
+    return LinuxContentBlockerRuleDiagnostic(
+      index: map['index'] ?? 0,
+      message: map['message'] ?? '',
+    );
+  }
+}
+
+/// Outcome of applying a list of content blockers.
+class LinuxContentBlockerCompileResult {
+  /// Whether the rules are applied. `false` if no rule compiled, or if a newer
+  /// update of the same shard replaced these rules before they were applied.
+  final bool success;
+
+  /// Number of rules in the list.
+  final int inputRules;
+
+  /// Number of rules applied, after dropping invalid and duplicate rules and
+  /// merging `css-display-none` rules with the same trigger.
+  final int compiledRules;
+
+  /// Number of rules dropped because WebKit does not support them.
+  final int invalidRules;
+
+  /// Number of rules dropped because an identical rule precedes them.
+  final int duplicateRules;
+
+  /// Number of `css-display-none` rules merged into a rule with the same trigger.
+  final int mergedRules;
+
+  /// Time spent converting and validating the rules, off the UI thread.
+  final Duration normalizeTime;
+
+  /// Time spent loading or compiling the WebKit filter.
+  final Duration compileTime;
+
+  /// Why rules were dropped (at most 256, [invalidRules] has the full count).
+  final List<LinuxContentBlockerRuleDiagnostic> diagnostics;
+
+  LinuxContentBlockerCompileResult({
+    required this.success,
+    this.inputRules = 0,
+    this.compiledRules = 0,
+    this.invalidRules = 0,
+    this.duplicateRules = 0,
+    this.mergedRules = 0,
+    this.normalizeTime = Duration.zero,
+    this.compileTime = Duration.zero,
+    this.diagnostics = const [],
+  });
+
+  static LinuxContentBlockerCompileResult fromMap(Map<String, dynamic> map) {
+    Duration toDuration(dynamic milliseconds) =>
+        Duration(microseconds: ((milliseconds ?? 0.0) * 1000).round());
+    return LinuxContentBlockerCompileResult(
+      success: map['success'] ?? false,
+      inputRules: map['inputRules'] ?? 0,
+      compiledRules: map['compiledRules'] ?? 0,
+      invalidRules: map['invalidRules'] ?? 0,
+      duplicateRules: map['duplicateRules'] ?? 0,
+      mergedRules: map['mergedRules'] ?? 0,
+      normalizeTime: toDuration(map['normalizeTime']),
+      compileTime: toDuration(map['compileTime']),
+      diagnostics: (map['diagnostics'] as List<dynamic>? ?? [])
+          .map((e) => LinuxContentBlockerRuleDiagnostic.fromMap(
+              e.cast<String, dynamic>()))
+          .toList(),
+    );
+  }
+}
+
+/// Requests blocked by the rules of one content blocker shard.
+class LinuxContentBlockerShardStats {
+  /// Number of blocked requests attributed to the shard.
+  final int blockedRequests;
+
+  /// Estimated size of the blocked resources, from earlier loads of the same
+  /// URL or the average size of the resources the WebView loaded.
+  final int estimatedBytesAvoided;
+
+  /// Number of rules in the shard's current filter.
+  final int compiledRules;
+
+  /// Time it took to convert and compile (or load) the shard's current filter.
+  final Duration compileTime;
+
+  /// Position of the rule in the shard's list -> number of requests it blocked.
+  /// Rules that never blocked anything are not listed.
+  final Map<int, int> ruleHits;
+
+  LinuxContentBlockerShardStats({
+    this.blockedRequests = 0,
+    this.estimatedBytesAvoided = 0,
+    this.compiledRules = 0,
+    this.compileTime = Duration.zero,
+    this.ruleHits = const {},
+  });
+
+  static LinuxContentBlockerShardStats fromMap(Map<String, dynamic> map) {
+    Map<int, int> ruleHits = {};
+    for (var hit in (map['ruleHits'] as List<dynamic>? ?? [])) {
+      ruleHits[hit['index'] ?? 0] = hit['hits'] ?? 0;
+    }
+    return LinuxContentBlockerShardStats(
+      blockedRequests: map['blockedRequests'] ?? 0,
+      estimatedBytesAvoided: map['estimatedBytesAvoided'] ?? 0,
+      compiledRules: map['compiledRules'] ?? 0,
+      compileTime: Duration(
+          microseconds: ((map['compileTime'] ?? 0.0) * 1000).round()),
+      ruleHits: ruleHits,
+    );
+  }
+}
+
+/// Content blocker statistics of a WebView.
+class LinuxContentBlockerStats {
+  /// Whether instrumentation is enabled.
+  final bool enabled;
+
+  /// Number of blocked requests, all shards included.
+  final int blockedRequests;
+
+  /// Estimated size of the blocked resources, all shards included.
+  final int estimatedBytesAvoided;
+
+  /// Statistics per shard name. The empty name is
+  /// [InAppWebViewSettings.contentBlockers].
+  final Map<String, LinuxContentBlockerShardStats> shards;
+
+  LinuxContentBlockerStats({
+    this.enabled = false,
+    this.blockedRequests = 0,
+    this.estimatedBytesAvoided = 0,
+    this.shards = const {},
+  });
+
+  static LinuxContentBlockerStats fromMap(Map<String, dynamic> map) {
+    return LinuxContentBlockerStats(
+      enabled: map['enabled'] ?? false,
+      blockedRequests: map['blockedRequests'] ?? 0,
+      estimatedBytesAvoided: map['estimatedBytesAvoided'] ?? 0,
+      shards: (map['shards'] as Map<dynamic, dynamic>? ?? {}).map((key, value) =>
+          MapEntry(key as String,
+              LinuxContentBlockerShardStats.fromMap(value.cast<String, dynamic>()))),
+    );
+  }
+}
+
+/// Decodes a JSON result as its chunks arrive, so the whole JSON string is
+/// never held in memory.
+class _ChunkedJsonResult {
+  Object? _value;
+  Object? _error;
+  late final StringConversionSink _sink = const JsonDecoder()
+      .startChunkedConversion(
+        ChunkedConversionSink<Object?>.withCallback((values) {
+          _value = values.isNotEmpty ? values.last : null;
+        }),
+      );
+
+  void add(String data) {
+    if (_error != null) {
+      return;
+    }
+    try {
+      _sink.add(data);
+    } catch (e) {
+      _error = e;
+    }
+  }
+
+  /// Returns the decoded value, or `null` if the JSON was invalid.
+  Object? close() {
+    if (_error == null) {
+      try {
+        _sink.close();
+      } catch (e) {
+        _error = e;
+      }
+    }
+    return _error == null ? _value : null;
+  }
+}
+
 /// Controls a WebView, such as an [InAppWebView] widget instance.
 ///
 /// If you are using the [InAppWebView] widget, an [InAppWebViewController] instance
@@ -58,6 +399,10 @@ class LinuxInAppWebViewController extends PlatformInAppWebViewController
   Set<String> _webMessageListenerObjNames = Set();
   Set<LinuxWebMessageChannel> _webMessageChannels = Set();
   Map<String, ScriptHtmlTagAttributes> _injectedScriptsFromURL = {};
+  Map<int, _ChunkedJsonResult> _evaluateJavascriptChunks = {};
+  Map<int, StreamIterator<Uint8List>> _customSchemeResponseStreams = {};
+  int _customSchemeResponseStreamId = 0;
+  int _evaluateJavascriptRequestId = 0;
 
   // static map that contains the properties to be saved and restored for keep alive feature
   static final Map<InAppWebViewKeepAlive, InAppWebViewControllerKeepAliveProps?>
@@ -267,13 +612,31 @@ class LinuxInAppWebViewController extends PlatformInAppWebViewController
           Map<String, dynamic> arguments = call.arguments
               .cast<String, dynamic>();
           ConsoleMessage consoleMessage = ConsoleMessage.fromMap(arguments)!;
-          if (webviewParams != null && webviewParams!.onConsoleMessage != null)
-            webviewParams!.onConsoleMessage!(
-              _controllerFromPlatform,
-              consoleMessage,
+          _dispatchConsoleMessage(consoleMessage);
+        }
+        break;
+      case "onConsoleMessages":
+        if ((webviewParams != null &&
+                webviewParams!.onConsoleMessage != null) ||
+            _inAppBrowserEventHandler != null) {
+          List<dynamic> messages = call.arguments["messages"];
+          int droppedCount = call.arguments["droppedCount"] ?? 0;
+          for (var message in messages) {
+            ConsoleMessage? consoleMessage = ConsoleMessage.fromMap(
+              message?.cast<String, dynamic>(),
             );
-          else
-            _inAppBrowserEventHandler!.onConsoleMessage(consoleMessage);
+            if (consoleMessage != null) {
+              _dispatchConsoleMessage(consoleMessage);
+            }
+          }
+          if (droppedCount > 0) {
+            _dispatchConsoleMessage(
+              ConsoleMessage(
+                message: '$droppedCount console messages dropped by rate limit',
+                messageLevel: ConsoleMessageLevel.WARNING,
+              ),
+            );
+          }
         }
         break;
       case "onLoadResource":
@@ -288,6 +651,24 @@ class LinuxInAppWebViewController extends PlatformInAppWebViewController
             _inAppBrowserEventHandler!.onLoadResource(resource);
         }
         break;
+      case "onLoadResources":
+        if ((webviewParams != null && webviewParams!.onLoadResource != null) ||
+            _inAppBrowserEventHandler != null) {
+          List<dynamic> resources = call.arguments["resources"];
+          for (var item in resources) {
+            LoadedResource? resource = LoadedResource.fromMap(
+              item?.cast<String, dynamic>(),
+            );
+            if (resource == null) {
+              continue;
+            }
+            if (webviewParams != null && webviewParams!.onLoadResource != null)
+              webviewParams!.onLoadResource!(_controllerFromPlatform, resource);
+            else
+              _inAppBrowserEventHandler!.onLoadResource(resource);
+          }
+        }
+        break;
       case "onTitleChanged":
         if ((webviewParams != null && webviewParams!.onTitleChanged != null) ||
             _inAppBrowserEventHandler != null) {
@@ -448,6 +829,31 @@ class LinuxInAppWebViewController extends PlatformInAppWebViewController
             _inAppBrowserEventHandler!.onScrollChanged(x, y);
         }
         break;
+      case "onContentSizeChanged":
+        if ((webviewParams != null &&
+                webviewParams!.onContentSizeChanged != null) ||
+            _inAppBrowserEventHandler != null) {
+          var oldContentSize = MapSize.fromMap(
+            call.arguments["oldContentSize"]?.cast<String, dynamic>(),
+          )!;
+          var newContentSize = MapSize.fromMap(
+            call.arguments["newContentSize"]?.cast<String, dynamic>(),
+          )!;
+
+          if (webviewParams != null &&
+              webviewParams!.onContentSizeChanged != null)
+            webviewParams!.onContentSizeChanged!(
+              _controllerFromPlatform,
+              oldContentSize,
+              newContentSize,
+            );
+          else
+            _inAppBrowserEventHandler!.onContentSizeChanged(
+              oldContentSize,
+              newContentSize,
+            );
+        }
+        break;
       case "onCloseWindow":
         if (webviewParams != null && webviewParams!.onCloseWindow != null)
           webviewParams!.onCloseWindow!(_controllerFromPlatform);
@@ -931,30 +1337,57 @@ class LinuxInAppWebViewController extends PlatformInAppWebViewController
               .cast<String, dynamic>();
           WebResourceRequest request = WebResourceRequest.fromMap(requestMap)!;
 
+          CustomSchemeResponse? response;
           if (webviewParams != null) {
             if (webviewParams!.onLoadResourceWithCustomScheme != null)
-              return (await webviewParams!.onLoadResourceWithCustomScheme!(
+              response = await webviewParams!.onLoadResourceWithCustomScheme!(
                 _controllerFromPlatform,
                 request,
-              ))?.toMap();
+              );
             else {
-              return (await webviewParams!
-                      // ignore: deprecated_member_use_from_same_package
-                      .onLoadResourceCustomScheme!(
-                    _controllerFromPlatform,
-                    request.url,
-                  ))
-                  ?.toMap();
+              response = await webviewParams!
+                  // ignore: deprecated_member_use_from_same_package
+                  .onLoadResourceCustomScheme!(
+                _controllerFromPlatform,
+                request.url,
+              );
             }
           } else {
-            return ((await _inAppBrowserEventHandler!
-                        .onLoadResourceWithCustomScheme(request)) ??
-                    (await _inAppBrowserEventHandler!
-                        .onLoadResourceCustomScheme(request.url)))
-                ?.toMap();
+            response = (await _inAppBrowserEventHandler!
+                    .onLoadResourceWithCustomScheme(request)) ??
+                (await _inAppBrowserEventHandler!
+                    .onLoadResourceCustomScheme(request.url));
+          }
+          if (response is LinuxCustomSchemeStreamResponse) {
+            int streamId = _customSchemeResponseStreamId++;
+            _customSchemeResponseStreams[streamId] =
+                StreamIterator(response.body);
+            return response.toMap()..['streamId'] = streamId;
           }
+          return response?.toMap();
         }
         break;
+      case "onCustomSchemeResponseStreamPull":
+        int streamId = call.arguments["streamId"];
+        StreamIterator<Uint8List>? iterator =
+            _customSchemeResponseStreams[streamId];
+        if (iterator == null) {
+          return null;
+        }
+        if (await iterator.moveNext()) {
+          return iterator.current;
+        }
+        _customSchemeResponseStreams.remove(streamId);
+        return null;
+      case "onCustomSchemeResponseStreamClosed":
+        int streamId = call.arguments["streamId"];
+        await _customSchemeResponseStreams.remove(streamId)?.cancel();
+        break;
+      case "onEvaluateJavascriptResultChunk":
+        int requestId = call.arguments["requestId"];
+        String data = call.arguments["data"];
+        _evaluateJavascriptChunks[requestId]?.add(data);
+        break;
       case "onCallJsHandler":
         String handlerName = call.arguments["handlerName"];
         Map<String, dynamic> handlerDataMap = call.arguments["data"]
@@ -1340,6 +1773,58 @@ class LinuxInAppWebViewController extends PlatformInAppWebViewController
     return result;
   }
 
+  /// Same as [evaluateJavascript], but lets the caller choose how the result
+  /// is transferred from the native side.
+  ///
+  /// [LinuxEvaluateJavascriptResultMode.VALUE] skips JSON entirely, while
+  /// [LinuxEvaluateJavascriptResultMode.CHUNKED_JSON] streams the serialized
+  /// result in slices of at most [chunkSize] bytes.
+  Future<dynamic> evaluateJavascriptWithResultMode({
+    required String source,
+    ContentWorld? contentWorld,
+    LinuxEvaluateJavascriptResultMode resultMode =
+        LinuxEvaluateJavascriptResultMode.JSON,
+    int? chunkSize,
+  }) async {
+    if (resultMode == LinuxEvaluateJavascriptResultMode.JSON) {
+      return await evaluateJavascript(
+        source: source,
+        contentWorld: contentWorld,
+      );
+    }
+
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('source', () => source);
+    if (contentWorld != null) {
+      args.putIfAbsent('contentWorld', () => contentWorld.toMap());
+    }
+    args.putIfAbsent('resultMode', () => resultMode.index);
+
+    if (resultMode == LinuxEvaluateJavascriptResultMode.VALUE) {
+      return await channel?.invokeMethod('evaluateJavascript', args);
+    }
+
+    int requestId = _evaluateJavascriptRequestId++;
+    args.putIfAbsent('requestId', () => requestId);
+    if (chunkSize != null) {
+      args.putIfAbsent('chunkSize', () => chunkSize);
+    }
+    _evaluateJavascriptChunks[requestId] = _ChunkedJsonResult();
+    try {
+      int? totalLength = await channel?.invokeMethod<int?>(
+        'evaluateJavascript',
+        args,
+      );
+      _ChunkedJsonResult? chunkedResult = _evaluateJavascriptChunks[requestId];
+      if (totalLength == null || chunkedResult == null) {
+        return null;
+      }
+      return chunkedResult.close();
+    } finally {
+      _evaluateJavascriptChunks.remove(requestId);
+    }
+  }
+
   @override
   Future<CallAsyncJavaScriptResult?> callAsyncJavaScript({
     required String functionBody,
@@ -1361,7 +1846,12 @@ class LinuxInAppWebViewController extends PlatformInAppWebViewController
       'callAsyncJavaScript',
       args,
     );
+    return _decodeCallAsyncJavaScriptResult(jsonResult);
+  }
 
+  CallAsyncJavaScriptResult? _decodeCallAsyncJavaScriptResult(
+    String? jsonResult,
+  ) {
     if (jsonResult != null) {
       try {
         Map<String, dynamic> result = jsonDecode(jsonResult);
@@ -1379,6 +1869,284 @@ class LinuxInAppWebViewController extends PlatformInAppWebViewController
     return null;
   }
 
+  /// Evaluates [source] concurrently in the main frame and in every iframe,
+  /// returning one entry per frame.
+  ///
+  /// Each entry is a map with `isMainFrame`, `url`, `origin`, `name`, `value`
+  /// and `error`. Frames that don't answer within [timeout] are left out and
+  /// `timedOut` is set in the returned map. [contentWorld] applies to the main
+  /// frame; iframes are evaluated in the page content world where the plugin
+  /// scripts run.
+  Future<Map<String, dynamic>?> evaluateJavascriptInAllFrames({
+    required String source,
+    ContentWorld? contentWorld,
+    Duration timeout = const Duration(seconds: 10),
+  }) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('source', () => source);
+    args.putIfAbsent('timeout', () => timeout.inMilliseconds);
+    if (contentWorld != null) {
+      args.putIfAbsent('contentWorld', () => contentWorld.toMap());
+    }
+    String? jsonResult = await channel?.invokeMethod<String?>(
+      'evaluateJavascriptInAllFrames',
+      args,
+    );
+    if (jsonResult == null) {
+      return null;
+    }
+    try {
+      return jsonDecode(jsonResult).cast<String, dynamic>();
+    } catch (e) {
+      return null;
+    }
+  }
+
+  /// Configures how console messages are collected by the page.
+  ///
+  /// Messages below [minLevel] are dropped inside the page, before they reach
+  /// the native side ([ConsoleMessageLevel.TIP] and [ConsoleMessageLevel.DEBUG]
+  /// are the lowest level). At most [maxMessagesPerSecond] messages are kept
+  /// (`0` means unlimited); the number of dropped messages is reported as a
+  /// single [ConsoleMessageLevel.WARNING] message. Kept messages are delivered
+  /// in batches every [batchInterval].
+  Future<void> setConsoleMessageOptions({
+    ConsoleMessageLevel minLevel = ConsoleMessageLevel.TIP,
+    int maxMessagesPerSecond = 0,
+    Duration batchInterval = Duration.zero,
+  }) async {
+    int level;
+    if (minLevel == ConsoleMessageLevel.ERROR) {
+      level = 3;
+    } else if (minLevel == ConsoleMessageLevel.WARNING) {
+      level = 2;
+    } else if (minLevel == ConsoleMessageLevel.LOG) {
+      level = 1;
+    } else {
+      level = 0;
+    }
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('minLevel', () => level);
+    args.putIfAbsent('maxMessagesPerSecond', () => maxMessagesPerSecond);
+    args.putIfAbsent('batchInterval', () => batchInterval.inMilliseconds);
+    await channel?.invokeMethod('setConsoleMessageOptions', args);
+  }
+
+  /// Filters the resources reported to `onLoadResource` before they are sent
+  /// to Dart.
+  ///
+  /// Only resources whose `initiatorType` is in [initiatorTypes] (all if empty)
+  /// and whose URL matches the [urlPattern] regular expression (all if `null`)
+  /// are kept; of these, the [sampleRate] fraction (`0.0` to `1.0`) is reported.
+  /// URLs longer than 8192 characters never match [urlPattern].
+  /// Returns `false` if [urlPattern] is not a valid regular expression.
+  Future<bool> setLoadResourceFilter({
+    List<String> initiatorTypes = const [],
+    String? urlPattern,
+    double sampleRate = 1.0,
+  }) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('initiatorTypes', () => initiatorTypes);
+    args.putIfAbsent('urlPattern', () => urlPattern);
+    args.putIfAbsent('sampleRate', () => sampleRate);
+    return await channel?.invokeMethod<bool>('setLoadResourceFilter', args) ??
+        false;
+  }
+
+  /// Serves the custom [scheme] natively from a local [directory], or from the
+  /// [assetPrefix] directory of the Flutter assets bundle (`''` for all assets),
+  /// without calling `onLoadResourceWithCustomScheme`.
+  ///
+  /// `scheme://host/a/b.js` is served from `<root>/a/b.js` (the host is
+  /// ignored) and directories from their `index.html`. Responses carry a
+  /// sniffed `Content-Type` and an `ETag`, and single byte-range requests are
+  /// supported. Missing files still go to `onLoadResourceWithCustomScheme`
+  /// when [fallbackToDart] is `true`, otherwise they fail with `404`.
+  /// The scheme must be listed in [InAppWebViewSettings.resourceCustomSchemes].
+  ///
+  /// Passing neither [directory] nor [assetPrefix] removes the mapping.
+  /// Returns `false` if the root is not a directory.
+  Future<bool> setCustomSchemeFileSource({
+    required String scheme,
+    String? directory,
+    String? assetPrefix,
+    bool fallbackToDart = true,
+  }) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('scheme', () => scheme);
+    args.putIfAbsent('directory', () => directory);
+    args.putIfAbsent('assetPrefix', () => assetPrefix);
+    args.putIfAbsent('fallbackToDart', () => fallbackToDart);
+    return await channel?.invokeMethod<bool>('setCustomSchemeFileSource', args) ??
+        false;
+  }
+
+  /// Applies [contentBlockers] as the named content blocker [shard] (e.g. one
+  /// per list source), alongside [InAppWebViewSettings.contentBlockers] and
+  /// the other shards.
+  ///
+  /// Each shard is compiled into its own filter, so updating a shard only
+  /// recompiles that shard and the others stay applied meanwhile. Compiled
+  /// shards are shared by webviews with the same rules. An `ignore-previous-rules`
+  /// action only applies to the rules of its own shard.
+  ///
+  /// Rules are converted off the UI thread. Rules WebKit does not support are
+  /// dropped and reported in [LinuxContentBlockerCompileResult.diagnostics],
+  /// instead of failing the whole list.
+  ///
+  /// An empty list removes the shard. If no rule compiles, the shard is removed
+  /// and [LinuxContentBlockerCompileResult.success] is `false`.
+  Future<LinuxContentBlockerCompileResult> setContentBlockerShard({
+    required String shard,
+    required List<ContentBlocker> contentBlockers,
+  }) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('shard', () => shard);
+    args.putIfAbsent(
+        'contentBlockers', () => contentBlockers.map((e) => e.toMap()).toList());
+    Map<String, dynamic>? result = (await channel
+            ?.invokeMethod<Map<dynamic, dynamic>>('setContentBlockerShard', args))
+        ?.cast<String, dynamic>();
+    return result != null
+        ? LinuxContentBlockerCompileResult.fromMap(result)
+        : LinuxContentBlockerCompileResult(success: false);
+  }
+
+  /// Removes the content blocker [shard] set with [setContentBlockerShard].
+  Future<bool> removeContentBlockerShard({required String shard}) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('shard', () => shard);
+    return await channel?.invokeMethod<bool>('removeContentBlockerShard', args) ??
+        false;
+  }
+
+  /// Returns the names of the content blocker shards set with [setContentBlockerShard].
+  Future<List<String>> getContentBlockerShardNames() async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    List<dynamic>? names = await channel?.invokeMethod<List<dynamic>>(
+        'getContentBlockerShardNames', args);
+    return names?.cast<String>() ?? [];
+  }
+
+  /// Enables or disables content blocker statistics, read with
+  /// [getContentBlockerStats].
+  ///
+  /// WebKit does not report blocked requests, so while enabled a script
+  /// reports the resources the page failed to load, and a failure counts as
+  /// blocked by the first `block` rule whose `url-filter` matches its URL
+  /// (other trigger conditions are not checked). Failures are reported in
+  /// batches, about once per second.
+  ///
+  /// Matching costs one regular expression per `block` rule, so keep it
+  /// disabled in production. Statistics are kept when disabling.
+  ///
+  /// Returns `false` if the JavaScript bridge is disabled.
+  Future<bool> setContentBlockerInstrumentation({required bool enabled}) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('enabled', () => enabled);
+    return await channel?.invokeMethod<bool>(
+            'setContentBlockerInstrumentation', args) ??
+        false;
+  }
+
+  /// Returns the content blocker statistics collected while instrumentation
+  /// was enabled (see [setContentBlockerInstrumentation]), then clears them
+  /// if [reset] is `true`.
+  ///
+  /// Rule positions refer to the current list of each shard: reset the
+  /// statistics after updating a shard.
+  Future<LinuxContentBlockerStats> getContentBlockerStats(
+      {bool reset = false}) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('reset', () => reset);
+    Map<String, dynamic>? result = (await channel
+            ?.invokeMethod<Map<dynamic, dynamic>>('getContentBlockerStats', args))
+        ?.cast<String, dynamic>();
+    return result != null
+        ? LinuxContentBlockerStats.fromMap(result)
+        : LinuxContentBlockerStats();
+  }
+
+  /// Sets rules applied to `fetch()` and `XMLHttpRequest` requests natively,
+  /// replacing the previous ones.
+  ///
+  /// The first matching rule decides the request without calling
+  /// `shouldInterceptFetchRequest` or `shouldInterceptAjaxRequest`, and the request
+  /// body is not serialized. Requests that match no rule are still sent to those
+  /// callbacks. Rules only apply while [InAppWebViewSettings.useShouldInterceptFetchRequest]
+  /// / [InAppWebViewSettings.useShouldInterceptAjaxRequest] are enabled.
+  /// Rules with an invalid [LinuxInterceptRequestRule.urlPattern] are ignored.
+  Future<void> setInterceptRequestRules(
+      {required List<LinuxInterceptRequestRule> rules}) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('rules', () => rules.map((e) => e.toMap()).toList());
+    await channel?.invokeMethod('setInterceptRequestRules', args);
+  }
+
+  /// Bounds the JavaScript handler calls (`callHandler`) waiting for an answer.
+  ///
+  /// Calls not answered within [timeout] are rejected on the JavaScript side.
+  /// At most [maxInFlight] calls are dispatched at the same time; further calls
+  /// are handled according to [overflowPolicy], with at most [maxQueued] calls
+  /// waiting. `null` or `0` means no limit. Pending calls are always cancelled
+  /// when the page navigates away or the WebView is disposed.
+  Future<void> setJavaScriptHandlerReplyOptions({
+    Duration? timeout,
+    int maxInFlight = 0,
+    int maxQueued = 0,
+    LinuxJavaScriptHandlerOverflowPolicy overflowPolicy =
+        LinuxJavaScriptHandlerOverflowPolicy.REJECT,
+  }) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('timeout', () => timeout?.inMilliseconds ?? 0);
+    args.putIfAbsent('maxInFlight', () => maxInFlight);
+    args.putIfAbsent('maxQueued', () => maxQueued);
+    args.putIfAbsent('overflowPolicy', () => overflowPolicy.index);
+    await channel?.invokeMethod('setJavaScriptHandlerReplyOptions', args);
+  }
+
+  /// Registers [functionBody] once and returns a handle for [callPreparedScript].
+  ///
+  /// The body follows the same rules as [callAsyncJavaScript]; [argumentKeys]
+  /// are the names the arguments map is destructured into. The compiled
+  /// function is kept in the page, so each call only sends its JSON arguments.
+  Future<int?> prepareScript({
+    required String functionBody,
+    List<String> argumentKeys = const <String>[],
+    ContentWorld? contentWorld,
+  }) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('functionBody', () => functionBody);
+    args.putIfAbsent('argumentKeys', () => argumentKeys);
+    if (contentWorld != null) {
+      args.putIfAbsent('contentWorld', () => contentWorld.toMap());
+    }
+    return await channel?.invokeMethod<int?>('prepareScript', args);
+  }
+
+  /// Calls a script registered with [prepareScript].
+  Future<CallAsyncJavaScriptResult?> callPreparedScript({
+    required int handle,
+    Map<String, dynamic> arguments = const <String, dynamic>{},
+  }) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('handle', () => handle);
+    args.putIfAbsent('arguments', () => jsonEncode(arguments));
+    String? jsonResult = await channel?.invokeMethod<String?>(
+      'callPreparedScript',
+      args,
+    );
+    return _decodeCallAsyncJavaScriptResult(jsonResult);
+  }
+
+  /// Releases a script registered with [prepareScript].
+  Future<bool> disposePreparedScript({required int handle}) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('handle', () => handle);
+    return await channel?.invokeMethod<bool?>('disposePreparedScript', args) ??
+        false;
+  }
+
   @override
   Future<void> injectJavascriptFileFromUrl({
     required WebUri urlFile,
@@ -1486,6 +2254,34 @@ class LinuxInAppWebViewController extends PlatformInAppWebViewController
         'flutter_inappwebview';
   }
 
+  /// Enables or disables lazy activation of the plugin scripts for color and
+  /// date inputs, cursor detection and `window.print()` interception.
+  ///
+  /// When enabled, pages get a small stub per feature instead of the full
+  /// script, and the stub loads the implementation through the JavaScript
+  /// bridge once the page uses the feature: when a matching input exists or
+  /// is hovered/focused, on the first mouse move, or on the first
+  /// `window.print()` call. The implementation is run with `eval`, so pages
+  /// whose Content-Security-Policy forbids it don't get these features.
+  ///
+  /// Applies to every WebView created afterwards. Disabled by default.
+  Future<void> setLazyPluginScriptActivation(bool enabled) async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    args.putIfAbsent('enabled', () => enabled);
+    await _staticChannel.invokeMethod('setLazyPluginScriptActivation', args);
+  }
+
+  /// Returns whether lazy plugin script activation is enabled (see
+  /// [setLazyPluginScriptActivation]).
+  Future<bool> isLazyPluginScriptActivationEnabled() async {
+    Map<String, dynamic> args = <String, dynamic>{};
+    return await _staticChannel.invokeMethod<bool>(
+          'isLazyPluginScriptActivationEnabled',
+          args,
+        ) ??
+        false;
+  }
+
   @override
   Future<void> disposeKeepAlive(InAppWebViewKeepAlive keepAlive) async {
     Map<String, dynamic> args = <String, dynamic>{};
@@ -2339,6 +3135,13 @@ class LinuxInAppWebViewController extends PlatformInAppWebViewController
     return await channel?.invokeMethod<bool?>('requestFocus', args);
   }
 
+  void _dispatchConsoleMessage(ConsoleMessage consoleMessage) {
+    if (webviewParams != null && webviewParams!.onConsoleMessage != null)
+      webviewParams!.onConsoleMessage!(_controllerFromPlatform, consoleMessage);
+    else
+      _inAppBrowserEventHandler?.onConsoleMessage(consoleMessage);
+  }
+
   @override
   void dispose({bool isKeepAlive = false}) {
     if (!isKeepAlive) {
@@ -2352,6 +3155,11 @@ class LinuxInAppWebViewController extends PlatformInAppWebViewController
       }
       _webMessageChannels.clear();
     }
+    _evaluateJavascriptChunks.clear();
+    for (final iterator in _customSchemeResponseStreams.values) {
+      iterator.cancel();
+    }
+    _customSchemeResponseStreams.clear();
     webStorage.dispose();
     disposeChannel(removeMethodCallHandler: !isKeepAlive);
   }
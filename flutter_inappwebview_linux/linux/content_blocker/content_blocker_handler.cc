@@ -1,352 +1,414 @@
 #include "content_blocker_handler.h"
 
-#include <nlohmann/json.hpp>
-
 #include <algorithm>
-#include <cstring>
-#include <filesystem>
+#include <iterator>
 
 #include "../utils/log.h"
-#include "../utils/util.h"
-
-using json = nlohmann::json;
+#include "content_blocker_rule_normalizer.h"
 
 namespace flutter_inappwebview_plugin {
 
-ContentBlockerHandler::ContentBlockerHandler(WebKitUserContentManager* content_manager)
-    : content_manager_(content_manager),
-      filter_store_(nullptr),
-      filter_identifier_("flutter_inappwebview_content_rules") {
+ContentBlockerHandler::ContentBlockerHandler(WebKitUserContentManager* content_manager,
+                                             ContentFilterRegistry* registry)
+    : content_manager_(content_manager), registry_(registry), cancellable_(g_cancellable_new()) {
   if (content_manager_ == nullptr) {
     errorLog("ContentBlockerHandler: content_manager is null");
-    return;
-  }
-
-  // Get app-specific ID for isolated storage
-  std::string app_id = resolve_application_id_sanitized();
-
-  // Create filter store in a cache directory
-  // Use XDG cache directory or fallback to /tmp
-  const char* xdg_cache = g_get_user_cache_dir();
-  if (xdg_cache != nullptr) {
-    store_path_ = std::string(xdg_cache) + "/flutter_inappwebview/" + app_id + "/content_filters";
-  } else {
-    store_path_ = "/tmp/flutter_inappwebview/" + app_id + "/content_filters";
-  }
-
-  // Ensure directory exists
-  std::error_code ec;
-  std::filesystem::create_directories(store_path_, ec);
-  if (ec) {
-    errorLog("ContentBlockerHandler: Failed to create filter store directory: " + ec.message());
   }
-
-  // Create the filter store
-  filter_store_ = webkit_user_content_filter_store_new(store_path_.c_str());
-  if (filter_store_ == nullptr) {
-    errorLog("ContentBlockerHandler: Failed to create WebKitUserContentFilterStore");
+  if (registry_ == nullptr) {
+    errorLog("ContentBlockerHandler: content filter registry is null");
   }
 }
 
 ContentBlockerHandler::~ContentBlockerHandler() {
-  removeAllFilters();
-
-  if (filter_store_ != nullptr) {
-    g_object_unref(filter_store_);
-    filter_store_ = nullptr;
+  // Rules being normalized on the worker thread are dropped unseen
+  g_cancellable_cancel(cancellable_);
+  g_object_unref(cancellable_);
+
+  // Pending callbacks may capture the owner, which is being destroyed too
+  for (auto& [name, shard] : shards_) {
+    supersedePending(shard, false);
+    if (!shard.identifier.empty()) {
+      detachFilter(shard.identifier);
+    }
   }
+  shards_.clear();
 }
 
 void ContentBlockerHandler::setContentBlockers(FlValue* contentBlockers,
                                                 std::function<void(bool success)> callback) {
-  if (filter_store_ == nullptr || content_manager_ == nullptr) {
-    errorLog("ContentBlockerHandler: filter_store or content_manager is null");
-    if (callback) callback(false);
+  setContentBlockerShard(kSettingsShard, contentBlockers,
+                         [callback = std::move(callback)](const ContentBlockerCompileResult& result) {
+                           if (callback) callback(result.success);
+                         });
+}
+
+void ContentBlockerHandler::setContentBlockerShard(const std::string& shardName,
+                                                    FlValue* contentBlockers,
+                                                    CompileCallback callback) {
+  ContentBlockerCompileResult result;
+  if (registry_ == nullptr || !registry_->isValid() || content_manager_ == nullptr) {
+    errorLog("ContentBlockerHandler: filter registry or content_manager is null");
+    if (callback) callback(result);
     return;
   }
 
-  // First remove existing filters
-  removeAllFilters();
-
   // Check if there are any content blockers to apply
   if (contentBlockers == nullptr ||
       fl_value_get_type(contentBlockers) != FL_VALUE_TYPE_LIST ||
       fl_value_get_length(contentBlockers) == 0) {
     // No blockers - this is success (empty set)
-    if (callback) callback(true);
+    removeContentBlockerShard(shardName);
+    result.success = true;
+    if (callback) callback(result);
     return;
   }
 
-  // Convert to JSON string
-  std::string jsonSource = convertToJsonString(contentBlockers);
-
-  if (jsonSource.empty()) {
-    errorLog("ContentBlockerHandler: Failed to convert content blockers to JSON");
-    if (callback) callback(false);
-    return;
-  }
-
-  // Compile the content blockers
-  compileContentBlockers(jsonSource, callback);
+  // The shard's current filter stays applied until the new one is ready
+  Shard& shard = shards_[shardName];
+  supersedePending(shard, true);
+  uint64_t generation = ++shard.generation;
+  shard.pendingCallback = std::move(callback);
+
+  // Large lists take a while to convert: keep the main thread free. The
+  // destructor cancels the task, so the callback can use this.
+  ContentBlockerRuleNormalizer::normalizeAsync(
+      contentBlockers, cancellable_,
+      [this, shardName, generation](ContentBlockerRuleNormalizer::Output output) {
+        auto it = shards_.find(shardName);
+        if (it == shards_.end() || it->second.generation != generation) {
+          // Superseded meanwhile, the callback already ran
+          return;
+        }
+        onRulesNormalized(shardName, std::move(output));
+      });
 }
 
-void ContentBlockerHandler::removeAllFilters() {
-  // Check if content_manager is still valid before calling WebKit API
-  // The content_manager becomes invalid when the webview is destroyed
-  if (content_manager_ != nullptr && WEBKIT_IS_USER_CONTENT_MANAGER(content_manager_)) {
-    webkit_user_content_manager_remove_all_filters(content_manager_);
+void ContentBlockerHandler::onRulesNormalized(const std::string& shardName,
+                                              ContentBlockerRuleNormalizer::Output output) {
+  Shard& shard = shards_[shardName];
+  shard.pendingMatchRules = std::move(output.matchRules);
+  ContentBlockerCompileResult result = std::move(output.result);
+  if (result.invalidRules > 0) {
+    debugLog("ContentBlockerHandler: dropped " + std::to_string(result.invalidRules) +
+             " invalid content blocker rule(s), first: " + result.diagnostics.front().message);
   }
-}
 
-std::string ContentBlockerHandler::convertToJsonString(FlValue* contentBlockers) {
-  if (contentBlockers == nullptr ||
-      fl_value_get_type(contentBlockers) != FL_VALUE_TYPE_LIST) {
-    return "";
+  if (output.json.empty()) {
+    errorLog("ContentBlockerHandler: No valid content blocker rule to apply");
+    // Same outcome as before the failed update: no rules in this shard
+    CompileCallback callback = std::move(shard.pendingCallback);
+    removeContentBlockerShard(shardName);
+    if (callback) callback(result);
+    return;
   }
 
-  json jsonArray = json::array();
-
-  size_t count = fl_value_get_length(contentBlockers);
-  for (size_t i = 0; i < count; i++) {
-    FlValue* blocker = fl_value_get_list_value(contentBlockers, i);
-    if (fl_value_get_type(blocker) != FL_VALUE_TYPE_MAP) {
-      continue;
-    }
-
-    json rule;
-
-    // Parse trigger
-    FlValue* triggerValue = fl_value_lookup_string(blocker, "trigger");
-    if (triggerValue != nullptr && fl_value_get_type(triggerValue) == FL_VALUE_TYPE_MAP) {
-      json trigger;
-
-      // url-filter (required)
-      FlValue* urlFilter = fl_value_lookup_string(triggerValue, "url-filter");
-      if (urlFilter != nullptr && fl_value_get_type(urlFilter) == FL_VALUE_TYPE_STRING) {
-        trigger["url-filter"] = fl_value_get_string(urlFilter);
-      } else {
-        // Skip this rule - url-filter is required
-        continue;
-      }
-
-      // url-filter-is-case-sensitive
-      FlValue* caseSensitive = fl_value_lookup_string(triggerValue, "url-filter-is-case-sensitive");
-      if (caseSensitive != nullptr && fl_value_get_type(caseSensitive) == FL_VALUE_TYPE_BOOL) {
-        if (fl_value_get_bool(caseSensitive)) {
-          trigger["url-filter-is-case-sensitive"] = true;
-        }
-      }
-
-      // resource-type (array)
-      FlValue* resourceType = fl_value_lookup_string(triggerValue, "resource-type");
-      if (resourceType != nullptr && fl_value_get_type(resourceType) == FL_VALUE_TYPE_LIST) {
-        json types = json::array();
-        for (size_t j = 0; j < fl_value_get_length(resourceType); j++) {
-          FlValue* type = fl_value_get_list_value(resourceType, j);
-          if (fl_value_get_type(type) == FL_VALUE_TYPE_STRING) {
-            types.push_back(fl_value_get_string(type));
-          }
-        }
-        if (!types.empty()) {
-          trigger["resource-type"] = types;
-        }
-      }
-
-      // if-domain (array)
-      FlValue* ifDomain = fl_value_lookup_string(triggerValue, "if-domain");
-      if (ifDomain != nullptr && fl_value_get_type(ifDomain) == FL_VALUE_TYPE_LIST) {
-        json domains = json::array();
-        for (size_t j = 0; j < fl_value_get_length(ifDomain); j++) {
-          FlValue* domain = fl_value_get_list_value(ifDomain, j);
-          if (fl_value_get_type(domain) == FL_VALUE_TYPE_STRING) {
-            domains.push_back(fl_value_get_string(domain));
-          }
-        }
-        if (!domains.empty()) {
-          trigger["if-domain"] = domains;
-        }
-      }
+  // Settings updates re-send the same rules: nothing to do
+  std::string identifier = ContentFilterRegistry::identifierForSource(shardName, output.json);
+  if (identifier == shard.identifier) {
+    CompileCallback callback = std::move(shard.pendingCallback);
+    onShardApplied(shardName, nullptr);
+    result.success = true;
+    if (callback) callback(result);
+    return;
+  }
 
-      // unless-domain (array)
-      FlValue* unlessDomain = fl_value_lookup_string(triggerValue, "unless-domain");
-      if (unlessDomain != nullptr && fl_value_get_type(unlessDomain) == FL_VALUE_TYPE_LIST) {
-        json domains = json::array();
-        for (size_t j = 0; j < fl_value_get_length(unlessDomain); j++) {
-          FlValue* domain = fl_value_get_list_value(unlessDomain, j);
-          if (fl_value_get_type(domain) == FL_VALUE_TYPE_STRING) {
-            domains.push_back(fl_value_get_string(domain));
-          }
+  // A newer call (or the destructor) cancels the request, so the callback can
+  // use this
+  gint64 start = g_get_monotonic_time();
+  uint64_t ticket = registry_->acquire(
+      identifier, output.json,
+      [this, shardName, identifier, result, start](WebKitUserContentFilter* filter) mutable {
+        Shard& shard = shards_[shardName];
+        shard.pendingTicket = 0;
+        CompileCallback callback = std::move(shard.pendingCallback);
+        result.compileTime = static_cast<double>(g_get_monotonic_time() - start) / 1000.0;
+        if (filter == nullptr) {
+          // Same outcome as before the failed update: no rules in this shard
+          removeContentBlockerShard(shardName);
+          if (callback) callback(result);
+          return;
         }
-        if (!domains.empty()) {
-          trigger["unless-domain"] = domains;
+        // Attach first, so that rules kept by both versions never lapse
+        attachFilter(filter, identifier);
+        std::string previous = std::move(shard.identifier);
+        shard.identifier = identifier;
+        if (!previous.empty()) {
+          detachFilter(previous);
         }
-      }
+        result.success = true;
+        onShardApplied(shardName, &result);
+        if (callback) callback(result);
+      });
+  // 0 if the filter was in memory and the callback already ran
+  if (ticket != 0) {
+    shards_[shardName].pendingTicket = ticket;
+  }
+}
 
-      // load-type (array)
-      FlValue* loadType = fl_value_lookup_string(triggerValue, "load-type");
-      if (loadType != nullptr && fl_value_get_type(loadType) == FL_VALUE_TYPE_LIST) {
-        json types = json::array();
-        for (size_t j = 0; j < fl_value_get_length(loadType); j++) {
-          FlValue* type = fl_value_get_list_value(loadType, j);
-          if (fl_value_get_type(type) == FL_VALUE_TYPE_STRING) {
-            types.push_back(fl_value_get_string(type));
-          }
-        }
-        if (!types.empty()) {
-          trigger["load-type"] = types;
-        }
-      }
+void ContentBlockerHandler::removeContentBlockerShard(const std::string& shardName) {
+  auto it = shards_.find(shardName);
+  if (it == shards_.end()) {
+    return;
+  }
+  supersedePending(it->second, true);
+  if (!it->second.identifier.empty()) {
+    detachFilter(it->second.identifier);
+  }
+  shards_.erase(it);
+}
 
-      // if-top-url (array)
-      FlValue* ifTopUrl = fl_value_lookup_string(triggerValue, "if-top-url");
-      if (ifTopUrl != nullptr && fl_value_get_type(ifTopUrl) == FL_VALUE_TYPE_LIST) {
-        json urls = json::array();
-        for (size_t j = 0; j < fl_value_get_length(ifTopUrl); j++) {
-          FlValue* url = fl_value_get_list_value(ifTopUrl, j);
-          if (fl_value_get_type(url) == FL_VALUE_TYPE_STRING) {
-            urls.push_back(fl_value_get_string(url));
-          }
-        }
-        if (!urls.empty()) {
-          trigger["if-top-url"] = urls;
-        }
-      }
+std::vector<std::string> ContentBlockerHandler::getContentBlockerShardNames() const {
+  std::vector<std::string> names;
+  for (const auto& [name, shard] : shards_) {
+    names.push_back(name);
+  }
+  return names;
+}
 
-      // unless-top-url (array)
-      FlValue* unlessTopUrl = fl_value_lookup_string(triggerValue, "unless-top-url");
-      if (unlessTopUrl != nullptr && fl_value_get_type(unlessTopUrl) == FL_VALUE_TYPE_LIST) {
-        json urls = json::array();
-        for (size_t j = 0; j < fl_value_get_length(unlessTopUrl); j++) {
-          FlValue* url = fl_value_get_list_value(unlessTopUrl, j);
-          if (fl_value_get_type(url) == FL_VALUE_TYPE_STRING) {
-            urls.push_back(fl_value_get_string(url));
-          }
-        }
-        if (!urls.empty()) {
-          trigger["unless-top-url"] = urls;
-        }
-      }
+std::string ContentBlockerHandler::getFilterIdentifier(const std::string& shardName) const {
+  auto it = shards_.find(shardName);
+  return it != shards_.end() ? it->second.identifier : "";
+}
 
-      // if-frame-url (array) - WPE WebKit supports this
-      FlValue* ifFrameUrl = fl_value_lookup_string(triggerValue, "if-frame-url");
-      if (ifFrameUrl != nullptr && fl_value_get_type(ifFrameUrl) == FL_VALUE_TYPE_LIST) {
-        json urls = json::array();
-        for (size_t j = 0; j < fl_value_get_length(ifFrameUrl); j++) {
-          FlValue* url = fl_value_get_list_value(ifFrameUrl, j);
-          if (fl_value_get_type(url) == FL_VALUE_TYPE_STRING) {
-            urls.push_back(fl_value_get_string(url));
-          }
-        }
-        if (!urls.empty()) {
-          trigger["if-frame-url"] = urls;
-        }
-      }
+void ContentBlockerHandler::attachFilter(WebKitUserContentFilter* filter,
+                                         const std::string& identifier) {
+  // Shards with the same rules share one filter in the content manager
+  if (attached_filters_[identifier]++ > 0) {
+    return;
+  }
+  if (content_manager_ != nullptr && WEBKIT_IS_USER_CONTENT_MANAGER(content_manager_)) {
+    webkit_user_content_manager_add_filter(content_manager_, filter);
+  }
+}
 
-      rule["trigger"] = trigger;
+void ContentBlockerHandler::detachFilter(const std::string& identifier) {
+  auto it = attached_filters_.find(identifier);
+  if (it != attached_filters_.end() && --it->second <= 0) {
+    attached_filters_.erase(it);
+    // Check if content_manager is still valid before calling WebKit API
+    // The content_manager becomes invalid when the webview is destroyed
+    if (content_manager_ != nullptr && WEBKIT_IS_USER_CONTENT_MANAGER(content_manager_)) {
+      webkit_user_content_manager_remove_filter_by_id(content_manager_, identifier.c_str());
     }
+  }
+  if (registry_ != nullptr) {
+    registry_->release(identifier);
+  }
+}
 
-    // Parse action
-    FlValue* actionValue = fl_value_lookup_string(blocker, "action");
-    if (actionValue != nullptr && fl_value_get_type(actionValue) == FL_VALUE_TYPE_MAP) {
-      json action;
-
-      // type (required)
-      FlValue* type = fl_value_lookup_string(actionValue, "type");
-      if (type != nullptr && fl_value_get_type(type) == FL_VALUE_TYPE_STRING) {
-        std::string typeStr = fl_value_get_string(type);
-
-        // WPE WebKit supports: block, block-cookies, css-display-none,
-        // ignore-previous-rules, make-https
-        action["type"] = typeStr;
-      } else {
-        // Skip this rule - type is required
-        continue;
-      }
+void ContentBlockerHandler::supersedePending(Shard& shard, bool notify) {
+  // Results of the superseded update are ignored from now on
+  shard.generation++;
+  if (shard.pendingTicket != 0 && registry_ != nullptr) {
+    registry_->cancel(shard.pendingTicket);
+  }
+  shard.pendingTicket = 0;
+  shard.pendingMatchRules.reset();
+
+  CompileCallback callback = std::move(shard.pendingCallback);
+  shard.pendingCallback = nullptr;
+  if (notify && callback) {
+    // Not applied: a newer update replaced these rules
+    callback(ContentBlockerCompileResult());
+  }
+}
 
-      // selector (for css-display-none)
-      FlValue* selector = fl_value_lookup_string(actionValue, "selector");
-      if (selector != nullptr && fl_value_get_type(selector) == FL_VALUE_TYPE_STRING) {
-        action["selector"] = fl_value_get_string(selector);
-      }
+void ContentBlockerHandler::onShardApplied(const std::string& shardName,
+                                           const ContentBlockerCompileResult* result) {
+  Shard& shard = shards_[shardName];
+  shard.matchRules = std::move(shard.pendingMatchRules);
+  if (result != nullptr) {
+    shard.compiledRules = result->compiledRules;
+    shard.compileTime = result->normalizeTime + result->compileTime;
+  }
+  if (instrumentation_enabled_) {
+    buildMatcher(shardName);
+  }
+}
 
-      rule["action"] = action;
-    }
+void ContentBlockerHandler::buildMatcher(const std::string& shardName) {
+  Shard& shard = shards_[shardName];
+  uint64_t generation = ++shard.matcherGeneration;
+  if (shard.matchRules == nullptr) {
+    shard.matcher.reset();
+    return;
+  }
+  // The previous matcher is used until the new one is ready
+  ContentBlockerRuleMatcher::buildAsync(
+      shard.matchRules, cancellable_,
+      [this, shardName, generation](std::shared_ptr<const ContentBlockerRuleMatcher> matcher) {
+        auto it = shards_.find(shardName);
+        if (it == shards_.end() || it->second.matcherGeneration != generation) {
+          return;
+        }
+        it->second.matcher = std::move(matcher);
+      });
+}
 
-    if (rule.contains("trigger") && rule.contains("action")) {
-      jsonArray.push_back(rule);
+void ContentBlockerHandler::setInstrumentationEnabled(bool enabled) {
+  if (enabled == instrumentation_enabled_) {
+    return;
+  }
+  instrumentation_enabled_ = enabled;
+  for (auto& [name, shard] : shards_) {
+    if (enabled) {
+      buildMatcher(name);
+    } else {
+      // Also discards matchers still being built
+      shard.matcherGeneration++;
+      shard.matcher.reset();
     }
   }
+  if (!enabled) {
+    known_resource_sizes_.clear();
+    queued_failed_resources_.clear();
+    queued_failed_resource_urls_.clear();
+  }
+}
 
-  if (jsonArray.empty()) {
-    return "";
+void ContentBlockerHandler::recordLoadedResource(const std::string& url, int64_t size) {
+  if (!instrumentation_enabled_ || size <= 0) {
+    return;
+  }
+  loaded_resource_bytes_ += size;
+  loaded_resource_count_++;
+  if (known_resource_sizes_.size() >= kMaxKnownResourceSizes) {
+    known_resource_sizes_.clear();
   }
+  known_resource_sizes_[url] = size;
+}
 
-  return jsonArray.dump();
+void ContentBlockerHandler::recordFailedResources(const std::vector<std::string>& urls) {
+  if (!instrumentation_enabled_) {
+    return;
+  }
+  for (const auto& url : urls) {
+    if (queued_failed_resources_.size() >= kMaxQueuedFailedResources) {
+      break;
+    }
+    if (queued_failed_resource_urls_.insert(url).second) {
+      queued_failed_resources_.push_back(url);
+    }
+  }
+  matchFailedResources();
 }
 
-void ContentBlockerHandler::compileContentBlockers(const std::string& jsonSource,
-                                                    std::function<void(bool success)> callback) {
-  if (filter_store_ == nullptr) {
-    if (callback) callback(false);
+void ContentBlockerHandler::matchFailedResources() {
+  if (matching_failed_resources_ || queued_failed_resources_.empty()) {
     return;
   }
 
-  // Create GBytes from JSON source
-  GBytes* sourceBytes = g_bytes_new(jsonSource.c_str(), jsonSource.length());
+  auto* request = new FailedResourceMatch{this, {}, {}, {}};
+  for (const auto& [name, shard] : shards_) {
+    if (shard.matcher != nullptr) {
+      request->matchers.emplace_back(name, shard.matcher);
+    }
+  }
+  // Blocked before the matchers were built: nothing to match against
+  if (request->matchers.empty()) {
+    delete request;
+    queued_failed_resources_.clear();
+    queued_failed_resource_urls_.clear();
+    return;
+  }
 
-  // Create context for async callback
-  auto* context = new CompileContext{this, std::move(callback)};
+  size_t count = std::min(queued_failed_resources_.size(), kMaxFailedResourcesPerBatch);
+  request->urls.assign(std::make_move_iterator(queued_failed_resources_.begin()),
+                       std::make_move_iterator(queued_failed_resources_.begin() + count));
+  queued_failed_resources_.erase(queued_failed_resources_.begin(),
+                                 queued_failed_resources_.begin() + count);
+  for (const auto& url : request->urls) {
+    queued_failed_resource_urls_.erase(url);
+  }
 
-  // Start async compilation
-  webkit_user_content_filter_store_save(filter_store_, filter_identifier_.c_str(), sourceBytes,
-                                         nullptr,  // cancellable
-                                         onFilterCompiled, context);
+  matching_failed_resources_ = true;
+  GTask* task = g_task_new(nullptr, cancellable_, onFailedResourcesMatched, request);
+  g_task_set_task_data(task, request, nullptr);
+  g_task_run_in_thread(task, runFailedResourceMatch);
+  g_object_unref(task);
+}
 
-  g_bytes_unref(sourceBytes);
+void ContentBlockerHandler::runFailedResourceMatch(GTask* task, gpointer /*source_object*/,
+                                                   gpointer task_data,
+                                                   GCancellable* /*cancellable*/) {
+  // Matchers are immutable once built, and shared with the main thread
+  auto* request = static_cast<FailedResourceMatch*>(task_data);
+  for (const auto& url : request->urls) {
+    for (const auto& [name, matcher] : request->matchers) {
+      int64_t index = matcher->match(url.c_str());
+      if (index >= 0) {
+        request->hits.push_back(FailedResourceHit{url, name, matcher.get(), index});
+        break;
+      }
+    }
+  }
+  g_task_return_boolean(task, TRUE);
 }
 
-void ContentBlockerHandler::onFilterCompiled(GObject* source, GAsyncResult* result,
-                                              gpointer user_data) {
-  auto* context = static_cast<CompileContext*>(user_data);
-  if (context == nullptr) {
+void ContentBlockerHandler::onFailedResourcesMatched(GObject* /*source_object*/,
+                                                     GAsyncResult* result, gpointer user_data) {
+  std::unique_ptr<FailedResourceMatch> request(static_cast<FailedResourceMatch*>(user_data));
+  // Fails with G_IO_ERROR_CANCELLED once the handler is gone
+  if (!g_task_propagate_boolean(G_TASK(result), nullptr)) {
     return;
   }
 
-  auto* handler = context->handler;
-  auto callback = std::move(context->callback);
-  delete context;
-
-  if (handler == nullptr || handler->filter_store_ == nullptr) {
-    if (callback) callback(false);
+  ContentBlockerHandler* handler = request->handler;
+  handler->matching_failed_resources_ = false;
+  if (!handler->instrumentation_enabled_) {
     return;
   }
 
-  GError* error = nullptr;
-  WebKitUserContentFilter* filter =
-      webkit_user_content_filter_store_save_finish(handler->filter_store_, result, &error);
+  for (const auto& hit : request->hits) {
+    // Rule indexes refer to the shard's current list: drop hits of replaced rules
+    auto shard = handler->shards_.find(hit.shardName);
+    if (shard == handler->shards_.end() || shard->second.matcher.get() != hit.matcher) {
+      continue;
+    }
 
-  if (error != nullptr) {
-    errorLog("ContentBlockerHandler: Failed to compile content blockers: " +
-             std::string(error->message));
-    g_error_free(error);
-    if (callback) callback(false);
-    return;
-  }
+    // Blocked requests have no response: use the size of an earlier load of
+    // the same URL, or else the average size of loaded resources
+    int64_t estimatedSize = 0;
+    auto known = handler->known_resource_sizes_.find(hit.url);
+    if (known != handler->known_resource_sizes_.end()) {
+      estimatedSize = known->second;
+    } else if (handler->loaded_resource_count_ > 0) {
+      estimatedSize = handler->loaded_resource_bytes_ / handler->loaded_resource_count_;
+    }
 
-  if (filter == nullptr) {
-    errorLog("ContentBlockerHandler: Compiled filter is null");
-    if (callback) callback(false);
-    return;
+    ContentBlockerStats& stats = handler->stats_;
+    stats.blockedRequests++;
+    stats.estimatedBytesAvoided += estimatedSize;
+    ContentBlockerShardStats& shardStats = stats.shards[hit.shardName];
+    shardStats.blockedRequests++;
+    shardStats.estimatedBytesAvoided += estimatedSize;
+    shardStats.ruleHits[hit.index]++;
   }
 
-  // Add the compiled filter to the content manager
-  if (handler->content_manager_ != nullptr) {
-    webkit_user_content_manager_add_filter(handler->content_manager_, filter);
+  handler->matchFailedResources();
+}
+
+ContentBlockerStats ContentBlockerHandler::getStats() const {
+  ContentBlockerStats stats = stats_;
+  stats.enabled = instrumentation_enabled_;
+  // Current shards are listed even without hits: rules that never fire are
+  // the ones to prune
+  for (const auto& [name, shard] : shards_) {
+    ContentBlockerShardStats& shardStats = stats.shards[name];
+    shardStats.compiledRules = shard.compiledRules;
+    shardStats.compileTime = shard.compileTime;
   }
+  return stats;
+}
 
-  webkit_user_content_filter_unref(filter);
+void ContentBlockerHandler::resetStats() {
+  stats_ = ContentBlockerStats();
+}
 
-  if (callback) callback(true);
+void ContentBlockerHandler::removeAllFilters() {
+  while (!shards_.empty()) {
+    removeContentBlockerShard(shards_.begin()->first);
+  }
 }
 
 }  // namespace flutter_inappwebview_plugin
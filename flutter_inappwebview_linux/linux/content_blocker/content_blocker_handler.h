@@ -4,9 +4,20 @@
 #include <flutter_linux/flutter_linux.h>
 #include <wpe/webkit.h>
 
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../types/content_blocker_compile_result.h"
+#include "../types/content_blocker_stats.h"
+#include "content_blocker_rule_matcher.h"
+#include "content_blocker_rule_normalizer.h"
+#include "content_filter_registry.h"
 
 namespace flutter_inappwebview_plugin {
 
@@ -16,7 +27,8 @@ class InAppWebView;
  * ContentBlockerHandler manages WebKit content filters for content blocking.
  *
  * Uses WebKitUserContentFilterStore to compile Safari-compatible content blocker
- * JSON rules into native WebKit filters. This is the same mechanism used by
+ * JSON rules into native WebKit filters. Rules are converted and validated by
+ * ContentBlockerRuleNormalizer on a worker thread first. This is the same mechanism used by
  * iOS/macOS (WKContentRuleListStore).
  *
  * WPE WebKit uses the Safari content blocker JSON format:
@@ -31,14 +43,37 @@ class InAppWebView;
  * - block: Block the resource from loading
  * - css-display-none: Hide matching elements with CSS
  * - make-https: Upgrade HTTP URLs to HTTPS
+ *
+ * Compiled filters are content-addressed: the identifier is derived from a
+ * hash of the normalized JSON, so an unchanged rule set is not re-applied.
+ * Filters are obtained from the process-wide ContentFilterRegistry, so that
+ * webviews with the same rules share one compiled filter.
+ *
+ * Rules can be split into named shards (e.g. one per list source), each
+ * compiled into its own filter and added to / removed from the content
+ * manager independently, so updating one shard leaves the others untouched.
+ * The contentBlockers setting is the kSettingsShard shard. As on Apple
+ * platforms, "ignore-previous-rules" only applies within its own shard.
+ *
+ * With instrumentation enabled, the owner reports the resources pages loaded
+ * and failed to load. WebKit doesn't tell why a load failed, nor which rule
+ * blocked it, so a failed load is counted as blocked by the first block rule
+ * (shards in name order) whose url-filter matches its URL.
  */
 class ContentBlockerHandler {
  public:
-  explicit ContentBlockerHandler(WebKitUserContentManager* content_manager);
+  ContentBlockerHandler(WebKitUserContentManager* content_manager,
+                        ContentFilterRegistry* registry);
   ~ContentBlockerHandler();
 
+  // Shard of the contentBlockers setting
+  static constexpr const char* kSettingsShard = "";
+
+  using CompileCallback = std::function<void(const ContentBlockerCompileResult& result)>;
+
   /**
-   * Compile and apply content blockers from FlValue list.
+   * Compile and apply content blockers from FlValue list, as the
+   * kSettingsShard shard.
    *
    * The FlValue should be a list of content blocker maps, each with:
    * - "trigger": map with "url-filter" and optional other trigger properties
@@ -50,51 +85,164 @@ class ContentBlockerHandler {
   void setContentBlockers(FlValue* contentBlockers,
                           std::function<void(bool success)> callback);
 
+  /**
+   * Compile and apply the shard shardName, replacing its previous rules.
+   * An empty list removes the shard.
+   *
+   * @param shardName Name of the shard
+   * @param contentBlockers FlValue list of content blocker maps
+   * @param callback Called with the statistics when compilation is complete,
+   *        or unsuccessful if a newer update of the shard replaced it
+   */
+  void setContentBlockerShard(const std::string& shardName, FlValue* contentBlockers,
+                              CompileCallback callback);
+
+  /**
+   * Remove the filter of shardName from the content manager.
+   */
+  void removeContentBlockerShard(const std::string& shardName);
+
+  /**
+   * Names of the shards applied or being compiled.
+   */
+  std::vector<std::string> getContentBlockerShardNames() const;
+
   /**
    * Remove all content filters from the content manager.
    */
   void removeAllFilters();
 
   /**
-   * Get the current filter identifier.
+   * Get the identifier of the filter applied for shardName (empty if none).
    */
-  std::string getFilterIdentifier() const { return filter_identifier_; }
+  std::string getFilterIdentifier(const std::string& shardName = kSettingsShard) const;
 
- private:
   /**
-   * Convert FlValue content blockers to Safari-format JSON string.
-   *
-   * @param contentBlockers FlValue list of content blocker maps
-   * @return JSON string in Safari content blocker format, or empty string on error
+   * Enable or disable hit statistics. Enabling builds a rule matcher per
+   * shard (on a worker thread), disabling frees them; statistics are kept.
    */
-  std::string convertToJsonString(FlValue* contentBlockers);
+  void setInstrumentationEnabled(bool enabled);
+  bool isInstrumentationEnabled() const { return instrumentation_enabled_; }
 
   /**
-   * Compile JSON to WebKit filter (async).
-   *
-   * @param jsonSource JSON string in Safari format
-   * @param callback Called when compilation is complete
+   * A resource of size bytes loaded. Used to estimate the size of blocked
+   * resources.
    */
-  void compileContentBlockers(const std::string& jsonSource,
-                              std::function<void(bool success)> callback);
+  void recordLoadedResource(const std::string& url, int64_t size);
 
   /**
-   * Callback when filter store save completes.
+   * Resources failed to load. The URLs are matched against the block rules on
+   * a worker thread, one batch at a time; a URL a rule matches counts as a
+   * blocked request. URLs already waiting to be matched are only counted
+   * once, and URLs beyond kMaxQueuedFailedResources are dropped.
    */
-  static void onFilterCompiled(GObject* source, GAsyncResult* result, gpointer user_data);
+  void recordFailedResources(const std::vector<std::string>& urls);
 
-  WebKitUserContentManager* content_manager_;  // Not owned (from webview)
-  WebKitUserContentFilterStore* filter_store_;  // Owned
-  std::string filter_identifier_;
-  std::string store_path_;
+  /**
+   * Statistics since instrumentation was enabled or the last reset. Rule
+   * indexes refer to the shard's current list.
+   */
+  ContentBlockerStats getStats() const;
+  void resetStats();
 
+ private:
   /**
-   * Context for async filter compilation callback.
+   * Load or compile the normalized rules of shardName.
    */
-  struct CompileContext {
+  void onRulesNormalized(const std::string& shardName,
+                         ContentBlockerRuleNormalizer::Output output);
+
+  struct Shard {
+    std::string identifier;           // Applied filter, empty if none
+    uint64_t generation = 0;          // Bumped by every update, to spot stale results
+    uint64_t pendingTicket = 0;       // Registry request in flight, 0 if none
+    CompileCallback pendingCallback;  // Of the update in flight
+    // Accepted rules of the applied filter and of the update in flight
+    ContentBlockerRuleNormalizer::MatchRules matchRules;
+    ContentBlockerRuleNormalizer::MatchRules pendingMatchRules;
+    // Built while instrumentation is enabled
+    std::shared_ptr<const ContentBlockerRuleMatcher> matcher;
+    uint64_t matcherGeneration = 0;
+    int64_t compiledRules = 0;  // Of the applied filter
+    double compileTime = 0;
+  };
+
+  // Bound on the URL -> size table used to estimate blocked sizes
+  static constexpr size_t kMaxKnownResourceSizes = 1024;
+  // Failed resource URLs matched by one worker task, and waiting for it
+  static constexpr size_t kMaxFailedResourcesPerBatch = 256;
+  static constexpr size_t kMaxQueuedFailedResources = 1024;
+
+  struct FailedResourceHit {
+    std::string url;
+    std::string shardName;
+    const ContentBlockerRuleMatcher* matcher;  // That matched, to spot replaced rules
+    int64_t index;
+  };
+
+  struct FailedResourceMatch {
     ContentBlockerHandler* handler;
-    std::function<void(bool)> callback;
+    std::vector<std::pair<std::string, std::shared_ptr<const ContentBlockerRuleMatcher>>> matchers;
+    std::vector<std::string> urls;
+    std::vector<FailedResourceHit> hits;  // Filled by the worker
   };
+
+  /**
+   * The update in flight of shard is applied. result is nullptr if the rules
+   * didn't change.
+   */
+  void onShardApplied(const std::string& shardName, const ContentBlockerCompileResult* result);
+
+  /**
+   * Build the rule matcher of shardName from its applied rules.
+   */
+  void buildMatcher(const std::string& shardName);
+
+  /**
+   * Match the next batch of queued failed resources on a worker thread,
+   * unless a batch is being matched already.
+   */
+  void matchFailedResources();
+
+  static void runFailedResourceMatch(GTask* task, gpointer source_object, gpointer task_data,
+                                     GCancellable* cancellable);
+  static void onFailedResourcesMatched(GObject* source_object, GAsyncResult* result,
+                                       gpointer user_data);
+
+  /**
+   * Add filter to the content manager for one more shard. The registry
+   * reference taken for the shard is now held.
+   */
+  void attachFilter(WebKitUserContentFilter* filter, const std::string& identifier);
+
+  /**
+   * Undo attachFilter() and release the shard's registry reference.
+   */
+  void detachFilter(const std::string& identifier);
+
+  /**
+   * Drop the update of shard still in flight, if any, calling its callback
+   * (unsuccessful) when notify is true.
+   */
+  void supersedePending(Shard& shard, bool notify);
+
+  WebKitUserContentManager* content_manager_;  // Not owned (from webview)
+  ContentFilterRegistry* registry_;            // Not owned (from PluginInstance)
+  GCancellable* cancellable_;                  // Owned, cancelled on destruction
+  std::map<std::string, Shard> shards_;
+
+  // Number of shards using each filter added to the content manager
+  std::map<std::string, int> attached_filters_;
+
+  bool instrumentation_enabled_ = false;
+  ContentBlockerStats stats_;
+  std::unordered_map<std::string, int64_t> known_resource_sizes_;
+  int64_t loaded_resource_bytes_ = 0;
+  int64_t loaded_resource_count_ = 0;
+  // Failed resource URLs waiting for the batch being matched, in order
+  std::vector<std::string> queued_failed_resources_;
+  std::unordered_set<std::string> queued_failed_resource_urls_;
+  bool matching_failed_resources_ = false;
 };
 
 }  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,89 @@
+#include "content_blocker_rule_matcher.h"
+
+#include <utility>
+
+namespace flutter_inappwebview_plugin {
+
+namespace {
+
+struct BuildRequest {
+  ContentBlockerRuleNormalizer::MatchRules rules;  // Immutable, shared with the worker
+  ContentBlockerRuleMatcher::Callback callback;
+};
+
+using MatcherPtr = std::shared_ptr<const ContentBlockerRuleMatcher>;
+
+void RunBuild(GTask* task, gpointer /*source_object*/, gpointer task_data,
+              GCancellable* /*cancellable*/) {
+  auto* request = static_cast<BuildRequest*>(task_data);
+  auto* matcher = new MatcherPtr(ContentBlockerRuleMatcher::build(*request->rules));
+  g_task_return_pointer(task, matcher, [](gpointer data) { delete static_cast<MatcherPtr*>(data); });
+}
+
+void OnBuilt(GObject* /*source_object*/, GAsyncResult* result, gpointer user_data) {
+  auto* request = static_cast<BuildRequest*>(user_data);
+  // Fails with G_IO_ERROR_CANCELLED if the cancellable was cancelled meanwhile
+  auto* matcher = static_cast<MatcherPtr*>(g_task_propagate_pointer(G_TASK(result), nullptr));
+  if (matcher != nullptr) {
+    request->callback(std::move(*matcher));
+    delete matcher;
+  }
+  delete request;
+}
+
+}  // namespace
+
+ContentBlockerRuleMatcher::~ContentBlockerRuleMatcher() {
+  for (auto& rule : rules_) {
+    g_regex_unref(rule.regex);
+  }
+}
+
+std::shared_ptr<const ContentBlockerRuleMatcher> ContentBlockerRuleMatcher::build(
+    const std::vector<MatchRule>& rules) {
+  auto matcher = std::make_shared<ContentBlockerRuleMatcher>();
+  matcher->rules_.reserve(rules.size());
+  for (const auto& rule : rules) {
+    // The normalizer only accepts the url-filter subset WebKit supports,
+    // which is valid PCRE
+    GRegex* regex = g_regex_new(
+        rule.urlFilter.c_str(),
+        static_cast<GRegexCompileFlags>(rule.caseSensitive ? 0 : G_REGEX_CASELESS),
+        static_cast<GRegexMatchFlags>(0), nullptr);
+    if (regex != nullptr) {
+      matcher->rules_.push_back(Rule{rule.index, rule.ignorePreviousRules, regex});
+    }
+  }
+  return matcher;
+}
+
+void ContentBlockerRuleMatcher::buildAsync(ContentBlockerRuleNormalizer::MatchRules rules,
+                                           GCancellable* cancellable, Callback callback) {
+  auto* request = new BuildRequest{std::move(rules), std::move(callback)};
+  GTask* task = g_task_new(nullptr, cancellable, OnBuilt, request);
+  g_task_set_task_data(task, request, nullptr);
+  g_task_run_in_thread(task, RunBuild);
+  g_object_unref(task);
+}
+
+int64_t ContentBlockerRuleMatcher::match(const char* url) const {
+  // Like WebKit, a matching ignore-previous-rules rule cancels the block
+  // rules before it
+  int64_t blockedBy = -1;
+  for (const auto& rule : rules_) {
+    if (rule.ignorePreviousRules && blockedBy < 0) {
+      continue;
+    }
+    if (!g_regex_match(rule.regex, url, static_cast<GRegexMatchFlags>(0), nullptr)) {
+      continue;
+    }
+    if (rule.ignorePreviousRules) {
+      blockedBy = -1;
+    } else if (blockedBy < 0) {
+      blockedBy = rule.index;
+    }
+  }
+  return blockedBy;
+}
+
+}  // namespace flutter_inappwebview_plugin
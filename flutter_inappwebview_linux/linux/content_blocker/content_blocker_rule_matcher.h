@@ -0,0 +1,69 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_RULE_MATCHER_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_RULE_MATCHER_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <gio/gio.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "content_blocker_rule_normalizer.h"
+
+namespace flutter_inappwebview_plugin {
+
+/**
+ * Finds which "block" rule of a content blocker list a blocked URL was
+ * (most likely) blocked by.
+ *
+ * WebKit doesn't say which rule blocked a request, so the URL is matched
+ * against the url-filter of the rules the normalizer accepted, in list order:
+ * the first matching block rule after the last matching ignore-previous-rules
+ * rule wins. Other trigger conditions (domains, resource and load types) are
+ * not checked. Only built while content blocker instrumentation is enabled:
+ * it holds one compiled regular expression per rule.
+ */
+class ContentBlockerRuleMatcher {
+ public:
+  using Callback = std::function<void(std::shared_ptr<const ContentBlockerRuleMatcher> matcher)>;
+  using MatchRule = ContentBlockerRuleNormalizer::MatchRule;
+
+  ContentBlockerRuleMatcher() = default;
+  ~ContentBlockerRuleMatcher();
+
+  ContentBlockerRuleMatcher(const ContentBlockerRuleMatcher&) = delete;
+  ContentBlockerRuleMatcher& operator=(const ContentBlockerRuleMatcher&) = delete;
+
+  /**
+   * Build a matcher for the accepted rules of a normalized list, on the
+   * calling thread.
+   */
+  static std::shared_ptr<const ContentBlockerRuleMatcher> build(
+      const std::vector<MatchRule>& rules);
+
+  /**
+   * Build a matcher on a worker thread. callback runs on the calling
+   * thread's main context, unless cancellable is cancelled first.
+   */
+  static void buildAsync(ContentBlockerRuleNormalizer::MatchRules rules, GCancellable* cancellable,
+                         Callback callback);
+
+  /**
+   * Index in the input list of the block rule matching url, -1 if none.
+   */
+  int64_t match(const char* url) const;
+
+ private:
+  struct Rule {
+    int64_t index;
+    bool ignorePreviousRules;
+    GRegex* regex;  // Owned
+  };
+
+  std::vector<Rule> rules_;
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_RULE_MATCHER_H_
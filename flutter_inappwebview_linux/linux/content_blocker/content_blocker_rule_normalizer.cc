@@ -0,0 +1,494 @@
+#include "content_blocker_rule_normalizer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace flutter_inappwebview_plugin {
+
+namespace {
+
+constexpr const char* kResourceTypes[] = {
+    "document", "image", "style-sheet", "script", "font",      "raw",   "svg-document",
+    "media",    "popup", "ping",        "fetch",  "websocket", "other",
+};
+
+constexpr const char* kLoadTypes[] = {"first-party", "third-party"};
+
+constexpr const char* kActionTypes[] = {
+    "block", "block-cookies", "css-display-none", "ignore-previous-rules", "make-https",
+};
+
+template <size_t N>
+bool isOneOf(const char* value, const char* const (&allowed)[N]) {
+  for (const char* candidate : allowed) {
+    if (strcmp(value, candidate) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void appendJsonString(std::string& out, const char* value) {
+  out += '"';
+  for (const char* c = value; *c != '\0'; c++) {
+    switch (*c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(*c));
+          out += escaped;
+        } else {
+          out += *c;
+        }
+    }
+  }
+  out += '"';
+}
+
+// A rule that passed validation, with its trigger already serialized
+struct NormalizedRule {
+  int64_t index = 0;  // In the input list
+  std::string trigger;
+  std::string urlFilter;
+  bool caseSensitive = false;
+  std::string actionType;
+  std::string selector;  // css-display-none only
+};
+
+class RuleReader {
+ public:
+  explicit RuleReader(ContentBlockerCompileResult& result) : result_(result) {}
+
+  // Serializes rule into normalized, or reports why it is dropped
+  bool read(int64_t index, FlValue* rule, NormalizedRule& normalized) {
+    index_ = index;
+    if (fl_value_get_type(rule) != FL_VALUE_TYPE_MAP) {
+      return fail("rule is not a map");
+    }
+    FlValue* trigger = fl_value_lookup_string(rule, "trigger");
+    if (trigger == nullptr || fl_value_get_type(trigger) != FL_VALUE_TYPE_MAP) {
+      return fail("trigger is required");
+    }
+    FlValue* action = fl_value_lookup_string(rule, "action");
+    if (action == nullptr || fl_value_get_type(action) != FL_VALUE_TYPE_MAP) {
+      return fail("action is required");
+    }
+    normalized.index = index;
+    return readTrigger(trigger, normalized) && readAction(action, normalized);
+  }
+
+ private:
+  ContentBlockerCompileResult& result_;
+  int64_t index_ = 0;
+
+  bool fail(const std::string& message) {
+    result_.invalidRules++;
+    if (result_.diagnostics.size() < ContentBlockerCompileResult::kMaxDiagnostics) {
+      result_.diagnostics.emplace_back(index_, message);
+    }
+    return false;
+  }
+
+  // Appends ,"key":[...] for a non-empty string list. Returns false (and
+  // reports) if the value is malformed or check rejects an item.
+  template <typename Check>
+  bool appendStringList(std::string& out, FlValue* map, const char* key, bool& present,
+                        Check check) {
+    present = false;
+    FlValue* list = fl_value_lookup_string(map, key);
+    if (list == nullptr || fl_value_get_type(list) == FL_VALUE_TYPE_NULL) {
+      return true;
+    }
+    if (fl_value_get_type(list) != FL_VALUE_TYPE_LIST) {
+      return fail(std::string("trigger.") + key + " is not a list");
+    }
+    size_t length = fl_value_get_length(list);
+    size_t start = out.size();
+    for (size_t i = 0; i < length; i++) {
+      FlValue* item = fl_value_get_list_value(list, i);
+      if (fl_value_get_type(item) != FL_VALUE_TYPE_STRING) {
+        continue;
+      }
+      std::string value = fl_value_get_string(item);
+      std::string error = check(value);
+      if (!error.empty()) {
+        out.resize(start);
+        return fail(std::string("trigger.") + key + ": " + error);
+      }
+      out += present ? "," : std::string(",\"") + key + "\":[";
+      appendJsonString(out, value.c_str());
+      present = true;
+    }
+    if (present) {
+      out += ']';
+    }
+    return true;
+  }
+
+  bool readTrigger(FlValue* trigger, NormalizedRule& normalized) {
+    std::string& out = normalized.trigger;
+    FlValue* urlFilter = fl_value_lookup_string(trigger, "url-filter");
+    if (urlFilter == nullptr || fl_value_get_type(urlFilter) != FL_VALUE_TYPE_STRING) {
+      return fail("trigger.url-filter is required");
+    }
+    std::string error = ContentBlockerRuleNormalizer::validateUrlFilter(fl_value_get_string(urlFilter));
+    if (!error.empty()) {
+      return fail("trigger.url-filter: " + error);
+    }
+
+    normalized.urlFilter = fl_value_get_string(urlFilter);
+    out = "{\"url-filter\":";
+    appendJsonString(out, normalized.urlFilter.c_str());
+
+    FlValue* caseSensitive = fl_value_lookup_string(trigger, "url-filter-is-case-sensitive");
+    normalized.caseSensitive = caseSensitive != nullptr &&
+                               fl_value_get_type(caseSensitive) == FL_VALUE_TYPE_BOOL &&
+                               fl_value_get_bool(caseSensitive);
+    if (normalized.caseSensitive) {
+      out += ",\"url-filter-is-case-sensitive\":true";
+    }
+
+    bool present = false;
+    auto checkResourceType = [](std::string& value) {
+      return isOneOf(value.c_str(), kResourceTypes) ? std::string()
+                                                     : "unknown resource type '" + value + "'";
+    };
+    auto checkLoadType = [](std::string& value) {
+      return isOneOf(value.c_str(), kLoadTypes) ? std::string()
+                                                 : "unknown load type '" + value + "'";
+    };
+    // WebKit only accepts lowercase ASCII domains ("*" prefix for subdomains)
+    auto normalizeDomain = [](std::string& value) {
+      for (char& c : value) {
+        if (static_cast<unsigned char>(c) >= 0x80) {
+          return "non-ASCII domain '" + value + "' (use punycode)";
+        }
+        c = g_ascii_tolower(c);
+      }
+      return std::string();
+    };
+    auto checkUrlFilter = [](std::string& value) {
+      return ContentBlockerRuleNormalizer::validateUrlFilter(value);
+    };
+
+    if (!appendStringList(out, trigger, "resource-type", present, checkResourceType) ||
+        !appendStringList(out, trigger, "load-type", present, checkLoadType)) {
+      return false;
+    }
+
+    // WebKit accepts at most one of these conditions per trigger
+    int conditions = 0;
+    if (!appendStringList(out, trigger, "if-domain", present, normalizeDomain)) return false;
+    conditions += present;
+    if (!appendStringList(out, trigger, "unless-domain", present, normalizeDomain)) return false;
+    conditions += present;
+    if (!appendStringList(out, trigger, "if-top-url", present, checkUrlFilter)) return false;
+    conditions += present;
+    if (!appendStringList(out, trigger, "unless-top-url", present, checkUrlFilter)) return false;
+    conditions += present;
+    if (conditions > 1) {
+      return fail(
+          "trigger can only have one of if-domain, unless-domain, if-top-url and unless-top-url");
+    }
+
+    if (!appendStringList(out, trigger, "if-frame-url", present, checkUrlFilter)) return false;
+
+    out += '}';
+    return true;
+  }
+
+  bool readAction(FlValue* action, NormalizedRule& normalized) {
+    FlValue* type = fl_value_lookup_string(action, "type");
+    if (type == nullptr || fl_value_get_type(type) != FL_VALUE_TYPE_STRING) {
+      return fail("action.type is required");
+    }
+    const char* typeStr = fl_value_get_string(type);
+    if (!isOneOf(typeStr, kActionTypes)) {
+      return fail(std::string("unknown action type '") + typeStr + "'");
+    }
+    normalized.actionType = typeStr;
+
+    if (normalized.actionType == "css-display-none") {
+      FlValue* selector = fl_value_lookup_string(action, "selector");
+      if (selector == nullptr || fl_value_get_type(selector) != FL_VALUE_TYPE_STRING ||
+          *fl_value_get_string(selector) == '\0') {
+        return fail("action.selector is required for css-display-none");
+      }
+      normalized.selector = fl_value_get_string(selector);
+    }
+    return true;
+  }
+};
+
+struct NormalizeRequest {
+  FlValue* rules;  // Ref'd, released on the calling thread
+  ContentBlockerRuleNormalizer::Callback callback;
+};
+
+void RunNormalize(GTask* task, gpointer /*source_object*/, gpointer task_data,
+                  GCancellable* /*cancellable*/) {
+  auto* request = static_cast<NormalizeRequest*>(task_data);
+  auto* output = new ContentBlockerRuleNormalizer::Output(
+      ContentBlockerRuleNormalizer::normalize(request->rules));
+  g_task_return_pointer(task, output, [](gpointer data) {
+    delete static_cast<ContentBlockerRuleNormalizer::Output*>(data);
+  });
+}
+
+void OnNormalized(GObject* /*source_object*/, GAsyncResult* result, gpointer user_data) {
+  auto* request = static_cast<NormalizeRequest*>(user_data);
+  // Fails with G_IO_ERROR_CANCELLED if the cancellable was cancelled meanwhile
+  auto* output = static_cast<ContentBlockerRuleNormalizer::Output*>(
+      g_task_propagate_pointer(G_TASK(result), nullptr));
+  fl_value_unref(request->rules);
+  if (output != nullptr) {
+    request->callback(std::move(*output));
+    delete output;
+  }
+  delete request;
+}
+
+}  // namespace
+
+ContentBlockerRuleNormalizer::Output ContentBlockerRuleNormalizer::normalize(FlValue* rules) {
+  gint64 start = g_get_monotonic_time();
+  Output output;
+  ContentBlockerCompileResult& result = output.result;
+  auto matchRules = std::make_shared<std::vector<MatchRule>>();
+  output.matchRules = matchRules;
+  if (rules == nullptr || fl_value_get_type(rules) != FL_VALUE_TYPE_LIST) {
+    return output;
+  }
+
+  size_t count = fl_value_get_length(rules);
+  result.inputRules = static_cast<int64_t>(count);
+
+  std::vector<NormalizedRule> normalized;
+  normalized.reserve(count);
+  // Within the current run of rules (reset at each ignore-previous-rules):
+  // full rule -> seen, and trigger -> index of its css-display-none rule
+  std::unordered_map<std::string, size_t> seenRules;
+  std::unordered_map<std::string, size_t> cssRuleByTrigger;
+
+  RuleReader reader(result);
+  for (size_t i = 0; i < count; i++) {
+    NormalizedRule rule;
+    if (!reader.read(static_cast<int64_t>(i), fl_value_get_list_value(rules, i), rule)) {
+      continue;
+    }
+
+    if (rule.actionType == "ignore-previous-rules") {
+      seenRules.clear();
+      cssRuleByTrigger.clear();
+      normalized.push_back(std::move(rule));
+      continue;
+    }
+
+    std::string key = rule.trigger;
+    key += '\n';
+    key += rule.actionType;
+    key += '\n';
+    key += rule.selector;
+    if (!seenRules.emplace(std::move(key), normalized.size()).second) {
+      result.duplicateRules++;
+      continue;
+    }
+
+    if (rule.actionType == "css-display-none") {
+      auto it = cssRuleByTrigger.find(rule.trigger);
+      if (it != cssRuleByTrigger.end()) {
+        normalized[it->second].selector += ", " + rule.selector;
+        result.mergedRules++;
+        continue;
+      }
+      cssRuleByTrigger.emplace(rule.trigger, normalized.size());
+    }
+    normalized.push_back(std::move(rule));
+  }
+
+  for (auto& rule : normalized) {
+    bool ignorePreviousRules = rule.actionType == "ignore-previous-rules";
+    if (ignorePreviousRules || rule.actionType == "block") {
+      matchRules->push_back(
+          MatchRule{rule.index, std::move(rule.urlFilter), rule.caseSensitive, ignorePreviousRules});
+    }
+  }
+
+  if (!normalized.empty()) {
+    std::string& json = output.json;
+    size_t size = 2;
+    for (const auto& rule : normalized) {
+      size += rule.trigger.size() + rule.actionType.size() + rule.selector.size() + 48;
+    }
+    json.reserve(size);
+
+    json += '[';
+    for (size_t i = 0; i < normalized.size(); i++) {
+      const auto& rule = normalized[i];
+      if (i > 0) {
+        json += ',';
+      }
+      json += "{\"trigger\":";
+      json += rule.trigger;
+      json += ",\"action\":{\"type\":";
+      appendJsonString(json, rule.actionType.c_str());
+      if (!rule.selector.empty()) {
+        json += ",\"selector\":";
+        appendJsonString(json, rule.selector.c_str());
+      }
+      json += "}}";
+    }
+    json += ']';
+  }
+
+  result.compiledRules = static_cast<int64_t>(normalized.size());
+  result.normalizeTime = static_cast<double>(g_get_monotonic_time() - start) / 1000.0;
+  return output;
+}
+
+void ContentBlockerRuleNormalizer::normalizeAsync(FlValue* rules, GCancellable* cancellable,
+                                                  Callback callback) {
+  auto* request = new NormalizeRequest{fl_value_ref(rules), std::move(callback)};
+  GTask* task = g_task_new(nullptr, cancellable, OnNormalized, request);
+  g_task_set_task_data(task, request, nullptr);
+  g_task_run_in_thread(task, RunNormalize);
+  g_object_unref(task);
+}
+
+std::string ContentBlockerRuleNormalizer::validateUrlFilter(const std::string& urlFilter) {
+  if (urlFilter.empty()) {
+    return "empty pattern";
+  }
+
+  int depth = 0;
+  // Something a quantifier can apply to precedes the current position
+  bool canQuantify = false;
+  bool previousWasQuantifier = false;
+  size_t length = urlFilter.size();
+
+  for (size_t i = 0; i < length; i++) {
+    unsigned char c = static_cast<unsigned char>(urlFilter[i]);
+    if (c >= 0x80) {
+      return "non-ASCII characters are not supported";
+    }
+
+    bool isQuantifier = false;
+    switch (c) {
+      case '\\': {
+        if (i + 1 >= length) {
+          return "trailing backslash";
+        }
+        char escaped = urlFilter[++i];
+        if (strchr("dDwWsS", escaped) != nullptr) {
+          return std::string("character class \\") + escaped + " is not supported";
+        }
+        if (escaped == 'b' || escaped == 'B') {
+          return "word boundaries are not supported";
+        }
+        if (escaped >= '1' && escaped <= '9') {
+          return "backreferences are not supported";
+        }
+        canQuantify = true;
+        break;
+      }
+      case '|':
+        return "disjunctions (|) are not supported";
+      case '{':
+        return "{n,m} quantifiers are not supported";
+      case '^':
+        if (i != 0) {
+          return "^ is only supported at the start of the pattern";
+        }
+        canQuantify = false;
+        break;
+      case '$':
+        if (i != length - 1) {
+          return "$ is only supported at the end of the pattern";
+        }
+        canQuantify = false;
+        break;
+      case '(':
+        if (i + 1 < length && urlFilter[i + 1] == '?') {
+          if (i + 2 >= length || urlFilter[i + 2] != ':') {
+            return "lookaround assertions are not supported";
+          }
+          i += 2;
+        }
+        depth++;
+        canQuantify = false;
+        break;
+      case ')':
+        if (--depth < 0) {
+          return "unbalanced parentheses";
+        }
+        canQuantify = true;
+        break;
+      case '[': {
+        size_t j = i + 1;
+        if (j < length && urlFilter[j] == '^') j++;
+        // A leading ] is a literal
+        if (j < length && urlFilter[j] == ']') j++;
+        for (; j < length && urlFilter[j] != ']'; j++) {
+          unsigned char member = static_cast<unsigned char>(urlFilter[j]);
+          if (member >= 0x80) {
+            return "non-ASCII characters are not supported";
+          }
+          if (member == '\\' && j + 1 < length) {
+            char escaped = urlFilter[++j];
+            if (strchr("dDwWsS", escaped) != nullptr) {
+              return std::string("character class \\") + escaped + " is not supported";
+            }
+          }
+        }
+        if (j >= length) {
+          return "unterminated character set";
+        }
+        i = j;
+        canQuantify = true;
+        break;
+      }
+      case '*':
+      case '+':
+      case '?':
+        // "x*?" is a lazy quantifier, which matches the same URLs
+        if (c == '?' && previousWasQuantifier) {
+          break;
+        }
+        if (!canQuantify) {
+          return std::string("nothing to repeat before ") + static_cast<char>(c);
+        }
+        isQuantifier = true;
+        canQuantify = false;
+        break;
+      default:
+        canQuantify = true;
+        break;
+    }
+    previousWasQuantifier = isQuantifier;
+  }
+
+  if (depth != 0) {
+    return "unbalanced parentheses";
+  }
+  return "";
+}
+
+}  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,71 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_RULE_NORMALIZER_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_RULE_NORMALIZER_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <gio/gio.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../types/content_blocker_compile_result.h"
+
+namespace flutter_inappwebview_plugin {
+
+/**
+ * Converts content blocker rules, as sent by Dart (a list of maps with
+ * "trigger" and "action"), to WebKit's Safari JSON format.
+ *
+ * - The JSON text is written directly, without building a document tree.
+ * - Rules WebKit would reject (unsupported url-filter syntax, unknown
+ *   resource or action types, conflicting conditions...) are dropped with a
+ *   diagnostic, instead of failing the compilation of the whole list.
+ * - Duplicate rules are dropped and css-display-none rules with the same
+ *   trigger are merged into one. Rules are never moved across an
+ *   ignore-previous-rules rule, so the list keeps its meaning.
+ */
+class ContentBlockerRuleNormalizer {
+ public:
+  // An accepted rule that decides whether a request is blocked (block and
+  // ignore-previous-rules), with its index in the input list
+  struct MatchRule {
+    int64_t index = 0;
+    std::string urlFilter;
+    bool caseSensitive = false;
+    bool ignorePreviousRules = false;
+  };
+  using MatchRules = std::shared_ptr<const std::vector<MatchRule>>;
+
+  struct Output {
+    std::string json;  // Empty if no rule is valid
+    ContentBlockerCompileResult result;
+    MatchRules matchRules;  // In list order, never null
+  };
+
+  using Callback = std::function<void(Output output)>;
+
+  /**
+   * Normalize rules on the calling thread. rules must not be modified meanwhile.
+   */
+  static Output normalize(FlValue* rules);
+
+  /**
+   * Normalize rules on a worker thread. callback runs on the calling thread's
+   * main context, unless cancellable is cancelled first.
+   */
+  static void normalizeAsync(FlValue* rules, GCancellable* cancellable, Callback callback);
+
+  /**
+   * Check a url-filter against the regular expression subset supported by
+   * WebKit content extensions.
+   *
+   * @return Empty string if supported, otherwise the reason why not
+   */
+  static std::string validateUrlFilter(const std::string& urlFilter);
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_RULE_NORMALIZER_H_
@@ -0,0 +1,285 @@
+#include "content_filter_registry.h"
+
+#include <cstring>
+#include <filesystem>
+#include <memory>
+
+#include "../utils/log.h"
+#include "../utils/util.h"
+
+namespace flutter_inappwebview_plugin {
+
+namespace {
+
+// Prefix of every identifier this plugin saves in the filter store. The bare
+// prefix was the fixed identifier used before filters were content-addressed.
+constexpr const char* kFilterIdentifierPrefix = "flutter_inappwebview_content_rules";
+
+// Hex digits of the SHA-256 digest of the rule set kept in identifiers (128 bits)
+constexpr size_t kFilterIdentifierHashLength = 32;
+
+// Hex digits of the SHA-256 digest of the key (32 bits)
+constexpr size_t kFilterKeyHashLength = 8;
+
+std::string sha256Hex(const std::string& data, size_t length) {
+  g_autofree gchar* digest = g_compute_checksum_for_data(
+      G_CHECKSUM_SHA256, reinterpret_cast<const guchar*>(data.data()), data.size());
+  return std::string(digest, length);
+}
+
+// Key part of an identifier saved by identifierForSource(), empty for the
+// identifiers of earlier versions of the plugin
+std::string keyHashOf(const std::string& identifier) {
+  const size_t prefixLength = strlen(kFilterIdentifierPrefix) + 1;
+  if (identifier.size() != prefixLength + kFilterKeyHashLength + 1 + kFilterIdentifierHashLength ||
+      identifier[prefixLength + kFilterKeyHashLength] != '_') {
+    return "";
+  }
+  return identifier.substr(prefixLength, kFilterKeyHashLength);
+}
+
+bool isCancelled(const GError* error) {
+  return g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+}
+
+}  // namespace
+
+ContentFilterRegistry::ContentFilterRegistry() : cancellable_(g_cancellable_new()) {
+  // Get app-specific ID for isolated storage
+  std::string app_id = resolve_application_id_sanitized();
+
+  // Create filter store in a cache directory
+  // Use XDG cache directory or fallback to /tmp
+  const char* xdg_cache = g_get_user_cache_dir();
+  if (xdg_cache != nullptr) {
+    store_path_ = std::string(xdg_cache) + "/flutter_inappwebview/" + app_id + "/content_filters";
+  } else {
+    store_path_ = "/tmp/flutter_inappwebview/" + app_id + "/content_filters";
+  }
+
+  // Ensure directory exists
+  std::error_code ec;
+  std::filesystem::create_directories(store_path_, ec);
+  if (ec) {
+    errorLog("ContentFilterRegistry: Failed to create filter store directory: " + ec.message());
+  }
+
+  filter_store_ = webkit_user_content_filter_store_new(store_path_.c_str());
+  if (filter_store_ == nullptr) {
+    errorLog("ContentFilterRegistry: Failed to create WebKitUserContentFilterStore");
+  }
+}
+
+ContentFilterRegistry::~ContentFilterRegistry() {
+  // Pending load/compile callbacks see the cancellation and don't touch this
+  g_cancellable_cancel(cancellable_);
+  g_object_unref(cancellable_);
+
+  for (auto& [identifier, entry] : entries_) {
+    if (entry.filter != nullptr) {
+      webkit_user_content_filter_unref(entry.filter);
+    }
+  }
+  entries_.clear();
+
+  if (filter_store_ != nullptr) {
+    g_object_unref(filter_store_);
+    filter_store_ = nullptr;
+  }
+}
+
+std::string ContentFilterRegistry::identifierForSource(const std::string& key,
+                                                       const std::string& jsonSource) {
+  return std::string(kFilterIdentifierPrefix) + "_" + sha256Hex(key, kFilterKeyHashLength) +
+         "_" + sha256Hex(jsonSource, kFilterIdentifierHashLength);
+}
+
+uint64_t ContentFilterRegistry::acquire(const std::string& identifier,
+                                        const std::string& jsonSource, FilterCallback callback) {
+  if (filter_store_ == nullptr) {
+    if (callback) callback(nullptr);
+    return 0;
+  }
+
+  Entry& entry = entries_[identifier];
+  entry.refCount++;
+
+  if (entry.filter != nullptr) {
+    if (callback) callback(entry.filter);
+    return 0;
+  }
+
+  uint64_t ticket = next_ticket_++;
+  bool started = !entry.waiters.empty();
+  entry.waiters.push_back(Waiter{ticket, std::move(callback)});
+  if (started) {
+    return ticket;
+  }
+
+  auto* context = new LoadContext{
+      this, identifier, g_bytes_new(jsonSource.c_str(), jsonSource.length())};
+
+  // A filter compiled from the same rules in a previous run is loaded as is;
+  // compiling is only needed on a miss
+  webkit_user_content_filter_store_load(filter_store_, identifier.c_str(), cancellable_,
+                                         onFilterLoaded, context);
+  return ticket;
+}
+
+void ContentFilterRegistry::cancel(uint64_t ticket) {
+  if (ticket == 0) {
+    return;
+  }
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    auto& waiters = it->second.waiters;
+    for (auto waiter = waiters.begin(); waiter != waiters.end(); ++waiter) {
+      if (waiter->ticket == ticket) {
+        waiters.erase(waiter);
+        // The entry stays until its load completes, which drops it if unused
+        it->second.refCount--;
+        return;
+      }
+    }
+  }
+}
+
+void ContentFilterRegistry::release(const std::string& identifier) {
+  auto it = entries_.find(identifier);
+  if (it == entries_.end() || --it->second.refCount > 0) {
+    return;
+  }
+  // Still loading: onFilterReady drops it
+  if (it->second.filter == nullptr) {
+    return;
+  }
+  // The stored filter stays: the rules may be applied again, until a newer
+  // version of its key replaces them
+  webkit_user_content_filter_unref(it->second.filter);
+  entries_.erase(it);
+}
+
+void ContentFilterRegistry::onFilterLoaded(GObject* source, GAsyncResult* result,
+                                           gpointer user_data) {
+  auto* context = static_cast<LoadContext*>(user_data);
+  auto* store = WEBKIT_USER_CONTENT_FILTER_STORE(source);
+
+  g_autoptr(GError) error = nullptr;
+  WebKitUserContentFilter* filter =
+      webkit_user_content_filter_store_load_finish(store, result, &error);
+
+  if (isCancelled(error)) {
+    // The registry is gone (plugin shut down): touch nothing
+    g_bytes_unref(context->source);
+    delete context;
+    return;
+  }
+
+  if (filter == nullptr) {
+    // Not compiled yet: the registry is still alive, so is its cancellable
+    webkit_user_content_filter_store_save(store, context->identifier.c_str(), context->source,
+                                           context->registry->cancellable_, onFilterCompiled,
+                                           context);
+    return;
+  }
+
+  onFilterReady(context, filter, nullptr);
+}
+
+void ContentFilterRegistry::onFilterCompiled(GObject* source, GAsyncResult* result,
+                                             gpointer user_data) {
+  auto* context = static_cast<LoadContext*>(user_data);
+
+  GError* error = nullptr;
+  WebKitUserContentFilter* filter = webkit_user_content_filter_store_save_finish(
+      WEBKIT_USER_CONTENT_FILTER_STORE(source), result, &error);
+
+  onFilterReady(context, filter, error);
+}
+
+void ContentFilterRegistry::onFilterReady(LoadContext* context, WebKitUserContentFilter* filter,
+                                          GError* error) {
+  auto* registry = context->registry;
+  std::string identifier = std::move(context->identifier);
+  g_bytes_unref(context->source);
+  delete context;
+
+  if (isCancelled(error)) {
+    g_error_free(error);
+    return;
+  }
+
+  auto it = registry->entries_.find(identifier);
+  if (it == registry->entries_.end()) {
+    if (filter != nullptr) webkit_user_content_filter_unref(filter);
+    if (error != nullptr) g_error_free(error);
+    return;
+  }
+
+  std::vector<Waiter> waiters = std::move(it->second.waiters);
+  it->second.waiters.clear();
+
+  if (filter == nullptr) {
+    errorLog("ContentFilterRegistry: Failed to compile content blockers: " +
+             std::string(error != nullptr ? error->message : "compiled filter is null"));
+    if (error != nullptr) g_error_free(error);
+    registry->entries_.erase(it);
+    for (auto& waiter : waiters) {
+      if (waiter.callback) waiter.callback(nullptr);
+    }
+    return;
+  }
+
+  // Every waiter cancelled meanwhile
+  if (it->second.refCount <= 0) {
+    webkit_user_content_filter_unref(filter);
+    registry->entries_.erase(it);
+    return;
+  }
+
+  it->second.filter = filter;
+  registry->collectReplacedFilters(identifier);
+
+  // The filter is owned by the entry, which the waiters' references keep
+  for (auto& waiter : waiters) {
+    if (waiter.callback) waiter.callback(filter);
+  }
+}
+
+void ContentFilterRegistry::collectReplacedFilters(const std::string& identifier) {
+  if (filter_store_ == nullptr) {
+    return;
+  }
+  struct CollectContext {
+    ContentFilterRegistry* registry;
+    std::string keyHash;
+  };
+  webkit_user_content_filter_store_fetch_identifiers(
+      filter_store_, cancellable_,
+      [](GObject* source, GAsyncResult* result, gpointer user_data) {
+        std::unique_ptr<CollectContext> context(static_cast<CollectContext*>(user_data));
+        auto* store = WEBKIT_USER_CONTENT_FILTER_STORE(source);
+        // Fails with G_IO_ERROR_CANCELLED once the registry is gone
+        gchar** identifiers =
+            webkit_user_content_filter_store_fetch_identifiers_finish(store, result);
+        if (identifiers == nullptr) {
+          return;
+        }
+        // Checked on completion, so that filters acquired meanwhile are kept
+        for (gchar** id = identifiers; *id != nullptr; id++) {
+          if (!g_str_has_prefix(*id, kFilterIdentifierPrefix) ||
+              context->registry->entries_.count(*id) > 0) {
+            continue;
+          }
+          // Older versions of the same key, and filters saved by earlier
+          // versions of the plugin, which are never loaded again
+          std::string keyHash = keyHashOf(*id);
+          if (keyHash.empty() || keyHash == context->keyHash) {
+            webkit_user_content_filter_store_remove(store, *id, nullptr, nullptr, nullptr);
+          }
+        }
+        g_strfreev(identifiers);
+      },
+      new CollectContext{this, keyHashOf(identifier)});
+}
+
+}  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,118 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_FILTER_REGISTRY_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_FILTER_REGISTRY_H_
+
+#include <wpe/webkit.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace flutter_inappwebview_plugin {
+
+/**
+ * ContentFilterRegistry shares compiled content filters between all the
+ * webviews of the process.
+ *
+ * Owned by the PluginInstance. It holds the single WebKitUserContentFilterStore
+ * of the app and one WebKitUserContentFilter per distinct rule set (keyed by
+ * the content-addressed identifier of its normalized JSON). Filters don't
+ * depend on the web context, so webviews of every WebViewEnvironment share
+ * them too.
+ *
+ * Each acquire() takes a reference on the identifier, held while the filter
+ * is loaded or compiled and then by the webview it was handed to, until the
+ * matching release(). Concurrent requests for the same rule set share one
+ * load/compile. The in-memory filter is dropped with its last reference, but
+ * the stored filter is kept so that the rules load without compiling when
+ * they are applied again. A stored filter is only removed once a newer rule
+ * set of the same key (e.g. content blocker shard) is ready and nothing
+ * references the old one.
+ */
+class ContentFilterRegistry {
+ public:
+  /**
+   * Called with the filter (not owned, ref it to keep it), or nullptr if it
+   * failed to compile. On failure the reference taken by acquire() is gone.
+   */
+  using FilterCallback = std::function<void(WebKitUserContentFilter* filter)>;
+
+  ContentFilterRegistry();
+  ~ContentFilterRegistry();
+
+  ContentFilterRegistry(const ContentFilterRegistry&) = delete;
+  ContentFilterRegistry& operator=(const ContentFilterRegistry&) = delete;
+
+  /**
+   * Store identifier for a normalized Safari JSON rule set. Rule sets with the
+   * same key are versions of each other: a new version makes the stored older
+   * ones stale.
+   */
+  static std::string identifierForSource(const std::string& key, const std::string& jsonSource);
+
+  /**
+   * Get the filter for identifier, loading it from the store or compiling
+   * jsonSource on a miss. callback may run synchronously if the filter is
+   * already in memory.
+   *
+   * @return Ticket for cancel(), 0 if callback already ran
+   */
+  uint64_t acquire(const std::string& identifier, const std::string& jsonSource,
+                   FilterCallback callback);
+
+  /**
+   * Drop a pending acquire(): its callback won't run and its reference is
+   * released.
+   */
+  void cancel(uint64_t ticket);
+
+  /**
+   * Release a reference obtained through a successful acquire().
+   */
+  void release(const std::string& identifier);
+
+  bool isValid() const { return filter_store_ != nullptr; }
+
+ private:
+  struct Waiter {
+    uint64_t ticket;
+    FilterCallback callback;
+  };
+
+  struct Entry {
+    WebKitUserContentFilter* filter = nullptr;  // Owned, null while pending
+    int refCount = 0;
+    std::vector<Waiter> waiters;
+  };
+
+  struct LoadContext {
+    ContentFilterRegistry* registry;
+    std::string identifier;
+    GBytes* source;  // Owned
+  };
+
+  static void onFilterLoaded(GObject* source, GAsyncResult* result, gpointer user_data);
+  static void onFilterCompiled(GObject* source, GAsyncResult* result, gpointer user_data);
+
+  /**
+   * Complete the load/compile of context->identifier (takes filter, error).
+   */
+  static void onFilterReady(LoadContext* context, WebKitUserContentFilter* filter, GError* error);
+
+  /**
+   * Remove the stored filters of the key of identifier, other than the ones
+   * entries reference, now that identifier is ready.
+   */
+  void collectReplacedFilters(const std::string& identifier);
+
+  WebKitUserContentFilterStore* filter_store_ = nullptr;  // Owned
+  GCancellable* cancellable_ = nullptr;                   // Owned, cancelled on destruction
+  std::string store_path_;
+  std::map<std::string, Entry> entries_;
+  uint64_t next_ticket_ = 1;
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_FILTER_REGISTRY_H_
@@ -1,8 +1,9 @@
 #include "cookie_manager.h"
 
-#include <atomic>
+#include <algorithm>
 #include <cstring>
 #include <ctime>
+#include <string_view>
 
 #include "plugin_instance.h"
 #include "utils/flutter.h"
@@ -38,6 +39,83 @@ std::string sameSiteToString(SoupSameSitePolicy policy) {
       return "None";
   }
 }
+
+// Parse a list of cookie maps
+std::vector<Cookie> cookiesFromFlList(FlValue* list) {
+  std::vector<Cookie> cookies;
+  if (list == nullptr || fl_value_get_type(list) != FL_VALUE_TYPE_LIST) {
+    return cookies;
+  }
+  size_t length = fl_value_get_length(list);
+  cookies.reserve(length);
+  for (size_t i = 0; i < length; i++) {
+    cookies.emplace_back(fl_value_get_list_value(list, i));
+  }
+  return cookies;
+}
+
+// Adds or deletes cookies as one batch
+struct CookieBatch {
+  size_t remaining;
+  bool anyFailed;
+  bool add;
+  std::function<void(bool)> callback;
+};
+
+void onCookieBatchRequestDone(GObject* source, GAsyncResult* result, gpointer user_data) {
+  auto* batch = static_cast<CookieBatch*>(user_data);
+
+  GError* error = nullptr;
+  gboolean success =
+      batch->add
+          ? webkit_cookie_manager_add_cookie_finish(WEBKIT_COOKIE_MANAGER(source), result, &error)
+          : webkit_cookie_manager_delete_cookie_finish(WEBKIT_COOKIE_MANAGER(source), result,
+                                                       &error);
+
+  if (error != nullptr) {
+    errorLog(std::string("CookieManager: ") + (batch->add ? "setCookies" : "deleteCookies") +
+             " failed: " + error->message);
+    g_error_free(error);
+  }
+  if (!success) {
+    batch->anyFailed = true;
+  }
+
+  if (--batch->remaining == 0) {
+    batch->callback(!batch->anyFailed);
+    delete batch;
+  }
+}
+
+// Takes ownership of soupCookies. The requests are all in flight together,
+// so the batch costs about one round trip to the network process instead
+// of one per cookie. Completion callbacks run on the main thread.
+void runCookieBatch(WebKitCookieManager* manager, std::vector<SoupCookie*> soupCookies, bool add,
+                    std::function<void(bool)> callback) {
+  if (manager == nullptr) {
+    for (SoupCookie* soupCookie : soupCookies) {
+      soup_cookie_free(soupCookie);
+    }
+    callback(false);
+    return;
+  }
+  if (soupCookies.empty()) {
+    callback(true);
+    return;
+  }
+
+  auto* batch = new CookieBatch{soupCookies.size(), false, add, std::move(callback)};
+  for (SoupCookie* soupCookie : soupCookies) {
+    if (add) {
+      webkit_cookie_manager_add_cookie(manager, soupCookie, nullptr, onCookieBatchRequestDone,
+                                       batch);
+    } else {
+      webkit_cookie_manager_delete_cookie(manager, soupCookie, nullptr, onCookieBatchRequestDone,
+                                          batch);
+    }
+    soup_cookie_free(soupCookie);
+  }
+}
 }  // namespace
 
 // === Cookie ===
@@ -151,15 +229,169 @@ FlValue* Cookie::toFlValue() const {
   });
 }
 
+// === CookieSnapshot ===
+
+CookieSnapshot::CookieSnapshot(GList* cookies) {
+  for (GList* l = cookies; l != nullptr; l = l->next) {
+    SoupCookie* soupCookie = static_cast<SoupCookie*>(l->data);
+    const char* domain = soup_cookie_get_domain(soupCookie);
+    const char* path = soup_cookie_get_path(soupCookie);
+    const char* name = soup_cookie_get_name(soupCookie);
+    Key key{domain != nullptr ? domain : "", path != nullptr ? path : "",
+            name != nullptr ? name : ""};
+    // The cookie store has one cookie per key
+    if (!index_.emplace(std::move(key), soupCookie).second) {
+      soup_cookie_free(soupCookie);
+    }
+  }
+  g_list_free(cookies);
+}
+
+CookieSnapshot::~CookieSnapshot() {
+  for (auto& [key, soupCookie] : index_) {
+    soup_cookie_free(soupCookie);
+  }
+}
+
+std::vector<SoupCookie*> CookieSnapshot::cookiesForUri(GUri* uri) const {
+  std::vector<SoupCookie*> result;
+  const char* host = uri != nullptr ? g_uri_get_host(uri) : nullptr;
+  if (host == nullptr) {
+    return result;
+  }
+
+  // Host-only cookies of the host, then domain cookies of the host and of
+  // its parent domains
+  gchar* lowerHost = g_ascii_strdown(host, -1);
+  std::string hostName(lowerHost);
+  g_free(lowerHost);
+  std::vector<std::string> domains{hostName};
+  std::string_view rest(hostName);
+  while (!rest.empty()) {
+    domains.push_back("." + std::string(rest));
+    size_t dot = rest.find('.');
+    rest = dot != std::string_view::npos ? rest.substr(dot + 1) : std::string_view();
+  }
+
+  GDateTime* now = g_date_time_new_now_utc();
+  for (const auto& domain : domains) {
+    for (auto it = index_.lower_bound(Key{domain, "", ""});
+         it != index_.end() && std::get<0>(it->first) == domain; ++it) {
+      SoupCookie* soupCookie = it->second;
+      // Expired cookies stay in the snapshot until the store drops them
+      GDateTime* expires = soup_cookie_get_expires(soupCookie);
+      if (expires != nullptr && g_date_time_compare(expires, now) <= 0) {
+        continue;
+      }
+      if (soup_cookie_applies_to_uri(soupCookie, uri)) {
+        result.push_back(soupCookie);
+      }
+    }
+  }
+  g_date_time_unref(now);
+
+  // Longest path first, like the Cookie header
+  std::stable_sort(result.begin(), result.end(), [](SoupCookie* a, SoupCookie* b) {
+    return strlen(soup_cookie_get_path(a)) > strlen(soup_cookie_get_path(b));
+  });
+  return result;
+}
+
+std::vector<SoupCookie*> CookieSnapshot::allCookies() const {
+  std::vector<SoupCookie*> result;
+  result.reserve(index_.size());
+  for (const auto& [key, soupCookie] : index_) {
+    result.push_back(soupCookie);
+  }
+  return result;
+}
+
+// === CookieSnapshotCache ===
+
+CookieSnapshotCache::CookieSnapshotCache(std::function<void()> loader)
+    : loader_(std::move(loader)) {}
+
+void CookieSnapshotCache::request(Callback callback) {
+  if (snapshot_ != nullptr) {
+    callback(snapshot_);
+    return;
+  }
+  waiting_.emplace_back(generation_, std::move(callback));
+  load();
+}
+
+void CookieSnapshotCache::prefetch() {
+  if (snapshot_ == nullptr) {
+    load();
+  }
+}
+
+void CookieSnapshotCache::invalidate() {
+  snapshot_.reset();
+  generation_++;
+}
+
+void CookieSnapshotCache::load() {
+  if (loading()) {
+    return;
+  }
+  loading_generation_ = generation_;
+  loader_();
+}
+
+void CookieSnapshotCache::finishLoad(std::shared_ptr<const CookieSnapshot> snapshot) {
+  if (!loading()) {
+    return;
+  }
+  uint64_t generation = *loading_generation_;
+  loading_generation_.reset();
+  // Cookies that changed while loading are not cached
+  if (snapshot != nullptr && generation == generation_) {
+    snapshot_ = snapshot;
+  }
+
+  // Lookups made after a change must not see the cookies from before it;
+  // the others are answered, however many changes came since
+  std::vector<std::pair<uint64_t, Callback>> waiting;
+  waiting.swap(waiting_);
+  std::vector<Callback> ready;
+  for (auto& [callbackGeneration, callback] : waiting) {
+    if (snapshot == nullptr || callbackGeneration <= generation) {
+      ready.push_back(std::move(callback));
+    } else {
+      waiting_.emplace_back(callbackGeneration, std::move(callback));
+    }
+  }
+  if (!waiting_.empty()) {
+    load();
+  }
+  for (auto& callback : ready) {
+    callback(snapshot);
+  }
+}
+
+void CookieSnapshotCache::clear() {
+  waiting_.clear();
+}
+
 // === CookieManager ===
 
 CookieManager::CookieManager(PluginInstance* plugin)
     : ChannelDelegate(plugin->messenger(), METHOD_CHANNEL_NAME),
       plugin_(plugin),
-      cookie_manager_(nullptr) {}
+      cookie_manager_(nullptr),
+      cancellable_(g_cancellable_new()),
+      snapshot_cache_([this]() { loadCookieSnapshot(); }) {}
 
 CookieManager::~CookieManager() {
   debugLog("dealloc CookieManager");
+  // Snapshot loads and pending invalidations are dropped
+  g_cancellable_cancel(cancellable_);
+  g_object_unref(cancellable_);
+  if (cookie_manager_ != nullptr && changed_handler_id_ != 0) {
+    g_signal_handler_disconnect(cookie_manager_, changed_handler_id_);
+  }
+  snapshot_cache_.clear();
   plugin_ = nullptr;
 }
 
@@ -170,10 +402,120 @@ WebKitCookieManager* CookieManager::getCookieManager() {
     if (session != nullptr) {
       cookie_manager_ = webkit_network_session_get_cookie_manager(session);
     }
+    if (cookie_manager_ != nullptr) {
+      // Any change to the cookie store, including Set-Cookie headers and
+      // document.cookie, makes the snapshot stale
+      changed_handler_id_ =
+          g_signal_connect(cookie_manager_, "changed", G_CALLBACK(OnCookiesChanged), this);
+    }
   }
   return cookie_manager_;
 }
 
+void CookieManager::OnCookiesChanged(WebKitCookieManager* manager, gpointer user_data) {
+  static_cast<CookieManager*>(user_data)->snapshot_cache_.invalidate();
+}
+
+std::function<void(bool)> CookieManager::invalidatingCallback(std::function<void(bool)> callback) {
+  // The changed signal may arrive after the operation's reply, so the caller
+  // could read its own write from a stale snapshot. The cancellable tells
+  // whether this still exists.
+  std::shared_ptr<GCancellable> cancellable(G_CANCELLABLE(g_object_ref(cancellable_)),
+                                            g_object_unref);
+  return [this, cancellable, callback = std::move(callback)](bool success) {
+    if (!g_cancellable_is_cancelled(cancellable.get())) {
+      snapshot_cache_.invalidate();
+    }
+    callback(success);
+  };
+}
+
+void CookieManager::withCookieSnapshot(SnapshotCallback callback) {
+  if (getCookieManager() == nullptr) {
+    callback(nullptr);
+    return;
+  }
+  snapshot_cache_.request(std::move(callback));
+}
+
+void CookieManager::withCookiesForUri(
+    const std::string& url, std::function<void(const std::vector<SoupCookie*>&)> callback) {
+  GUri* guri = g_uri_parse(url.c_str(), G_URI_FLAGS_NONE, nullptr);
+  WebKitCookieManager* manager = getCookieManager();
+  if (guri == nullptr || manager == nullptr) {
+    if (guri != nullptr) {
+      g_uri_unref(guri);
+    }
+    callback({});
+    return;
+  }
+
+  if (auto snapshot = snapshot_cache_.current()) {
+    callback(snapshot->cookiesForUri(guri));
+    g_uri_unref(guri);
+    return;
+  }
+  g_uri_unref(guri);
+
+  // Later lookups are served from the snapshot once it is loaded
+  snapshot_cache_.prefetch();
+
+  auto* callbackPtr =
+      new std::function<void(const std::vector<SoupCookie*>&)>(std::move(callback));
+
+  webkit_cookie_manager_get_cookies(
+      manager, url.c_str(),
+      nullptr,  // cancellable
+      [](GObject* source, GAsyncResult* result, gpointer user_data) {
+        auto* cb = static_cast<std::function<void(const std::vector<SoupCookie*>&)>*>(user_data);
+
+        GError* error = nullptr;
+        GList* cookies =
+            webkit_cookie_manager_get_cookies_finish(WEBKIT_COOKIE_MANAGER(source), result, &error);
+
+        std::vector<SoupCookie*> cookieList;
+        if (error != nullptr) {
+          errorLog(std::string("CookieManager: getCookies failed: ") + error->message);
+          g_error_free(error);
+        }
+        for (GList* l = cookies; l != nullptr; l = l->next) {
+          cookieList.push_back(static_cast<SoupCookie*>(l->data));
+        }
+
+        (*cb)(cookieList);
+        delete cb;
+        g_list_free_full(cookies, reinterpret_cast<GDestroyNotify>(soup_cookie_free));
+      },
+      callbackPtr);
+}
+
+void CookieManager::loadCookieSnapshot() {
+  webkit_cookie_manager_get_all_cookies(
+      getCookieManager(), cancellable_,
+      [](GObject* source, GAsyncResult* result, gpointer user_data) {
+        GError* error = nullptr;
+        GList* cookies = webkit_cookie_manager_get_all_cookies_finish(
+            WEBKIT_COOKIE_MANAGER(source), result, &error);
+
+        if (error != nullptr && g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+          // The cookie manager was destroyed
+          g_error_free(error);
+          return;
+        }
+
+        auto* self = static_cast<CookieManager*>(user_data);
+        std::shared_ptr<const CookieSnapshot> snapshot;
+        if (error != nullptr) {
+          errorLog(std::string("CookieManager: cookie snapshot failed: ") + error->message);
+          g_error_free(error);
+        } else {
+          snapshot = std::make_shared<const CookieSnapshot>(cookies);
+        }
+        self->snapshot_cache_.finishLoad(std::move(snapshot));
+      },
+      this);
+}
+
 void CookieManager::HandleMethodCall(FlMethodCall* method_call) {
   const gchar* method = fl_method_call_get_name(method_call);
   FlValue* args = fl_method_call_get_args(method_call);
@@ -194,6 +536,34 @@ void CookieManager::HandleMethodCall(FlMethodCall* method_call) {
       fl_method_call_respond_success(method_call, fl_value_new_bool(success), nullptr);
       g_object_unref(method_call);
     });
+  } else if (string_equals(method, "setCookies")) {
+    std::string url = get_fl_map_value<std::string>(args, "url", "");
+    std::vector<Cookie> cookies = cookiesFromFlList(fl_value_lookup_string(args, "cookies"));
+
+    if (url.empty()) {
+      fl_method_call_respond_success(method_call, fl_value_new_bool(FALSE), nullptr);
+      return;
+    }
+
+    g_object_ref(method_call);
+    setCookies(url, cookies, [method_call](bool success) {
+      fl_method_call_respond_success(method_call, fl_value_new_bool(success), nullptr);
+      g_object_unref(method_call);
+    });
+  } else if (string_equals(method, "replaceAllCookies")) {
+    std::string url = get_fl_map_value<std::string>(args, "url", "");
+    std::vector<Cookie> cookies = cookiesFromFlList(fl_value_lookup_string(args, "cookies"));
+
+    if (url.empty() && !cookies.empty()) {
+      fl_method_call_respond_success(method_call, fl_value_new_bool(FALSE), nullptr);
+      return;
+    }
+
+    g_object_ref(method_call);
+    replaceAllCookies(url, cookies, [method_call](bool success) {
+      fl_method_call_respond_success(method_call, fl_value_new_bool(success), nullptr);
+      g_object_unref(method_call);
+    });
   } else if (string_equals(method, "getCookies")) {
     std::string url = get_fl_map_value<std::string>(args, "url", "");
 
@@ -273,6 +643,7 @@ void CookieManager::HandleMethodCall(FlMethodCall* method_call) {
 
 void CookieManager::setCookie(const std::string& url, const Cookie& cookie,
                               std::function<void(bool)> callback) {
+  callback = invalidatingCallback(std::move(callback));
   WebKitCookieManager* manager = getCookieManager();
   if (manager == nullptr) {
     callback(false);
@@ -311,51 +682,49 @@ void CookieManager::setCookie(const std::string& url, const Cookie& cookie,
   soup_cookie_free(soupCookie);
 }
 
-void CookieManager::getCookies(const std::string& url,
-                               std::function<void(std::vector<Cookie>)> callback) {
-  WebKitCookieManager* manager = getCookieManager();
-  if (manager == nullptr) {
-    callback({});
-    return;
+void CookieManager::setCookies(const std::string& url, const std::vector<Cookie>& cookies,
+                               std::function<void(bool)> callback) {
+  callback = invalidatingCallback(std::move(callback));
+  std::vector<SoupCookie*> soupCookies;
+  soupCookies.reserve(cookies.size());
+  bool allValid = true;
+  for (const auto& cookie : cookies) {
+    SoupCookie* soupCookie = cookie.toSoupCookie(url);
+    if (soupCookie == nullptr) {
+      allValid = false;
+      continue;
+    }
+    soupCookies.push_back(soupCookie);
   }
 
-  auto* callbackPtr = new std::function<void(std::vector<Cookie>)>(std::move(callback));
-
-  webkit_cookie_manager_get_cookies(
-      manager, url.c_str(),
-      nullptr,  // cancellable
-      [](GObject* source, GAsyncResult* result, gpointer user_data) {
-        auto* cb = static_cast<std::function<void(std::vector<Cookie>)>*>(user_data);
-
-        GError* error = nullptr;
-        GList* cookies =
-            webkit_cookie_manager_get_cookies_finish(WEBKIT_COOKIE_MANAGER(source), result, &error);
-
-        std::vector<Cookie> cookieList;
-
-        if (error != nullptr) {
-          errorLog(std::string("CookieManager: getCookies failed: ") + error->message);
-          g_error_free(error);
-        } else if (cookies != nullptr) {
-          for (GList* l = cookies; l != nullptr; l = l->next) {
-            SoupCookie* soupCookie = static_cast<SoupCookie*>(l->data);
-            cookieList.emplace_back(soupCookie);
-          }
-          g_list_free_full(cookies, reinterpret_cast<GDestroyNotify>(soup_cookie_free));
-        }
+  // The valid cookies are set anyway, like separate setCookie calls would
+  runCookieBatch(getCookieManager(), std::move(soupCookies), true,
+                 [allValid, callback = std::move(callback)](bool success) {
+                   callback(allValid && success);
+                 });
+}
 
-        (*cb)(cookieList);
-        delete cb;
-      },
-      callbackPtr);
+void CookieManager::getCookies(const std::string& url,
+                               std::function<void(std::vector<Cookie>)> callback) {
+  withCookiesForUri(url, [callback = std::move(callback)](
+                             const std::vector<SoupCookie*>& soupCookies) {
+    std::vector<Cookie> cookieList;
+    for (SoupCookie* soupCookie : soupCookies) {
+      cookieList.emplace_back(soupCookie);
+    }
+    callback(cookieList);
+  });
 }
 
 void CookieManager::getCookie(const std::string& url, const std::string& name,
                               std::function<void(std::optional<Cookie>)> callback) {
-  getCookies(url, [name, callback = std::move(callback)](std::vector<Cookie> cookies) {
-    for (const auto& cookie : cookies) {
-      if (cookie.name == name) {
-        callback(cookie);
+  // Only the match is converted to a Cookie
+  withCookiesForUri(url, [name, callback = std::move(callback)](
+                             const std::vector<SoupCookie*>& soupCookies) {
+    for (SoupCookie* soupCookie : soupCookies) {
+      const char* cookieName = soup_cookie_get_name(soupCookie);
+      if (cookieName != nullptr && name == cookieName) {
+        callback(Cookie(soupCookie));
         return;
       }
     }
@@ -385,153 +754,107 @@ void CookieManager::deleteCookie(const std::string& url, const std::string& name
     }
   }
 
+  callback = invalidatingCallback(std::move(callback));
+
   // WPE WebKit requires the EXACT SoupCookie object to delete, not a minimal one.
-  // We must first fetch all cookies and find the matching one with all its attributes.
-  auto* callbackPtr = new std::function<void(bool)>(std::move(callback));
-  
-  // Capture parameters for the callback
-  struct DeleteContext {
-    WebKitCookieManager* manager;
-    std::string name;
-    std::string domain;
-    std::string path;
-    std::function<void(bool)>* callback;
-  };
-  
-  auto* ctx = new DeleteContext{manager, name, cookieDomain, path, callbackPtr};
+  // We must find the matching stored cookie with all its attributes.
+  withCookieSnapshot([manager, name, cookieDomain, path, callback = std::move(callback)](
+                         std::shared_ptr<const CookieSnapshot> snapshot) {
+    if (snapshot == nullptr) {
+      callback(false);
+      return;
+    }
 
-  webkit_cookie_manager_get_all_cookies(
-      manager,
-      nullptr,  // cancellable
-      [](GObject* source, GAsyncResult* result, gpointer user_data) {
-        auto* ctx = static_cast<DeleteContext*>(user_data);
-        
-        GError* error = nullptr;
-        GList* cookies = webkit_cookie_manager_get_all_cookies_finish(
-            WEBKIT_COOKIE_MANAGER(source), result, &error);
-        
-        if (error != nullptr) {
-          errorLog(std::string("CookieManager: deleteCookie fetch failed: ") + error->message);
-          g_error_free(error);
-          (*(ctx->callback))(false);
-          delete ctx->callback;
-          delete ctx;
-          return;
+    // Find the matching cookie
+    SoupCookie* matchingCookie = nullptr;
+    for (SoupCookie* soupCookie : snapshot->allCookies()) {
+      const char* soupCookieName = soup_cookie_get_name(soupCookie);
+      const char* soupCookieDomain = soup_cookie_get_domain(soupCookie);
+      const char* soupCookiePath = soup_cookie_get_path(soupCookie);
+
+      if (soupCookieName != nullptr && strcmp(soupCookieName, name.c_str()) == 0) {
+        // Check domain match (if specified)
+        bool domainMatch = cookieDomain.empty() ||
+                           (soupCookieDomain != nullptr &&
+                            (strcmp(soupCookieDomain, cookieDomain.c_str()) == 0 ||
+                             // Also match with leading dot (e.g., ".example.com" matches "example.com")
+                             (soupCookieDomain[0] == '.' && strcmp(soupCookieDomain + 1, cookieDomain.c_str()) == 0) ||
+                             (cookieDomain[0] == '.' && strcmp(soupCookieDomain, cookieDomain.c_str() + 1) == 0)));
+
+        // Check path match (if not default)
+        bool pathMatch = path == "/" ||
+                         (soupCookiePath != nullptr && strcmp(soupCookiePath, path.c_str()) == 0);
+
+        if (domainMatch && pathMatch) {
+          matchingCookie = soupCookie;
+          break;
         }
-        
-        // Find the matching cookie
-        SoupCookie* matchingCookie = nullptr;
-        for (GList* l = cookies; l != nullptr; l = l->next) {
-          SoupCookie* soupCookie = static_cast<SoupCookie*>(l->data);
-          const char* cookieName = soup_cookie_get_name(soupCookie);
-          const char* cookieDomain = soup_cookie_get_domain(soupCookie);
-          const char* cookiePath = soup_cookie_get_path(soupCookie);
-          
-          if (cookieName != nullptr && strcmp(cookieName, ctx->name.c_str()) == 0) {
-            // Check domain match (if specified)
-            bool domainMatch = ctx->domain.empty() ||
-                               (cookieDomain != nullptr && 
-                                (strcmp(cookieDomain, ctx->domain.c_str()) == 0 ||
-                                 // Also match with leading dot (e.g., ".example.com" matches "example.com")
-                                 (cookieDomain[0] == '.' && strcmp(cookieDomain + 1, ctx->domain.c_str()) == 0) ||
-                                 (ctx->domain[0] == '.' && strcmp(cookieDomain, ctx->domain.c_str() + 1) == 0)));
-            
-            // Check path match (if not default)
-            bool pathMatch = ctx->path == "/" || 
-                             (cookiePath != nullptr && strcmp(cookiePath, ctx->path.c_str()) == 0);
-            
-            if (domainMatch && pathMatch) {
-              matchingCookie = soup_cookie_copy(soupCookie);
-              break;
-            }
-          }
-        }
-        
-        g_list_free_full(cookies, reinterpret_cast<GDestroyNotify>(soup_cookie_free));
-        
-        if (matchingCookie == nullptr) {
-          // Cookie not found - consider this a success (nothing to delete)
-          (*(ctx->callback))(true);
-          delete ctx->callback;
-          delete ctx;
-          return;
-        }
-        
-        // Now delete the actual cookie with all its attributes
-        webkit_cookie_manager_delete_cookie(
-            ctx->manager, matchingCookie,
-            nullptr,  // cancellable
-            [](GObject* source, GAsyncResult* result, gpointer user_data) {
-              auto* ctx = static_cast<DeleteContext*>(user_data);
-              
-              GError* error = nullptr;
-              gboolean success = webkit_cookie_manager_delete_cookie_finish(
-                  WEBKIT_COOKIE_MANAGER(source), result, &error);
-              
-              if (error != nullptr) {
-                errorLog(std::string("CookieManager: deleteCookie failed: ") + error->message);
-                g_error_free(error);
-              }
-              
-              (*(ctx->callback))(success);
-              delete ctx->callback;
-              delete ctx;
-            },
-            ctx);
-        
-        soup_cookie_free(matchingCookie);
-      },
-      ctx);
+      }
+    }
+
+    if (matchingCookie == nullptr) {
+      // Cookie not found - consider this a success (nothing to delete)
+      callback(true);
+      return;
+    }
+
+    // Now delete the actual cookie with all its attributes
+    runCookieBatch(manager, {soup_cookie_copy(matchingCookie)}, false, callback);
+  });
 }
 
 void CookieManager::deleteCookies(const std::string& url, const std::string& domain,
                                   const std::string& path, std::function<void(bool)> callback) {
-  // Get all cookies for the URL and delete them
-  getCookies(url,
-             [this, domain, path, callback = std::move(callback)](std::vector<Cookie> cookies) {
-               if (cookies.empty()) {
-                 callback(true);
-                 return;
-               }
-
-               auto* remaining = new std::atomic<size_t>(cookies.size());
-               auto* anyFailed = new std::atomic<bool>(false);
-               auto* sharedCallback = new std::function<void(bool)>(callback);
-
-               for (const auto& cookie : cookies) {
-                 std::string cookieDomain = cookie.domain.value_or("");
-                 std::string cookiePath = cookie.path.value_or("/");
-
-                 // Filter by domain if specified
-                 if (!domain.empty() && cookieDomain != domain) {
-                   size_t prev = remaining->fetch_sub(1);
-                   if (prev == 1) {
-                     (*sharedCallback)(!(*anyFailed));
-                     delete remaining;
-                     delete anyFailed;
-                     delete sharedCallback;
-                   }
-                   continue;
-                 }
-
-                 deleteCookie("", cookie.name, cookieDomain, cookiePath,
-                              [remaining, anyFailed, sharedCallback](bool success) {
-                                if (!success) {
-                                  anyFailed->store(true);
-                                }
-                                size_t prev = remaining->fetch_sub(1);
-                                if (prev == 1) {
-                                  (*sharedCallback)(!(*anyFailed));
-                                  delete remaining;
-                                  delete anyFailed;
-                                  delete sharedCallback;
-                                }
-                              });
-               }
-             });
+  GUri* guri = g_uri_parse(url.c_str(), G_URI_FLAGS_NONE, nullptr);
+  if (guri == nullptr) {
+    // No cookie is sent to an invalid URL: nothing to delete
+    callback(true);
+    return;
+  }
+  std::shared_ptr<GUri> uri(guri, g_uri_unref);
+
+  // The cookies getCookies(url) returns, filtered by domain if specified
+  deleteCookiesIf(
+      [uri, domain](SoupCookie* soupCookie) {
+        if (!soup_cookie_applies_to_uri(soupCookie, uri.get())) {
+          return false;
+        }
+        const char* cookieDomain = soup_cookie_get_domain(soupCookie);
+        return domain.empty() || (cookieDomain != nullptr && domain == cookieDomain);
+      },
+      std::move(callback));
+}
+
+void CookieManager::deleteCookiesIf(std::function<bool(SoupCookie*)> predicate,
+                                    std::function<void(bool)> callback) {
+  WebKitCookieManager* manager = getCookieManager();
+  if (manager == nullptr) {
+    callback(false);
+    return;
+  }
+  callback = invalidatingCallback(std::move(callback));
+
+  // WPE WebKit requires the EXACT SoupCookie object to delete, so the stored
+  // cookies are the ones deleted
+  withCookieSnapshot([manager, predicate = std::move(predicate), callback = std::move(callback)](
+                         std::shared_ptr<const CookieSnapshot> snapshot) {
+    if (snapshot == nullptr) {
+      callback(false);
+      return;
+    }
+
+    std::vector<SoupCookie*> matchingCookies;
+    for (SoupCookie* soupCookie : snapshot->allCookies()) {
+      if (predicate(soupCookie)) {
+        matchingCookies.push_back(soup_cookie_copy(soupCookie));
+      }
+    }
+    runCookieBatch(manager, std::move(matchingCookies), false, callback);
+  });
 }
 
 void CookieManager::deleteAllCookies(std::function<void(bool)> callback) {
+  callback = invalidatingCallback(std::move(callback));
   // WPE WebKit 2.x uses NetworkSession API
   WebKitNetworkSession* session = webkit_network_session_get_default();
   WebKitWebsiteDataManager* manager =
@@ -566,42 +889,79 @@ void CookieManager::deleteAllCookies(std::function<void(bool)> callback) {
       callbackPtr);
 }
 
-void CookieManager::getAllCookies(std::function<void(std::vector<Cookie>)> callback) {
+void CookieManager::replaceAllCookies(const std::string& url, const std::vector<Cookie>& cookies,
+                                     std::function<void(bool)> callback) {
+#if WEBKIT_CHECK_VERSION(2, 42, 0)
+  callback = invalidatingCallback(std::move(callback));
   WebKitCookieManager* manager = getCookieManager();
   if (manager == nullptr) {
-    callback({});
+    callback(false);
     return;
   }
 
-  auto* callbackPtr = new std::function<void(std::vector<Cookie>)>(std::move(callback));
+  GList* soupCookies = nullptr;
+  bool allValid = true;
+  for (const auto& cookie : cookies) {
+    SoupCookie* soupCookie = cookie.toSoupCookie(url);
+    if (soupCookie == nullptr) {
+      allValid = false;
+      continue;
+    }
+    soupCookies = g_list_prepend(soupCookies, soupCookie);
+  }
+  soupCookies = g_list_reverse(soupCookies);
 
-  webkit_cookie_manager_get_all_cookies(
-      manager,
+  auto* callbackPtr = new std::function<void(bool)>(
+      [allValid, callback = std::move(callback)](bool success) {
+        callback(allValid && success);
+      });
+
+  // One operation on the cookie store: other cookie requests see either the
+  // old or the new cookies, never a mix
+  webkit_cookie_manager_replace_cookies(
+      manager, soupCookies,
       nullptr,  // cancellable
       [](GObject* source, GAsyncResult* result, gpointer user_data) {
-        auto* cb = static_cast<std::function<void(std::vector<Cookie>)>*>(user_data);
+        auto* cb = static_cast<std::function<void(bool)>*>(user_data);
 
         GError* error = nullptr;
-        GList* cookies = webkit_cookie_manager_get_all_cookies_finish(
+        gboolean success = webkit_cookie_manager_replace_cookies_finish(
             WEBKIT_COOKIE_MANAGER(source), result, &error);
 
-        std::vector<Cookie> cookieList;
-
         if (error != nullptr) {
-          errorLog(std::string("CookieManager: getAllCookies failed: ") + error->message);
+          errorLog(std::string("CookieManager: replaceAllCookies failed: ") + error->message);
           g_error_free(error);
-        } else if (cookies != nullptr) {
-          for (GList* l = cookies; l != nullptr; l = l->next) {
-            SoupCookie* soupCookie = static_cast<SoupCookie*>(l->data);
-            cookieList.emplace_back(soupCookie);
-          }
-          g_list_free_full(cookies, reinterpret_cast<GDestroyNotify>(soup_cookie_free));
         }
 
-        (*cb)(cookieList);
+        (*cb)(success);
         delete cb;
       },
       callbackPtr);
+
+  g_list_free_full(soupCookies, reinterpret_cast<GDestroyNotify>(soup_cookie_free));
+#else
+  // No replace operation before WebKit 2.42: clear, then set as one batch
+  deleteAllCookies([this, url, cookies, callback = std::move(callback)](bool success) {
+    if (!success) {
+      callback(false);
+      return;
+    }
+    setCookies(url, cookies, callback);
+  });
+#endif
+}
+
+void CookieManager::getAllCookies(std::function<void(std::vector<Cookie>)> callback) {
+  withCookieSnapshot(
+      [callback = std::move(callback)](std::shared_ptr<const CookieSnapshot> snapshot) {
+        std::vector<Cookie> cookieList;
+        if (snapshot != nullptr) {
+          for (SoupCookie* soupCookie : snapshot->allCookies()) {
+            cookieList.emplace_back(soupCookie);
+          }
+        }
+        callback(cookieList);
+      });
 }
 
 }  // namespace flutter_inappwebview_plugin
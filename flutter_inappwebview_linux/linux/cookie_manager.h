@@ -4,10 +4,14 @@
 #include <flutter_linux/flutter_linux.h>
 #include <wpe/webkit.h>
 
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "types/channel_delegate.h"
@@ -40,6 +44,75 @@ class Cookie {
   FlValue* toFlValue() const;
 };
 
+/**
+ * Copy of the cookie store, indexed by (domain, path, name), so lookups
+ * don't go to the network process.
+ */
+class CookieSnapshot {
+ public:
+  /// Takes ownership of cookies and of the SoupCookies in it.
+  explicit CookieSnapshot(GList* cookies);
+  ~CookieSnapshot();
+
+  CookieSnapshot(const CookieSnapshot&) = delete;
+  CookieSnapshot& operator=(const CookieSnapshot&) = delete;
+
+  /// The unexpired cookies sent to uri, longest path first. Owned by the snapshot.
+  std::vector<SoupCookie*> cookiesForUri(GUri* uri) const;
+
+  /// Every stored cookie. Owned by the snapshot.
+  std::vector<SoupCookie*> allCookies() const;
+
+ private:
+  // domain, path, name
+  using Key = std::tuple<std::string, std::string, std::string>;
+  std::map<Key, SoupCookie*> index_;
+};
+
+/**
+ * The current CookieSnapshot and the lookups waiting for it. Each change to
+ * the cookie store starts a new generation; a snapshot answers the lookups
+ * made up to the generation it was loaded at, and is cached only while that
+ * generation is current.
+ */
+class CookieSnapshotCache {
+ public:
+  using Callback = std::function<void(std::shared_ptr<const CookieSnapshot>)>;
+
+  /// loader starts reading the cookie store, and calls finishLoad() with the
+  /// result. Only one load runs at a time.
+  explicit CookieSnapshotCache(std::function<void()> loader);
+
+  /// The snapshot of the current generation, or nullptr if it is stale.
+  std::shared_ptr<const CookieSnapshot> current() const { return snapshot_; }
+
+  bool loading() const { return loading_generation_.has_value(); }
+
+  /// Calls callback with the current snapshot, loading it first if needed.
+  void request(Callback callback);
+
+  /// Starts loading a stale snapshot without waiting for it.
+  void prefetch();
+
+  void invalidate();
+
+  /// snapshot is nullptr if the load failed; every waiting lookup gets it then.
+  void finishLoad(std::shared_ptr<const CookieSnapshot> snapshot);
+
+  /// Drops the waiting lookups without calling them.
+  void clear();
+
+ private:
+  std::function<void()> loader_;
+  std::shared_ptr<const CookieSnapshot> snapshot_;
+  uint64_t generation_ = 0;
+  std::optional<uint64_t> loading_generation_;
+  // Generation when the lookup was made, and its callback
+  std::vector<std::pair<uint64_t, Callback>> waiting_;
+
+  void load();
+};
+
 /**
  * Manages cookies for WebKitGTK.
  * Uses WebKitCookieManager and libsoup for cookie operations.
@@ -60,6 +133,11 @@ class CookieManager : public ChannelDelegate {
   // Cookie operations
   void setCookie(const std::string& url, const Cookie& cookie, std::function<void(bool)> callback);
 
+  /// Sets all cookies in one batch: the requests are sent together and
+  /// callback is called once, with whether every cookie was set.
+  void setCookies(const std::string& url, const std::vector<Cookie>& cookies,
+                  std::function<void(bool)> callback);
+
   void getCookies(const std::string& url, std::function<void(std::vector<Cookie>)> callback);
 
   void getCookie(const std::string& url, const std::string& name,
@@ -71,15 +149,50 @@ class CookieManager : public ChannelDelegate {
   void deleteCookies(const std::string& url, const std::string& domain, const std::string& path,
                      std::function<void(bool)> callback);
 
+  /// Deletes the stored cookies predicate returns true for, with one fetch
+  /// of the cookie store and one batch of deletions.
+  void deleteCookiesIf(std::function<bool(SoupCookie*)> predicate,
+                       std::function<void(bool)> callback);
+
   void deleteAllCookies(std::function<void(bool)> callback);
 
+  /// Replaces every stored cookie with cookies, as a single cookie store
+  /// operation where WebKit supports it.
+  void replaceAllCookies(const std::string& url, const std::vector<Cookie>& cookies,
+                         std::function<void(bool)> callback);
+
   void getAllCookies(std::function<void(std::vector<Cookie>)> callback);
 
  private:
+  using SnapshotCallback = CookieSnapshotCache::Callback;
+
   PluginInstance* plugin_ = nullptr;
   WebKitCookieManager* cookie_manager_;
+  GCancellable* cancellable_;
+  gulong changed_handler_id_ = 0;
+
+  // Reads are served from the snapshot until the cookie store changes
+  CookieSnapshotCache snapshot_cache_;
 
   WebKitCookieManager* getCookieManager();
+
+  /// Calls callback with the current snapshot, loading it first if needed
+  /// (nullptr on failure).
+  void withCookieSnapshot(SnapshotCallback callback);
+
+  /// Calls callback with the cookies sent to url. While the snapshot is
+  /// stale they are read from the cookie store for url alone, so a lookup
+  /// doesn't wait for the whole store to load.
+  void withCookiesForUri(const std::string& url,
+                         std::function<void(const std::vector<SoupCookie*>&)> callback);
+
+  void loadCookieSnapshot();
+
+  /// Wraps the callback of a cookie store change to drop the snapshot once
+  /// the change is done.
+  std::function<void(bool)> invalidatingCallback(std::function<void(bool)> callback);
+
+  static void OnCookiesChanged(WebKitCookieManager* manager, gpointer user_data);
 };
 
 }  // namespace flutter_inappwebview_plugin
@@ -2,16 +2,34 @@
 
 #include <gdk/gdk.h>
 
+#include <algorithm>
 #include <cstring>
 
 #include "../utils/flutter.h"
 #include "../utils/log.h"
+#include "../utils/string.h"
 #include "inappwebview_egl_texture.h"
 #include "inappwebview_texture.h"
 
 namespace flutter_inappwebview_plugin {
 
 namespace {
+
+// Every method name handled by HandleMethodCall*; the switch there only sees
+// the hash of an exact known name, so a colliding unknown name can't reach a case
+constexpr std::string_view kMethodNames[] = {
+    "setSize", "setTextureOffset", "setCursorPos", "setPointerButton", "setScrollDelta",
+    "sendKeyEvent", "sendTouchEvent", "setFocused", "setVisible", "getActivityState",
+    "setTargetRefreshRate", "getTargetRefreshRate", "requestEnterFullscreen",
+    "requestExitFullscreen", "isInFullscreen", "requestPointerLock", "requestPointerUnlock",
+};
+// Doesn't compile if two method names share a hash
+constexpr KnownStringHashes kMethodHashes(kMethodNames);
+
+constexpr uint32_t method_case(const std::string_view name) {
+  return kMethodHashes.caseFor(name);
+}
+
 // Check if GL textures should be used (enabled by default, can be disabled)
 // Disable with FLUTTER_INAPPWEBVIEW_LINUX_DISABLE_GL=1 to force software rendering.
 bool UseGLTextureEnvOverride() {
@@ -77,6 +95,74 @@ bool UseGLTexture() {
   }
   return IsOpenGLAvailable();
 }
+
+// Binary input channel records (written by _InputEventWriter in custom_platform_view.dart).
+//
+// A message is a sequence of records, each starting on an 8 byte boundary, all
+// values little-endian. Every record starts with an 8 byte header:
+//   uint8 type, uint8 arg0, uint8 arg1, uint8 reserved, int32 arg2
+// followed by a fixed payload for its type:
+//   cursorPos:     float64 x, float64 y
+//   pointerButton: (arg0 = kind, arg1 = button, arg2 = clickCount)
+//   scrollDelta:   float64 dx, float64 dy
+//   keyEvent:      (arg0 = type, arg2 = scanCode) int64 keyCode, int32 modifiers,
+//                  uint32 charactersLength, UTF-8 characters padded to 8 bytes
+//   touchEvent:    (arg0 = type, arg2 = id) float64 x, float64 y, uint32 pointCount,
+//                  uint32 reserved, pointCount x (int32 id, int32 type, float64 x, float64 y)
+enum InputRecordType : uint8_t {
+  kInputRecordCursorPos = 1,
+  kInputRecordPointerButton = 2,
+  kInputRecordScrollDelta = 3,
+  kInputRecordKeyEvent = 4,
+  kInputRecordTouchEvent = 5,
+};
+
+// Bounds-checked little-endian reader over an input message
+class InputRecordReader {
+ public:
+  InputRecordReader(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+  bool done() const { return offset_ >= length_; }
+  bool has(size_t size) const { return length_ - offset_ >= size; }
+
+  uint8_t u8() { return data_[offset_++]; }
+
+  uint32_t u32() {
+    uint32_t value;
+    memcpy(&value, data_ + offset_, sizeof(value));
+    offset_ += sizeof(value);
+    return GUINT32_FROM_LE(value);
+  }
+
+  int32_t i32() { return static_cast<int32_t>(u32()); }
+
+  int64_t i64() {
+    uint64_t value;
+    memcpy(&value, data_ + offset_, sizeof(value));
+    offset_ += sizeof(value);
+    return static_cast<int64_t>(GUINT64_FROM_LE(value));
+  }
+
+  double f64() {
+    uint64_t bits = static_cast<uint64_t>(i64());
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  const char* bytes(size_t size) {
+    const char* value = reinterpret_cast<const char*>(data_ + offset_);
+    offset_ += size;
+    return value;
+  }
+
+  void align() { offset_ = std::min(length_, (offset_ + 7) & ~static_cast<size_t>(7)); }
+
+ private:
+  const uint8_t* data_;
+  size_t length_;
+  size_t offset_ = 0;
+};
 }  // namespace
 
 CustomPlatformView::CustomPlatformView(FlBinaryMessenger* messenger,
@@ -165,6 +251,17 @@ CustomPlatformView::CustomPlatformView(FlBinaryMessenger* messenger,
     fl_method_channel_set_method_call_handler(method_channel_, HandleMethodCall, this, nullptr);
   }
 
+  // Create binary channel for high-frequency input events
+  std::string input_channel_name =
+      "com.pichillilorenzo/custom_platform_view_" + std::to_string(texture_id_) + "_input";
+  g_autoptr(FlBinaryCodec) input_codec = fl_binary_codec_new();
+  input_channel_ = fl_basic_message_channel_new(messenger, input_channel_name.c_str(),
+                                                FL_MESSAGE_CODEC(input_codec));
+  if (input_channel_ != nullptr) {
+    fl_basic_message_channel_set_message_handler(input_channel_, HandleInputMessage, this,
+                                                 nullptr);
+  }
+
   // Create event channel for cursor changes, etc.
   std::string event_channel_name =
       "com.pichillilorenzo/custom_platform_view_" + std::to_string(texture_id_) + "_events";
@@ -185,6 +282,12 @@ CustomPlatformView::~CustomPlatformView() {
     method_channel_ = nullptr;
   }
 
+  if (input_channel_ != nullptr) {
+    fl_basic_message_channel_set_message_handler(input_channel_, nullptr, nullptr, nullptr);
+    g_object_unref(input_channel_);
+    input_channel_ = nullptr;
+  }
+
   if (event_channel_ != nullptr) {
     fl_event_channel_set_stream_handlers(event_channel_, nullptr, nullptr, nullptr, nullptr);
     g_object_unref(event_channel_);
@@ -217,386 +320,492 @@ void CustomPlatformView::HandleMethodCallImpl(FlMethodCall* method_call) {
   const gchar* method = fl_method_call_get_name(method_call);
   FlValue* args = fl_method_call_get_args(method_call);
 
-  // setSize: [double width, double height, double scaleFactor]
-  if (strcmp(method, "setSize") == 0) {
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_LIST && fl_value_get_length(args) >= 2) {
-      FlValue* width_value = fl_value_get_list_value(args, 0);
-      FlValue* height_value = fl_value_get_list_value(args, 1);
-      double width = 0, height = 0;
-      double scale_factor = 1.0;
-
-      if (fl_value_get_type(width_value) == FL_VALUE_TYPE_FLOAT) {
-        width = fl_value_get_float(width_value);
-      } else if (fl_value_get_type(width_value) == FL_VALUE_TYPE_INT) {
-        width = static_cast<double>(fl_value_get_int(width_value));
-      }
+  switch (kMethodHashes.find(method)) {
+    // setSize: [double width, double height, double scaleFactor]
+    case method_case("setSize"): {
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_LIST && fl_value_get_length(args) >= 2) {
+        FlValue* width_value = fl_value_get_list_value(args, 0);
+        FlValue* height_value = fl_value_get_list_value(args, 1);
+        double width = 0, height = 0;
+        double scale_factor = 1.0;
+
+        if (fl_value_get_type(width_value) == FL_VALUE_TYPE_FLOAT) {
+          width = fl_value_get_float(width_value);
+        } else if (fl_value_get_type(width_value) == FL_VALUE_TYPE_INT) {
+          width = static_cast<double>(fl_value_get_int(width_value));
+        }
 
-      if (fl_value_get_type(height_value) == FL_VALUE_TYPE_FLOAT) {
-        height = fl_value_get_float(height_value);
-      } else if (fl_value_get_type(height_value) == FL_VALUE_TYPE_INT) {
-        height = static_cast<double>(fl_value_get_int(height_value));
-      }
+        if (fl_value_get_type(height_value) == FL_VALUE_TYPE_FLOAT) {
+          height = fl_value_get_float(height_value);
+        } else if (fl_value_get_type(height_value) == FL_VALUE_TYPE_INT) {
+          height = static_cast<double>(fl_value_get_int(height_value));
+        }
 
-      if (webview_ && width > 0 && height > 0) {
-        if (fl_value_get_length(args) >= 3) {
-          FlValue* scale_value = fl_value_get_list_value(args, 2);
-          if (scale_value != nullptr) {
-            if (fl_value_get_type(scale_value) == FL_VALUE_TYPE_FLOAT) {
-              scale_factor = fl_value_get_float(scale_value);
-            } else if (fl_value_get_type(scale_value) == FL_VALUE_TYPE_INT) {
-              scale_factor = static_cast<double>(fl_value_get_int(scale_value));
+        if (webview_ && width > 0 && height > 0) {
+          if (fl_value_get_length(args) >= 3) {
+            FlValue* scale_value = fl_value_get_list_value(args, 2);
+            if (scale_value != nullptr) {
+              if (fl_value_get_type(scale_value) == FL_VALUE_TYPE_FLOAT) {
+                scale_factor = fl_value_get_float(scale_value);
+              } else if (fl_value_get_type(scale_value) == FL_VALUE_TYPE_INT) {
+                scale_factor = static_cast<double>(fl_value_get_int(scale_value));
+              }
             }
           }
+          webview_->setScaleFactor(scale_factor);
+          // IMPORTANT: GTK/WebKit may already apply the monitor scale factor to
+          // offscreen rendering. Passing physical pixels here can double-scale
+          // the snapshot size. Keep the widget size in logical pixels and use
+          // scaleFactor only for input coordinate conversion.
+          webview_->setSize(static_cast<int>(width), static_cast<int>(height));
         }
-        webview_->setScaleFactor(scale_factor);
-        // IMPORTANT: GTK/WebKit may already apply the monitor scale factor to
-        // offscreen rendering. Passing physical pixels here can double-scale
-        // the snapshot size. Keep the widget size in logical pixels and use
-        // scaleFactor only for input coordinate conversion.
-        webview_->setSize(static_cast<int>(width), static_cast<int>(height));
       }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  // setTextureOffset: [double x, double y]
-  if (strcmp(method, "setTextureOffset") == 0) {
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_LIST && fl_value_get_length(args) >= 2) {
-      FlValue* x_value = fl_value_get_list_value(args, 0);
-      FlValue* y_value = fl_value_get_list_value(args, 1);
-      double x = 0, y = 0;
-
-      if (fl_value_get_type(x_value) == FL_VALUE_TYPE_FLOAT) {
-        x = fl_value_get_float(x_value);
-      } else if (fl_value_get_type(x_value) == FL_VALUE_TYPE_INT) {
-        x = static_cast<double>(fl_value_get_int(x_value));
-      }
+    // setTextureOffset: [double x, double y]
+    case method_case("setTextureOffset"): {
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_LIST && fl_value_get_length(args) >= 2) {
+        FlValue* x_value = fl_value_get_list_value(args, 0);
+        FlValue* y_value = fl_value_get_list_value(args, 1);
+        double x = 0, y = 0;
+
+        if (fl_value_get_type(x_value) == FL_VALUE_TYPE_FLOAT) {
+          x = fl_value_get_float(x_value);
+        } else if (fl_value_get_type(x_value) == FL_VALUE_TYPE_INT) {
+          x = static_cast<double>(fl_value_get_int(x_value));
+        }
 
-      if (fl_value_get_type(y_value) == FL_VALUE_TYPE_FLOAT) {
-        y = fl_value_get_float(y_value);
-      } else if (fl_value_get_type(y_value) == FL_VALUE_TYPE_INT) {
-        y = static_cast<double>(fl_value_get_int(y_value));
-      }
+        if (fl_value_get_type(y_value) == FL_VALUE_TYPE_FLOAT) {
+          y = fl_value_get_float(y_value);
+        } else if (fl_value_get_type(y_value) == FL_VALUE_TYPE_INT) {
+          y = static_cast<double>(fl_value_get_int(y_value));
+        }
 
-      if (webview_) {
-        webview_->SetTextureOffset(x, y);
+        if (webview_) {
+          webview_->SetTextureOffset(x, y);
+        }
       }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  // setCursorPos: [double x, double y]
-  if (strcmp(method, "setCursorPos") == 0) {
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_LIST && fl_value_get_length(args) >= 2) {
-      FlValue* x_value = fl_value_get_list_value(args, 0);
-      FlValue* y_value = fl_value_get_list_value(args, 1);
-      double x = 0, y = 0;
-
-      if (fl_value_get_type(x_value) == FL_VALUE_TYPE_FLOAT) {
-        x = fl_value_get_float(x_value);
-      } else if (fl_value_get_type(x_value) == FL_VALUE_TYPE_INT) {
-        x = static_cast<double>(fl_value_get_int(x_value));
-      }
+    // setCursorPos: [double x, double y]
+    case method_case("setCursorPos"): {
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_LIST && fl_value_get_length(args) >= 2) {
+        FlValue* x_value = fl_value_get_list_value(args, 0);
+        FlValue* y_value = fl_value_get_list_value(args, 1);
+        double x = 0, y = 0;
+
+        if (fl_value_get_type(x_value) == FL_VALUE_TYPE_FLOAT) {
+          x = fl_value_get_float(x_value);
+        } else if (fl_value_get_type(x_value) == FL_VALUE_TYPE_INT) {
+          x = static_cast<double>(fl_value_get_int(x_value));
+        }
 
-      if (fl_value_get_type(y_value) == FL_VALUE_TYPE_FLOAT) {
-        y = fl_value_get_float(y_value);
-      } else if (fl_value_get_type(y_value) == FL_VALUE_TYPE_INT) {
-        y = static_cast<double>(fl_value_get_int(y_value));
+        if (fl_value_get_type(y_value) == FL_VALUE_TYPE_FLOAT) {
+          y = fl_value_get_float(y_value);
+        } else if (fl_value_get_type(y_value) == FL_VALUE_TYPE_INT) {
+          y = static_cast<double>(fl_value_get_int(y_value));
+        }
+
+        if (webview_) {
+          webview_->SetCursorPos(x, y);
+        }
       }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-      if (webview_) {
-        webview_->SetCursorPos(x, y);
+    // setPointerButton: {"kind": int, "button": int, "clickCount": int}
+    case method_case("setPointerButton"): {
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
+        FlValue* kind_value = fl_value_lookup_string(args, "kind");
+        FlValue* button_value = fl_value_lookup_string(args, "button");
+        FlValue* click_count_value = fl_value_lookup_string(args, "clickCount");
+
+        if (kind_value != nullptr && button_value != nullptr) {
+          int kind = 0, button = 0, clickCount = 1;
+
+          if (fl_value_get_type(kind_value) == FL_VALUE_TYPE_INT) {
+            kind = static_cast<int>(fl_value_get_int(kind_value));
+          }
+          if (fl_value_get_type(button_value) == FL_VALUE_TYPE_INT) {
+            button = static_cast<int>(fl_value_get_int(button_value));
+          }
+          if (click_count_value != nullptr &&
+              fl_value_get_type(click_count_value) == FL_VALUE_TYPE_INT) {
+            clickCount = static_cast<int>(fl_value_get_int(click_count_value));
+          }
+
+          if (webview_) {
+            webview_->SetPointerButton(kind, button, clickCount);
+          }
+        }
       }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  // setPointerButton: {"kind": int, "button": int, "clickCount": int}
-  if (strcmp(method, "setPointerButton") == 0) {
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
-      FlValue* kind_value = fl_value_lookup_string(args, "kind");
-      FlValue* button_value = fl_value_lookup_string(args, "button");
-      FlValue* click_count_value = fl_value_lookup_string(args, "clickCount");
+    // setScrollDelta: [double dx, double dy]
+    case method_case("setScrollDelta"): {
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_LIST && fl_value_get_length(args) >= 2) {
+        FlValue* dx_value = fl_value_get_list_value(args, 0);
+        FlValue* dy_value = fl_value_get_list_value(args, 1);
+        double dx = 0, dy = 0;
+
+        if (fl_value_get_type(dx_value) == FL_VALUE_TYPE_FLOAT) {
+          dx = fl_value_get_float(dx_value);
+        } else if (fl_value_get_type(dx_value) == FL_VALUE_TYPE_INT) {
+          dx = static_cast<double>(fl_value_get_int(dx_value));
+        }
 
-      if (kind_value != nullptr && button_value != nullptr) {
-        int kind = 0, button = 0, clickCount = 1;
+        if (fl_value_get_type(dy_value) == FL_VALUE_TYPE_FLOAT) {
+          dy = fl_value_get_float(dy_value);
+        } else if (fl_value_get_type(dy_value) == FL_VALUE_TYPE_INT) {
+          dy = static_cast<double>(fl_value_get_int(dy_value));
+        }
 
-        if (fl_value_get_type(kind_value) == FL_VALUE_TYPE_INT) {
-          kind = static_cast<int>(fl_value_get_int(kind_value));
+        if (webview_) {
+          webview_->SetScrollDelta(dx, dy);
+        }
+      }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
+
+    // sendKeyEvent: {"type": int, "keyCode": int64, "scanCode": int, "modifiers": int, "characters":
+    // string}
+    case method_case("sendKeyEvent"): {
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
+        FlValue* type_value = fl_value_lookup_string(args, "type");
+        FlValue* keyCode_value = fl_value_lookup_string(args, "keyCode");
+        FlValue* scanCode_value = fl_value_lookup_string(args, "scanCode");
+        FlValue* modifiers_value = fl_value_lookup_string(args, "modifiers");
+        FlValue* characters_value = fl_value_lookup_string(args, "characters");
+
+        int type = 0, scanCode = 0, modifiers = 0;
+        int64_t keyCode = 0;
+        std::string characters;
+
+        if (type_value != nullptr && fl_value_get_type(type_value) == FL_VALUE_TYPE_INT) {
+          type = static_cast<int>(fl_value_get_int(type_value));
+        }
+        if (keyCode_value != nullptr && fl_value_get_type(keyCode_value) == FL_VALUE_TYPE_INT) {
+          keyCode = fl_value_get_int(keyCode_value);
         }
-        if (fl_value_get_type(button_value) == FL_VALUE_TYPE_INT) {
-          button = static_cast<int>(fl_value_get_int(button_value));
+        if (scanCode_value != nullptr && fl_value_get_type(scanCode_value) == FL_VALUE_TYPE_INT) {
+          scanCode = static_cast<int>(fl_value_get_int(scanCode_value));
         }
-        if (click_count_value != nullptr &&
-            fl_value_get_type(click_count_value) == FL_VALUE_TYPE_INT) {
-          clickCount = static_cast<int>(fl_value_get_int(click_count_value));
+        if (modifiers_value != nullptr && fl_value_get_type(modifiers_value) == FL_VALUE_TYPE_INT) {
+          modifiers = static_cast<int>(fl_value_get_int(modifiers_value));
+        }
+        if (characters_value != nullptr &&
+            fl_value_get_type(characters_value) == FL_VALUE_TYPE_STRING) {
+          characters = fl_value_get_string(characters_value);
         }
 
         if (webview_) {
-          webview_->SetPointerButton(kind, button, clickCount);
+          webview_->SendKeyEvent(type, keyCode, scanCode, modifiers, characters);
         }
       }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  // setScrollDelta: [double dx, double dy]
-  if (strcmp(method, "setScrollDelta") == 0) {
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_LIST && fl_value_get_length(args) >= 2) {
-      FlValue* dx_value = fl_value_get_list_value(args, 0);
-      FlValue* dy_value = fl_value_get_list_value(args, 1);
-      double dx = 0, dy = 0;
-
-      if (fl_value_get_type(dx_value) == FL_VALUE_TYPE_FLOAT) {
-        dx = fl_value_get_float(dx_value);
-      } else if (fl_value_get_type(dx_value) == FL_VALUE_TYPE_INT) {
-        dx = static_cast<double>(fl_value_get_int(dx_value));
+    // sendTouchEvent: {"type": int, "id": int, "x": double, "y": double, "touchPoints": list}
+    case method_case("sendTouchEvent"): {
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
+        FlValue* type_value = fl_value_lookup_string(args, "type");
+        FlValue* id_value = fl_value_lookup_string(args, "id");
+        FlValue* x_value = fl_value_lookup_string(args, "x");
+        FlValue* y_value = fl_value_lookup_string(args, "y");
+        FlValue* touchPoints_value = fl_value_lookup_string(args, "touchPoints");
+
+        int type = 0, id = 0;
+        double x = 0, y = 0;
+        std::vector<std::tuple<int, double, double, int>> touchPoints;
+
+        if (type_value != nullptr && fl_value_get_type(type_value) == FL_VALUE_TYPE_INT) {
+          type = static_cast<int>(fl_value_get_int(type_value));
+        }
+        if (id_value != nullptr && fl_value_get_type(id_value) == FL_VALUE_TYPE_INT) {
+          id = static_cast<int>(fl_value_get_int(id_value));
+        }
+        if (x_value != nullptr && fl_value_get_type(x_value) == FL_VALUE_TYPE_FLOAT) {
+          x = fl_value_get_float(x_value);
+        }
+        if (y_value != nullptr && fl_value_get_type(y_value) == FL_VALUE_TYPE_FLOAT) {
+          y = fl_value_get_float(y_value);
+        }
+
+        // Parse touch points list
+        if (touchPoints_value != nullptr &&
+            fl_value_get_type(touchPoints_value) == FL_VALUE_TYPE_LIST) {
+          size_t len = fl_value_get_length(touchPoints_value);
+          for (size_t i = 0; i < len; i++) {
+            FlValue* point = fl_value_get_list_value(touchPoints_value, i);
+            if (fl_value_get_type(point) == FL_VALUE_TYPE_MAP) {
+              int point_id = 0, point_type = 0;
+              double point_x = 0, point_y = 0;
+
+              FlValue* pid = fl_value_lookup_string(point, "id");
+              FlValue* px = fl_value_lookup_string(point, "x");
+              FlValue* py = fl_value_lookup_string(point, "y");
+              FlValue* ptype = fl_value_lookup_string(point, "type");
+
+              if (pid && fl_value_get_type(pid) == FL_VALUE_TYPE_INT) {
+                point_id = static_cast<int>(fl_value_get_int(pid));
+              }
+              if (px && fl_value_get_type(px) == FL_VALUE_TYPE_FLOAT) {
+                point_x = fl_value_get_float(px);
+              }
+              if (py && fl_value_get_type(py) == FL_VALUE_TYPE_FLOAT) {
+                point_y = fl_value_get_float(py);
+              }
+              if (ptype && fl_value_get_type(ptype) == FL_VALUE_TYPE_INT) {
+                point_type = static_cast<int>(fl_value_get_int(ptype));
+              }
+
+              touchPoints.emplace_back(point_id, point_x, point_y, point_type);
+            }
+          }
+        }
+
+        if (webview_) {
+          webview_->SendTouchEvent(type, id, x, y, touchPoints);
+        }
       }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-      if (fl_value_get_type(dy_value) == FL_VALUE_TYPE_FLOAT) {
-        dy = fl_value_get_float(dy_value);
-      } else if (fl_value_get_type(dy_value) == FL_VALUE_TYPE_INT) {
-        dy = static_cast<double>(fl_value_get_int(dy_value));
+    // setFocused: bool focused
+    case method_case("setFocused"): {
+      bool focused = false;
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_BOOL) {
+        focused = fl_value_get_bool(args);
+      } else if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
+        focused = fl_value_get_int(args) != 0;
       }
 
       if (webview_) {
-        webview_->SetScrollDelta(dx, dy);
+        webview_->setFocused(focused);
       }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  // sendKeyEvent: {"type": int, "keyCode": int64, "scanCode": int, "modifiers": int, "characters":
-  // string}
-  if (strcmp(method, "sendKeyEvent") == 0) {
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
-      FlValue* type_value = fl_value_lookup_string(args, "type");
-      FlValue* keyCode_value = fl_value_lookup_string(args, "keyCode");
-      FlValue* scanCode_value = fl_value_lookup_string(args, "scanCode");
-      FlValue* modifiers_value = fl_value_lookup_string(args, "modifiers");
-      FlValue* characters_value = fl_value_lookup_string(args, "characters");
-
-      int type = 0, scanCode = 0, modifiers = 0;
-      int64_t keyCode = 0;
-      std::string characters;
-
-      if (type_value != nullptr && fl_value_get_type(type_value) == FL_VALUE_TYPE_INT) {
-        type = static_cast<int>(fl_value_get_int(type_value));
-      }
-      if (keyCode_value != nullptr && fl_value_get_type(keyCode_value) == FL_VALUE_TYPE_INT) {
-        keyCode = fl_value_get_int(keyCode_value);
-      }
-      if (scanCode_value != nullptr && fl_value_get_type(scanCode_value) == FL_VALUE_TYPE_INT) {
-        scanCode = static_cast<int>(fl_value_get_int(scanCode_value));
-      }
-      if (modifiers_value != nullptr && fl_value_get_type(modifiers_value) == FL_VALUE_TYPE_INT) {
-        modifiers = static_cast<int>(fl_value_get_int(modifiers_value));
-      }
-      if (characters_value != nullptr &&
-          fl_value_get_type(characters_value) == FL_VALUE_TYPE_STRING) {
-        characters = fl_value_get_string(characters_value);
+    // setVisible: bool visible
+    case method_case("setVisible"): {
+      bool visible = true;
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_BOOL) {
+        visible = fl_value_get_bool(args);
+      } else if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
+        visible = fl_value_get_int(args) != 0;
       }
 
       if (webview_) {
-        webview_->SendKeyEvent(type, keyCode, scanCode, modifiers, characters);
+        webview_->setVisible(visible);
       }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  // sendTouchEvent: {"type": int, "id": int, "x": double, "y": double, "touchPoints": list}
-  if (strcmp(method, "sendTouchEvent") == 0) {
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
-      FlValue* type_value = fl_value_lookup_string(args, "type");
-      FlValue* id_value = fl_value_lookup_string(args, "id");
-      FlValue* x_value = fl_value_lookup_string(args, "x");
-      FlValue* y_value = fl_value_lookup_string(args, "y");
-      FlValue* touchPoints_value = fl_value_lookup_string(args, "touchPoints");
-
-      int type = 0, id = 0;
-      double x = 0, y = 0;
-      std::vector<std::tuple<int, double, double, int>> touchPoints;
-
-      if (type_value != nullptr && fl_value_get_type(type_value) == FL_VALUE_TYPE_INT) {
-        type = static_cast<int>(fl_value_get_int(type_value));
-      }
-      if (id_value != nullptr && fl_value_get_type(id_value) == FL_VALUE_TYPE_INT) {
-        id = static_cast<int>(fl_value_get_int(id_value));
-      }
-      if (x_value != nullptr && fl_value_get_type(x_value) == FL_VALUE_TYPE_FLOAT) {
-        x = fl_value_get_float(x_value);
-      }
-      if (y_value != nullptr && fl_value_get_type(y_value) == FL_VALUE_TYPE_FLOAT) {
-        y = fl_value_get_float(y_value);
+    // getActivityState: returns uint32
+    case method_case("getActivityState"): {
+      uint32_t state = 0;
+      if (webview_) {
+        state = webview_->getActivityState();
       }
+      g_autoptr(FlValue) result = fl_value_new_int(static_cast<int64_t>(state));
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-      // Parse touch points list
-      if (touchPoints_value != nullptr &&
-          fl_value_get_type(touchPoints_value) == FL_VALUE_TYPE_LIST) {
-        size_t len = fl_value_get_length(touchPoints_value);
-        for (size_t i = 0; i < len; i++) {
-          FlValue* point = fl_value_get_list_value(touchPoints_value, i);
-          if (fl_value_get_type(point) == FL_VALUE_TYPE_MAP) {
-            int point_id = 0, point_type = 0;
-            double point_x = 0, point_y = 0;
-
-            FlValue* pid = fl_value_lookup_string(point, "id");
-            FlValue* px = fl_value_lookup_string(point, "x");
-            FlValue* py = fl_value_lookup_string(point, "y");
-            FlValue* ptype = fl_value_lookup_string(point, "type");
-
-            if (pid && fl_value_get_type(pid) == FL_VALUE_TYPE_INT) {
-              point_id = static_cast<int>(fl_value_get_int(pid));
-            }
-            if (px && fl_value_get_type(px) == FL_VALUE_TYPE_FLOAT) {
-              point_x = fl_value_get_float(px);
-            }
-            if (py && fl_value_get_type(py) == FL_VALUE_TYPE_FLOAT) {
-              point_y = fl_value_get_float(py);
-            }
-            if (ptype && fl_value_get_type(ptype) == FL_VALUE_TYPE_INT) {
-              point_type = static_cast<int>(fl_value_get_int(ptype));
-            }
-
-            touchPoints.emplace_back(point_id, point_x, point_y, point_type);
-          }
-        }
+    // setTargetRefreshRate: int rate
+    case method_case("setTargetRefreshRate"): {
+      uint32_t rate = 0;
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
+        rate = static_cast<uint32_t>(fl_value_get_int(args));
       }
 
       if (webview_) {
-        webview_->SendTouchEvent(type, id, x, y, touchPoints);
+        webview_->setTargetRefreshRate(rate);
       }
-    }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
-
-  // setFocused: bool focused
-  if (strcmp(method, "setFocused") == 0) {
-    bool focused = false;
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_BOOL) {
-      focused = fl_value_get_bool(args);
-    } else if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
-      focused = fl_value_get_int(args) != 0;
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
 
-    if (webview_) {
-      webview_->setFocused(focused);
+    // getTargetRefreshRate: returns uint32
+    case method_case("getTargetRefreshRate"): {
+      uint32_t rate = 0;
+      if (webview_) {
+        rate = webview_->getTargetRefreshRate();
+      }
+      g_autoptr(FlValue) result = fl_value_new_int(static_cast<int64_t>(rate));
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  // setVisible: bool visible
-  if (strcmp(method, "setVisible") == 0) {
-    bool visible = true;
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_BOOL) {
-      visible = fl_value_get_bool(args);
-    } else if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
-      visible = fl_value_get_int(args) != 0;
+    // requestEnterFullscreen
+    case method_case("requestEnterFullscreen"): {
+      if (webview_) {
+        webview_->requestEnterFullscreen();
+      }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
 
-    if (webview_) {
-      webview_->setVisible(visible);
+    // requestExitFullscreen
+    case method_case("requestExitFullscreen"): {
+      if (webview_) {
+        webview_->requestExitFullscreen();
+      }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  // getActivityState: returns uint32
-  if (strcmp(method, "getActivityState") == 0) {
-    uint32_t state = 0;
-    if (webview_) {
-      state = webview_->getActivityState();
+    // isInFullscreen: returns bool
+    case method_case("isInFullscreen"): {
+      bool fullscreen = false;
+      if (webview_) {
+        fullscreen = webview_->isInFullscreen();
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(fullscreen);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_int(static_cast<int64_t>(state));
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  // setTargetRefreshRate: int rate
-  if (strcmp(method, "setTargetRefreshRate") == 0) {
-    uint32_t rate = 0;
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
-      rate = static_cast<uint32_t>(fl_value_get_int(args));
+    // requestPointerLock: returns bool
+    case method_case("requestPointerLock"): {
+      bool success = false;
+      if (webview_) {
+        success = webview_->requestPointerLock();
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(success);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
 
-    if (webview_) {
-      webview_->setTargetRefreshRate(rate);
+    // requestPointerUnlock: returns bool
+    case method_case("requestPointerUnlock"): {
+      bool success = false;
+      if (webview_) {
+        success = webview_->requestPointerUnlock();
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(success);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
+    default:
+      break;
   }
 
-  // getTargetRefreshRate: returns uint32
-  if (strcmp(method, "getTargetRefreshRate") == 0) {
-    uint32_t rate = 0;
-    if (webview_) {
-      rate = webview_->getTargetRefreshRate();
-    }
-    g_autoptr(FlValue) result = fl_value_new_int(static_cast<int64_t>(rate));
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+  fl_method_call_respond_not_implemented(method_call, nullptr);
+}
 
-  // requestEnterFullscreen
-  if (strcmp(method, "requestEnterFullscreen") == 0) {
-    if (webview_) {
-      webview_->requestEnterFullscreen();
-    }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
+void CustomPlatformView::HandleInputMessage(FlBasicMessageChannel* channel, FlValue* message,
+                                            FlBasicMessageChannelResponseHandle* response_handle,
+                                            gpointer user_data) {
+  auto* self = static_cast<CustomPlatformView*>(user_data);
+  if (message != nullptr && fl_value_get_type(message) == FL_VALUE_TYPE_UINT8_LIST) {
+    self->DispatchInputRecords(fl_value_get_uint8_list(message), fl_value_get_length(message));
   }
 
-  // requestExitFullscreen
-  if (strcmp(method, "requestExitFullscreen") == 0) {
-    if (webview_) {
-      webview_->requestExitFullscreen();
-    }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
+  // The binary codec can't encode null, reply with an empty message
+  g_autoptr(FlValue) response = fl_value_new_uint8_list(nullptr, 0);
+  g_autoptr(GError) error = nullptr;
+  if (!fl_basic_message_channel_respond(channel, response_handle, response, &error)) {
+    debugLog(std::string("CustomPlatformView: failed to respond to input message: ") +
+             (error ? error->message : "unknown error"));
   }
+}
 
-  // isInFullscreen: returns bool
-  if (strcmp(method, "isInFullscreen") == 0) {
-    bool fullscreen = false;
-    if (webview_) {
-      fullscreen = webview_->isInFullscreen();
-    }
-    g_autoptr(FlValue) result = fl_value_new_bool(fullscreen);
-    fl_method_call_respond_success(method_call, result, nullptr);
+void CustomPlatformView::DispatchInputRecords(const uint8_t* data, size_t length) {
+  if (!webview_) {
     return;
   }
 
-  // requestPointerLock: returns bool
-  if (strcmp(method, "requestPointerLock") == 0) {
-    bool success = false;
-    if (webview_) {
-      success = webview_->requestPointerLock();
+  InputRecordReader reader(data, length);
+  while (!reader.done()) {
+    if (!reader.has(8)) {
+      errorLog("CustomPlatformView: truncated input record header");
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(success);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
-
-  // requestPointerUnlock: returns bool
-  if (strcmp(method, "requestPointerUnlock") == 0) {
-    bool success = false;
-    if (webview_) {
-      success = webview_->requestPointerUnlock();
+    uint8_t type = reader.u8();
+    uint8_t arg0 = reader.u8();
+    uint8_t arg1 = reader.u8();
+    reader.u8();  // reserved
+    int32_t arg2 = reader.i32();
+
+    switch (type) {
+      case kInputRecordCursorPos:
+      case kInputRecordScrollDelta: {
+        if (!reader.has(16)) {
+          errorLog("CustomPlatformView: truncated input record");
+          return;
+        }
+        double x = reader.f64();
+        double y = reader.f64();
+        if (type == kInputRecordCursorPos) {
+          webview_->SetCursorPos(x, y);
+        } else {
+          webview_->SetScrollDelta(x, y);
+        }
+        break;
+      }
+      case kInputRecordPointerButton:
+        webview_->SetPointerButton(arg0, arg1, arg2);
+        break;
+      case kInputRecordKeyEvent: {
+        if (!reader.has(16)) {
+          errorLog("CustomPlatformView: truncated key input record");
+          return;
+        }
+        int64_t keyCode = reader.i64();
+        int32_t modifiers = reader.i32();
+        uint32_t charactersLength = reader.u32();
+        if (!reader.has(charactersLength)) {
+          errorLog("CustomPlatformView: truncated key input record");
+          return;
+        }
+        std::string characters(reader.bytes(charactersLength), charactersLength);
+        reader.align();
+        webview_->SendKeyEvent(arg0, keyCode, arg2, modifiers, characters);
+        break;
+      }
+      case kInputRecordTouchEvent: {
+        if (!reader.has(24)) {
+          errorLog("CustomPlatformView: truncated touch input record");
+          return;
+        }
+        double x = reader.f64();
+        double y = reader.f64();
+        uint32_t pointCount = reader.u32();
+        reader.u32();  // reserved
+        if (!reader.has(static_cast<size_t>(pointCount) * 24)) {
+          errorLog("CustomPlatformView: truncated touch input record");
+          return;
+        }
+        touch_points_scratch_.clear();
+        for (uint32_t i = 0; i < pointCount; i++) {
+          int point_id = reader.i32();
+          int point_type = reader.i32();
+          double point_x = reader.f64();
+          double point_y = reader.f64();
+          touch_points_scratch_.emplace_back(point_id, point_x, point_y, point_type);
+        }
+        webview_->SendTouchEvent(arg0, arg2, x, y, touch_points_scratch_);
+        break;
+      }
+      default:
+        // Unknown record: its size is unknown too, so the rest can't be decoded
+        errorLog("CustomPlatformView: unknown input record type " + std::to_string(type));
+        return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(success);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
   }
-
-  fl_method_call_respond_not_implemented(method_call, nullptr);
 }
 
 FlMethodErrorResponse* CustomPlatformView::OnListen(FlEventChannel* channel, FlValue* args,
@@ -5,6 +5,8 @@
 
 #include <memory>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "in_app_webview.h"
 #include "inappwebview_egl_texture.h"
@@ -45,11 +47,23 @@ class CustomPlatformView {
   FlEventChannel* event_channel_ = nullptr;
   bool event_sink_active_ = false;
 
+  // Binary channel carrying batched pointer/keyboard/touch records
+  // (layout documented in custom_platform_view.cc)
+  FlBasicMessageChannel* input_channel_ = nullptr;
+  // Reused between touch records to avoid a vector allocation per event
+  std::vector<std::tuple<int, double, double, int>> touch_points_scratch_;
+
   // Method call handler
   static void HandleMethodCall(FlMethodChannel* channel, FlMethodCall* method_call,
                                gpointer user_data);
   void HandleMethodCallImpl(FlMethodCall* method_call);
 
+  // Binary input channel handler
+  static void HandleInputMessage(FlBasicMessageChannel* channel, FlValue* message,
+                                 FlBasicMessageChannelResponseHandle* response_handle,
+                                 gpointer user_data);
+  void DispatchInputRecords(const uint8_t* data, size_t length);
+
   // Event channel handlers
   static FlMethodErrorResponse* OnListen(FlEventChannel* channel, FlValue* args,
                                          gpointer user_data);
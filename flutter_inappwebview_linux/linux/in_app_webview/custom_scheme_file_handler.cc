@@ -0,0 +1,290 @@
+#include "custom_scheme_file_handler.h"
+
+#include <linux/limits.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../utils/log.h"
+
+namespace flutter_inappwebview_plugin {
+
+namespace {
+
+// Types WebKit is strict about (module scripts, WebAssembly streaming
+// compilation), checked before falling back to GIO content sniffing
+const std::map<std::string, std::string>& webMimeTypes() {
+  static const auto* types = new std::map<std::string, std::string>{
+      {".html", "text/html"},
+      {".htm", "text/html"},
+      {".js", "text/javascript"},
+      {".mjs", "text/javascript"},
+      {".css", "text/css"},
+      {".json", "application/json"},
+      {".map", "application/json"},
+      {".wasm", "application/wasm"},
+      {".svg", "image/svg+xml"},
+      {".xml", "application/xml"},
+      {".txt", "text/plain"},
+  };
+  return *types;
+}
+
+std::string guessMimeType(const std::filesystem::path& path, GBytes* bytes) {
+  std::string extension = path.extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  auto it = webMimeTypes().find(extension);
+  if (it != webMimeTypes().end()) {
+    return it->second;
+  }
+
+  gsize size = 0;
+  const auto* data = static_cast<const guchar*>(g_bytes_get_data(bytes, &size));
+  gboolean uncertain = FALSE;
+  g_autofree gchar* contentType = g_content_type_guess(
+      path.filename().c_str(), data, std::min<gsize>(size, 4096), &uncertain);
+  g_autofree gchar* mimeType =
+      contentType != nullptr ? g_content_type_get_mime_type(contentType) : nullptr;
+  return mimeType != nullptr ? mimeType : "application/octet-stream";
+}
+
+std::string makeETag(const std::filesystem::path& path, gsize size) {
+  std::error_code ec;
+  auto mtime = std::filesystem::last_write_time(path, ec);
+  auto ticks = ec ? 0 : static_cast<long long>(mtime.time_since_epoch().count());
+  char etag[64];
+  snprintf(etag, sizeof(etag), "\"%zx-%llx\"", static_cast<size_t>(size), ticks);
+  return etag;
+}
+
+bool etagMatches(const char* ifNoneMatch, const std::string& etag) {
+  if (ifNoneMatch == nullptr) {
+    return false;
+  }
+  std::string value = ifNoneMatch;
+  // Weak comparison, as required for If-None-Match
+  return value.find('*') != std::string::npos || value.find(etag) != std::string::npos;
+}
+
+std::optional<std::filesystem::path> flutterAssetsDirectory() {
+  char exe_path[PATH_MAX];
+  ssize_t len = readlink("/proc/self/exe", exe_path, sizeof(exe_path) - 1);
+  if (len == -1) {
+    return std::nullopt;
+  }
+  exe_path[len] = '\0';
+  return std::filesystem::path(exe_path).parent_path() / "data" / "flutter_assets";
+}
+
+}  // namespace
+
+bool CustomSchemeFileHandler::mount(const std::string& scheme, const std::string& rootDirectory,
+                                    bool fallbackToDart) {
+  std::error_code ec;
+  std::filesystem::path root = std::filesystem::canonical(rootDirectory, ec);
+  if (ec || !std::filesystem::is_directory(root, ec)) {
+    debugLog("CustomSchemeFileHandler: not a directory: " + rootDirectory);
+    return false;
+  }
+  mounts_[scheme] = Mount{root, fallbackToDart};
+  return true;
+}
+
+bool CustomSchemeFileHandler::mountAssets(const std::string& scheme,
+                                          const std::string& assetPrefix, bool fallbackToDart) {
+  auto assets = flutterAssetsDirectory();
+  if (!assets.has_value()) {
+    debugLog("CustomSchemeFileHandler: failed to locate the Flutter assets directory");
+    return false;
+  }
+  return mount(scheme, (assets.value() / assetPrefix).string(), fallbackToDart);
+}
+
+void CustomSchemeFileHandler::unmount(const std::string& scheme) {
+  mounts_.erase(scheme);
+}
+
+bool CustomSchemeFileHandler::handle(WebKitURISchemeRequest* request) const {
+  if (mounts_.empty()) {
+    return false;
+  }
+  const gchar* scheme = webkit_uri_scheme_request_get_scheme(request);
+  auto it = scheme != nullptr ? mounts_.find(scheme) : mounts_.end();
+  if (it == mounts_.end()) {
+    return false;
+  }
+
+  auto path = resolve(it->second.root, webkit_uri_scheme_request_get_path(request));
+  if (!path.has_value()) {
+    if (it->second.fallbackToDart) {
+      return false;
+    }
+    finishWithStatus(request, 404, nullptr);
+    return true;
+  }
+
+  serveFile(request, path.value());
+  return true;
+}
+
+bool CustomSchemeFileHandler::parseRange(const char* header, gsize size, gsize& start, gsize& end,
+                                         bool& unsatisfiable) {
+  unsatisfiable = false;
+  if (header == nullptr || strncmp(header, "bytes=", 6) != 0 || strchr(header, ',') != nullptr) {
+    return false;
+  }
+  const char* spec = header + 6;
+  const char* dash = strchr(spec, '-');
+  if (dash == nullptr) {
+    return false;
+  }
+
+  char* parseEnd = nullptr;
+  if (dash == spec) {
+    // Suffix range: the last N bytes
+    unsigned long long suffix = strtoull(dash + 1, &parseEnd, 10);
+    if (parseEnd == dash + 1 || *parseEnd != '\0') {
+      return false;
+    }
+    if (suffix == 0 || size == 0) {
+      unsatisfiable = true;
+      return true;
+    }
+    start = suffix >= size ? 0 : size - static_cast<gsize>(suffix);
+    end = size - 1;
+    return true;
+  }
+
+  unsigned long long first = strtoull(spec, &parseEnd, 10);
+  if (parseEnd != dash) {
+    return false;
+  }
+  unsigned long long last = size > 0 ? size - 1 : 0;
+  if (*(dash + 1) != '\0') {
+    last = strtoull(dash + 1, &parseEnd, 10);
+    if (*parseEnd != '\0' || last < first) {
+      return false;
+    }
+  }
+  if (first >= size) {
+    unsatisfiable = true;
+    return true;
+  }
+  start = static_cast<gsize>(first);
+  end = std::min<gsize>(static_cast<gsize>(last), size - 1);
+  return true;
+}
+
+std::optional<std::filesystem::path> CustomSchemeFileHandler::resolve(
+    const std::filesystem::path& root, const char* uriPath) {
+  g_autofree gchar* decoded = g_uri_unescape_string(uriPath != nullptr ? uriPath : "/", "/");
+  if (decoded == nullptr) {
+    return std::nullopt;
+  }
+  std::string relative = decoded;
+  relative.erase(0, relative.find_first_not_of('/'));
+
+  std::error_code ec;
+  std::filesystem::path candidate = root / relative;
+  if (std::filesystem::is_directory(candidate, ec)) {
+    candidate /= "index.html";
+  }
+  std::filesystem::path resolved = std::filesystem::canonical(candidate, ec);
+  if (ec || !std::filesystem::is_regular_file(resolved, ec)) {
+    return std::nullopt;
+  }
+
+  // Reject "..", and symlinks, leading outside of the root
+  std::filesystem::path inside = resolved.lexically_relative(root);
+  if (inside.empty() || *inside.begin() == "..") {
+    return std::nullopt;
+  }
+  return resolved;
+}
+
+void CustomSchemeFileHandler::serveFile(WebKitURISchemeRequest* request,
+                                        const std::filesystem::path& path) {
+  g_autoptr(GError) error = nullptr;
+  GMappedFile* mappedFile = g_mapped_file_new(path.c_str(), FALSE, &error);
+  if (mappedFile == nullptr) {
+    debugLog("CustomSchemeFileHandler: " + std::string(error->message));
+    finishWithStatus(request, 404, nullptr);
+    return;
+  }
+  // The bytes keep the mapping alive for as long as WebKit reads the stream
+  g_autoptr(GBytes) bytes = g_mapped_file_get_bytes(mappedFile);
+  g_mapped_file_unref(mappedFile);
+  gsize size = g_bytes_get_size(bytes);
+
+  SoupMessageHeaders* requestHeaders = webkit_uri_scheme_request_get_http_headers(request);
+  SoupMessageHeaders* headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+  std::string etag = makeETag(path, size);
+  soup_message_headers_append(headers, "ETag", etag.c_str());
+  soup_message_headers_append(headers, "Accept-Ranges", "bytes");
+
+  if (requestHeaders != nullptr &&
+      etagMatches(soup_message_headers_get_one(requestHeaders, "If-None-Match"), etag)) {
+    finishWithStatus(request, 304, headers);
+    return;
+  }
+
+  guint statusCode = 200;
+  g_autoptr(GBytes) body = g_bytes_ref(bytes);
+  gsize start = 0;
+  gsize end = 0;
+  bool unsatisfiable = false;
+  if (requestHeaders != nullptr &&
+      parseRange(soup_message_headers_get_one(requestHeaders, "Range"), size, start, end,
+                 unsatisfiable)) {
+    if (unsatisfiable) {
+      g_autofree gchar* contentRange = g_strdup_printf("bytes */%" G_GSIZE_FORMAT, size);
+      soup_message_headers_append(headers, "Content-Range", contentRange);
+      finishWithStatus(request, 416, headers);
+      return;
+    }
+    statusCode = 206;
+    g_bytes_unref(body);
+    // Slices the mapping, no copy
+    body = g_bytes_new_from_bytes(bytes, start, end - start + 1);
+    g_autofree gchar* contentRange = g_strdup_printf(
+        "bytes %" G_GSIZE_FORMAT "-%" G_GSIZE_FORMAT "/%" G_GSIZE_FORMAT, start, end, size);
+    soup_message_headers_append(headers, "Content-Range", contentRange);
+  }
+
+  if (g_strcmp0(webkit_uri_scheme_request_get_http_method(request), "HEAD") == 0) {
+    g_bytes_unref(body);
+    body = g_bytes_new(nullptr, 0);
+  }
+
+  std::string mimeType = guessMimeType(path, bytes);
+  gsize length = g_bytes_get_size(body);
+  g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_bytes(body);
+  WebKitURISchemeResponse* response = webkit_uri_scheme_response_new(stream, length);
+  webkit_uri_scheme_response_set_status(response, statusCode, nullptr);
+  webkit_uri_scheme_response_set_content_type(response, mimeType.c_str());
+  // Takes ownership of headers
+  webkit_uri_scheme_response_set_http_headers(response, headers);
+  webkit_uri_scheme_request_finish_with_response(request, response);
+  g_object_unref(response);
+}
+
+void CustomSchemeFileHandler::finishWithStatus(WebKitURISchemeRequest* request, guint statusCode,
+                                               SoupMessageHeaders* headers) {
+  g_autoptr(GInputStream) stream = g_memory_input_stream_new();
+  WebKitURISchemeResponse* response = webkit_uri_scheme_response_new(stream, 0);
+  webkit_uri_scheme_response_set_status(response, statusCode, nullptr);
+  if (headers != nullptr) {
+    // Takes ownership of headers
+    webkit_uri_scheme_response_set_http_headers(response, headers);
+  }
+  webkit_uri_scheme_request_finish_with_response(request, response);
+  g_object_unref(response);
+}
+
+}  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,65 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_CUSTOM_SCHEME_FILE_HANDLER_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_CUSTOM_SCHEME_FILE_HANDLER_H_
+
+// Serves custom scheme requests straight from a local directory (or the
+// Flutter assets bundle) without going through onLoadResourceWithCustomScheme.
+//
+// For a scheme mounted on root, "scheme://any-host/a/b.js" maps to
+// root/a/b.js ("/" and directories map to their index.html). Files are
+// memory-mapped and handed to WebKit without copying. Responses carry a
+// sniffed Content-Type, an ETag (honouring If-None-Match) and support single
+// byte-range requests. Paths resolving outside of root are rejected.
+
+#include <wpe/webkit.h>
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+namespace flutter_inappwebview_plugin {
+
+class CustomSchemeFileHandler {
+ public:
+  CustomSchemeFileHandler() = default;
+  ~CustomSchemeFileHandler() = default;
+
+  // Mounts scheme on rootDirectory. When fallbackToDart is true, requests for
+  // missing files still go to Dart instead of failing with 404.
+  // Returns false if rootDirectory is not a directory.
+  bool mount(const std::string& scheme, const std::string& rootDirectory, bool fallbackToDart);
+  // Mounts scheme on a directory of the Flutter assets bundle ("" for all assets)
+  bool mountAssets(const std::string& scheme, const std::string& assetPrefix, bool fallbackToDart);
+  void unmount(const std::string& scheme);
+
+  // Serves request if its scheme is mounted. Returns false if the request
+  // should be handled by Dart instead.
+  bool handle(WebKitURISchemeRequest* request) const;
+
+  // Parses a single "bytes=" Range header against size. Returns false if the
+  // header should be ignored (absent, malformed or multiple ranges);
+  // unsatisfiable is set for a well-formed range outside of the body.
+  static bool parseRange(const char* header, gsize size, gsize& start, gsize& end,
+                         bool& unsatisfiable);
+
+  // Maps a URI path to the file it names under root (canonical), nullopt if
+  // there is no such regular file or it resolves outside of root
+  static std::optional<std::filesystem::path> resolve(const std::filesystem::path& root,
+                                                      const char* uriPath);
+
+ private:
+  struct Mount {
+    std::filesystem::path root;  // Canonical
+    bool fallbackToDart = true;
+  };
+
+  std::map<std::string, Mount> mounts_;
+
+  static void serveFile(WebKitURISchemeRequest* request, const std::filesystem::path& path);
+  static void finishWithStatus(WebKitURISchemeRequest* request, guint statusCode,
+                               SoupMessageHeaders* headers);
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_CUSTOM_SCHEME_FILE_HANDLER_H_
@@ -0,0 +1,182 @@
+#include "custom_scheme_response_stream.h"
+
+#include <gio/gunixinputstream.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "../utils/log.h"
+
+namespace flutter_inappwebview_plugin {
+
+CustomSchemeResponseStream::CustomSchemeResponseStream(size_t highWaterMark, size_t lowWaterMark)
+    : high_water_mark_(highWaterMark), low_water_mark_(std::min(lowWaterMark, highWaterMark)) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+    errorLog("CustomSchemeResponseStream: failed to create socket pair");
+    return;
+  }
+
+  // A socket (rather than a pipe) lets writes fail with EPIPE instead of
+  // raising SIGPIPE when WebKit stops reading
+  g_autoptr(GError) error = nullptr;
+  socket_ = g_socket_new_from_fd(fds[1], &error);
+  if (socket_ == nullptr) {
+    errorLog("CustomSchemeResponseStream: " + std::string(error->message));
+    ::close(fds[0]);
+    ::close(fds[1]);
+    return;
+  }
+  g_socket_set_blocking(socket_, FALSE);
+  input_ = g_unix_input_stream_new(fds[0], TRUE);
+}
+
+CustomSchemeResponseStream::~CustomSchemeResponseStream() {
+  if (writable_source_ != nullptr) {
+    g_source_destroy(writable_source_);
+    g_source_unref(writable_source_);
+  }
+  if (socket_ != nullptr) {
+    if (!closed_) {
+      g_socket_close(socket_, nullptr);
+    }
+    g_object_unref(socket_);
+  }
+  if (input_ != nullptr) {
+    g_object_unref(input_);
+  }
+}
+
+bool CustomSchemeResponseStream::write(const uint8_t* data, size_t size) {
+  if (finishing_ || closed_ || !isValid()) {
+    return false;
+  }
+  if (size > 0) {
+    queue_.emplace_back(data, data + size);
+    queued_bytes_ += size;
+  }
+  data_requested_ = false;
+  if (writable_source_ == nullptr) {
+    flush();
+  }
+  return true;
+}
+
+void CustomSchemeResponseStream::finish() {
+  if (finishing_ || closed_) {
+    return;
+  }
+  finishing_ = true;
+  if (writable_source_ == nullptr) {
+    flush();
+  }
+}
+
+void CustomSchemeResponseStream::cancel() {
+  close(false);
+}
+
+void CustomSchemeResponseStream::flush() {
+  // write()/finish() called from the need data callback: the loop below
+  // picks up the new data
+  if (flushing_ || !isValid()) {
+    return;
+  }
+  flushing_ = true;
+
+  while (!closed_) {
+    bool blocked = false;
+    while (!queue_.empty()) {
+      const auto& chunk = queue_.front();
+      g_autoptr(GError) error = nullptr;
+      gssize written = g_socket_send(socket_,
+                                     reinterpret_cast<const gchar*>(chunk.data()) + front_offset_,
+                                     chunk.size() - front_offset_, nullptr, &error);
+      if (written < 0) {
+        if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+          blocked = true;
+          break;
+        }
+        // WebKit closed its end (navigation, cancelled load)
+        flushing_ = false;
+        close(false);
+        return;
+      }
+      front_offset_ += static_cast<size_t>(written);
+      queued_bytes_ -= static_cast<size_t>(written);
+      if (front_offset_ == chunk.size()) {
+        queue_.pop_front();
+        front_offset_ = 0;
+      }
+    }
+
+    if (queue_.empty() && finishing_) {
+      flushing_ = false;
+      close(true);
+      return;
+    }
+    if (blocked) {
+      waitWritable();
+    }
+    if (finishing_ || data_requested_ || queued_bytes_ > low_water_mark_ || !need_data_callback_) {
+      break;
+    }
+
+    data_requested_ = true;
+    need_data_callback_();
+    if (blocked) {
+      break;
+    }
+  }
+
+  flushing_ = false;
+}
+
+void CustomSchemeResponseStream::waitWritable() {
+  if (writable_source_ != nullptr) {
+    return;
+  }
+  writable_source_ = g_socket_create_source(socket_, G_IO_OUT, nullptr);
+  g_source_set_callback(writable_source_, G_SOURCE_FUNC(OnWritable), this, nullptr);
+  g_source_attach(writable_source_, nullptr);
+}
+
+gboolean CustomSchemeResponseStream::OnWritable(GSocket* /*socket*/, GIOCondition /*condition*/,
+                                                gpointer user_data) {
+  auto* self = static_cast<CustomSchemeResponseStream*>(user_data);
+  g_source_unref(self->writable_source_);
+  self->writable_source_ = nullptr;
+  // An error or hang up condition makes the next send fail and close the stream
+  self->flush();
+  return G_SOURCE_REMOVE;
+}
+
+void CustomSchemeResponseStream::close(bool completed) {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+
+  if (writable_source_ != nullptr) {
+    g_source_destroy(writable_source_);
+    g_source_unref(writable_source_);
+    writable_source_ = nullptr;
+  }
+  if (socket_ != nullptr) {
+    g_socket_close(socket_, nullptr);
+  }
+  queue_.clear();
+  front_offset_ = 0;
+  queued_bytes_ = 0;
+
+  // Last statement: the owner may schedule this object's destruction
+  ClosedCallback callback = std::move(closed_callback_);
+  if (callback) {
+    callback(completed);
+  }
+}
+
+}  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,93 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_CUSTOM_SCHEME_RESPONSE_STREAM_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_CUSTOM_SCHEME_RESPONSE_STREAM_H_
+
+// Body of a streamed custom scheme response.
+//
+// WebKit reads from inputStream(), the read end of a socket pair. Chunks
+// passed to write() are queued and copied into the socket as it drains, so
+// only a bounded amount of the body is held in memory:
+// - wantsData() is true while fewer than highWaterMark bytes are queued
+// - the need data callback fires whenever the queue drains below
+//   lowWaterMark and the producer may push more
+// - the closed callback fires once, when the body was fully written after
+//   finish(), or when WebKit stopped reading (navigation, cancelled load)
+//
+// The callbacks may call write()/finish()/cancel(), but must not destroy the
+// stream synchronously.
+
+#include <gio/gio.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace flutter_inappwebview_plugin {
+
+class CustomSchemeResponseStream {
+ public:
+  static constexpr size_t kDefaultHighWaterMark = 1024 * 1024;
+  static constexpr size_t kDefaultLowWaterMark = 256 * 1024;
+
+  using NeedDataCallback = std::function<void()>;
+  // completed is false if the body was cut short (cancel() or reader gone)
+  using ClosedCallback = std::function<void(bool completed)>;
+
+  CustomSchemeResponseStream(size_t highWaterMark = kDefaultHighWaterMark,
+                             size_t lowWaterMark = kDefaultLowWaterMark);
+  ~CustomSchemeResponseStream();
+
+  CustomSchemeResponseStream(const CustomSchemeResponseStream&) = delete;
+  CustomSchemeResponseStream& operator=(const CustomSchemeResponseStream&) = delete;
+
+  // False if the socket pair could not be created
+  bool isValid() const { return input_ != nullptr && socket_ != nullptr; }
+
+  // Stream to hand to WebKit, owned by this object
+  GInputStream* inputStream() const { return input_; }
+
+  void setNeedDataCallback(NeedDataCallback callback) { need_data_callback_ = std::move(callback); }
+  void setClosedCallback(ClosedCallback callback) { closed_callback_ = std::move(callback); }
+
+  // Queues a chunk of the body. Returns false if the stream is already
+  // finished or closed, in which case the chunk is dropped.
+  bool write(const uint8_t* data, size_t size);
+  // No more chunks will be written; the socket is closed once drained
+  void finish();
+  // Drops queued chunks and closes the socket right away
+  void cancel();
+
+  bool wantsData() const { return !finishing_ && !closed_ && queued_bytes_ < high_water_mark_; }
+  bool isClosed() const { return closed_; }
+  size_t queuedBytes() const { return queued_bytes_; }
+
+ private:
+  GInputStream* input_ = nullptr;
+  GSocket* socket_ = nullptr;
+  GSource* writable_source_ = nullptr;
+
+  size_t high_water_mark_;
+  size_t low_water_mark_;
+
+  std::deque<std::vector<uint8_t>> queue_;
+  size_t front_offset_ = 0;
+  size_t queued_bytes_ = 0;
+  bool finishing_ = false;
+  bool closed_ = false;
+  bool flushing_ = false;
+  // The need data callback fired and nothing was written since
+  bool data_requested_ = false;
+
+  NeedDataCallback need_data_callback_;
+  ClosedCallback closed_callback_;
+
+  void flush();
+  void waitWritable();
+  void close(bool completed);
+  static gboolean OnWritable(GSocket* socket, GIOCondition condition, gpointer user_data);
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_CUSTOM_SCHEME_RESPONSE_STREAM_H_
@@ -42,15 +42,12 @@
 // Cairo for PNG encoding (used by takeScreenshot)
 #include <cairo.h>
 
-#include "../plugin_scripts_js/color_input_js.h"
 #include "../plugin_scripts_js/console_log_js.h"
-#include "../plugin_scripts_js/cursor_detection_js.h"
-#include "../plugin_scripts_js/date_input_js.h"
+#include "../plugin_scripts_js/content_blocker_stats_js.h"
 #include "../plugin_scripts_js/intercept_ajax_request_js.h"
-#include "../plugin_scripts_js/intercept_fetch_request_js.h"
 #include "../plugin_scripts_js/javascript_bridge_js.h"
-#include "../plugin_scripts_js/on_load_resource_js.h"
-#include "../plugin_scripts_js/print_interception_js.h"
+#include "../plugin_scripts_js/lazy_plugin_script_js.h"
+#include "../plugin_scripts_js/plugin_script_bundler.h"
 #include "../plugin_scripts_js/web_message_channel_js.h"
 #include "../plugin_scripts_js/web_message_listener_js.h"
 #include "../types/client_cert_challenge.h"
@@ -68,6 +65,7 @@
 #include "../plugin_instance.h"
 #include "../utils/flutter.h"
 #include "../utils/gl_context.h"
+#include "../utils/jsc.h"
 #include "../utils/log.h"
 #include "../utils/uri.h"
 #include "in_app_webview_manager.h"
@@ -357,9 +355,23 @@ void InAppWebView::AttachChannel(FlBinaryMessenger* messenger, const std::string
 
 InAppWebView::~InAppWebView() {
   debugLog("dealloc InAppWebView");
+  // Pending callbacks must not touch a webview being destroyed
+  lifetime_.reset();
 
   CleanupMonitorChangeHandlers();
 
+  if (coalesced_input_source_id_ != 0) {
+    g_source_remove(coalesced_input_source_id_);
+    coalesced_input_source_id_ = 0;
+  }
+
+  if (custom_scheme_stream_cleanup_source_id_ != 0) {
+    g_source_remove(custom_scheme_stream_cleanup_source_id_);
+    custom_scheme_stream_cleanup_source_id_ = 0;
+  }
+  // Closes the sockets: WebKit sees the end of any body still being read
+  custom_scheme_response_streams_.clear();
+
   context_menu_popup_.reset();
 
   if (findInteractionController_) {
@@ -404,6 +416,13 @@ InAppWebView::~InAppWebView() {
   }
   web_message_listeners_.clear();
 
+  // Complete in-flight multi-frame evaluations with whatever was collected
+  while (!frame_evaluation_requests_.empty()) {
+    completeFrameEvaluation(frame_evaluation_requests_.begin()->first, true);
+  }
+  releaseFrameEvaluationAgents();
+  script_message_reply_registry_.cancelAll("WebView disposed");
+
   // IMPORTANT: Clean up user content controller FIRST while webview is still valid
   // The UserContentController destructor needs access to WebKit's user content manager
   // which becomes invalid after we unref the webview
@@ -897,7 +916,8 @@ void InAppWebView::InitWebView(const InAppWebViewCreationParams& params) {
   // Create content blocker handler for Safari-style content blocking rules
   WebKitUserContentManager* content_manager = webkit_web_view_get_user_content_manager(webview_);
   if (content_manager != nullptr) {
-    content_blocker_handler_ = std::make_unique<ContentBlockerHandler>(content_manager);
+    content_blocker_handler_ = std::make_unique<ContentBlockerHandler>(
+        content_manager, plugin_ != nullptr ? plugin_->contentFilterRegistry() : nullptr);
   }
 }
 
@@ -1023,64 +1043,43 @@ void InAppWebView::PrepareAndAddUserScripts() {
   // === Add Console Log Interception Script ===
   // Note: Console log is always for main frame only to avoid issues
   // (see https://github.com/pichillilorenzo/flutter_inappwebview/issues/1738)
-  auto consoleLogScript = ConsoleLogJS::CONSOLE_LOG_JS_PLUGIN_SCRIPT(pluginScriptsOriginAllowList);
+  auto consoleLogScript = ConsoleLogJS::CONSOLE_LOG_JS_PLUGIN_SCRIPT(
+      pluginScriptsOriginAllowList, console_min_level_, console_max_messages_per_second_,
+      console_batch_interval_);
   user_content_controller_->addPluginScript(std::move(consoleLogScript));
 
-  // === Add Color Input Interception Script ===
-  // WPE WebKit doesn't have the run-color-chooser signal, so we handle <input type="color">
-  // via JavaScript interception
-  auto colorInputScript =
-      ColorInputJS::COLOR_INPUT_JS_PLUGIN_SCRIPT(pluginScriptsOriginAllowList, pluginScriptsForMainFrameOnly);
-  user_content_controller_->addPluginScript(std::move(colorInputScript));
-
-  // === Add Date Input Interception Script ===
-  // WPE WebKit doesn't have date picker support, so we handle <input type="date/time/etc.>
-  // via JavaScript interception
-  auto dateInputScript =
-      DateInputJS::DATE_INPUT_JS_PLUGIN_SCRIPT(pluginScriptsOriginAllowList, pluginScriptsForMainFrameOnly);
-  user_content_controller_->addPluginScript(std::move(dateInputScript));
-
-  // === Add Cursor Detection Script ===
-  // WPE WebKit renders offscreen so we detect cursor style via JavaScript
-  // This script handles CSS cursor detection and intelligent "auto" cursor resolution
-  auto cursorDetectionScript =
-      CursorDetectionJS::CURSOR_DETECTION_JS_PLUGIN_SCRIPT(pluginScriptsOriginAllowList, pluginScriptsForMainFrameOnly);
-  user_content_controller_->addPluginScript(std::move(cursorDetectionScript));
-
-  // === Add OnLoadResource Script ===
-  // Uses PerformanceObserver API to track resource loading
-  if (settings_ != nullptr && settings_->useOnLoadResource) {
-    auto onLoadResourceScript = OnLoadResourceJS::ON_LOAD_RESOURCE_JS_PLUGIN_SCRIPT(
+  // === Add Bundled Plugin Scripts ===
+  // Color/date input and print interception, cursor detection, scroll metrics,
+  // onLoadResource, AJAX/fetch interception and the frame evaluation agent, as one
+  // minified script per injection time (built once per settings combination)
+  PluginScriptBundler::Options bundleOptions;
+  bundleOptions.forMainFrameOnly = pluginScriptsForMainFrameOnly;
+  if (settings_ != nullptr) {
+    bundleOptions.useOnLoadResource = settings_->useOnLoadResource;
+    bundleOptions.useShouldInterceptAjaxRequest = settings_->useShouldInterceptAjaxRequest;
+    bundleOptions.useOnAjaxReadyStateChange = settings_->useOnAjaxReadyStateChange;
+    bundleOptions.useOnAjaxProgress = settings_->useOnAjaxProgress;
+    bundleOptions.useShouldInterceptFetchRequest = settings_->useShouldInterceptFetchRequest;
+  }
+  // Subframes can only be reached through the bridge when it is injected in them
+  bundleOptions.useFrameEvaluation =
+      !pluginScriptsForMainFrameOnly && !javaScriptBridgeForMainFrameOnly;
+  // Color/date input, cursor detection and print interception as stubs that
+  // load their implementation through _loadPluginScript on first use
+  bundleOptions.lazyActivation = LazyPluginScriptJS::get_LAZY_ACTIVATION_ENABLED();
+  for (auto& bundledScript :
+       PluginScriptBundler::bundle(bundleOptions, pluginScriptsOriginAllowList)) {
+    user_content_controller_->addPluginScript(std::move(bundledScript));
+  }
+
+  // === Add Intercept Request Rules Flag Script ===
+  // Makes the AJAX/fetch interception scripts ask the native rule table first
+  if (!intercept_request_rules_.empty()) {
+    auto interceptRulesScript = InterceptAjaxRequestJS::INTERCEPT_REQUEST_RULES_JS_PLUGIN_SCRIPT(
         pluginScriptsOriginAllowList, pluginScriptsForMainFrameOnly);
-    user_content_controller_->addPluginScript(std::move(onLoadResourceScript));
-  }
-
-  // === Add AJAX Request Interception Script ===
-  // Intercepts XMLHttpRequest calls for shouldInterceptAjaxRequest, onAjaxReadyStateChange, onAjaxProgress
-  if (settings_ != nullptr && settings_->useShouldInterceptAjaxRequest) {
-    auto ajaxInterceptScript = InterceptAjaxRequestJS::INTERCEPT_AJAX_REQUEST_JS_PLUGIN_SCRIPT(
-        pluginScriptsOriginAllowList,
-        pluginScriptsForMainFrameOnly,
-        settings_->useOnAjaxReadyStateChange,
-        settings_->useOnAjaxProgress);
-    user_content_controller_->addPluginScript(std::move(ajaxInterceptScript));
+    user_content_controller_->addPluginScript(std::move(interceptRulesScript));
   }
 
-  // === Add Fetch Request Interception Script ===
-  // Intercepts fetch() calls for shouldInterceptFetchRequest
-  if (settings_ != nullptr && settings_->useShouldInterceptFetchRequest) {
-    auto fetchInterceptScript = InterceptFetchRequestJS::INTERCEPT_FETCH_REQUEST_JS_PLUGIN_SCRIPT(
-        pluginScriptsOriginAllowList, pluginScriptsForMainFrameOnly);
-    user_content_controller_->addPluginScript(std::move(fetchInterceptScript));
-  }
-
-  // === Add Print Interception Script ===
-  // WPE WebKit doesn't have a native print signal, so we intercept window.print()
-  // via JavaScript and notify the Dart side
-  auto printInterceptionScript = PrintInterceptionJS::PRINT_INTERCEPTION_JS_PLUGIN_SCRIPT(
-      pluginScriptsOriginAllowList, pluginScriptsForMainFrameOnly);
-  user_content_controller_->addPluginScript(std::move(printInterceptionScript));
-
   // TODO: Add additional plugin scripts as needed:
   // - FindTextHighlightJS
   // - etc.
@@ -1525,10 +1524,7 @@ void InAppWebView::loadUrl(const std::shared_ptr<URLRequest>& urlRequest) {
   WebKitURIRequest* request = webkit_uri_request_new(urlRequest->url.value().c_str());
 
   if (urlRequest->headers.has_value()) {
-    SoupMessageHeaders* headers = webkit_uri_request_get_http_headers(request);
-    for (const auto& header : urlRequest->headers.value()) {
-      soup_message_headers_append(headers, header.first.c_str(), header.second.c_str());
-    }
+    urlRequest->headers->appendTo(webkit_uri_request_get_http_headers(request));
   }
 
   webkit_web_view_load_request(webview_, request);
@@ -1891,18 +1887,17 @@ HitTestResult InAppWebView::getHitTestResult() const {
 
 // === JavaScript ===
 
-void InAppWebView::evaluateJavascript(
-    const std::string& source,
-    const std::optional<std::string>& worldName,
-    std::function<void(const std::optional<std::string>&)> callback) {
+void InAppWebView::evaluateJavascriptRaw(const std::string& source,
+                                         const std::optional<std::string>& worldName,
+                                         std::function<void(JSCValue*)> callback) {
   if (webview_ == nullptr) {
     if (callback)
-      callback(std::nullopt);
+      callback(nullptr);
     return;
   }
 
   struct CallbackData {
-    std::function<void(const std::optional<std::string>&)> callback;
+    std::function<void(JSCValue*)> callback;
   };
 
   auto* cb_data = new CallbackData{std::move(callback)};
@@ -1917,40 +1912,15 @@ void InAppWebView::evaluateJavascript(
       [](GObject* source, GAsyncResult* result, gpointer user_data) {
         auto* data = static_cast<CallbackData*>(user_data);
         GError* error = nullptr;
-        JSCValue* js_result =
+        g_autoptr(JSCValue) js_result =
             webkit_web_view_evaluate_javascript_finish(WEBKIT_WEB_VIEW(source), result, &error);
 
         if (error != nullptr) {
-          if (data->callback)
-            data->callback(std::nullopt);
           g_error_free(error);
-        } else if (js_result != nullptr) {
-          // Use JSON.stringify on the result via JSC to get proper JSON
-          JSCContext* context = jsc_value_get_context(js_result);
-          g_autoptr(JSCValue) json_stringify = jsc_context_evaluate(
-              context,
-              "(function(v) { return JSON.stringify(v); })",
-              -1);
-          g_autoptr(JSCValue) json_value = jsc_value_function_call(
-              json_stringify, JSC_TYPE_VALUE, js_result, G_TYPE_NONE);
-          
-          if (json_value != nullptr && jsc_value_is_string(json_value)) {
-            g_autofree gchar* str = jsc_value_to_string(json_value);
-            if (data->callback) {
-              if (str) {
-                data->callback(std::string(str));
-              } else {
-                data->callback(std::nullopt);
-              }
-            }
-          } else {
-            if (data->callback)
-              data->callback(std::nullopt);
-          }
-          g_object_unref(js_result);
-        } else {
-          if (data->callback)
-            data->callback(std::nullopt);
+        }
+
+        if (data->callback) {
+          data->callback(js_result);
         }
 
         delete data;
@@ -1958,6 +1928,117 @@ void InAppWebView::evaluateJavascript(
       cb_data);
 }
 
+void InAppWebView::evaluateJavascript(
+    const std::string& source,
+    const std::optional<std::string>& worldName,
+    std::function<void(const std::optional<std::string>&)> callback) {
+  evaluateJavascriptRaw(source, worldName, [callback = std::move(callback)](JSCValue* js_result) {
+    if (!callback) {
+      return;
+    }
+    if (js_result == nullptr) {
+      callback(std::nullopt);
+      return;
+    }
+    // jsc_value_to_json serializes natively, without evaluating a
+    // JSON.stringify wrapper in the page context on every call
+    g_autofree gchar* str = jsc_value_to_json(js_result, 0);
+    if (str != nullptr) {
+      callback(std::string(str));
+    } else {
+      callback(std::nullopt);
+    }
+  });
+}
+
+void InAppWebView::evaluateJavascriptAsFlValue(
+    const std::string& source, const std::optional<std::string>& worldName,
+    std::function<void(FlValue*, const GError*)> callback) {
+  evaluateJavascriptRaw(source, worldName, [callback = std::move(callback)](JSCValue* js_result) {
+    if (!callback) {
+      return;
+    }
+    g_autoptr(GError) error = nullptr;
+    g_autoptr(FlValue) value = jsc_value_to_fl_value(js_result, &error);
+    callback(value, error);
+  });
+}
+
+void InAppWebView::evaluateJavascriptChunked(const std::string& source,
+                                             const std::optional<std::string>& worldName,
+                                             size_t chunkSize,
+                                             std::function<void(const char*, size_t)> onChunk,
+                                             std::function<void(bool, size_t)> onComplete) {
+  if (chunkSize == 0) {
+    chunkSize = kDefaultEvaluateJavascriptChunkSize;
+  }
+  chunkSize = std::max(chunkSize, kMinEvaluateJavascriptChunkSize);
+
+  struct ChunkPump {
+    gchar* json;
+    size_t length;
+    size_t offset;
+    size_t chunkSize;
+    std::function<void(const char*, size_t)> onChunk;
+    std::function<void(bool, size_t)> onComplete;
+    std::weak_ptr<bool> lifetime;
+  };
+
+  evaluateJavascriptRaw(
+      source, worldName,
+      [chunkSize, onChunk = std::move(onChunk), onComplete = std::move(onComplete),
+       webViewLifetime = lifetime()](JSCValue* js_result) mutable {
+        gchar* json = js_result != nullptr ? jsc_value_to_json(js_result, 0) : nullptr;
+        if (json == nullptr) {
+          if (onComplete)
+            onComplete(false, 0);
+          return;
+        }
+
+        // One slice per main loop iteration: each channel message is handed
+        // to Dart before the next one is built
+        auto* pump = new ChunkPump{json,
+                                   strlen(json),
+                                   0,
+                                   chunkSize,
+                                   std::move(onChunk),
+                                   std::move(onComplete),
+                                   std::move(webViewLifetime)};
+        g_idle_add_full(
+            G_PRIORITY_DEFAULT_IDLE,
+            [](gpointer user_data) -> gboolean {
+              auto* pump = static_cast<ChunkPump*>(user_data);
+              if (pump->lifetime.expired()) {
+                // The channel went away with the webview
+                if (pump->onComplete)
+                  pump->onComplete(false, 0);
+                return G_SOURCE_REMOVE;
+              }
+              if (pump->offset < pump->length) {
+                size_t end = std::min(pump->offset + pump->chunkSize, pump->length);
+                // Never split a UTF-8 sequence: move back to the start of the code point
+                while (end < pump->length && end > pump->offset + 1 &&
+                       (static_cast<unsigned char>(pump->json[end]) & 0xC0) == 0x80) {
+                  end--;
+                }
+                if (pump->onChunk)
+                  pump->onChunk(pump->json + pump->offset, end - pump->offset);
+                pump->offset = end;
+                return G_SOURCE_CONTINUE;
+              }
+              if (pump->onComplete)
+                pump->onComplete(true, pump->length);
+              return G_SOURCE_REMOVE;
+            },
+            pump,
+            [](gpointer user_data) {
+              auto* pump = static_cast<ChunkPump*>(user_data);
+              g_free(pump->json);
+              delete pump;
+            });
+      });
+}
+
 // Helper function to convert FlValue to GVariant
 void InAppWebView::callAsyncJavaScript(
     const std::string& functionBody,
@@ -2033,21 +2114,8 @@ void InAppWebView::callAsyncJavaScript(
           json_result = "{\"value\":null,\"error\":\"" + escaped_error + "\"}";
           g_error_free(error);
         } else if (js_result != nullptr) {
-          // Use JSON.stringify on the result via JSC to get proper JSON
-          JSCContext* context = jsc_value_get_context(js_result);
-          g_autoptr(JSCValue) json_stringify = jsc_context_evaluate(
-              context,
-              "(function(v) { return JSON.stringify({value: v, error: null}); })",
-              -1);
-          g_autoptr(JSCValue) json_value = jsc_value_function_call(
-              json_stringify, JSC_TYPE_VALUE, js_result, G_TYPE_NONE);
-          
-          if (json_value != nullptr && jsc_value_is_string(json_value)) {
-            g_autofree gchar* str = jsc_value_to_string(json_value);
-            json_result = str ? str : "{\"value\":null,\"error\":null}";
-          } else {
-            json_result = "{\"value\":null,\"error\":null}";
-          }
+          g_autofree gchar* str = jsc_value_to_json(js_result, 0);
+          json_result = std::string("{\"value\":") + (str ? str : "null") + ",\"error\":null}";
           g_object_unref(js_result);
         } else {
           json_result = "{\"value\":null,\"error\":null}";
@@ -2061,6 +2129,523 @@ void InAppWebView::callAsyncJavaScript(
       cb_data);
 }
 
+void InAppWebView::setConsoleMessageOptions(int64_t minLevel, int64_t maxMessagesPerSecond,
+                                            int64_t batchInterval) {
+  console_min_level_ = minLevel;
+  console_max_messages_per_second_ = std::max<int64_t>(maxMessagesPerSecond, 0);
+  console_batch_interval_ = std::max<int64_t>(batchInterval, 0);
+
+  if (user_content_controller_ == nullptr ||
+      (settings_ && !settings_->javaScriptBridgeEnabled)) {
+    return;
+  }
+
+  // Replace the plugin script so new pages start with the new options...
+  std::optional<std::vector<std::string>> pluginScriptsOriginAllowList =
+      settings_ ? settings_->pluginScriptsOriginAllowList : std::nullopt;
+  user_content_controller_->removePluginScriptsByGroupName(
+      ConsoleLogJS::CONSOLE_LOG_JS_PLUGIN_SCRIPT_GROUP_NAME);
+  user_content_controller_->addPluginScript(ConsoleLogJS::CONSOLE_LOG_JS_PLUGIN_SCRIPT(
+      pluginScriptsOriginAllowList, console_min_level_, console_max_messages_per_second_,
+      console_batch_interval_));
+
+  // ...and update the current page in place
+  evaluateJavascript(ConsoleLogJS::CONSOLE_LOG_CONFIGURE_JS_SOURCE(
+                         console_min_level_, console_max_messages_per_second_,
+                         console_batch_interval_),
+                     std::nullopt, nullptr);
+}
+
+bool InAppWebView::setCustomSchemeFileSource(const std::string& scheme,
+                                             const std::optional<std::string>& directory,
+                                             const std::optional<std::string>& assetPrefix,
+                                             bool fallbackToDart) {
+  if (directory.has_value()) {
+    return custom_scheme_file_handler_.mount(scheme, directory.value(), fallbackToDart);
+  }
+  if (assetPrefix.has_value()) {
+    return custom_scheme_file_handler_.mountAssets(scheme, assetPrefix.value(), fallbackToDart);
+  }
+  custom_scheme_file_handler_.unmount(scheme);
+  return true;
+}
+
+void InAppWebView::setContentBlockerShard(
+    const std::string& shard, FlValue* contentBlockers,
+    std::function<void(const ContentBlockerCompileResult&)> callback) {
+  if (content_blocker_handler_ == nullptr) {
+    callback(ContentBlockerCompileResult());
+    return;
+  }
+  content_blocker_handler_->setContentBlockerShard(shard, contentBlockers, std::move(callback));
+}
+
+void InAppWebView::removeContentBlockerShard(const std::string& shard) {
+  if (content_blocker_handler_ != nullptr) {
+    content_blocker_handler_->removeContentBlockerShard(shard);
+  }
+}
+
+std::vector<std::string> InAppWebView::getContentBlockerShardNames() const {
+  std::vector<std::string> names;
+  if (content_blocker_handler_ != nullptr) {
+    for (auto& name : content_blocker_handler_->getContentBlockerShardNames()) {
+      // The contentBlockers setting is not a named shard
+      if (name != ContentBlockerHandler::kSettingsShard) {
+        names.push_back(std::move(name));
+      }
+    }
+  }
+  return names;
+}
+
+bool InAppWebView::setContentBlockerInstrumentation(bool enabled) {
+  if (content_blocker_handler_ == nullptr || user_content_controller_ == nullptr ||
+      (settings_ && !settings_->javaScriptBridgeEnabled)) {
+    return false;
+  }
+  if (enabled == content_blocker_handler_->isInstrumentationEnabled()) {
+    return true;
+  }
+  content_blocker_handler_->setInstrumentationEnabled(enabled);
+
+  // New pages get the script from the plugin scripts...
+  user_content_controller_->removePluginScriptsByGroupName(
+      ContentBlockerStatsJS::CONTENT_BLOCKER_STATS_JS_PLUGIN_SCRIPT_GROUP_NAME);
+  if (enabled) {
+    user_content_controller_->addPluginScript(
+        ContentBlockerStatsJS::CONTENT_BLOCKER_STATS_JS_PLUGIN_SCRIPT(
+            settings_ ? settings_->pluginScriptsOriginAllowList : std::nullopt,
+            settings_ ? settings_->pluginScriptsForMainFrameOnly : false));
+  }
+  // ...the current page installs it now (once) or stops reporting
+  evaluateJavascript(enabled ? ContentBlockerStatsJS::CONTENT_BLOCKER_STATS_JS_SOURCE()
+                             : ContentBlockerStatsJS::FLAG_VARIABLE_FOR_CONTENT_BLOCKER_STATS_JS_SOURCE() +
+                                   " = false;",
+                     std::nullopt, nullptr);
+  return true;
+}
+
+ContentBlockerStats InAppWebView::getContentBlockerStats(bool reset) {
+  if (content_blocker_handler_ == nullptr) {
+    return ContentBlockerStats();
+  }
+  ContentBlockerStats stats = content_blocker_handler_->getStats();
+  if (reset) {
+    content_blocker_handler_->resetStats();
+  }
+  return stats;
+}
+
+bool InAppWebView::setLoadResourceFilter(const std::vector<std::string>& initiatorTypes,
+                                         const std::optional<std::string>& urlPattern,
+                                         double sampleRate) {
+  std::shared_ptr<GRegex> pattern;
+  if (urlPattern.has_value() && !urlPattern->empty()) {
+    GError* error = nullptr;
+    GRegex* regex = g_regex_new(urlPattern->c_str(), G_REGEX_OPTIMIZE,
+                                static_cast<GRegexMatchFlags>(0), &error);
+    if (regex == nullptr) {
+      errorLog("InAppWebView: invalid onLoadResource urlPattern '" + urlPattern.value() +
+               "': " + (error != nullptr ? error->message : ""));
+      if (error != nullptr) {
+        g_error_free(error);
+      }
+      return false;
+    }
+    pattern = std::shared_ptr<GRegex>(regex, g_regex_unref);
+  }
+
+  load_resource_initiator_types_ = initiatorTypes;
+  load_resource_url_pattern_ = std::move(pattern);
+  load_resource_sample_rate_ = std::clamp(sampleRate, 0.0, 1.0);
+  load_resource_sample_credit_ = 0.0;
+  return true;
+}
+
+bool InAppWebView::shouldReportLoadResource(const std::string& url, const std::string& initiatorType) {
+  if (!load_resource_initiator_types_.empty() &&
+      std::find(load_resource_initiator_types_.begin(), load_resource_initiator_types_.end(),
+                initiatorType) == load_resource_initiator_types_.end()) {
+    return false;
+  }
+  if (load_resource_url_pattern_ != nullptr &&
+      (url.size() > kLoadResourceFilterMaxUrlLength ||
+       !g_regex_match(load_resource_url_pattern_.get(), url.c_str(),
+                      static_cast<GRegexMatchFlags>(0), nullptr))) {
+    return false;
+  }
+  if (load_resource_sample_rate_ >= 1.0) {
+    return true;
+  }
+  // Deterministic sampling: keeps sampleRate of the matching resources, evenly spread
+  load_resource_sample_credit_ += load_resource_sample_rate_;
+  if (load_resource_sample_credit_ >= 1.0) {
+    load_resource_sample_credit_ -= 1.0;
+    return true;
+  }
+  return false;
+}
+
+void InAppWebView::setInterceptRequestRules(std::vector<InterceptRequestRule> rules) {
+  intercept_request_rules_.clear();
+  for (auto& rule : rules) {
+    if (rule.valid) {
+      intercept_request_rules_.push_back(std::move(rule));
+    }
+  }
+
+  if (user_content_controller_ == nullptr ||
+      (settings_ && !settings_->javaScriptBridgeEnabled)) {
+    return;
+  }
+
+  // The flag script makes the intercept scripts ask the rule table first,
+  // so it is only kept while there are rules
+  user_content_controller_->removePluginScriptsByGroupName(
+      InterceptAjaxRequestJS::INTERCEPT_REQUEST_RULES_JS_PLUGIN_SCRIPT_GROUP_NAME);
+  bool enabled = !intercept_request_rules_.empty();
+  if (enabled) {
+    user_content_controller_->addPluginScript(
+        InterceptAjaxRequestJS::INTERCEPT_REQUEST_RULES_JS_PLUGIN_SCRIPT(
+            settings_ ? settings_->pluginScriptsOriginAllowList : std::nullopt,
+            settings_ ? settings_->pluginScriptsForMainFrameOnly : false));
+  }
+  evaluateJavascript(InterceptAjaxRequestJS::FLAG_VARIABLE_FOR_NATIVE_INTERCEPT_RULES_JS_SOURCE() +
+                         " = " + (enabled ? "true" : "false") + ";",
+                     std::nullopt, nullptr);
+}
+
+void InAppWebView::setJavaScriptHandlerReplyOptions(int64_t timeoutMs, int64_t maxInFlight,
+                                                    int64_t maxQueued,
+                                                    ScriptMessageReplyOverflowPolicy overflowPolicy) {
+  script_message_reply_registry_.setTimeout(std::max<int64_t>(timeoutMs, 0));
+  script_message_reply_registry_.setMaxInFlight(static_cast<size_t>(std::max<int64_t>(maxInFlight, 0)));
+  script_message_reply_registry_.setMaxQueued(static_cast<size_t>(std::max<int64_t>(maxQueued, 0)));
+  script_message_reply_registry_.setOverflowPolicy(overflowPolicy);
+}
+
+// === Prepared scripts ===
+
+namespace {
+
+constexpr const char* kPreparedScriptsRegistry = "window.__flutter_inappwebview_prepared_scripts__";
+constexpr const char* kPreparedScriptMissing = "__flutter_inappwebview_prepared_script_missing__";
+
+// Small body sent on every call: looks up the compiled function in the page
+std::string buildPreparedScriptInvocation(int64_t handle) {
+  return "var __f = " + std::string(kPreparedScriptsRegistry) + " && " +
+         std::string(kPreparedScriptsRegistry) + "[" + std::to_string(handle) + "];\n"
+         "if (typeof __f !== 'function') { throw new Error('" + kPreparedScriptMissing + "'); }\n"
+         "return await __f(__args__);";
+}
+
+// Full body sent only when the page (or content world) doesn't know the handle yet,
+// e.g. the first call or the first call after a navigation
+std::string buildPreparedScriptDefinition(int64_t handle, const PreparedScript& script) {
+  std::string body =
+      "if (" + std::string(kPreparedScriptsRegistry) + " === undefined) {\n"
+      "  Object.defineProperty(window, '__flutter_inappwebview_prepared_scripts__', "
+      "{value: {}, enumerable: false});\n"
+      "}\n" +
+      std::string(kPreparedScriptsRegistry) + "[" + std::to_string(handle) +
+      "] = async function(__args__) {\n";
+  if (!script.argumentKeys.empty()) {
+    body += "const {";
+    for (size_t i = 0; i < script.argumentKeys.size(); i++) {
+      if (i > 0) body += ", ";
+      body += script.argumentKeys[i];
+    }
+    body += "} = JSON.parse(__args__);\n";
+  }
+  body += script.functionBody;
+  body += "\n};\n";
+  return body + buildPreparedScriptInvocation(handle);
+}
+
+}  // namespace
+
+int64_t InAppWebView::prepareScript(const std::string& functionBody,
+                                    const std::vector<std::string>& argumentKeys,
+                                    const std::optional<std::string>& worldName) {
+  int64_t handle = next_prepared_script_id_++;
+  prepared_scripts_[handle] = PreparedScript{functionBody, argumentKeys, worldName};
+  return handle;
+}
+
+void InAppWebView::callPreparedScript(int64_t handle,
+                                      const std::string& argumentsJson,
+                                      std::function<void(const std::string&)> callback) {
+  auto it = prepared_scripts_.find(handle);
+  if (it == prepared_scripts_.end()) {
+    if (callback) {
+      callback(R"({"value":null,"error":"Unknown prepared script handle"})");
+    }
+    return;
+  }
+
+  // Arguments are destructured inside the compiled function, so the call itself passes no keys
+  std::optional<std::string> worldName = it->second.worldName;
+  callAsyncJavaScript(
+      buildPreparedScriptInvocation(handle), argumentsJson, {}, worldName,
+      [this, handle, argumentsJson, worldName,
+       callback = std::move(callback)](const std::string& jsonResult) {
+        if (jsonResult.find(kPreparedScriptMissing) == std::string::npos) {
+          if (callback)
+            callback(jsonResult);
+          return;
+        }
+
+        auto script = prepared_scripts_.find(handle);
+        if (script == prepared_scripts_.end()) {
+          if (callback)
+            callback(R"({"value":null,"error":"Unknown prepared script handle"})");
+          return;
+        }
+        callAsyncJavaScript(buildPreparedScriptDefinition(handle, script->second), argumentsJson, {},
+                            worldName, callback);
+      });
+}
+
+bool InAppWebView::disposePreparedScript(int64_t handle) {
+  auto it = prepared_scripts_.find(handle);
+  if (it == prepared_scripts_.end()) {
+    return false;
+  }
+  std::optional<std::string> worldName = it->second.worldName;
+  prepared_scripts_.erase(it);
+
+  // Drop the compiled function from the current page; later navigations won't recreate it
+  std::string source = "(function() { var s = " + std::string(kPreparedScriptsRegistry) +
+                       "; if (s) { delete s[" + std::to_string(handle) + "]; } })();";
+  evaluateJavascript(source, worldName, nullptr);
+  return true;
+}
+
+// === Multi-frame evaluation ===
+
+void InAppWebView::evaluateJavascriptInAllFrames(const std::string& source,
+                                                 const std::optional<std::string>& worldName,
+                                                 int64_t timeoutMs,
+                                                 std::function<void(const std::string&)> callback) {
+  int64_t id = next_frame_evaluation_id_++;
+  auto& request = frame_evaluation_requests_[id];
+  request.callback = std::move(callback);
+  // Main frame plus every subframe agent, including the busy ones
+  request.pending = 1 + frame_evaluation_agents_.size();
+
+  if (timeoutMs > 0) {
+    struct TimeoutData {
+      InAppWebView* self;
+      std::weak_ptr<bool> lifetime;
+      int64_t id;
+    };
+    request.timeout_source_id = g_timeout_add_full(
+        G_PRIORITY_DEFAULT, static_cast<guint>(timeoutMs),
+        [](gpointer user_data) -> gboolean {
+          auto* data = static_cast<TimeoutData*>(user_data);
+          if (data->lifetime.expired()) {
+            return G_SOURCE_REMOVE;
+          }
+          auto it = data->self->frame_evaluation_requests_.find(data->id);
+          if (it != data->self->frame_evaluation_requests_.end()) {
+            it->second.timeout_source_id = 0;
+            data->self->completeFrameEvaluation(data->id, true);
+          }
+          return G_SOURCE_REMOVE;
+        },
+        new TimeoutData{this, lifetime(), id},
+        [](gpointer user_data) { delete static_cast<TimeoutData*>(user_data); });
+  }
+
+  // Queue the command on every subframe agent: parked agents get it now, the
+  // busy ones once they report their current result
+  json command = {{"id", id}, {"source", source}};
+  std::string commandJson = command.dump();
+  for (auto& [token, agent] : frame_evaluation_agents_) {
+    agent.queue.emplace_back(id, commandJson);
+    dispatchFrameEvaluationCommand(agent);
+  }
+
+  // The main frame is evaluated directly, which also honors the content world
+  std::string url = getUrl().value_or("");
+  evaluateJavascript(source, worldName,
+                     [this, webViewLifetime = lifetime(), id,
+                      url](const std::optional<std::string>& result) {
+                       if (webViewLifetime.expired()) {
+                         return;
+                       }
+                       json value = nullptr;
+                       if (result.has_value()) {
+                         value = json::parse(result.value(), nullptr, false);
+                         if (value.is_discarded()) {
+                           value = nullptr;
+                         }
+                       }
+                       json frameResult = {{"isMainFrame", true},
+                                           {"url", url},
+                                           {"origin", get_origin_from_url(url)},
+                                           {"name", ""},
+                                           {"value", value},
+                                           {"error", nullptr}};
+                       addFrameEvaluationResult(id, frameResult.dump());
+                     });
+}
+
+void InAppWebView::dispatchFrameEvaluationCommand(FrameEvaluationAgent& agent) {
+  if (agent.reply == nullptr || agent.running_id != 0) {
+    return;
+  }
+  while (!agent.queue.empty()) {
+    auto [id, commandJson] = std::move(agent.queue.front());
+    agent.queue.pop_front();
+    if (frame_evaluation_requests_.count(id) == 0) {
+      // Completed meanwhile (e.g. timed out)
+      continue;
+    }
+    agent.running_id = id;
+    // Resolving releases the parked reference
+    WebKitScriptMessageReply* reply = agent.reply;
+    agent.reply = nullptr;
+    ResolveInternalHandlerWithReply(reply, commandJson);
+    return;
+  }
+}
+
+void InAppWebView::handleFrameEvaluationMessage(const std::string& argsJsonStr,
+                                                WebKitScriptMessageReply* reply) {
+  json frameInfo;
+  json result;
+  try {
+    json argsJson = json::parse(argsJsonStr);
+    if (argsJson.is_array() && !argsJson.empty()) {
+      frameInfo = argsJson[0];
+      if (argsJson.size() > 1) {
+        result = argsJson[1];
+      }
+    }
+  } catch (const json::parse_error& e) {
+    debugLog("_frameEvaluation: JSON parse error: " + std::string(e.what()));
+  }
+
+  if (!frameInfo.is_object() || !frameInfo.contains("token") || !frameInfo["token"].is_string()) {
+    ResolveInternalHandlerWithReply(reply, "null");
+    return;
+  }
+  std::string token = frameInfo["token"].get<std::string>();
+
+  auto existing = frame_evaluation_agents_.find(token);
+  if (frameInfo.value("detach", false)) {
+    if (existing != frame_evaluation_agents_.end()) {
+      FrameEvaluationAgent agent = std::move(existing->second);
+      frame_evaluation_agents_.erase(existing);
+      if (agent.reply != nullptr) {
+        webkit_script_message_reply_unref(agent.reply);
+      }
+      // The requests waiting for this frame don't wait for the timeout
+      if (agent.running_id != 0) {
+        addFrameEvaluationResult(agent.running_id, std::nullopt);
+      }
+      for (const auto& [id, commandJson] : agent.queue) {
+        addFrameEvaluationResult(id, std::nullopt);
+      }
+    }
+    ResolveInternalHandlerWithReply(reply, "null");
+    return;
+  }
+
+  FrameEvaluationAgent& agent = frame_evaluation_agents_[token];
+  if (existing == frame_evaluation_agents_.end()) {
+    agent.url = frameInfo.value("url", "");
+    agent.origin = frameInfo.value("origin", "");
+    agent.name = frameInfo.value("name", "");
+  }
+
+  // Only the result of the command this agent received is accepted, so a
+  // frame can't answer for another one
+  if (result.is_object() && result.contains("id") && result["id"].is_number_integer() &&
+      agent.running_id != 0 && result["id"].get<int64_t>() == agent.running_id) {
+    int64_t id = agent.running_id;
+    agent.running_id = 0;
+    json error = result.contains("error") ? result["error"] : json(nullptr);
+    json frameResult = {{"isMainFrame", false},
+                        {"url", agent.url},
+                        {"origin", agent.origin},
+                        {"name", agent.name},
+                        {"value", result.contains("value") ? result["value"] : json(nullptr)},
+                        {"error", error}};
+    addFrameEvaluationResult(id, frameResult.dump());
+  }
+
+  // Park the frame until its next command (add ref to keep it alive); an
+  // earlier parked call from the same frame is dropped
+  if (agent.reply != nullptr) {
+    webkit_script_message_reply_unref(agent.reply);
+  }
+  agent.reply = reply;
+  webkit_script_message_reply_ref(reply);
+  dispatchFrameEvaluationCommand(agent);
+}
+
+void InAppWebView::addFrameEvaluationResult(int64_t id, std::optional<std::string> result) {
+  auto it = frame_evaluation_requests_.find(id);
+  if (it == frame_evaluation_requests_.end()) {
+    // Already completed (e.g. timed out)
+    return;
+  }
+  if (result.has_value()) {
+    it->second.results.push_back(std::move(result.value()));
+  }
+  if (it->second.pending > 0) {
+    it->second.pending--;
+  }
+  if (it->second.pending == 0) {
+    completeFrameEvaluation(id, false);
+  }
+}
+
+void InAppWebView::completeFrameEvaluation(int64_t id, bool timedOut) {
+  auto it = frame_evaluation_requests_.find(id);
+  if (it == frame_evaluation_requests_.end()) {
+    return;
+  }
+  FrameEvaluationRequest request = std::move(it->second);
+  frame_evaluation_requests_.erase(it);
+
+  if (request.timeout_source_id != 0) {
+    g_source_remove(request.timeout_source_id);
+  }
+
+  std::string json_result = "{\"results\":[";
+  for (size_t i = 0; i < request.results.size(); i++) {
+    if (i > 0) json_result += ",";
+    json_result += request.results[i];
+  }
+  json_result += std::string("],\"timedOut\":") + (timedOut ? "true" : "false") + "}";
+
+  if (request.callback) {
+    request.callback(json_result);
+  }
+}
+
+void InAppWebView::releaseFrameEvaluationAgents() {
+  // Completing a request runs its callback, so don't iterate the member map
+  auto agents = std::move(frame_evaluation_agents_);
+  frame_evaluation_agents_.clear();
+  for (auto& [token, agent] : agents) {
+    if (agent.reply != nullptr) {
+      webkit_script_message_reply_unref(agent.reply);
+    }
+    // As on detach, the requests waiting for these frames don't wait for the timeout
+    if (agent.running_id != 0) {
+      addFrameEvaluationResult(agent.running_id, std::nullopt);
+    }
+    for (const auto& [id, commandJson] : agent.queue) {
+      addFrameEvaluationResult(id, std::nullopt);
+    }
+  }
+}
+
 void InAppWebView::injectJavascriptFileFromUrl(const std::string& urlFile) {
   std::string script =
       "(function() {"
@@ -2375,7 +2960,19 @@ void InAppWebView::disposeWebMessageChannel(const std::string& channelId) {
 // === HTML Content ===
 
 void InAppWebView::getHtml(std::function<void(const std::optional<std::string>&)> callback) {
-  evaluateJavascript("document.documentElement.outerHTML", std::nullopt, callback);
+  // Read the string straight out of the JSCValue instead of JSON-quoting it
+  evaluateJavascriptRaw("document.documentElement.outerHTML", std::nullopt,
+                        [callback = std::move(callback)](JSCValue* js_result) {
+                          if (!callback) {
+                            return;
+                          }
+                          if (js_result == nullptr || !jsc_value_is_string(js_result)) {
+                            callback(std::nullopt);
+                            return;
+                          }
+                          g_autofree gchar* html = jsc_value_to_string(js_result);
+                          callback(html != nullptr ? std::optional<std::string>(html) : std::nullopt);
+                        });
 }
 
 // === Screenshot ===
@@ -2550,7 +3147,7 @@ void InAppWebView::scrollTo(int64_t x, int64_t y, bool animated) {
       animated ? "window.scrollTo({top: " + std::to_string(y) + ", left: " + std::to_string(x) +
                      ", behavior: 'smooth'});"
                : "window.scrollTo(" + std::to_string(x) + ", " + std::to_string(y) + ");";
-  evaluateJavascript(script, std::nullopt, nullptr);
+  runScrollScript(script);
 }
 
 void InAppWebView::scrollBy(int64_t x, int64_t y, bool animated) {
@@ -2558,7 +3155,21 @@ void InAppWebView::scrollBy(int64_t x, int64_t y, bool animated) {
       animated ? "window.scrollBy({top: " + std::to_string(y) + ", left: " + std::to_string(x) +
                      ", behavior: 'smooth'});"
                : "window.scrollBy(" + std::to_string(x) + ", " + std::to_string(y) + ");";
-  evaluateJavascript(script, std::nullopt, nullptr);
+  runScrollScript(script);
+}
+
+void InAppWebView::runScrollScript(const std::string& script) {
+  // The cached metrics no longer describe the page: the getters fall back to
+  // evaluating JavaScript (ordered after this script) until the page pushes
+  // metrics tagged with the new epoch. Pushes measured before the scroll still
+  // carry the old epoch and can't revalidate the cache.
+  scroll_metrics_.valid = false;
+  scroll_metrics_epoch_++;
+  std::string epoch = std::to_string(scroll_metrics_epoch_);
+  evaluateJavascript(script +
+                         "if (typeof window._flutterInAppWebViewScrollMetricsSync === 'function') "
+                         "window._flutterInAppWebViewScrollMetricsSync(" + epoch + ");",
+                     std::nullopt, nullptr);
 }
 
 void InAppWebView::getScrollX(std::function<void(int64_t)> callback) {
@@ -2567,6 +3178,11 @@ void InAppWebView::getScrollX(std::function<void(int64_t)> callback) {
     return;
   }
 
+  if (scroll_metrics_.valid) {
+    callback(scroll_metrics_.scrollX);
+    return;
+  }
+
   evaluateJavascript(
       "window.scrollX || window.pageXOffset || document.documentElement.scrollLeft || 0",
       std::nullopt,
@@ -2589,6 +3205,11 @@ void InAppWebView::getScrollY(std::function<void(int64_t)> callback) {
     return;
   }
 
+  if (scroll_metrics_.valid) {
+    callback(scroll_metrics_.scrollY);
+    return;
+  }
+
   evaluateJavascript(
       "window.scrollY || window.pageYOffset || document.documentElement.scrollTop || 0",
       std::nullopt,
@@ -2611,6 +3232,11 @@ void InAppWebView::canScrollVertically(std::function<void(bool)> callback) {
     return;
   }
 
+  if (scroll_metrics_.valid) {
+    callback(scroll_metrics_.contentHeight > scroll_metrics_.viewportHeight);
+    return;
+  }
+
   evaluateJavascript(
       "document.documentElement.scrollHeight > document.documentElement.clientHeight",
       std::nullopt,
@@ -2629,6 +3255,11 @@ void InAppWebView::canScrollHorizontally(std::function<void(bool)> callback) {
     return;
   }
 
+  if (scroll_metrics_.valid) {
+    callback(scroll_metrics_.contentWidth > scroll_metrics_.viewportWidth);
+    return;
+  }
+
   evaluateJavascript(
       "document.documentElement.scrollWidth > document.documentElement.clientWidth",
       std::nullopt,
@@ -2648,6 +3279,11 @@ void InAppWebView::getContentHeight(std::function<void(int64_t)> callback) {
     return;
   }
 
+  if (scroll_metrics_.valid) {
+    callback(scroll_metrics_.contentHeight);
+    return;
+  }
+
   // Use JavaScript to get the document's scroll height
   evaluateJavascript(
       "Math.max(document.body.scrollHeight, document.documentElement.scrollHeight)",
@@ -2671,6 +3307,11 @@ void InAppWebView::getContentWidth(std::function<void(int64_t)> callback) {
     return;
   }
 
+  if (scroll_metrics_.valid) {
+    callback(scroll_metrics_.contentWidth);
+    return;
+  }
+
   // Use JavaScript to get the document's scroll width
   evaluateJavascript(
       "Math.max(document.body.scrollWidth, document.documentElement.scrollWidth)",
@@ -2689,6 +3330,46 @@ void InAppWebView::getContentWidth(std::function<void(int64_t)> callback) {
       });
 }
 
+void InAppWebView::handleScrollMetricsMessage(const std::string& argsJsonStr) {
+  if (argsJsonStr.empty()) {
+    return;
+  }
+
+  ScrollMetrics metrics;
+  try {
+    json argsJson = json::parse(argsJsonStr);
+    if (!argsJson.is_array() || argsJson.empty() || !argsJson[0].is_object()) {
+      return;
+    }
+    const json& data = argsJson[0];
+    metrics.scrollX = data.value("scrollX", int64_t{0});
+    metrics.scrollY = data.value("scrollY", int64_t{0});
+    metrics.contentWidth = data.value("contentWidth", int64_t{0});
+    metrics.contentHeight = data.value("contentHeight", int64_t{0});
+    metrics.viewportWidth = data.value("viewportWidth", int64_t{0});
+    metrics.viewportHeight = data.value("viewportHeight", int64_t{0});
+    // Stale until the page measured after the last scrollTo/scrollBy
+    metrics.valid = data.value("epoch", int64_t{0}) == scroll_metrics_epoch_;
+  } catch (const json::exception& e) {
+    return;
+  }
+
+  ScrollMetrics previous = scroll_metrics_;
+  scroll_metrics_ = metrics;
+
+  if (channel_delegate_ == nullptr) {
+    return;
+  }
+  if (metrics.scrollX != previous.scrollX || metrics.scrollY != previous.scrollY) {
+    channel_delegate_->onScrollChanged(metrics.scrollX, metrics.scrollY);
+  }
+  if (metrics.contentWidth != previous.contentWidth ||
+      metrics.contentHeight != previous.contentHeight) {
+    channel_delegate_->onContentSizeChanged(previous.contentWidth, previous.contentHeight,
+                                            metrics.contentWidth, metrics.contentHeight);
+  }
+}
+
 // === Settings ===
 
 FlValue* InAppWebView::getSettings() const {
@@ -3077,10 +3758,71 @@ void InAppWebView::SetTextureOffset(double x, double y) {
 }
 
 void InAppWebView::SetCursorPos(double x, double y) {
+  // A pending scroll happened at the previous cursor position
+  if (coalesced_input_.has_scroll) {
+    FlushCoalescedInput();
+  }
+
   // Store logical coordinates
   cursor_x_ = x;
   cursor_y_ = y;
 
+  // Moves are merged until the next display frame: WebKit can't show more
+  // hit-test results than frames, and high polling rate mice send many more
+  coalesced_input_.has_move = true;
+  coalesced_input_.move_x = x;
+  coalesced_input_.move_y = y;
+  ScheduleCoalescedInputFlush();
+}
+
+void InAppWebView::ScheduleCoalescedInputFlush() {
+  if (coalesced_input_source_id_ != 0) {
+    return;
+  }
+
+  // Target refresh rate is in mHz
+  uint32_t refresh_rate = getTargetRefreshRate();
+  gint64 frame_interval = 1000000000LL / (refresh_rate > 0 ? refresh_rate : 60000);
+  gint64 elapsed = g_get_monotonic_time() - last_input_flush_time_;
+  if (elapsed >= frame_interval) {
+    // Nothing was sent during the current frame, don't add latency
+    FlushCoalescedInput();
+    return;
+  }
+
+  guint delay_ms = static_cast<guint>((frame_interval - elapsed + 999) / 1000);
+  coalesced_input_source_id_ = g_timeout_add_full(
+      G_PRIORITY_HIGH, delay_ms,
+      [](gpointer user_data) -> gboolean {
+        auto* self = static_cast<InAppWebView*>(user_data);
+        self->coalesced_input_source_id_ = 0;
+        self->FlushCoalescedInput();
+        return G_SOURCE_REMOVE;
+      },
+      this, nullptr);
+}
+
+void InAppWebView::FlushCoalescedInput() {
+  if (!coalesced_input_.has_move && !coalesced_input_.has_scroll) {
+    return;
+  }
+  if (coalesced_input_source_id_ != 0) {
+    g_source_remove(coalesced_input_source_id_);
+    coalesced_input_source_id_ = 0;
+  }
+  last_input_flush_time_ = g_get_monotonic_time();
+
+  CoalescedInput pending = coalesced_input_;
+  coalesced_input_ = CoalescedInput();
+  if (pending.has_move) {
+    DispatchPointerMove(pending.move_x, pending.move_y);
+  }
+  if (pending.has_scroll) {
+    DispatchScroll(pending.scroll_dx, pending.scroll_dy);
+  }
+}
+
+void InAppWebView::DispatchPointerMove(double x, double y) {
 #ifdef HAVE_WPE_PLATFORM
   // Send pointer motion event using WPEPlatform API
   if (wpe_view_ != nullptr) {
@@ -3117,6 +3859,9 @@ void InAppWebView::SetCursorPos(double x, double y) {
 }
 
 void InAppWebView::SetPointerButton(int kind, int button, int clickCount) {
+  // Button transitions must reach WebKit after the moves that preceded them
+  FlushCoalescedInput();
+
   // Hide all popups on any button DOWN (kind=1 is Down per WpePointerEventKind enum)
   if (kind == static_cast<int>(WpePointerEventKind::Down)) {
     HideAllPopups();
@@ -3294,6 +4039,19 @@ void InAppWebView::SetScrollDelta(double dx, double dy) {
   // Hide all popups when scrolling
   HideAllPopups();
 
+  // A pending move must land first so the scroll targets the right element
+  if (coalesced_input_.has_move) {
+    FlushCoalescedInput();
+  }
+
+  // Deltas are summed until the next display frame
+  coalesced_input_.has_scroll = true;
+  coalesced_input_.scroll_dx += dx;
+  coalesced_input_.scroll_dy += dy;
+  ScheduleCoalescedInputFlush();
+}
+
+void InAppWebView::DispatchScroll(double dx, double dy) {
 #ifdef HAVE_WPE_PLATFORM
   if (wpe_view_ == nullptr)
     return;
@@ -3357,6 +4115,9 @@ void InAppWebView::SetScrollDelta(double dx, double dy) {
 
 void InAppWebView::SendKeyEvent(int type, int64_t keyCode, int scanCode, int modifiers,
                                 const std::string& characters) {
+  // Keep key events ordered after pending pointer input
+  FlushCoalescedInput();
+
   // Intercept clipboard shortcuts on key down (type=0)
   // Modifiers: Control=1, Shift=2, Alt=4, Meta=8
   const bool isCtrl = (modifiers & 1) != 0;
@@ -3453,6 +4214,9 @@ void InAppWebView::SendKeyEvent(int type, int64_t keyCode, int scanCode, int mod
 void InAppWebView::SendTouchEvent(
     int type, int id, double x, double y,
     const std::vector<std::tuple<int, double, double, int>>& touchPoints) {
+  // Keep touch events ordered after pending pointer input
+  FlushCoalescedInput();
+
 #ifdef HAVE_WPE_PLATFORM
   if (wpe_view_ == nullptr)
     return;
@@ -3787,6 +4551,13 @@ void InAppWebView::OnLoadChanged(WebKitWebView* web_view, WebKitLoadEvent load_e
       // Redirects are handled internally by WebKit
       break;
     case WEBKIT_LOAD_COMMITTED:
+      // Subframes of the previous page are gone, and so are their pending results
+      self->releaseFrameEvaluationAgents();
+      // Scroll metrics describe the previous page until the new one reports them
+      self->scroll_metrics_.valid = false;
+      self->scroll_metrics_epoch_ = 0;
+      // Nobody is left to receive replies to handler calls from the previous page
+      self->script_message_reply_registry_.cancelAll("Page navigated away");
       // Notify that page content is starting to be visible
       self->channel_delegate_->onPageCommitVisible(self->getUrl().value_or(""));
       break;
@@ -7363,6 +8134,52 @@ bool InAppWebView::handleScriptMessageWithReply(const std::string& body, WebKitS
     return true;
   }
   
+  if (handlerName == "onConsoleMessages") {
+    // Batch of console messages, already filtered and rate limited by the page
+    std::vector<ConsoleMessageEntry> messages;
+    int64_t droppedCount = 0;
+
+    if (!argsJsonStr.empty()) {
+      try {
+        json argsJson = json::parse(argsJsonStr);
+        if (argsJson.is_array() && !argsJson.empty() && argsJson[0].is_object()) {
+          const json& batch = argsJson[0];
+          if (batch.contains("dropped") && batch["dropped"].is_number_integer()) {
+            droppedCount = batch["dropped"].get<int64_t>();
+          }
+          if (batch.contains("messages") && batch["messages"].is_array()) {
+            messages.reserve(batch["messages"].size());
+            for (const auto& item : batch["messages"]) {
+              if (!item.is_object()) {
+                continue;
+              }
+              std::string level = item.value("level", "log");
+              ConsoleMessageEntry entry;
+              entry.message = item.value("message", "");
+              entry.timestamp = item.value("timestamp", 0.0);
+              if (level == "debug") {
+                entry.messageLevel = 0;
+              } else if (level == "warn") {
+                entry.messageLevel = 2;
+              } else if (level == "error") {
+                entry.messageLevel = 3;
+              } else {
+                entry.messageLevel = 1;  // LOG
+              }
+              messages.push_back(std::move(entry));
+            }
+          }
+        }
+      } catch (const json::exception& e) {}
+    }
+
+    if (targetWebView->channel_delegate_ && (!messages.empty() || droppedCount > 0)) {
+      targetWebView->channel_delegate_->onConsoleMessages(messages, droppedCount);
+    }
+    ResolveInternalHandlerWithReply(reply, "null");
+    return true;
+  }
+
   if (handlerName == "onLoadResource") {
     // Handle resource load tracking
     std::string url = "";
@@ -7391,13 +8208,91 @@ bool InAppWebView::handleScriptMessageWithReply(const std::string& body, WebKitS
       } catch (const json::parse_error& e) {}
     }
 
-    if (targetWebView->channel_delegate_) {
+    if (targetWebView->channel_delegate_ && targetWebView->shouldReportLoadResource(url, initiatorType)) {
       targetWebView->channel_delegate_->onLoadResource(url, initiatorType, startTime, duration);
     }
     ResolveInternalHandlerWithReply(reply, "null");
     return true;
   }
 
+  if (handlerName == "onContentBlockerResources") {
+    // Batch of {failed: [url], loaded: [{url, size}]} from ContentBlockerStatsJS
+    ContentBlockerHandler* handler = targetWebView->content_blocker_handler_.get();
+    if (handler != nullptr && handler->isInstrumentationEnabled() && !argsJsonStr.empty()) {
+      try {
+        json argsJson = json::parse(argsJsonStr);
+        if (argsJson.is_array() && !argsJson.empty() && argsJson[0].is_object()) {
+          const json& batch = argsJson[0];
+          // Sizes first, so that a resource that failed after loading once is estimated
+          if (batch.contains("loaded") && batch["loaded"].is_array()) {
+            for (const auto& item : batch["loaded"]) {
+              if (item.is_object() && item.contains("url") && item["url"].is_string() &&
+                  item.contains("size") && item["size"].is_number()) {
+                handler->recordLoadedResource(item["url"].get<std::string>(),
+                                              item["size"].get<int64_t>());
+              }
+            }
+          }
+          if (batch.contains("failed") && batch["failed"].is_array()) {
+            std::vector<std::string> failed;
+            failed.reserve(batch["failed"].size());
+            for (const auto& item : batch["failed"]) {
+              if (item.is_string()) {
+                failed.push_back(item.get<std::string>());
+              }
+            }
+            // Matched against the block rules off the main thread
+            handler->recordFailedResources(failed);
+          }
+        }
+      } catch (const json::exception& e) {}
+    }
+    ResolveInternalHandlerWithReply(reply, "null");
+    return true;
+  }
+
+  if (handlerName == "onLoadResources") {
+    // All entries of one PerformanceObserver callback
+    std::vector<LoadResourceEntry> resources;
+
+    if (!argsJsonStr.empty()) {
+      try {
+        json argsJson = json::parse(argsJsonStr);
+        if (argsJson.is_array() && !argsJson.empty() && argsJson[0].is_array()) {
+          resources.reserve(argsJson[0].size());
+          for (const auto& item : argsJson[0]) {
+            if (!item.is_object()) {
+              continue;
+            }
+            LoadResourceEntry entry;
+            if (item.contains("url") && item["url"].is_string()) {
+              entry.url = item["url"].get<std::string>();
+            }
+            if (item.contains("initiatorType") && item["initiatorType"].is_string()) {
+              entry.initiatorType = item["initiatorType"].get<std::string>();
+            }
+            if (!targetWebView->shouldReportLoadResource(entry.url, entry.initiatorType)) {
+              continue;
+            }
+            if (item.contains("startTime") && item["startTime"].is_number()) {
+              entry.startTime = item["startTime"].get<double>();
+            }
+            if (item.contains("duration") && item["duration"].is_number()) {
+              entry.duration = item["duration"].get<double>();
+            }
+            resources.push_back(std::move(entry));
+          }
+        }
+      } catch (const json::exception& e) {}
+    }
+
+    if (targetWebView->channel_delegate_ && !resources.empty()) {
+      targetWebView->channel_delegate_->onLoadResources(resources);
+    }
+    ResolveInternalHandlerWithReply(reply, "null");
+    return true;
+  }
+
   if (handlerName == "onWebMessagePortMessageReceived") {
     // Handle WebMessageChannel port message
     std::string webMessageChannelId = "";
@@ -7524,6 +8419,12 @@ bool InAppWebView::handleScriptMessageWithReply(const std::string& body, WebKitS
     return true;
   }
 
+  if (handlerName == "_scrollMetricsChanged") {
+    targetWebView->handleScrollMetricsMessage(argsJsonStr);
+    ResolveInternalHandlerWithReply(reply, "null");
+    return true;
+  }
+
   if (handlerName == "_cursorChanged") {
     if (!argsJsonStr.empty()) {
       try {
@@ -7676,6 +8577,68 @@ bool InAppWebView::handleScriptMessageWithReply(const std::string& body, WebKitS
     return true;
   }
 
+  // === Internal Handler: _matchInterceptRequestRule ===
+  if (handlerName == "_matchInterceptRequestRule") {
+    // fetch()/XMLHttpRequest lookup in the native rule table; null falls back to Dart
+    std::string replyJson = "null";
+    if (!argsJsonStr.empty()) {
+      try {
+        json argsJson = json::parse(argsJsonStr);
+        if (argsJson.is_array() && !argsJson.empty() && argsJson[0].is_object()) {
+          const json& request = argsJson[0];
+          auto requestType = static_cast<InterceptRequestType>(request.value("requestType", 0));
+          std::string url = request.contains("url") && request["url"].is_string()
+                                ? request["url"].get<std::string>()
+                                : "";
+          std::string method = request.contains("method") && request["method"].is_string()
+                                   ? request["method"].get<std::string>()
+                                   : "GET";
+          // Rules only stand in for the interception callbacks that are enabled;
+          // scripts injected before a settings change may still ask
+          const auto& settings = targetWebView->settings_;
+          bool interceptionEnabled =
+              settings != nullptr && (requestType == InterceptRequestType::fetch
+                                          ? settings->useShouldInterceptFetchRequest
+                                          : settings->useShouldInterceptAjaxRequest);
+          for (const auto& rule : targetWebView->intercept_request_rules_) {
+            if (interceptionEnabled && rule.matches(requestType, url, method)) {
+              replyJson = rule.toReplyJson(url);
+              break;
+            }
+          }
+        }
+      } catch (const json::exception& e) {}
+    }
+    ResolveInternalHandlerWithReply(reply, replyJson);
+    return true;
+  }
+
+  // === Internal Handler: _loadPluginScript ===
+  if (handlerName == LazyPluginScriptJS::LOAD_PLUGIN_SCRIPT_HANDLER_NAME) {
+    // A lazy plugin script stub asking for its implementation; null if unknown
+    std::string replyJson = "null";
+    if (!argsJsonStr.empty()) {
+      try {
+        json argsJson = json::parse(argsJsonStr);
+        if (argsJson.is_array() && !argsJson.empty() && argsJson[0].is_string()) {
+          auto source = PluginScriptBundler::lazySource(argsJson[0].get<std::string>());
+          if (source.has_value()) {
+            replyJson = json(source.value()).dump();
+          }
+        }
+      } catch (const json::exception& e) {}
+    }
+    ResolveInternalHandlerWithReply(reply, replyJson);
+    return true;
+  }
+
+  // === Internal Handler: _frameEvaluation ===
+  if (handlerName == "_frameEvaluation") {
+    // Subframe agent reporting a result and/or parking itself for the next evaluation
+    targetWebView->handleFrameEvaluationMessage(argsJsonStr, reply);
+    return true;
+  }
+
   // === Internal Handler: _onPrintRequest ===
   if (handlerName == "_onPrintRequest") {
     // Print request from JavaScript (window.print() interception)
@@ -7709,37 +8672,67 @@ bool InAppWebView::handleScriptMessageWithReply(const std::string& body, WebKitS
 
   // === External Handler - Send to Dart ===
   if (targetWebView->channel_delegate_) {
-    auto data = std::make_unique<JavaScriptHandlerFunctionData>(
-        sourceOrigin, requestUrl, isMainFrame, argsJsonStr);
+    InAppWebView* capturedTargetWebView = targetWebView;
+    std::weak_ptr<bool> webViewLifetime = targetWebView->lifetime();
+
+    // The registry holds the reply (bounded by timeout and in-flight cap) and
+    // dispatches the call now or once a slot frees up
+    targetWebView->script_message_reply_registry_.submit(
+        reply, [capturedTargetWebView, webViewLifetime, handlerName, sourceOrigin, requestUrl,
+                isMainFrame, argsJsonStr](int64_t replyId) {
+          if (!capturedTargetWebView->channel_delegate_) {
+            capturedTargetWebView->script_message_reply_registry_.settle(
+                replyId, [capturedTargetWebView](WebKitScriptMessageReply* pendingReply) {
+                  capturedTargetWebView->RejectInternalHandlerWithReply(pendingReply,
+                                                                        "WebView disposed");
+                });
+            return;
+          }
 
-    auto callback = std::make_unique<WebViewChannelDelegate::CallJsHandlerCallback>();
+          auto data = std::make_unique<JavaScriptHandlerFunctionData>(
+              sourceOrigin, requestUrl, isMainFrame, argsJsonStr);
 
-    // Hold a reference to reply for async callback
-    webkit_script_message_reply_ref(reply);
-    InAppWebView* capturedTargetWebView = targetWebView;
+          auto callback = std::make_unique<WebViewChannelDelegate::CallJsHandlerCallback>();
 
-    callback->defaultBehaviour = [capturedTargetWebView, reply](
-        const std::optional<FlValue*>& response) {
-      std::string jsonResult = "null";
-      if (response.has_value() && response.value() != nullptr) {
-        FlValue* val = response.value();
-        if (fl_value_get_type(val) == FL_VALUE_TYPE_STRING) {
-          jsonResult = fl_value_get_string(val);
-        }
-      }
-      capturedTargetWebView->ResolveInternalHandlerWithReply(reply, jsonResult);
-    };
+          // Dart may answer after the WebView was disposed; the registry
+          // already rejected every pending reply at that point
+          callback->defaultBehaviour = [capturedTargetWebView, webViewLifetime, replyId](
+              const std::optional<FlValue*>& response) {
+            if (webViewLifetime.expired()) {
+              return;
+            }
+            std::string jsonResult = "null";
+            if (response.has_value() && response.value() != nullptr) {
+              FlValue* val = response.value();
+              if (fl_value_get_type(val) == FL_VALUE_TYPE_STRING) {
+                jsonResult = fl_value_get_string(val);
+              }
+            }
+            // No-op if the reply already expired or was cancelled
+            capturedTargetWebView->script_message_reply_registry_.settle(
+                replyId, [capturedTargetWebView, &jsonResult](WebKitScriptMessageReply* pendingReply) {
+                  capturedTargetWebView->ResolveInternalHandlerWithReply(pendingReply, jsonResult);
+                });
+          };
 
-    callback->error = [capturedTargetWebView, reply](
-        const std::string& code, const std::string& message) {
-      std::string errorMessage = code;
-      if (!message.empty()) {
-        errorMessage += ", " + message;
-      }
-      capturedTargetWebView->RejectInternalHandlerWithReply(reply, errorMessage);
-    };
+          callback->error = [capturedTargetWebView, webViewLifetime, replyId](
+              const std::string& code, const std::string& message) {
+            if (webViewLifetime.expired()) {
+              return;
+            }
+            std::string errorMessage = code;
+            if (!message.empty()) {
+              errorMessage += ", " + message;
+            }
+            capturedTargetWebView->script_message_reply_registry_.settle(
+                replyId, [capturedTargetWebView, &errorMessage](WebKitScriptMessageReply* pendingReply) {
+                  capturedTargetWebView->RejectInternalHandlerWithReply(pendingReply, errorMessage);
+                });
+          };
 
-    targetWebView->channel_delegate_->onCallJsHandler(handlerName, std::move(data), std::move(callback));
+          capturedTargetWebView->channel_delegate_->onCallJsHandler(handlerName, std::move(data),
+                                                                    std::move(callback));
+        });
     return true;  // We will reply asynchronously
   }
 
@@ -7891,6 +8884,12 @@ void InAppWebView::RegisterCustomSchemes() {
 
 void InAppWebView::OnCustomSchemeRequest(WebKitURISchemeRequest* request, gpointer user_data) {
   auto* self = static_cast<InAppWebView*>(user_data);
+
+  // Schemes mounted on a directory are answered without the Dart round trip
+  if (self != nullptr && self->custom_scheme_file_handler_.handle(request)) {
+    return;
+  }
+
   if (self == nullptr || self->webview_ == nullptr || self->channel_delegate_ == nullptr) {
     // Finish with error if we can't handle it
     g_autoptr(GError) error =
@@ -7909,27 +8908,11 @@ void InAppWebView::OnCustomSchemeRequest(WebKitURISchemeRequest* request, gpoint
   std::optional<std::string> method_str =
       http_method != nullptr ? std::optional<std::string>(http_method) : std::nullopt;
 
-  // Get HTTP headers if available
-  std::optional<std::map<std::string, std::string>> headers_map = std::nullopt;
+  // Header names are interned by HttpHeaders, only the values are copied
   SoupMessageHeaders* headers = webkit_uri_scheme_request_get_http_headers(request);
-  if (headers != nullptr) {
-    std::map<std::string, std::string> hdrs;
-    SoupMessageHeadersIter iter;
-    const char* name;
-    const char* value;
-    soup_message_headers_iter_init(&iter, headers);
-    while (soup_message_headers_iter_next(&iter, &name, &value)) {
-      if (name != nullptr && value != nullptr) {
-        hdrs[name] = value;
-      }
-    }
-    if (!hdrs.empty()) {
-      headers_map = hdrs;
-    }
-  }
 
   auto webResourceRequest =
-      std::make_shared<WebResourceRequest>(url_str, method_str, headers_map, true);
+      std::make_shared<WebResourceRequest>(url_str, method_str, headers, true);
 
   // Hold a reference to the request while we wait for the Dart callback
   g_object_ref(request);
@@ -7938,23 +8921,24 @@ void InAppWebView::OnCustomSchemeRequest(WebKitURISchemeRequest* request, gpoint
   auto callback = std::make_unique<WebViewChannelDelegate::LoadResourceWithCustomSchemeCallback>();
 
   // Set up the nonNullSuccess handler to process the response
-  callback->nonNullSuccess = [request](const std::shared_ptr<CustomSchemeResponse>& response) -> bool {
-    if (response == nullptr || response->data.empty()) {
+  // Dart may answer after the WebView was disposed
+  std::weak_ptr<bool> webViewLifetime = self->lifetime();
+  callback->nonNullSuccess = [self, webViewLifetime,
+                              request](const std::shared_ptr<CustomSchemeResponse>& response) -> bool {
+    if (webViewLifetime.expired()) {
+      g_autoptr(GError) error =
+          g_error_new(G_IO_ERROR, G_IO_ERROR_CANCELLED, "WebView disposed");
+      webkit_uri_scheme_request_finish_error(request, error);
+    } else if (response != nullptr && response->stream) {
+      // Body is pulled from Dart chunk by chunk while WebKit reads it
+      self->StartCustomSchemeResponseStream(request, *response);
+    } else if (response == nullptr || response->data.empty()) {
       // No response provided - finish with error
       g_autoptr(GError) error =
           g_error_new(G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "Resource not found");
       webkit_uri_scheme_request_finish_error(request, error);
     } else {
-      // Create input stream from response data
-      GInputStream* stream =
-          g_memory_input_stream_new_from_data(g_memdup2(response->data.data(), response->data.size()),
-                                              response->data.size(), g_free);
-
-      // Finish the request with the response data
-      webkit_uri_scheme_request_finish(request, stream, response->data.size(),
-                                       response->contentType.c_str());
-
-      g_object_unref(stream);
+      FinishBufferedCustomSchemeRequest(request, *response);
     }
     g_object_unref(request);
     return false;  // Don't run defaultBehaviour
@@ -7981,6 +8965,172 @@ void InAppWebView::OnCustomSchemeRequest(WebKitURISchemeRequest* request, gpoint
   self->channel_delegate_->onLoadResourceWithCustomScheme(webResourceRequest, std::move(callback));
 }
 
+void InAppWebView::FinishCustomSchemeRequest(WebKitURISchemeRequest* request, GInputStream* stream,
+                                             gint64 length, const CustomSchemeResponse& response) {
+  WebKitURISchemeResponse* schemeResponse = webkit_uri_scheme_response_new(stream, length);
+  webkit_uri_scheme_response_set_content_type(schemeResponse, response.contentType.c_str());
+  if (response.statusCode.has_value()) {
+    webkit_uri_scheme_response_set_status(
+        schemeResponse, static_cast<guint>(response.statusCode.value()),
+        response.reasonPhrase.has_value() ? response.reasonPhrase->c_str() : nullptr);
+  }
+  if (response.headers.has_value()) {
+    SoupMessageHeaders* headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+    response.headers->appendTo(headers);
+    // Takes ownership of headers
+    webkit_uri_scheme_response_set_http_headers(schemeResponse, headers);
+  }
+  webkit_uri_scheme_request_finish_with_response(request, schemeResponse);
+  g_object_unref(schemeResponse);
+}
+
+void InAppWebView::FinishBufferedCustomSchemeRequest(WebKitURISchemeRequest* request,
+                                                     CustomSchemeResponse& response) {
+  gsize size = response.data.size();
+  gsize start = 0;
+  gsize end = size - 1;
+  bool unsatisfiable = false;
+
+  // Single byte-range requests are answered here (206 or 416), unless the
+  // handler already built a partial response itself
+  bool handlerAnsweredRange =
+      (response.statusCode.has_value() && response.statusCode.value() != 200) ||
+      (response.headers.has_value() && response.headers->get("Content-Range").has_value());
+  SoupMessageHeaders* requestHeaders = webkit_uri_scheme_request_get_http_headers(request);
+  if (!handlerAnsweredRange && requestHeaders != nullptr &&
+      CustomSchemeFileHandler::parseRange(soup_message_headers_get_one(requestHeaders, "Range"),
+                                          size, start, end, unsatisfiable)) {
+    if (!response.headers.has_value()) {
+      response.headers = HttpHeaders();
+    }
+    response.headers->set("Accept-Ranges", "bytes");
+    response.reasonPhrase = std::nullopt;
+    if (unsatisfiable) {
+      response.statusCode = 416;
+      response.headers->set("Content-Range", "bytes */" + std::to_string(size));
+      g_autoptr(GInputStream) empty = g_memory_input_stream_new();
+      FinishCustomSchemeRequest(request, empty, 0, response);
+      return;
+    }
+    response.statusCode = 206;
+    response.headers->set("Content-Range", "bytes " + std::to_string(start) + "-" +
+                                               std::to_string(end) + "/" + std::to_string(size));
+  }
+
+  gsize length = end - start + 1;
+  g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_data(
+      g_memdup2(response.data.data() + start, length), length, g_free);
+  FinishCustomSchemeRequest(request, stream, length, response);
+}
+
+void InAppWebView::StartCustomSchemeResponseStream(WebKitURISchemeRequest* request,
+                                                   const CustomSchemeResponse& response) {
+  int64_t streamId = response.streamId;
+  auto stream = std::make_unique<CustomSchemeResponseStream>();
+  if (!stream->isValid() ||
+      custom_scheme_response_streams_.find(streamId) != custom_scheme_response_streams_.end()) {
+    g_autoptr(GError) error =
+        g_error_new(G_IO_ERROR, G_IO_ERROR_FAILED, "Unable to stream the response");
+    webkit_uri_scheme_request_finish_error(request, error);
+    if (channel_delegate_) {
+      channel_delegate_->onCustomSchemeResponseStreamClosed(streamId, false);
+    }
+    return;
+  }
+
+  stream->setNeedDataCallback([this, streamId]() { PullCustomSchemeResponseStream(streamId); });
+  stream->setClosedCallback([this, streamId](bool completed) {
+    if (channel_delegate_) {
+      channel_delegate_->onCustomSchemeResponseStreamClosed(streamId, completed);
+    }
+    ScheduleCustomSchemeStreamCleanup();
+  });
+
+  CustomSchemeResponseStream* rawStream = stream.get();
+  custom_scheme_response_streams_[streamId] = std::move(stream);
+
+  FinishCustomSchemeRequest(request, rawStream->inputStream(), response.contentLength, response);
+
+  // Starts pulling: the stream is empty, so it asks for the first chunk
+  rawStream->write(nullptr, 0);
+}
+
+void InAppWebView::PullCustomSchemeResponseStream(int64_t streamId) {
+  auto it = custom_scheme_response_streams_.find(streamId);
+  if (it == custom_scheme_response_streams_.end()) {
+    return;
+  }
+  if (channel_delegate_ == nullptr) {
+    it->second->cancel();
+    return;
+  }
+
+  auto callback =
+      std::make_unique<WebViewChannelDelegate::CustomSchemeResponseStreamPullCallback>();
+  // Dart may answer after the WebView (and its streams) were disposed
+  InAppWebView* self = this;
+  std::weak_ptr<bool> webViewLifetime = lifetime();
+  auto findStream = [self, webViewLifetime,
+                     streamId]() -> CustomSchemeResponseStream* {
+    if (webViewLifetime.expired()) {
+      return nullptr;
+    }
+    auto it = self->custom_scheme_response_streams_.find(streamId);
+    return it != self->custom_scheme_response_streams_.end() ? it->second.get() : nullptr;
+  };
+
+  callback->nonNullSuccess = [findStream](FlValue* chunk) {
+    if (auto* stream = findStream()) {
+      stream->write(fl_value_get_uint8_list(chunk), fl_value_get_length(chunk));
+    }
+    return false;
+  };
+
+  callback->nullSuccess = [findStream]() {
+    if (auto* stream = findStream()) {
+      stream->finish();
+    }
+    return false;
+  };
+
+  // Errors (and a missing Dart handler) cut the body short
+  callback->defaultBehaviour = [findStream](std::optional<FlValue*>) {
+    if (auto* stream = findStream()) {
+      stream->cancel();
+    }
+  };
+  callback->error = [findStream, streamId](const std::string& code, const std::string& message) {
+    debugLog("Custom scheme response stream " + std::to_string(streamId) + " failed: " + code +
+             " " + message);
+    if (auto* stream = findStream()) {
+      stream->cancel();
+    }
+  };
+
+  channel_delegate_->onCustomSchemeResponseStreamPull(streamId, std::move(callback));
+}
+
+void InAppWebView::ScheduleCustomSchemeStreamCleanup() {
+  if (custom_scheme_stream_cleanup_source_id_ != 0) {
+    return;
+  }
+  custom_scheme_stream_cleanup_source_id_ = g_idle_add(
+      [](gpointer user_data) -> gboolean {
+        auto* self = static_cast<InAppWebView*>(user_data);
+        self->custom_scheme_stream_cleanup_source_id_ = 0;
+        auto& streams = self->custom_scheme_response_streams_;
+        for (auto it = streams.begin(); it != streams.end();) {
+          if (it->second->isClosed()) {
+            it = streams.erase(it);
+          } else {
+            ++it;
+          }
+        }
+        return G_SOURCE_REMOVE;
+      },
+      this);
+}
+
 }  // namespace flutter_inappwebview_plugin
 
 #ifdef HAVE_WPE_BACKEND_LEGACY
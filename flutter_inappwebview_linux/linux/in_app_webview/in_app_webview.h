@@ -46,6 +46,7 @@
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
@@ -56,16 +57,22 @@
 #include <vector>
 
 #include "../content_blocker/content_blocker_handler.h"
+#include "../types/content_blocker_compile_result.h"
+#include "../types/content_blocker_stats.h"
 #include "../types/context_menu.h"
 #include "../types/context_menu_popup.h"
 #include "../types/option_menu_popup.h"
 #include "../types/find_session.h"
 #include "../types/hit_test_result.h"
+#include "../types/intercept_request_rule.h"
 #include "../types/ssl_certificate.h"
 #include "../types/url_request.h"
 #include "../types/user_script.h"
 #include "../find_interaction/find_interaction_controller.h"
+#include "custom_scheme_file_handler.h"
+#include "custom_scheme_response_stream.h"
 #include "in_app_webview_settings.h"
+#include "script_message_reply_registry.h"
 
 // Forward declaration of WPE types in global scope to avoid namespace conflicts
 #ifdef HAVE_WPE_BACKEND_LEGACY
@@ -74,6 +81,7 @@ struct wpe_fdo_egl_exported_image;
 
 namespace flutter_inappwebview_plugin {
 
+class CustomSchemeResponse;
 class InAppBrowser;
 class InAppWebViewManager;
 class PluginInstance;
@@ -116,6 +124,22 @@ enum class WpePointerEventKind {
 // Pointer button type (matches Dart side)
 enum class WpePointerButton { None = 0, Primary = 1, Secondary = 2, Tertiary = 3 };
 
+// How evaluateJavascript results are delivered to Dart (matches Dart side)
+enum class EvaluateJavascriptResultMode {
+  Json = 0,         // JSON string decoded on the Dart side (default)
+  Value = 1,        // Native FlValue tree, no JSON round-trip
+  ChunkedJson = 2   // JSON string streamed in chunks via onEvaluateJavascriptResultChunk
+};
+
+// A function body registered once through prepareScript() and then invoked by
+// handle. The compiled function lives in the page (per content world) so that
+// later calls only transfer their JSON arguments.
+struct PreparedScript {
+  std::string functionBody;
+  std::vector<std::string> argumentKeys;
+  std::optional<std::string> worldName;
+};
+
 /// InAppWebView - WPE WebKit based implementation
 ///
 /// This class provides offscreen web rendering using WPE WebKit.
@@ -125,12 +149,21 @@ class InAppWebView {
  public:
   static constexpr const char* METHOD_CHANNEL_NAME_PREFIX =
       "com.pichillilorenzo/flutter_inappwebview_";
+  // Default slice size used by evaluateJavascriptChunked
+  static constexpr size_t kDefaultEvaluateJavascriptChunkSize = 256 * 1024;
+  // Smallest slice: room for any UTF-8 sequence (4 bytes)
+  static constexpr size_t kMinEvaluateJavascriptChunkSize = 4;
+  // Longer URLs never match the onLoadResource urlPattern (see setLoadResourceFilter)
+  static constexpr size_t kLoadResourceFilterMaxUrlLength = 8192;
 
   InAppWebView(FlPluginRegistrar* registrar, FlBinaryMessenger* messenger, int64_t id,
                const InAppWebViewCreationParams& params);
   ~InAppWebView();
 
   int64_t id() const { return id_; }
+  // Expires when the webview is destroyed. Callbacks that can outlive it
+  // (Dart replies, main loop sources) check it before touching members.
+  std::weak_ptr<bool> lifetime() const { return lifetime_; }
   WebKitWebView* webview() const { return webview_; }
   WebViewChannelDelegate* channel_delegate() const { return channel_delegate_.get(); }
   FlPluginRegistrar* registrar() const { return registrar_; }
@@ -183,12 +216,83 @@ class InAppWebView {
   void evaluateJavascript(const std::string& source,
                           const std::optional<std::string>& worldName,
                           std::function<void(const std::optional<std::string>&)> callback);
+  // Converts the result straight into an FlValue tree (see utils/jsc.h).
+  // The FlValue passed to the callback is only valid for the duration of the
+  // call; it is nullptr, with error set, if the result could not be converted.
+  void evaluateJavascriptAsFlValue(const std::string& source,
+                                   const std::optional<std::string>& worldName,
+                                   std::function<void(FlValue*, const GError*)> callback);
+  // Serializes the result to JSON and hands it out in UTF-8 safe slices of at
+  // most chunkSize bytes, one per main loop iteration, so large results never
+  // need a single huge channel message and the receiver can decode them as they
+  // arrive. onComplete receives whether a result was produced and its total
+  // length in bytes; it is called with false if the webview is destroyed first.
+  void evaluateJavascriptChunked(const std::string& source,
+                                 const std::optional<std::string>& worldName,
+                                 size_t chunkSize,
+                                 std::function<void(const char*, size_t)> onChunk,
+                                 std::function<void(bool, size_t)> onComplete);
   void callAsyncJavaScript(
       const std::string& functionBody,
       const std::string& argumentsJson,
       const std::vector<std::string>& argumentKeys,
       const std::optional<std::string>& worldName,
       std::function<void(const std::string&)> callback);
+  // Console message filtering/batching done by the console log plugin script.
+  // minLevel: debug = 0, log/info = 1, warn = 2, error = 3; 0 disables rate limiting
+  void setConsoleMessageOptions(int64_t minLevel, int64_t maxMessagesPerSecond, int64_t batchInterval);
+
+  // Limits for JavaScript handler calls waiting for a Dart reply (0 = unlimited)
+  void setJavaScriptHandlerReplyOptions(int64_t timeoutMs, int64_t maxInFlight, int64_t maxQueued,
+                                        ScriptMessageReplyOverflowPolicy overflowPolicy);
+
+  // Filters resources reported to onLoadResource: only the given initiator types (empty = all)
+  // and URLs matching urlPattern are kept, then sampleRate (0..1) of them. URLs longer than
+  // kLoadResourceFilterMaxUrlLength are dropped when there is a urlPattern.
+  // Returns false if urlPattern is not a valid regular expression.
+  bool setLoadResourceFilter(const std::vector<std::string>& initiatorTypes,
+                             const std::optional<std::string>& urlPattern, double sampleRate);
+
+  // Native fetch()/XMLHttpRequest rule table, checked before shouldInterceptFetchRequest /
+  // shouldInterceptAjaxRequest. Invalid rules are dropped; an empty list disables the lookup.
+  void setInterceptRequestRules(std::vector<InterceptRequestRule> rules);
+
+  // Serves a custom scheme natively from directory, or from assetPrefix of the Flutter
+  // assets bundle. Both empty removes the mapping. Returns false if the root is not a directory.
+  bool setCustomSchemeFileSource(const std::string& scheme,
+                                 const std::optional<std::string>& directory,
+                                 const std::optional<std::string>& assetPrefix,
+                                 bool fallbackToDart);
+
+  // Named content blocker shards, applied alongside the contentBlockers setting. Updating a
+  // shard recompiles only that shard; an empty list removes it. callback gets the compile
+  // statistics, unsuccessful if no rule compiled (the shard is then removed).
+  void setContentBlockerShard(const std::string& shard, FlValue* contentBlockers,
+                              std::function<void(const ContentBlockerCompileResult&)> callback);
+  void removeContentBlockerShard(const std::string& shard);
+  std::vector<std::string> getContentBlockerShardNames() const;
+
+  // Content blocker hit statistics. Enabling injects a script reporting failed and loaded
+  // resources (in the current page too); the counters survive disabling.
+  bool setContentBlockerInstrumentation(bool enabled);
+  ContentBlockerStats getContentBlockerStats(bool reset);
+
+  // Prepared scripts - returns a handle usable with callPreparedScript()
+  int64_t prepareScript(const std::string& functionBody,
+                        const std::vector<std::string>& argumentKeys,
+                        const std::optional<std::string>& worldName);
+  // Same result format as callAsyncJavaScript; an unknown handle reports an error
+  void callPreparedScript(int64_t handle,
+                          const std::string& argumentsJson,
+                          std::function<void(const std::string&)> callback);
+  bool disposePreparedScript(int64_t handle);
+  // Evaluates source in the main frame and, through the frame evaluation agent,
+  // concurrently in every subframe. The callback receives a JSON string:
+  // {"results": [{"isMainFrame", "url", "origin", "name", "value", "error"}...], "timedOut": bool}
+  void evaluateJavascriptInAllFrames(const std::string& source,
+                                     const std::optional<std::string>& worldName,
+                                     int64_t timeoutMs,
+                                     std::function<void(const std::string&)> callback);
   void injectJavascriptFileFromUrl(const std::string& urlFile);
   void injectCSSCode(const std::string& source);
   void injectCSSFileFromUrl(const std::string& urlFile);
@@ -235,7 +339,8 @@ class InAppWebView {
   void canScrollVertically(std::function<void(bool)> callback);
   void canScrollHorizontally(std::function<void(bool)> callback);
 
-  // Content dimensions (async - via JavaScript)
+  // Content dimensions (answered from the scroll metrics cache when available,
+  // otherwise via JavaScript)
   void getContentHeight(std::function<void(int64_t)> callback);
   void getContentWidth(std::function<void(int64_t)> callback);
 
@@ -456,6 +561,7 @@ class InAppWebView {
   InAppWebViewManager* manager_ = nullptr;  // Manager reference for multi-window support
   int64_t id_ = 0;
   int64_t channel_id_ = -1;
+  std::shared_ptr<bool> lifetime_ = std::make_shared<bool>(true);  // see lifetime()
   std::string string_channel_id_;  // String-based channel ID for headless webviews
 
   // Settings
@@ -554,6 +660,65 @@ class InAppWebView {
   // JavaScript bridge secret for security
   std::string js_bridge_secret_;
 
+  // Console log plugin script options (see setConsoleMessageOptions)
+  int64_t console_min_level_ = 0;
+  int64_t console_max_messages_per_second_ = 0;
+  int64_t console_batch_interval_ = 0;
+
+  // Main frame scroll offset and content size pushed by the scroll metrics
+  // plugin script (see scroll_metrics_js.h); valid once the page reported them
+  struct ScrollMetrics {
+    bool valid = false;
+    int64_t scrollX = 0;
+    int64_t scrollY = 0;
+    int64_t contentWidth = 0;
+    int64_t contentHeight = 0;
+    int64_t viewportWidth = 0;
+    int64_t viewportHeight = 0;
+  };
+  ScrollMetrics scroll_metrics_;
+  // Bumped by scrollTo/scrollBy; pushed metrics only validate the cache once
+  // they carry the current epoch (reset with each new page)
+  int64_t scroll_metrics_epoch_ = 0;
+
+  // onLoadResource filter and sampling state (see setLoadResourceFilter)
+  std::vector<std::string> load_resource_initiator_types_;
+  std::shared_ptr<GRegex> load_resource_url_pattern_;  // nullptr keeps every URL
+  double load_resource_sample_rate_ = 1.0;
+  double load_resource_sample_credit_ = 0.0;
+
+  // fetch()/XMLHttpRequest interception rules (see setInterceptRequestRules)
+  std::vector<InterceptRequestRule> intercept_request_rules_;
+
+  // JavaScript handler calls waiting for a Dart reply
+  ScriptMessageReplyRegistry script_message_reply_registry_;
+
+  // Subframe agents by token (see frame_evaluation_js.h). An agent runs one
+  // command at a time: the others wait in its queue until it parks again.
+  struct FrameEvaluationAgent {
+    std::string url;
+    std::string origin;
+    std::string name;
+    WebKitScriptMessageReply* reply = nullptr;  // Parked call, null while evaluating
+    int64_t running_id = 0;                     // Request being evaluated, 0 if none
+    std::deque<std::pair<int64_t, std::string>> queue;  // Request id, command JSON
+  };
+  std::map<std::string, FrameEvaluationAgent> frame_evaluation_agents_;
+
+  // In-flight evaluateJavascriptInAllFrames calls
+  struct FrameEvaluationRequest {
+    std::function<void(const std::string&)> callback;
+    std::vector<std::string> results;  // Serialized per-frame result objects
+    size_t pending = 0;
+    guint timeout_source_id = 0;
+  };
+  std::map<int64_t, FrameEvaluationRequest> frame_evaluation_requests_;
+  int64_t next_frame_evaluation_id_ = 1;
+
+  // Prepared scripts by handle
+  std::map<int64_t, PreparedScript> prepared_scripts_;
+  int64_t next_prepared_script_id_ = 1;
+
   // Window ID for multi-window support
   std::optional<int64_t> window_id_;
 
@@ -579,6 +744,14 @@ class InAppWebView {
   // Pending custom scheme requests (for async handling)
   std::map<WebKitURISchemeRequest*, int64_t> pending_custom_scheme_requests_;
 
+  // Streamed custom scheme response bodies, keyed by the Dart stream id.
+  // Closed streams are destroyed from an idle callback.
+  std::map<int64_t, std::unique_ptr<CustomSchemeResponseStream>> custom_scheme_response_streams_;
+  guint custom_scheme_stream_cleanup_source_id_ = 0;
+
+  // Custom schemes served natively from a directory / the assets bundle
+  CustomSchemeFileHandler custom_scheme_file_handler_;
+
   // Frame available callback
   std::function<void()> on_frame_available_;
 
@@ -609,6 +782,20 @@ class InAppWebView {
   uint32_t button_state_ = 0;
   uint32_t current_modifiers_ = 0;  // Current keyboard modifiers (shift, ctrl, alt, meta)
 
+  // Pointer moves and scroll deltas waiting for the next display frame; consecutive
+  // moves keep the last position, consecutive scrolls sum their deltas
+  struct CoalescedInput {
+    bool has_move = false;
+    double move_x = 0;
+    double move_y = 0;
+    bool has_scroll = false;
+    double scroll_dx = 0;
+    double scroll_dy = 0;
+  };
+  CoalescedInput coalesced_input_;
+  guint coalesced_input_source_id_ = 0;
+  gint64 last_input_flush_time_ = 0;  // Monotonic time (us) of the last flush
+
   // Scroll multiplier
   double scroll_multiplier_ = 1.0;
 
@@ -712,6 +899,12 @@ class InAppWebView {
  private:
   static void OnFrameDisplayed(void* data);
 
+  // Input coalescing (see SetCursorPos/SetScrollDelta)
+  void ScheduleCoalescedInputFlush();
+  void FlushCoalescedInput();
+  void DispatchPointerMove(double x, double y);
+  void DispatchScroll(double dx, double dy);
+
   // Read pixels from EGL image to CPU buffer
   void ReadPixelsFromEglImage(void* egl_image, uint32_t width, uint32_t height);
 
@@ -795,12 +988,37 @@ class InAppWebView {
   void SendWpeAxisEvent(double x, double y, double dx, double dy);
   void SendWpeKeyboardEvent(uint32_t key, uint32_t state, uint32_t modifiers);
 
+  // === JavaScript ===
+  // Evaluates source and hands the raw JSCValue (nullptr on error) to the callback.
+  // The value is unreferenced once the callback returns.
+  void evaluateJavascriptRaw(const std::string& source,
+                             const std::optional<std::string>& worldName,
+                             std::function<void(JSCValue*)> callback);
+
   // === JavaScript bridge ===
   void dispatchPlatformReady();
+  void handleFrameEvaluationMessage(const std::string& argsJsonStr, WebKitScriptMessageReply* reply);
+  // nullopt when the frame went away before answering
+  void addFrameEvaluationResult(int64_t id, std::optional<std::string> result);
+  void dispatchFrameEvaluationCommand(FrameEvaluationAgent& agent);
+  void completeFrameEvaluation(int64_t id, bool timedOut);
+  void releaseFrameEvaluationAgents();
+  void handleScrollMetricsMessage(const std::string& argsJsonStr);
+  void runScrollScript(const std::string& script);
+  bool shouldReportLoadResource(const std::string& url, const std::string& initiatorType);
 
   // === Custom Scheme Handler ===
   void RegisterCustomSchemes();
   static void OnCustomSchemeRequest(WebKitURISchemeRequest* request, gpointer user_data);
+  static void FinishCustomSchemeRequest(WebKitURISchemeRequest* request, GInputStream* stream,
+                                        gint64 length, const CustomSchemeResponse& response);
+  // Finishes with response.data, answering single byte-range requests (206/416)
+  static void FinishBufferedCustomSchemeRequest(WebKitURISchemeRequest* request,
+                                                CustomSchemeResponse& response);
+  void StartCustomSchemeResponseStream(WebKitURISchemeRequest* request,
+                                       const CustomSchemeResponse& response);
+  void PullCustomSchemeResponseStream(int64_t streamId);
+  void ScheduleCustomSchemeStreamCleanup();
 
   // === Cursor detection ===
   void updateCursorFromCssStyle(const std::string& cursor_style);
@@ -6,6 +6,7 @@
 #include "../flutter_inappwebview_linux_plugin_private.h"
 #include "../plugin_instance.h"
 #include "../plugin_scripts_js/javascript_bridge_js.h"
+#include "../plugin_scripts_js/lazy_plugin_script_js.h"
 #include "../types/context_menu.h"
 #include "../utils/flutter.h"
 #include "../utils/log.h"
@@ -114,6 +115,21 @@ void InAppWebViewManager::HandleMethodCallImpl(FlMethodCall* method_call) {
     return;
   }
 
+  if (strcmp(method, "setLazyPluginScriptActivation") == 0) {
+    // Applies to the WebViews created afterwards
+    FlValue* args = fl_method_call_get_args(method_call);
+    LazyPluginScriptJS::set_LAZY_ACTIVATION_ENABLED(
+        get_fl_map_value<bool>(args, "enabled", false));
+    fl_method_call_respond_success(method_call, nullptr, nullptr);
+    return;
+  }
+
+  if (strcmp(method, "isLazyPluginScriptActivationEnabled") == 0) {
+    g_autoptr(FlValue) result = make_fl_value(LazyPluginScriptJS::get_LAZY_ACTIVATION_ENABLED());
+    fl_method_call_respond_success(method_call, result, nullptr);
+    return;
+  }
+
   if (strcmp(method, "disposeKeepAlive") == 0) {
     FlValue* args = fl_method_call_get_args(method_call);
     auto keepAliveIdOpt = get_optional_fl_map_value<std::string>(args, "keepAliveId");
@@ -0,0 +1,169 @@
+#include "script_message_reply_registry.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "../utils/log.h"
+
+namespace flutter_inappwebview_plugin {
+
+namespace {
+
+struct TimeoutData {
+  ScriptMessageReplyRegistry* registry;
+  int64_t id;
+};
+
+}  // namespace
+
+ScriptMessageReplyRegistry::~ScriptMessageReplyRegistry() {
+  cancelAll("WebView disposed");
+}
+
+bool ScriptMessageReplyRegistry::submit(WebKitScriptMessageReply* reply, DispatchCallback dispatch) {
+  if (reply == nullptr) {
+    return false;
+  }
+
+  bool hasSlot = max_in_flight_ == 0 || in_flight_.size() < max_in_flight_;
+  if (!hasSlot) {
+    bool canQueue = overflow_policy_ == ScriptMessageReplyOverflowPolicy::Queue &&
+                    (max_queued_ == 0 || queued_.size() < max_queued_);
+    if (!canQueue) {
+      debugLog("ScriptMessageReplyRegistry: too many pending JavaScript handler calls, rejecting");
+      webkit_script_message_reply_ref(reply);
+      rejectReply(reply, "Too many pending JavaScript handler calls");
+      return false;
+    }
+  }
+
+  int64_t id = next_id_++;
+  Entry entry;
+  entry.reply = reply;
+  webkit_script_message_reply_ref(reply);
+  entry.dispatch = std::move(dispatch);
+
+  if (!hasSlot) {
+    auto& queued = queued_entries_[id] = std::move(entry);
+    queued_.push_back(id);
+    startTimeout(id, queued);
+    return true;
+  }
+
+  auto& inFlight = in_flight_[id] = std::move(entry);
+  startTimeout(id, inFlight);
+  // Copy: the dispatch may synchronously complete and erase the entry
+  DispatchCallback callback = inFlight.dispatch;
+  if (callback) {
+    callback(id);
+  }
+  return true;
+}
+
+bool ScriptMessageReplyRegistry::settle(int64_t id, const SettleCallback& settleReply) {
+  auto it = in_flight_.find(id);
+  if (it == in_flight_.end()) {
+    return false;
+  }
+
+  WebKitScriptMessageReply* reply = it->second.reply;
+  if (it->second.timeout_source_id != 0) {
+    g_source_remove(it->second.timeout_source_id);
+  }
+  in_flight_.erase(it);
+
+  if (settleReply) {
+    settleReply(reply);
+  } else {
+    webkit_script_message_reply_unref(reply);
+  }
+
+  dispatchQueued();
+  return true;
+}
+
+void ScriptMessageReplyRegistry::cancelAll(const std::string& message) {
+  std::vector<Entry> entries;
+  for (auto& pair : in_flight_) {
+    entries.push_back(std::move(pair.second));
+  }
+  for (auto& pair : queued_entries_) {
+    entries.push_back(std::move(pair.second));
+  }
+  in_flight_.clear();
+  queued_entries_.clear();
+  queued_.clear();
+
+  for (auto& entry : entries) {
+    if (entry.timeout_source_id != 0) {
+      g_source_remove(entry.timeout_source_id);
+    }
+    rejectReply(entry.reply, message);
+  }
+}
+
+void ScriptMessageReplyRegistry::startTimeout(int64_t id, Entry& entry) {
+  if (timeout_ms_ <= 0) {
+    return;
+  }
+
+  auto* data = new TimeoutData{this, id};
+  entry.timeout_source_id = g_timeout_add_full(
+      G_PRIORITY_DEFAULT, static_cast<guint>(timeout_ms_),
+      [](gpointer user_data) -> gboolean {
+        auto* data = static_cast<TimeoutData*>(user_data);
+        data->registry->expire(data->id);
+        return G_SOURCE_REMOVE;
+      },
+      data, [](gpointer user_data) { delete static_cast<TimeoutData*>(user_data); });
+}
+
+void ScriptMessageReplyRegistry::expire(int64_t id) {
+  auto it = in_flight_.find(id);
+  if (it != in_flight_.end()) {
+    WebKitScriptMessageReply* reply = it->second.reply;
+    in_flight_.erase(it);
+    rejectReply(reply, "JavaScript handler call timed out");
+    dispatchQueued();
+    return;
+  }
+
+  auto queuedIt = queued_entries_.find(id);
+  if (queuedIt != queued_entries_.end()) {
+    WebKitScriptMessageReply* reply = queuedIt->second.reply;
+    queued_entries_.erase(queuedIt);
+    queued_.erase(std::remove(queued_.begin(), queued_.end(), id), queued_.end());
+    rejectReply(reply, "JavaScript handler call timed out");
+  }
+}
+
+void ScriptMessageReplyRegistry::dispatchQueued() {
+  while (!queued_.empty() && (max_in_flight_ == 0 || in_flight_.size() < max_in_flight_)) {
+    int64_t id = queued_.front();
+    queued_.pop_front();
+
+    auto it = queued_entries_.find(id);
+    if (it == queued_entries_.end()) {
+      continue;
+    }
+    auto& inFlight = in_flight_[id] = std::move(it->second);
+    queued_entries_.erase(it);
+
+    DispatchCallback callback = inFlight.dispatch;
+    if (callback) {
+      callback(id);
+    }
+  }
+}
+
+void ScriptMessageReplyRegistry::rejectReply(WebKitScriptMessageReply* reply,
+                                             const std::string& message) {
+  if (reply == nullptr) {
+    return;
+  }
+  webkit_script_message_reply_return_error_message(reply, message.c_str());
+  webkit_script_message_reply_unref(reply);
+}
+
+}  // namespace flutter_inappwebview_plugin
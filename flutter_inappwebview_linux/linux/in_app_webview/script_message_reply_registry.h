@@ -0,0 +1,86 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_SCRIPT_MESSAGE_REPLY_REGISTRY_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_SCRIPT_MESSAGE_REPLY_REGISTRY_H_
+
+// Per-webview registry of WebKitScriptMessageReply objects waiting for an
+// answer from Dart (JavaScript handler calls).
+//
+// Bounds the number of replies a page can keep alive:
+// - each pending reply can expire after a timeout and is then rejected
+// - the number of in-flight handler calls can be capped; calls over the cap
+//   are either rejected immediately or queued until a slot frees up
+// - all pending replies can be cancelled at once (navigation, dispose)
+
+#include <wpe/webkit.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace flutter_inappwebview_plugin {
+
+// What happens to a handler call when the in-flight cap is reached (matches Dart side)
+enum class ScriptMessageReplyOverflowPolicy { Reject = 0, Queue = 1 };
+
+class ScriptMessageReplyRegistry {
+ public:
+  // Dispatches a registered call to Dart; id is used later with settle()
+  using DispatchCallback = std::function<void(int64_t id)>;
+  // Answers a reply removed by settle(); must consume the reference it is given
+  using SettleCallback = std::function<void(WebKitScriptMessageReply* reply)>;
+
+  ScriptMessageReplyRegistry() = default;
+  ~ScriptMessageReplyRegistry();
+
+  ScriptMessageReplyRegistry(const ScriptMessageReplyRegistry&) = delete;
+  ScriptMessageReplyRegistry& operator=(const ScriptMessageReplyRegistry&) = delete;
+
+  // 0 disables the timeout / the in-flight cap
+  void setTimeout(int64_t timeoutMs) { timeout_ms_ = timeoutMs; }
+  void setMaxInFlight(size_t maxInFlight) { max_in_flight_ = maxInFlight; }
+  void setMaxQueued(size_t maxQueued) { max_queued_ = maxQueued; }
+  void setOverflowPolicy(ScriptMessageReplyOverflowPolicy policy) { overflow_policy_ = policy; }
+
+  // Registers reply (taking a reference) and dispatches it now or once a slot
+  // frees up. Returns false if the call was rejected because of the cap.
+  bool submit(WebKitScriptMessageReply* reply, DispatchCallback dispatch);
+
+  // Removes an in-flight entry and hands its reply to settleReply, which owns
+  // the reference. Queued calls are only dispatched after the reply was answered,
+  // so replies settle in order. Returns false (without calling settleReply) if
+  // the entry already expired or was cancelled.
+  bool settle(int64_t id, const SettleCallback& settleReply);
+
+  // Rejects every in-flight and queued reply with message
+  void cancelAll(const std::string& message);
+
+  size_t inFlightCount() const { return in_flight_.size(); }
+  size_t queuedCount() const { return queued_.size(); }
+
+ private:
+  struct Entry {
+    WebKitScriptMessageReply* reply = nullptr;
+    DispatchCallback dispatch;
+    guint timeout_source_id = 0;
+  };
+
+  int64_t timeout_ms_ = 0;
+  size_t max_in_flight_ = 0;
+  size_t max_queued_ = 0;
+  ScriptMessageReplyOverflowPolicy overflow_policy_ = ScriptMessageReplyOverflowPolicy::Reject;
+
+  int64_t next_id_ = 1;
+  std::map<int64_t, Entry> in_flight_;
+  std::map<int64_t, Entry> queued_entries_;
+  std::deque<int64_t> queued_;
+
+  void startTimeout(int64_t id, Entry& entry);
+  void expire(int64_t id);
+  void dispatchQueued();
+  static void rejectReply(WebKitScriptMessageReply* reply, const std::string& message);
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_SCRIPT_MESSAGE_REPLY_REGISTRY_H_
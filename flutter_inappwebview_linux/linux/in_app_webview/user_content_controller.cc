@@ -7,7 +7,6 @@
 
 #include <jsc/jsc.h>
 
-#include <algorithm>
 #include <nlohmann/json.hpp>
 
 #include "../utils/log.h"
@@ -48,6 +47,15 @@ UserContentController::~UserContentController() {
   if (manager_valid) {
     webkit_user_content_manager_remove_all_scripts(content_manager_);
   }
+  for (auto* wkScripts : {&document_start_webkit_scripts_, &document_end_webkit_scripts_,
+                          &plugin_webkit_scripts_}) {
+    for (WebKitUserScript* wkScript : *wkScripts) {
+      if (wkScript != nullptr) {
+        webkit_user_script_unref(wkScript);
+      }
+    }
+    wkScripts->clear();
+  }
 
   document_start_scripts_.clear();
   document_end_scripts_.clear();
@@ -59,78 +67,43 @@ void UserContentController::addUserScript(std::shared_ptr<UserScript> userScript
     return;
   }
 
-  // Store in our list
+  // Store in our list, with the WebKit user script installed for it
   if (userScript->injectionTime == UserScriptInjectionTime::atDocumentStart) {
+    document_start_webkit_scripts_.push_back(installScript(userScript));
     document_start_scripts_.push_back(userScript);
   } else {
+    document_end_webkit_scripts_.push_back(installScript(userScript));
     document_end_scripts_.push_back(userScript);
   }
-
-  // Create and add WebKit user script
-  WebKitUserScript* wkScript = createWebKitUserScript(userScript);
-  if (wkScript != nullptr) {
-    webkit_user_content_manager_add_script(content_manager_, wkScript);
-    webkit_user_script_unref(wkScript);
-  }
 }
 
 void UserContentController::removeUserScriptAt(size_t index,
                                                UserScriptInjectionTime injectionTime) {
-  auto& scripts = injectionTime == UserScriptInjectionTime::atDocumentStart
-                      ? document_start_scripts_
-                      : document_end_scripts_;
+  bool atDocumentStart = injectionTime == UserScriptInjectionTime::atDocumentStart;
+  auto& scripts = atDocumentStart ? document_start_scripts_ : document_end_scripts_;
+  auto& wkScripts = atDocumentStart ? document_start_webkit_scripts_ : document_end_webkit_scripts_;
 
   if (index < scripts.size()) {
+    uninstallScript(wkScripts[index]);
+    wkScripts.erase(wkScripts.begin() + index);
     scripts.erase(scripts.begin() + index);
-    rebuildScripts();
   }
 }
 
 void UserContentController::removeUserScriptsByGroupName(const std::string& groupName) {
-  auto removeFromVector = [&groupName](std::vector<std::shared_ptr<UserScript>>& scripts) {
-    scripts.erase(std::remove_if(scripts.begin(), scripts.end(),
-                                 [&groupName](const std::shared_ptr<UserScript>& script) {
-                                   return script->groupName.has_value() &&
-                                          script->groupName.value() == groupName;
-                                 }),
-                  scripts.end());
+  auto inGroup = [&groupName](const std::shared_ptr<UserScript>& script) {
+    return script->groupName.has_value() && script->groupName.value() == groupName;
   };
 
-  removeFromVector(document_start_scripts_);
-  removeFromVector(document_end_scripts_);
-  rebuildScripts();
+  removeScriptsIf(document_start_scripts_, document_start_webkit_scripts_, inGroup);
+  removeScriptsIf(document_end_scripts_, document_end_webkit_scripts_, inGroup);
 }
 
 void UserContentController::removeAllUserScripts() {
-  document_start_scripts_.clear();
-  document_end_scripts_.clear();
-
-  if (content_manager_ != nullptr) {
-    // Remove all scripts from WebKit (this also removes plugin scripts)
-    webkit_user_content_manager_remove_all_scripts(content_manager_);
-
-    // Re-add plugin scripts (they should persist)
-    for (const auto& pluginScript : plugin_scripts_) {
-      WebKitUserScriptInjectionTime webkitTime =
-          pluginScript->injectionTime == UserScriptInjectionTime::atDocumentStart
-              ? WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START
-              : WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_END;
-
-      WebKitUserContentInjectedFrames frames = pluginScript->forMainFrameOnly
-                                                   ? WEBKIT_USER_CONTENT_INJECT_TOP_FRAME
-                                                   : WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES;
-
-      WebKitUserScript* wkScript =
-          webkit_user_script_new(pluginScript->source.c_str(), frames, webkitTime,
-                                 nullptr,  // allow_list
-                                 nullptr   // block_list
-          );
-      if (wkScript != nullptr) {
-        webkit_user_content_manager_add_script(content_manager_, wkScript);
-        webkit_user_script_unref(wkScript);
-      }
-    }
-  }
+  // Plugin scripts stay installed
+  auto all = [](const std::shared_ptr<UserScript>&) { return true; };
+  removeScriptsIf(document_start_scripts_, document_start_webkit_scripts_, all);
+  removeScriptsIf(document_end_scripts_, document_end_webkit_scripts_, all);
 }
 
 const std::vector<std::shared_ptr<UserScript>>& UserContentController::getUserScripts(
@@ -232,15 +205,17 @@ void UserContentController::addPluginScript(std::unique_ptr<PluginScript> plugin
   );
 
   // Add the script
-  WebKitUserScript* wkScript = createWebKitUserScript(userScript);
-  if (wkScript != nullptr) {
-    webkit_user_content_manager_add_script(content_manager_, wkScript);
-    webkit_user_script_unref(wkScript);
-  }
-
+  plugin_webkit_scripts_.push_back(installScript(userScript));
   plugin_scripts_.push_back(std::move(pluginScript));
 }
 
+void UserContentController::removePluginScriptsByGroupName(const std::string& groupName) {
+  removeScriptsIf(plugin_scripts_, plugin_webkit_scripts_,
+                  [&groupName](const std::unique_ptr<PluginScript>& script) {
+                    return script->groupName.has_value() && script->groupName.value() == groupName;
+                  });
+}
+
 void UserContentController::onScriptMessageReceived(WebKitUserContentManager* manager,
                                                     JSCValue* value, gpointer user_data) {
   auto* self = static_cast<UserContentController*>(user_data);
@@ -321,51 +296,45 @@ WebKitUserScript* UserContentController::createWebKitUserScript(
   );
 }
 
-void UserContentController::rebuildScripts() {
-  if (content_manager_ == nullptr) {
-    return;
+WebKitUserScript* UserContentController::installScript(
+    const std::shared_ptr<UserScript>& userScript) const {
+  WebKitUserScript* wkScript = createWebKitUserScript(userScript);
+  if (wkScript != nullptr && content_manager_ != nullptr) {
+    webkit_user_content_manager_add_script(content_manager_, wkScript);
   }
+  return wkScript;
+}
 
-  // Remove all scripts
-  webkit_user_content_manager_remove_all_scripts(content_manager_);
-
-  // Re-add plugin scripts first (they take priority)
-  for (const auto& pluginScript : plugin_scripts_) {
-    WebKitUserScriptInjectionTime webkitTime =
-        pluginScript->injectionTime == UserScriptInjectionTime::atDocumentStart
-            ? WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_START
-            : WEBKIT_USER_SCRIPT_INJECT_AT_DOCUMENT_END;
-
-    WebKitUserContentInjectedFrames frames = pluginScript->forMainFrameOnly
-                                                 ? WEBKIT_USER_CONTENT_INJECT_TOP_FRAME
-                                                 : WEBKIT_USER_CONTENT_INJECT_ALL_FRAMES;
-
-    WebKitUserScript* wkScript =
-        webkit_user_script_new(pluginScript->source.c_str(), frames, webkitTime,
-                               nullptr,  // allow_list
-                               nullptr   // block_list
-        );
-    if (wkScript != nullptr) {
-      webkit_user_content_manager_add_script(content_manager_, wkScript);
-      webkit_user_script_unref(wkScript);
-    }
+void UserContentController::uninstallScript(WebKitUserScript* wkScript) const {
+  if (wkScript == nullptr) {
+    return;
   }
+  // Only this script goes: the web process keeps the others, and their
+  // sources aren't sent again
+  if (content_manager_ != nullptr) {
+    webkit_user_content_manager_remove_script(content_manager_, wkScript);
+  }
+  webkit_user_script_unref(wkScript);
+}
 
-  // Re-add user scripts
-  for (const auto& script : document_start_scripts_) {
-    WebKitUserScript* wkScript = createWebKitUserScript(script);
-    if (wkScript != nullptr) {
-      webkit_user_content_manager_add_script(content_manager_, wkScript);
-      webkit_user_script_unref(wkScript);
+template <typename Script, typename Predicate>
+void UserContentController::removeScriptsIf(std::vector<Script>& scripts,
+                                            std::vector<WebKitUserScript*>& wkScripts,
+                                            Predicate predicate) {
+  size_t kept = 0;
+  for (size_t i = 0; i < scripts.size(); i++) {
+    if (predicate(scripts[i])) {
+      uninstallScript(wkScripts[i]);
+      continue;
     }
-  }
-  for (const auto& script : document_end_scripts_) {
-    WebKitUserScript* wkScript = createWebKitUserScript(script);
-    if (wkScript != nullptr) {
-      webkit_user_content_manager_add_script(content_manager_, wkScript);
-      webkit_user_script_unref(wkScript);
+    if (kept != i) {
+      scripts[kept] = std::move(scripts[i]);
+      wkScripts[kept] = wkScripts[i];
     }
+    kept++;
   }
+  scripts.erase(scripts.begin() + kept, scripts.end());
+  wkScripts.erase(wkScripts.begin() + kept, wkScripts.end());
 }
 
 gboolean UserContentController::onScriptMessageWithReplyReceived(
@@ -44,6 +44,7 @@ class UserContentController {
 
   // Plugin script management (for internal scripts like JS bridge)
   void addPluginScript(std::unique_ptr<PluginScript> pluginScript);
+  void removePluginScriptsByGroupName(const std::string& groupName);
 
   // Script message handler (standard - no reply capability)
   void setScriptMessageHandler(ScriptMessageHandler handler);
@@ -65,6 +66,12 @@ class UserContentController {
   std::vector<std::shared_ptr<UserScript>> document_start_scripts_;
   std::vector<std::shared_ptr<UserScript>> document_end_scripts_;
   std::vector<std::unique_ptr<PluginScript>> plugin_scripts_;
+  // WebKit scripts installed for the entries of the lists above (same index,
+  // owned, null if creation failed). Removing entries only removes their
+  // scripts from the content manager, the others stay installed.
+  std::vector<WebKitUserScript*> document_start_webkit_scripts_;
+  std::vector<WebKitUserScript*> document_end_webkit_scripts_;
+  std::vector<WebKitUserScript*> plugin_webkit_scripts_;
   std::vector<std::string> registered_message_handlers_;
   std::vector<std::string> registered_message_handlers_with_reply_;
 
@@ -74,8 +81,16 @@ class UserContentController {
   // Helper to convert UserScript to WebKitUserScript
   WebKitUserScript* createWebKitUserScript(const std::shared_ptr<UserScript>& userScript) const;
 
-  // Rebuild all scripts (called after add/remove)
-  void rebuildScripts();
+  // Add userScript to the content manager, returns the installed script (owned)
+  WebKitUserScript* installScript(const std::shared_ptr<UserScript>& userScript) const;
+
+  // Remove a script returned by installScript from the content manager and release it
+  void uninstallScript(WebKitUserScript* wkScript) const;
+
+  // Uninstall and erase the entries of scripts matching predicate
+  template <typename Script, typename Predicate>
+  void removeScriptsIf(std::vector<Script>& scripts, std::vector<WebKitUserScript*>& wkScripts,
+                       Predicate predicate);
 
   // Static callback for script message received signal
   static void onScriptMessageReceived(WebKitUserContentManager* manager, JSCValue* value,
@@ -1,10 +1,9 @@
 #include "webview_channel_delegate.h"
 
-#include <cstring>
-
 #include "../in_app_browser/in_app_browser.h"
 #include "../types/client_cert_challenge.h"
 #include "../types/client_cert_response.h"
+#include "../types/content_blocker_compile_result.h"
 #include "../types/custom_scheme_response.h"
 #include "../types/hit_test_result.h"
 #include "../types/ssl_certificate.h"
@@ -15,16 +14,48 @@
 #include "../types/web_resource_response.h"
 #include "../utils/flutter.h"
 #include "../utils/log.h"
+#include "../utils/string.h"
 #include "in_app_webview.h"
 #include "in_app_webview_settings.h"
 
 namespace flutter_inappwebview_plugin {
 
 namespace {
-// Helper to compare method names
-bool string_equals(const gchar* a, const char* b) {
-  return strcmp(a, b) == 0;
+
+// Every method name handled by HandleMethodCall*; the switch there only sees
+// the hash of an exact known name, so a colliding unknown name can't reach a case
+constexpr std::string_view kMethodNames[] = {
+    "show", "hide", "close", "isHidden", "getUrl", "getOriginalUrl", "getTitle", "loadUrl",
+    "loadData", "postUrl", "reload", "reloadFromOrigin", "goBack", "goForward", "canGoBack",
+    "canGoForward", "goBackOrForward", "canGoBackOrForward", "getCopyBackForwardList",
+    "stopLoading", "getSettings", "setSettings", "setSize", "loadFile", "isLoading",
+    "evaluateJavascript", "callAsyncJavaScript", "evaluateJavascriptInAllFrames",
+    "setJavaScriptHandlerReplyOptions", "setInterceptRequestRules", "setCustomSchemeFileSource",
+    "setContentBlockerShard", "removeContentBlockerShard", "getContentBlockerShardNames",
+    "setContentBlockerInstrumentation", "getContentBlockerStats", "setLoadResourceFilter",
+    "setConsoleMessageOptions", "prepareScript", "callPreparedScript", "disposePreparedScript",
+    "injectJavascriptFileFromUrl", "injectCSSCode", "injectCSSFileFromUrl", "getProgress",
+    "getCertificate", "getHitTestResult", "getHtml", "takeScreenshot", "getSelectedText",
+    "isSecureContext", "canScrollVertically", "canScrollHorizontally", "saveState", "restoreState",
+    "saveWebArchive", "getZoomScale", "setZoomScale", "scrollTo", "scrollBy", "getScrollX",
+    "getScrollY", "getContentHeight", "getContentWidth", "addUserScript", "removeUserScript",
+    "removeUserScriptsByGroupName", "removeAllUserScripts", "addWebMessageListener",
+    "createWebMessageChannel", "postWebMessage", "isInFullscreen", "requestEnterFullscreen",
+    "requestExitFullscreen", "setVisible", "setTargetRefreshRate", "getTargetRefreshRate",
+    "getScreenScale", "setScreenScale", "isVisible", "requestPointerLock", "requestPointerUnlock",
+    "hideContextMenu", "pauseAllMediaPlayback", "setAllMediaPlaybackSuspended",
+    "closeAllMediaPresentations", "requestMediaPlaybackState", "getCameraCaptureState",
+    "setCameraCaptureState", "getMicrophoneCaptureState", "setMicrophoneCaptureState",
+    "getMetaThemeColor", "isPlayingAudio", "isMuted", "setMuted", "terminateWebProcess",
+    "clearFocus", "requestFocus",
+};
+// Doesn't compile if two method names share a hash
+constexpr KnownStringHashes kMethodHashes(kMethodNames);
+
+constexpr uint32_t method_case(const std::string_view name) {
+  return kMethodHashes.caseFor(name);
 }
+
 }  // namespace
 
 // === Callback implementations ===
@@ -179,6 +210,16 @@ WebViewChannelDelegate::LoadResourceWithCustomSchemeCallback::
   };
 }
 
+WebViewChannelDelegate::CustomSchemeResponseStreamPullCallback::
+    CustomSchemeResponseStreamPullCallback() {
+  decodeResult = [](FlValue* value) -> std::optional<FlValue*> {
+    if (value == nullptr || fl_value_get_type(value) != FL_VALUE_TYPE_UINT8_LIST) {
+      return std::nullopt;
+    }
+    return value;
+  };
+}
+
 WebViewChannelDelegate::NavigationResponseCallback::NavigationResponseCallback() {
   decodeResult = [](FlValue* value) -> std::optional<int> {
     if (value == nullptr || fl_value_get_type(value) == FL_VALUE_TYPE_NULL) {
@@ -228,253 +269,354 @@ void WebViewChannelDelegate::HandleMethodCall(FlMethodCall* method_call) {
   // When this WebView is embedded in an InAppBrowser, forward browser-specific methods
   InAppBrowser* inAppBrowser = webView->getInAppBrowserDelegate();
 
-  if (string_equals(methodName, "show")) {
-    if (inAppBrowser) {
-      inAppBrowser->show();
-      fl_method_call_respond_success(method_call, fl_value_new_bool(true), nullptr);
-    } else {
-      fl_method_call_respond_not_implemented(method_call, nullptr);
+  switch (kMethodHashes.find(methodName)) {
+    case method_case("show"): {
+      if (inAppBrowser) {
+        inAppBrowser->show();
+        fl_method_call_respond_success(method_call, fl_value_new_bool(true), nullptr);
+      } else {
+        fl_method_call_respond_not_implemented(method_call, nullptr);
+      }
+      return;
     }
-    return;
-  }
 
-  if (string_equals(methodName, "hide")) {
-    if (inAppBrowser) {
-      inAppBrowser->hide();
-      fl_method_call_respond_success(method_call, fl_value_new_bool(true), nullptr);
-    } else {
-      fl_method_call_respond_not_implemented(method_call, nullptr);
+    case method_case("hide"): {
+      if (inAppBrowser) {
+        inAppBrowser->hide();
+        fl_method_call_respond_success(method_call, fl_value_new_bool(true), nullptr);
+      } else {
+        fl_method_call_respond_not_implemented(method_call, nullptr);
+      }
+      return;
     }
-    return;
-  }
 
-  if (string_equals(methodName, "close")) {
-    if (inAppBrowser) {
-      inAppBrowser->close();
-      fl_method_call_respond_success(method_call, fl_value_new_bool(true), nullptr);
-    } else {
-      fl_method_call_respond_not_implemented(method_call, nullptr);
+    case method_case("close"): {
+      if (inAppBrowser) {
+        inAppBrowser->close();
+        fl_method_call_respond_success(method_call, fl_value_new_bool(true), nullptr);
+      } else {
+        fl_method_call_respond_not_implemented(method_call, nullptr);
+      }
+      return;
     }
-    return;
-  }
 
-  if (string_equals(methodName, "isHidden")) {
-    if (inAppBrowser) {
-      bool hidden = inAppBrowser->isHidden();
-      fl_method_call_respond_success(method_call, fl_value_new_bool(hidden), nullptr);
-    } else {
-      fl_method_call_respond_not_implemented(method_call, nullptr);
+    case method_case("isHidden"): {
+      if (inAppBrowser) {
+        bool hidden = inAppBrowser->isHidden();
+        fl_method_call_respond_success(method_call, fl_value_new_bool(hidden), nullptr);
+      } else {
+        fl_method_call_respond_not_implemented(method_call, nullptr);
+      }
+      return;
+    }
+
+    // === WebView methods ===
+
+    case method_case("getUrl"): {
+      auto url = webView->getUrl();
+      if (url.has_value()) {
+        g_autoptr(FlValue) result = fl_value_new_string(url->c_str());
+        fl_method_call_respond_success(method_call, result, nullptr);
+      } else {
+        fl_method_call_respond_success(method_call, nullptr, nullptr);
+      }
+      return;
     }
-    return;
-  }
 
-  // === WebView methods ===
+    case method_case("getOriginalUrl"): {
+      // In WPE WebKit, the original URL is not directly tracked separately
+      // We return the current URL as a fallback
+      auto url = webView->getUrl();
+      if (url.has_value()) {
+        g_autoptr(FlValue) result = fl_value_new_string(url->c_str());
+        fl_method_call_respond_success(method_call, result, nullptr);
+      } else {
+        fl_method_call_respond_success(method_call, nullptr, nullptr);
+      }
+      return;
+    }
+
+    case method_case("getTitle"): {
+      auto title = webView->getTitle();
+      if (title.has_value()) {
+        g_autoptr(FlValue) result = fl_value_new_string(title->c_str());
+        fl_method_call_respond_success(method_call, result, nullptr);
+      } else {
+        fl_method_call_respond_success(method_call, nullptr, nullptr);
+      }
+      return;
+    }
 
-  if (string_equals(methodName, "getUrl")) {
-    auto url = webView->getUrl();
-    if (url.has_value()) {
-      g_autoptr(FlValue) result = fl_value_new_string(url->c_str());
+    case method_case("loadUrl"): {
+      FlValue* url_request = get_fl_map_value_raw(args, "urlRequest");
+      if (url_request != nullptr && fl_value_get_type(url_request) == FL_VALUE_TYPE_MAP) {
+        auto request = std::make_shared<URLRequest>(url_request);
+        webView->loadUrl(request);
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
       fl_method_call_respond_success(method_call, result, nullptr);
-    } else {
-      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    return;
-  }
 
-  if (string_equals(methodName, "getOriginalUrl")) {
-    // In WPE WebKit, the original URL is not directly tracked separately
-    // We return the current URL as a fallback
-    auto url = webView->getUrl();
-    if (url.has_value()) {
-      g_autoptr(FlValue) result = fl_value_new_string(url->c_str());
+    case method_case("loadData"): {
+      std::string data = get_fl_map_value<std::string>(args, "data", "");
+      if (!data.empty()) {
+        std::string mime_type = get_fl_map_value<std::string>(args, "mimeType", "text/html");
+        std::string encoding = get_fl_map_value<std::string>(args, "encoding", "UTF-8");
+        std::string base_url = get_fl_map_value<std::string>(args, "baseUrl", "about:blank");
+        webView->loadData(data, mime_type, encoding, base_url);
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
       fl_method_call_respond_success(method_call, result, nullptr);
-    } else {
-      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    return;
-  }
 
-  if (string_equals(methodName, "getTitle")) {
-    auto title = webView->getTitle();
-    if (title.has_value()) {
-      g_autoptr(FlValue) result = fl_value_new_string(title->c_str());
+    case method_case("postUrl"): {
+      std::string url = get_fl_map_value<std::string>(args, "url", "");
+      auto postData = get_optional_fl_map_value<std::vector<uint8_t>>(args, "postData");
+      if (!url.empty() && postData.has_value()) {
+        webView->postUrl(url, postData.value());
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
       fl_method_call_respond_success(method_call, result, nullptr);
-    } else {
-      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    return;
-  }
 
-  if (string_equals(methodName, "loadUrl")) {
-    FlValue* url_request = get_fl_map_value_raw(args, "urlRequest");
-    if (url_request != nullptr && fl_value_get_type(url_request) == FL_VALUE_TYPE_MAP) {
-      auto request = std::make_shared<URLRequest>(url_request);
-      webView->loadUrl(request);
+    case method_case("reload"): {
+      webView->reload();
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "loadData")) {
-    std::string data = get_fl_map_value<std::string>(args, "data", "");
-    if (!data.empty()) {
-      std::string mime_type = get_fl_map_value<std::string>(args, "mimeType", "text/html");
-      std::string encoding = get_fl_map_value<std::string>(args, "encoding", "UTF-8");
-      std::string base_url = get_fl_map_value<std::string>(args, "baseUrl", "about:blank");
-      webView->loadData(data, mime_type, encoding, base_url);
+    case method_case("reloadFromOrigin"): {
+      webView->reloadFromOrigin();
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "postUrl")) {
-    std::string url = get_fl_map_value<std::string>(args, "url", "");
-    auto postData = get_optional_fl_map_value<std::vector<uint8_t>>(args, "postData");
-    if (!url.empty() && postData.has_value()) {
-      webView->postUrl(url, postData.value());
+    case method_case("goBack"): {
+      webView->goBack();
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "reload")) {
-    webView->reload();
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("goForward"): {
+      webView->goForward();
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "reloadFromOrigin")) {
-    webView->reloadFromOrigin();
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("canGoBack"): {
+      g_autoptr(FlValue) result = fl_value_new_bool(webView->canGoBack());
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "goBack")) {
-    webView->goBack();
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("canGoForward"): {
+      g_autoptr(FlValue) result = fl_value_new_bool(webView->canGoForward());
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "goForward")) {
-    webView->goForward();
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("goBackOrForward"): {
+      int64_t steps = get_fl_map_value<int64_t>(args, "steps", 0);
+      webView->goBackOrForward(static_cast<int>(steps));
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "canGoBack")) {
-    g_autoptr(FlValue) result = fl_value_new_bool(webView->canGoBack());
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("canGoBackOrForward"): {
+      int64_t steps = get_fl_map_value<int64_t>(args, "steps", 0);
+      bool canGo = webView->canGoBackOrForward(static_cast<int>(steps));
+      g_autoptr(FlValue) result = fl_value_new_bool(canGo);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "canGoForward")) {
-    g_autoptr(FlValue) result = fl_value_new_bool(webView->canGoForward());
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("getCopyBackForwardList"): {
+      FlValue* result = webView->getCopyBackForwardList();
+      fl_method_call_respond_success(method_call, result, nullptr);
+      fl_value_unref(result);  // getCopyBackForwardList returns a new reference
+      return;
+    }
 
-  if (string_equals(methodName, "goBackOrForward")) {
-    int64_t steps = get_fl_map_value<int64_t>(args, "steps", 0);
-    webView->goBackOrForward(static_cast<int>(steps));
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("stopLoading"): {
+      webView->stopLoading();
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "canGoBackOrForward")) {
-    int64_t steps = get_fl_map_value<int64_t>(args, "steps", 0);
-    bool canGo = webView->canGoBackOrForward(static_cast<int>(steps));
-    g_autoptr(FlValue) result = fl_value_new_bool(canGo);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("getSettings"): {
+      // For InAppBrowser, return combined browser + webview settings
+      if (inAppBrowser) {
+        g_autoptr(FlValue) result = inAppBrowser->getSettings();
+        fl_method_call_respond_success(method_call, result, nullptr);
+      } else {
+        g_autoptr(FlValue) result = webView->getSettings();
+        fl_method_call_respond_success(method_call, result, nullptr);
+      }
+      return;
+    }
 
-  if (string_equals(methodName, "getCopyBackForwardList")) {
-    FlValue* result = webView->getCopyBackForwardList();
-    fl_method_call_respond_success(method_call, result, nullptr);
-    fl_value_unref(result);  // getCopyBackForwardList returns a new reference
-    return;
-  }
+    case method_case("setSettings"): {
+      FlValue* settings_value = get_fl_map_value_raw(args, "settings");
+      if (settings_value != nullptr && fl_value_get_type(settings_value) == FL_VALUE_TYPE_MAP) {
+        // For InAppBrowser, set both browser and webview settings
+        if (inAppBrowser) {
+          auto newBrowserSettings = std::make_shared<InAppBrowserSettings>(settings_value);
+          inAppBrowser->setSettings(newBrowserSettings, settings_value);
+        } else {
+          auto newSettings = std::make_shared<InAppWebViewSettings>(settings_value);
+          webView->setSettings(newSettings, settings_value);
+        }
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "stopLoading")) {
-    webView->stopLoading();
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("setSize"): {
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_LIST && fl_value_get_length(args) >= 2) {
+        FlValue* width_value = fl_value_get_list_value(args, 0);
+        FlValue* height_value = fl_value_get_list_value(args, 1);
+        if (fl_value_get_type(width_value) == FL_VALUE_TYPE_FLOAT &&
+            fl_value_get_type(height_value) == FL_VALUE_TYPE_FLOAT) {
+          int width = static_cast<int>(fl_value_get_float(width_value));
+          int height = static_cast<int>(fl_value_get_float(height_value));
+          webView->setSize(width, height);
+        }
+      }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "getSettings")) {
-    // For InAppBrowser, return combined browser + webview settings
-    if (inAppBrowser) {
-      g_autoptr(FlValue) result = inAppBrowser->getSettings();
+    case method_case("loadFile"): {
+      std::string assetFilePath = get_fl_map_value<std::string>(args, "assetFilePath", "");
+      if (!assetFilePath.empty()) {
+        webView->loadFile(assetFilePath);
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
       fl_method_call_respond_success(method_call, result, nullptr);
-    } else {
-      g_autoptr(FlValue) result = webView->getSettings();
+      return;
+    }
+
+    case method_case("isLoading"): {
+      g_autoptr(FlValue) result = fl_value_new_bool(webView->isLoading());
       fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    return;
-  }
 
-  if (string_equals(methodName, "setSettings")) {
-    FlValue* settings_value = get_fl_map_value_raw(args, "settings");
-    if (settings_value != nullptr && fl_value_get_type(settings_value) == FL_VALUE_TYPE_MAP) {
-      // For InAppBrowser, set both browser and webview settings
-      if (inAppBrowser) {
-        auto newBrowserSettings = std::make_shared<InAppBrowserSettings>(settings_value);
-        inAppBrowser->setSettings(newBrowserSettings, settings_value);
-      } else {
-        auto newSettings = std::make_shared<InAppWebViewSettings>(settings_value);
-        webView->setSettings(newSettings, settings_value);
+    case method_case("evaluateJavascript"): {
+      std::string source = get_fl_map_value<std::string>(args, "source", "");
+      if (!source.empty()) {
+        // Extract contentWorld if provided
+        FlValue* contentWorld = fl_value_lookup_string(args, "contentWorld");
+        std::optional<std::string> worldName = std::nullopt;
+        if (contentWorld != nullptr && fl_value_get_type(contentWorld) == FL_VALUE_TYPE_MAP) {
+          FlValue* name = fl_value_lookup_string(contentWorld, "name");
+          if (name != nullptr && fl_value_get_type(name) == FL_VALUE_TYPE_STRING) {
+            worldName = fl_value_get_string(name);
+          }
+        }
+
+        auto resultMode = static_cast<EvaluateJavascriptResultMode>(
+            get_fl_map_value<int64_t>(args, "resultMode", static_cast<int64_t>(EvaluateJavascriptResultMode::Json)));
+
+        // Capture method_call for async callback
+        g_object_ref(method_call);
+
+        if (resultMode == EvaluateJavascriptResultMode::Value) {
+          webView->evaluateJavascriptAsFlValue(
+              source, worldName, [method_call](FlValue* result, const GError* error) {
+                if (error != nullptr) {
+                  fl_method_call_respond_error(method_call, "EVALUATE_JAVASCRIPT_ERROR",
+                                               error->message, nullptr, nullptr);
+                } else {
+                  fl_method_call_respond_success(method_call, result, nullptr);
+                }
+                g_object_unref(method_call);
+              });
+          return;
+        }
+
+        if (resultMode == EvaluateJavascriptResultMode::ChunkedJson) {
+          int64_t requestId = get_fl_map_value<int64_t>(args, "requestId", 0);
+          int64_t chunkSize = get_fl_map_value<int64_t>(args, "chunkSize", 0);
+          webView->evaluateJavascriptChunked(
+              source, worldName, chunkSize > 0 ? static_cast<size_t>(chunkSize) : 0,
+              [this, requestId](const char* data, size_t length) {
+                onEvaluateJavascriptResultChunk(requestId, data, length);
+              },
+              [method_call](bool hasResult, size_t totalLength) {
+                // Respond with the total JSON length once every chunk has been sent
+                if (hasResult) {
+                  g_autoptr(FlValue) val = fl_value_new_int(static_cast<int64_t>(totalLength));
+                  fl_method_call_respond_success(method_call, val, nullptr);
+                } else {
+                  fl_method_call_respond_success(method_call, nullptr, nullptr);
+                }
+                g_object_unref(method_call);
+              });
+          return;
+        }
+
+        webView->evaluateJavascript(
+            source, worldName, [method_call](const std::optional<std::string>& result) {
+              if (result.has_value()) {
+                g_autoptr(FlValue) val = fl_value_new_string(result->c_str());
+                fl_method_call_respond_success(method_call, val, nullptr);
+              } else {
+                fl_method_call_respond_success(method_call, nullptr, nullptr);
+              }
+              g_object_unref(method_call);
+            });
+        return;
       }
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "setSize")) {
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_LIST && fl_value_get_length(args) >= 2) {
-      FlValue* width_value = fl_value_get_list_value(args, 0);
-      FlValue* height_value = fl_value_get_list_value(args, 1);
-      if (fl_value_get_type(width_value) == FL_VALUE_TYPE_FLOAT &&
-          fl_value_get_type(height_value) == FL_VALUE_TYPE_FLOAT) {
-        int width = static_cast<int>(fl_value_get_float(width_value));
-        int height = static_cast<int>(fl_value_get_float(height_value));
-        webView->setSize(width, height);
+    case method_case("callAsyncJavaScript"): {
+      std::string functionBody = get_fl_map_value<std::string>(args, "functionBody", "");
+      // Arguments are now passed as a JSON-encoded string from Dart
+      std::string argumentsJson = get_fl_map_value<std::string>(args, "arguments", "{}");
+      // Get the list of argument keys for destructuring
+      std::vector<std::string> argumentKeys = get_fl_map_value<std::vector<std::string>>(args, "argumentKeys", {});
+      FlValue* contentWorld = fl_value_lookup_string(args, "contentWorld");
+
+      std::optional<std::string> worldName = std::nullopt;
+      if (contentWorld != nullptr && fl_value_get_type(contentWorld) == FL_VALUE_TYPE_MAP) {
+        FlValue* name = fl_value_lookup_string(contentWorld, "name");
+        if (name != nullptr && fl_value_get_type(name) == FL_VALUE_TYPE_STRING) {
+          worldName = fl_value_get_string(name);
+        }
       }
-    }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "loadFile")) {
-    std::string assetFilePath = get_fl_map_value<std::string>(args, "assetFilePath", "");
-    if (!assetFilePath.empty()) {
-      webView->loadFile(assetFilePath);
-    }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+      // Keep method call alive for async response
+      g_object_ref(method_call);
 
-  if (string_equals(methodName, "isLoading")) {
-    g_autoptr(FlValue) result = fl_value_new_bool(webView->isLoading());
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+      webView->callAsyncJavaScript(
+          functionBody, argumentsJson, argumentKeys, worldName,
+          [method_call](const std::string& jsonResult) {
+            // Return the JSON string directly - Dart side will decode it
+            g_autoptr(FlValue) result = fl_value_new_string(jsonResult.c_str());
+            fl_method_call_respond_success(method_call, result, nullptr);
+            g_object_unref(method_call);
+          });
+      return;
+    }
 
-  if (string_equals(methodName, "evaluateJavascript")) {
-    std::string source = get_fl_map_value<std::string>(args, "source", "");
-    if (!source.empty()) {
-      // Extract contentWorld if provided
+    case method_case("evaluateJavascriptInAllFrames"): {
+      std::string source = get_fl_map_value<std::string>(args, "source", "");
+      int64_t timeout = get_fl_map_value<int64_t>(args, "timeout", 10000);
       FlValue* contentWorld = fl_value_lookup_string(args, "contentWorld");
+
       std::optional<std::string> worldName = std::nullopt;
       if (contentWorld != nullptr && fl_value_get_type(contentWorld) == FL_VALUE_TYPE_MAP) {
         FlValue* name = fl_value_lookup_string(contentWorld, "name");
@@ -483,627 +625,744 @@ void WebViewChannelDelegate::HandleMethodCall(FlMethodCall* method_call) {
         }
       }
 
-      // Capture method_call for async callback
+      // Keep method call alive for async response
       g_object_ref(method_call);
 
-      webView->evaluateJavascript(
-          source, worldName, [method_call](const std::optional<std::string>& result) {
-            if (result.has_value()) {
-              g_autoptr(FlValue) val = fl_value_new_string(result->c_str());
-              fl_method_call_respond_success(method_call, val, nullptr);
-            } else {
-              fl_method_call_respond_success(method_call, nullptr, nullptr);
-            }
+      webView->evaluateJavascriptInAllFrames(
+          source, worldName, timeout, [method_call](const std::string& jsonResult) {
+            // Return the JSON string directly - Dart side will decode it
+            g_autoptr(FlValue) result = fl_value_new_string(jsonResult.c_str());
+            fl_method_call_respond_success(method_call, result, nullptr);
             g_object_unref(method_call);
           });
       return;
     }
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "callAsyncJavaScript")) {
-    std::string functionBody = get_fl_map_value<std::string>(args, "functionBody", "");
-    // Arguments are now passed as a JSON-encoded string from Dart
-    std::string argumentsJson = get_fl_map_value<std::string>(args, "arguments", "{}");
-    // Get the list of argument keys for destructuring
-    std::vector<std::string> argumentKeys = get_fl_map_value<std::vector<std::string>>(args, "argumentKeys", {});
-    FlValue* contentWorld = fl_value_lookup_string(args, "contentWorld");
-
-    std::optional<std::string> worldName = std::nullopt;
-    if (contentWorld != nullptr && fl_value_get_type(contentWorld) == FL_VALUE_TYPE_MAP) {
-      FlValue* name = fl_value_lookup_string(contentWorld, "name");
-      if (name != nullptr && fl_value_get_type(name) == FL_VALUE_TYPE_STRING) {
-        worldName = fl_value_get_string(name);
+    case method_case("setJavaScriptHandlerReplyOptions"): {
+      int64_t timeout = get_fl_map_value<int64_t>(args, "timeout", 0);
+      int64_t maxInFlight = get_fl_map_value<int64_t>(args, "maxInFlight", 0);
+      int64_t maxQueued = get_fl_map_value<int64_t>(args, "maxQueued", 0);
+      auto overflowPolicy = static_cast<ScriptMessageReplyOverflowPolicy>(get_fl_map_value<int64_t>(
+          args, "overflowPolicy", static_cast<int64_t>(ScriptMessageReplyOverflowPolicy::Reject)));
+      webView->setJavaScriptHandlerReplyOptions(timeout, maxInFlight, maxQueued, overflowPolicy);
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
+
+    case method_case("setInterceptRequestRules"): {
+      std::vector<InterceptRequestRule> rules;
+      FlValue* rulesValue = fl_value_lookup_string(args, "rules");
+      if (rulesValue != nullptr && fl_value_get_type(rulesValue) == FL_VALUE_TYPE_LIST) {
+        for (size_t i = 0; i < fl_value_get_length(rulesValue); i++) {
+          rules.emplace_back(fl_value_get_list_value(rulesValue, i));
+        }
       }
+      webView->setInterceptRequestRules(std::move(rules));
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
 
-    // Keep method call alive for async response
-    g_object_ref(method_call);
+    case method_case("setCustomSchemeFileSource"): {
+      std::string scheme = get_fl_map_value<std::string>(args, "scheme", "");
+      std::optional<std::string> directory = get_optional_fl_map_value<std::string>(args, "directory");
+      std::optional<std::string> assetPrefix =
+          get_optional_fl_map_value<std::string>(args, "assetPrefix");
+      bool fallbackToDart = get_fl_map_value<bool>(args, "fallbackToDart", true);
+      bool success =
+          !scheme.empty() &&
+          webView->setCustomSchemeFileSource(scheme, directory, assetPrefix, fallbackToDart);
+      g_autoptr(FlValue) result = fl_value_new_bool(success);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-    webView->callAsyncJavaScript(
-        functionBody, argumentsJson, argumentKeys, worldName,
-        [method_call](const std::string& jsonResult) {
-          // Return the JSON string directly - Dart side will decode it
-          g_autoptr(FlValue) result = fl_value_new_string(jsonResult.c_str());
-          fl_method_call_respond_success(method_call, result, nullptr);
-          g_object_unref(method_call);
-        });
-    return;
-  }
+    case method_case("setContentBlockerShard"): {
+      std::string shard = get_fl_map_value<std::string>(args, "shard", "");
+      if (shard.empty()) {
+        g_autoptr(FlValue) result = ContentBlockerCompileResult().toFlValue();
+        fl_method_call_respond_success(method_call, result, nullptr);
+        return;
+      }
+      FlValue* contentBlockers = get_fl_map_value_raw(args, "contentBlockers");
+      g_object_ref(method_call);
+      webView->setContentBlockerShard(
+          shard, contentBlockers, [method_call](const ContentBlockerCompileResult& compileResult) {
+            g_autoptr(FlValue) result = compileResult.toFlValue();
+            fl_method_call_respond_success(method_call, result, nullptr);
+            g_object_unref(method_call);
+          });
+      return;
+    }
 
-  if (string_equals(methodName, "injectJavascriptFileFromUrl")) {
-    std::string urlFile = get_fl_map_value<std::string>(args, "urlFile", "");
-    if (!urlFile.empty()) {
-      webView->injectJavascriptFileFromUrl(urlFile);
+    case method_case("removeContentBlockerShard"): {
+      std::string shard = get_fl_map_value<std::string>(args, "shard", "");
+      if (!shard.empty()) {
+        webView->removeContentBlockerShard(shard);
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(!shard.empty());
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
+
+    case method_case("getContentBlockerShardNames"): {
+      g_autoptr(FlValue) result = make_fl_value(webView->getContentBlockerShardNames());
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "injectCSSCode")) {
-    std::string source = get_fl_map_value<std::string>(args, "source", "");
-    if (!source.empty()) {
-      webView->injectCSSCode(source);
+    case method_case("setContentBlockerInstrumentation"): {
+      bool enabled = get_fl_map_value<bool>(args, "enabled", false);
+      g_autoptr(FlValue) result = fl_value_new_bool(webView->setContentBlockerInstrumentation(enabled));
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "injectCSSFileFromUrl")) {
-    std::string urlFile = get_fl_map_value<std::string>(args, "urlFile", "");
-    if (!urlFile.empty()) {
-      webView->injectCSSFileFromUrl(urlFile);
+    case method_case("getContentBlockerStats"): {
+      bool reset = get_fl_map_value<bool>(args, "reset", false);
+      g_autoptr(FlValue) result = webView->getContentBlockerStats(reset).toFlValue();
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "getProgress")) {
-    g_autoptr(FlValue) result = fl_value_new_int(webView->getProgress());
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("setLoadResourceFilter"): {
+      std::vector<std::string> initiatorTypes =
+          get_fl_map_value<std::vector<std::string>>(args, "initiatorTypes", {});
+      std::optional<std::string> urlPattern = get_optional_fl_map_value<std::string>(args, "urlPattern");
+      double sampleRate = get_fl_map_value<double>(args, "sampleRate", 1.0);
+      bool success = webView->setLoadResourceFilter(initiatorTypes, urlPattern, sampleRate);
+      g_autoptr(FlValue) result = fl_value_new_bool(success);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "getCertificate")) {
-    auto certificate = webView->getCertificate();
-    if (certificate.has_value()) {
-      FlValue* result = certificate->toFlValue();
+    case method_case("setConsoleMessageOptions"): {
+      int64_t minLevel = get_fl_map_value<int64_t>(args, "minLevel", 0);
+      int64_t maxMessagesPerSecond = get_fl_map_value<int64_t>(args, "maxMessagesPerSecond", 0);
+      int64_t batchInterval = get_fl_map_value<int64_t>(args, "batchInterval", 0);
+      webView->setConsoleMessageOptions(minLevel, maxMessagesPerSecond, batchInterval);
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
       fl_method_call_respond_success(method_call, result, nullptr);
-      fl_value_unref(result);
-    } else {
-      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    return;
-  }
 
-  if (string_equals(methodName, "getHitTestResult")) {
-    HitTestResult hitTestResult = webView->getHitTestResult();
-    FlValue* result = hitTestResult.toFlValue();
-    fl_method_call_respond_success(method_call, result, nullptr);
-    fl_value_unref(result);
-    return;
-  }
+    case method_case("prepareScript"): {
+      std::string functionBody = get_fl_map_value<std::string>(args, "functionBody", "");
+      std::vector<std::string> argumentKeys = get_fl_map_value<std::vector<std::string>>(args, "argumentKeys", {});
+      FlValue* contentWorld = fl_value_lookup_string(args, "contentWorld");
 
-  if (string_equals(methodName, "getHtml")) {
-    // Capture method_call for async callback
-    g_object_ref(method_call);
+      std::optional<std::string> worldName = std::nullopt;
+      if (contentWorld != nullptr && fl_value_get_type(contentWorld) == FL_VALUE_TYPE_MAP) {
+        FlValue* name = fl_value_lookup_string(contentWorld, "name");
+        if (name != nullptr && fl_value_get_type(name) == FL_VALUE_TYPE_STRING) {
+          worldName = fl_value_get_string(name);
+        }
+      }
 
-    webView->getHtml([method_call](const std::optional<std::string>& result) {
-      if (result.has_value()) {
-        g_autoptr(FlValue) val = fl_value_new_string(result->c_str());
-        fl_method_call_respond_success(method_call, val, nullptr);
-      } else {
-        fl_method_call_respond_success(method_call, nullptr, nullptr);
+      g_autoptr(FlValue) result = fl_value_new_int(webView->prepareScript(functionBody, argumentKeys, worldName));
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
+
+    case method_case("callPreparedScript"): {
+      int64_t handle = get_fl_map_value<int64_t>(args, "handle", 0);
+      std::string argumentsJson = get_fl_map_value<std::string>(args, "arguments", "{}");
+
+      // Keep method call alive for async response
+      g_object_ref(method_call);
+
+      webView->callPreparedScript(handle, argumentsJson, [method_call](const std::string& jsonResult) {
+        // Same {"value": ..., "error": ...} JSON string as callAsyncJavaScript
+        g_autoptr(FlValue) result = fl_value_new_string(jsonResult.c_str());
+        fl_method_call_respond_success(method_call, result, nullptr);
+        g_object_unref(method_call);
+      });
+      return;
+    }
+
+    case method_case("disposePreparedScript"): {
+      int64_t handle = get_fl_map_value<int64_t>(args, "handle", 0);
+      g_autoptr(FlValue) result = fl_value_new_bool(webView->disposePreparedScript(handle));
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
+
+    case method_case("injectJavascriptFileFromUrl"): {
+      std::string urlFile = get_fl_map_value<std::string>(args, "urlFile", "");
+      if (!urlFile.empty()) {
+        webView->injectJavascriptFileFromUrl(urlFile);
       }
-      g_object_unref(method_call);
-    });
-    return;
-  }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "takeScreenshot")) {
-    // Capture method_call for async callback
-    g_object_ref(method_call);
+    case method_case("injectCSSCode"): {
+      std::string source = get_fl_map_value<std::string>(args, "source", "");
+      if (!source.empty()) {
+        webView->injectCSSCode(source);
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-    webView->takeScreenshot([method_call](const std::optional<std::vector<uint8_t>>& result) {
-      if (result.has_value() && !result->empty()) {
-        // Return the PNG data as a Uint8List
-        g_autoptr(FlValue) val = fl_value_new_uint8_list(result->data(), result->size());
-        fl_method_call_respond_success(method_call, val, nullptr);
-      } else {
-        fl_method_call_respond_success(method_call, nullptr, nullptr);
+    case method_case("injectCSSFileFromUrl"): {
+      std::string urlFile = get_fl_map_value<std::string>(args, "urlFile", "");
+      if (!urlFile.empty()) {
+        webView->injectCSSFileFromUrl(urlFile);
       }
-      g_object_unref(method_call);
-    });
-    return;
-  }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "getSelectedText")) {
-    // Capture method_call for async callback
-    g_object_ref(method_call);
+    case method_case("getProgress"): {
+      g_autoptr(FlValue) result = fl_value_new_int(webView->getProgress());
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-    webView->getSelectedText([method_call](const std::optional<std::string>& result) {
-      if (result.has_value()) {
-        g_autoptr(FlValue) val = fl_value_new_string(result->c_str());
-        fl_method_call_respond_success(method_call, val, nullptr);
+    case method_case("getCertificate"): {
+      auto certificate = webView->getCertificate();
+      if (certificate.has_value()) {
+        FlValue* result = certificate->toFlValue();
+        fl_method_call_respond_success(method_call, result, nullptr);
+        fl_value_unref(result);
       } else {
         fl_method_call_respond_success(method_call, nullptr, nullptr);
       }
-      g_object_unref(method_call);
-    });
-    return;
-  }
+      return;
+    }
 
-  if (string_equals(methodName, "isSecureContext")) {
-    // Capture method_call for async callback
-    g_object_ref(method_call);
+    case method_case("getHitTestResult"): {
+      HitTestResult hitTestResult = webView->getHitTestResult();
+      FlValue* result = hitTestResult.toFlValue();
+      fl_method_call_respond_success(method_call, result, nullptr);
+      fl_value_unref(result);
+      return;
+    }
 
-    webView->isSecureContext([method_call](bool isSecure) {
-      g_autoptr(FlValue) val = fl_value_new_bool(isSecure);
-      fl_method_call_respond_success(method_call, val, nullptr);
-      g_object_unref(method_call);
-    });
-    return;
-  }
+    case method_case("getHtml"): {
+      // Capture method_call for async callback
+      g_object_ref(method_call);
 
-  if (string_equals(methodName, "canScrollVertically")) {
-    // Capture method_call for async callback
-    g_object_ref(method_call);
+      webView->getHtml([method_call](const std::optional<std::string>& result) {
+        if (result.has_value()) {
+          g_autoptr(FlValue) val = fl_value_new_string(result->c_str());
+          fl_method_call_respond_success(method_call, val, nullptr);
+        } else {
+          fl_method_call_respond_success(method_call, nullptr, nullptr);
+        }
+        g_object_unref(method_call);
+      });
+      return;
+    }
 
-    webView->canScrollVertically([method_call](bool canScroll) {
-      g_autoptr(FlValue) val = fl_value_new_bool(canScroll);
-      fl_method_call_respond_success(method_call, val, nullptr);
-      g_object_unref(method_call);
-    });
-    return;
-  }
+    case method_case("takeScreenshot"): {
+      // Capture method_call for async callback
+      g_object_ref(method_call);
 
-  if (string_equals(methodName, "canScrollHorizontally")) {
-    // Capture method_call for async callback
-    g_object_ref(method_call);
+      webView->takeScreenshot([method_call](const std::optional<std::vector<uint8_t>>& result) {
+        if (result.has_value() && !result->empty()) {
+          // Return the PNG data as a Uint8List
+          g_autoptr(FlValue) val = fl_value_new_uint8_list(result->data(), result->size());
+          fl_method_call_respond_success(method_call, val, nullptr);
+        } else {
+          fl_method_call_respond_success(method_call, nullptr, nullptr);
+        }
+        g_object_unref(method_call);
+      });
+      return;
+    }
 
-    webView->canScrollHorizontally([method_call](bool canScroll) {
-      g_autoptr(FlValue) val = fl_value_new_bool(canScroll);
-      fl_method_call_respond_success(method_call, val, nullptr);
-      g_object_unref(method_call);
-    });
-    return;
-  }
+    case method_case("getSelectedText"): {
+      // Capture method_call for async callback
+      g_object_ref(method_call);
 
-  if (string_equals(methodName, "saveState")) {
-    auto state = webView->saveState();
-    if (state.has_value() && !state->empty()) {
-      g_autoptr(FlValue) result = fl_value_new_uint8_list(state->data(), state->size());
-      fl_method_call_respond_success(method_call, result, nullptr);
-    } else {
-      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      webView->getSelectedText([method_call](const std::optional<std::string>& result) {
+        if (result.has_value()) {
+          g_autoptr(FlValue) val = fl_value_new_string(result->c_str());
+          fl_method_call_respond_success(method_call, val, nullptr);
+        } else {
+          fl_method_call_respond_success(method_call, nullptr, nullptr);
+        }
+        g_object_unref(method_call);
+      });
+      return;
     }
-    return;
-  }
 
-  if (string_equals(methodName, "restoreState")) {
-    auto stateOpt = get_optional_fl_map_value<std::vector<uint8_t>>(args, "state");
-    if (stateOpt.has_value() && !stateOpt->empty()) {
-      bool success = webView->restoreState(stateOpt.value());
-      g_autoptr(FlValue) result = fl_value_new_bool(success);
-      fl_method_call_respond_success(method_call, result, nullptr);
+    case method_case("isSecureContext"): {
+      // Capture method_call for async callback
+      g_object_ref(method_call);
+
+      webView->isSecureContext([method_call](bool isSecure) {
+        g_autoptr(FlValue) val = fl_value_new_bool(isSecure);
+        fl_method_call_respond_success(method_call, val, nullptr);
+        g_object_unref(method_call);
+      });
       return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(false);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "saveWebArchive")) {
-    auto filePath = get_fl_map_value<std::string>(args, "filePath", "");
-    bool autoname = get_fl_map_value<bool>(args, "autoname", false);
-    
-    if (filePath.empty()) {
-      fl_method_call_respond_success(method_call, fl_value_new_null(), nullptr);
+    case method_case("canScrollVertically"): {
+      // Capture method_call for async callback
+      g_object_ref(method_call);
+
+      webView->canScrollVertically([method_call](bool canScroll) {
+        g_autoptr(FlValue) val = fl_value_new_bool(canScroll);
+        fl_method_call_respond_success(method_call, val, nullptr);
+        g_object_unref(method_call);
+      });
       return;
     }
-    
-    // Ref the method call to prevent it from being freed before async callback
-    g_object_ref(method_call);
-    
-    webView->saveWebArchive(filePath, autoname, [method_call](const std::optional<std::string>& result) {
-      if (result.has_value()) {
-        g_autoptr(FlValue) flResult = fl_value_new_string(result->c_str());
-        fl_method_call_respond_success(method_call, flResult, nullptr);
-      } else {
-        fl_method_call_respond_success(method_call, fl_value_new_null(), nullptr);
-      }
-      g_object_unref(method_call);
-    });
-    return;
-  }
 
-  if (string_equals(methodName, "getZoomScale")) {
-    g_autoptr(FlValue) result = fl_value_new_float(webView->getZoomScale());
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("canScrollHorizontally"): {
+      // Capture method_call for async callback
+      g_object_ref(method_call);
 
-  if (string_equals(methodName, "setZoomScale")) {
-    double zoomScale = get_fl_map_value<double>(args, "zoomScale", 1.0);
-    webView->setZoomScale(zoomScale);
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+      webView->canScrollHorizontally([method_call](bool canScroll) {
+        g_autoptr(FlValue) val = fl_value_new_bool(canScroll);
+        fl_method_call_respond_success(method_call, val, nullptr);
+        g_object_unref(method_call);
+      });
+      return;
+    }
 
-  if (string_equals(methodName, "scrollTo")) {
-    int64_t x = get_fl_map_value<int64_t>(args, "x", 0);
-    int64_t y = get_fl_map_value<int64_t>(args, "y", 0);
-    bool animated = get_fl_map_value<bool>(args, "animated", false);
-    webView->scrollTo(x, y, animated);
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("saveState"): {
+      auto state = webView->saveState();
+      if (state.has_value() && !state->empty()) {
+        g_autoptr(FlValue) result = fl_value_new_uint8_list(state->data(), state->size());
+        fl_method_call_respond_success(method_call, result, nullptr);
+      } else {
+        fl_method_call_respond_success(method_call, nullptr, nullptr);
+      }
+      return;
+    }
 
-  if (string_equals(methodName, "scrollBy")) {
-    int64_t x = get_fl_map_value<int64_t>(args, "x", 0);
-    int64_t y = get_fl_map_value<int64_t>(args, "y", 0);
-    bool animated = get_fl_map_value<bool>(args, "animated", false);
-    webView->scrollBy(x, y, animated);
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("restoreState"): {
+      auto stateOpt = get_optional_fl_map_value<std::vector<uint8_t>>(args, "state");
+      if (stateOpt.has_value() && !stateOpt->empty()) {
+        bool success = webView->restoreState(stateOpt.value());
+        g_autoptr(FlValue) result = fl_value_new_bool(success);
+        fl_method_call_respond_success(method_call, result, nullptr);
+        return;
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(false);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "getScrollX")) {
-    g_object_ref(method_call);
-    webView->getScrollX([method_call](int64_t scrollX) {
-      g_autoptr(FlValue) result = fl_value_new_int(scrollX);
+    case method_case("saveWebArchive"): {
+      auto filePath = get_fl_map_value<std::string>(args, "filePath", "");
+      bool autoname = get_fl_map_value<bool>(args, "autoname", false);
+    
+      if (filePath.empty()) {
+        fl_method_call_respond_success(method_call, fl_value_new_null(), nullptr);
+        return;
+      }
+    
+      // Ref the method call to prevent it from being freed before async callback
+      g_object_ref(method_call);
+    
+      webView->saveWebArchive(filePath, autoname, [method_call](const std::optional<std::string>& result) {
+        if (result.has_value()) {
+          g_autoptr(FlValue) flResult = fl_value_new_string(result->c_str());
+          fl_method_call_respond_success(method_call, flResult, nullptr);
+        } else {
+          fl_method_call_respond_success(method_call, fl_value_new_null(), nullptr);
+        }
+        g_object_unref(method_call);
+      });
+      return;
+    }
+
+    case method_case("getZoomScale"): {
+      g_autoptr(FlValue) result = fl_value_new_float(webView->getZoomScale());
       fl_method_call_respond_success(method_call, result, nullptr);
-      g_object_unref(method_call);
-    });
-    return;
-  }
+      return;
+    }
 
-  if (string_equals(methodName, "getScrollY")) {
-    g_object_ref(method_call);
-    webView->getScrollY([method_call](int64_t scrollY) {
-      g_autoptr(FlValue) result = fl_value_new_int(scrollY);
+    case method_case("setZoomScale"): {
+      double zoomScale = get_fl_map_value<double>(args, "zoomScale", 1.0);
+      webView->setZoomScale(zoomScale);
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
       fl_method_call_respond_success(method_call, result, nullptr);
-      g_object_unref(method_call);
-    });
-    return;
-  }
+      return;
+    }
 
-  if (string_equals(methodName, "getContentHeight")) {
-    // Capture method_call for async callback
-    g_object_ref(method_call);
-    webView->getContentHeight([method_call](int64_t height) {
-      g_autoptr(FlValue) result = fl_value_new_int(height);
+    case method_case("scrollTo"): {
+      int64_t x = get_fl_map_value<int64_t>(args, "x", 0);
+      int64_t y = get_fl_map_value<int64_t>(args, "y", 0);
+      bool animated = get_fl_map_value<bool>(args, "animated", false);
+      webView->scrollTo(x, y, animated);
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
       fl_method_call_respond_success(method_call, result, nullptr);
-      g_object_unref(method_call);
-    });
-    return;
-  }
+      return;
+    }
 
-  if (string_equals(methodName, "getContentWidth")) {
-    // Capture method_call for async callback
-    g_object_ref(method_call);
-    webView->getContentWidth([method_call](int64_t width) {
-      g_autoptr(FlValue) result = fl_value_new_int(width);
+    case method_case("scrollBy"): {
+      int64_t x = get_fl_map_value<int64_t>(args, "x", 0);
+      int64_t y = get_fl_map_value<int64_t>(args, "y", 0);
+      bool animated = get_fl_map_value<bool>(args, "animated", false);
+      webView->scrollBy(x, y, animated);
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
       fl_method_call_respond_success(method_call, result, nullptr);
-      g_object_unref(method_call);
-    });
-    return;
-  }
+      return;
+    }
 
-  // === User Script Methods ===
-  if (string_equals(methodName, "addUserScript")) {
-    FlValue* user_script_value = get_fl_map_value_raw(args, "userScript");
-    if (user_script_value != nullptr && fl_value_get_type(user_script_value) == FL_VALUE_TYPE_MAP) {
-      auto userScript = std::make_shared<UserScript>(user_script_value);
-      webView->addUserScript(userScript);
+    case method_case("getScrollX"): {
+      g_object_ref(method_call);
+      webView->getScrollX([method_call](int64_t scrollX) {
+        g_autoptr(FlValue) result = fl_value_new_int(scrollX);
+        fl_method_call_respond_success(method_call, result, nullptr);
+        g_object_unref(method_call);
+      });
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "removeUserScript")) {
-    int64_t index = get_fl_map_value<int64_t>(args, "index", 0);
-    int64_t injectionTimeInt = get_fl_map_value<int64_t>(args, "injectionTime", 0);
-    auto injectionTime = static_cast<UserScriptInjectionTime>(injectionTimeInt);
-    webView->removeUserScriptAt(static_cast<size_t>(index), injectionTime);
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("getScrollY"): {
+      g_object_ref(method_call);
+      webView->getScrollY([method_call](int64_t scrollY) {
+        g_autoptr(FlValue) result = fl_value_new_int(scrollY);
+        fl_method_call_respond_success(method_call, result, nullptr);
+        g_object_unref(method_call);
+      });
+      return;
+    }
+
+    case method_case("getContentHeight"): {
+      // Capture method_call for async callback
+      g_object_ref(method_call);
+      webView->getContentHeight([method_call](int64_t height) {
+        g_autoptr(FlValue) result = fl_value_new_int(height);
+        fl_method_call_respond_success(method_call, result, nullptr);
+        g_object_unref(method_call);
+      });
+      return;
+    }
 
-  if (string_equals(methodName, "removeUserScriptsByGroupName")) {
-    std::string groupName = get_fl_map_value<std::string>(args, "groupName", "");
-    if (!groupName.empty()) {
-      webView->removeUserScriptsByGroupName(groupName);
+    case method_case("getContentWidth"): {
+      // Capture method_call for async callback
+      g_object_ref(method_call);
+      webView->getContentWidth([method_call](int64_t width) {
+        g_autoptr(FlValue) result = fl_value_new_int(width);
+        fl_method_call_respond_success(method_call, result, nullptr);
+        g_object_unref(method_call);
+      });
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "removeAllUserScripts")) {
-    webView->removeAllUserScripts();
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    // === User Script Methods ===
+    case method_case("addUserScript"): {
+      FlValue* user_script_value = get_fl_map_value_raw(args, "userScript");
+      if (user_script_value != nullptr && fl_value_get_type(user_script_value) == FL_VALUE_TYPE_MAP) {
+        auto userScript = std::make_shared<UserScript>(user_script_value);
+        webView->addUserScript(userScript);
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
+
+    case method_case("removeUserScript"): {
+      int64_t index = get_fl_map_value<int64_t>(args, "index", 0);
+      int64_t injectionTimeInt = get_fl_map_value<int64_t>(args, "injectionTime", 0);
+      auto injectionTime = static_cast<UserScriptInjectionTime>(injectionTimeInt);
+      webView->removeUserScriptAt(static_cast<size_t>(index), injectionTime);
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
+
+    case method_case("removeUserScriptsByGroupName"): {
+      std::string groupName = get_fl_map_value<std::string>(args, "groupName", "");
+      if (!groupName.empty()) {
+        webView->removeUserScriptsByGroupName(groupName);
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
+
+    case method_case("removeAllUserScripts"): {
+      webView->removeAllUserScripts();
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  // === Web Message Listener Methods ===
-  if (string_equals(methodName, "addWebMessageListener")) {
-    FlValue* listener_value = get_fl_map_value_raw(args, "webMessageListener");
-    if (listener_value != nullptr && fl_value_get_type(listener_value) == FL_VALUE_TYPE_MAP) {
-      std::string jsObjectName = get_fl_map_value<std::string>(listener_value, "jsObjectName", "");
-      std::vector<std::string> allowedOriginRules = 
-          get_fl_map_value<std::vector<std::string>>(listener_value, "allowedOriginRules", std::vector<std::string>());
+    // === Web Message Listener Methods ===
+    case method_case("addWebMessageListener"): {
+      FlValue* listener_value = get_fl_map_value_raw(args, "webMessageListener");
+      if (listener_value != nullptr && fl_value_get_type(listener_value) == FL_VALUE_TYPE_MAP) {
+        std::string jsObjectName = get_fl_map_value<std::string>(listener_value, "jsObjectName", "");
+        std::vector<std::string> allowedOriginRules = 
+            get_fl_map_value<std::vector<std::string>>(listener_value, "allowedOriginRules", std::vector<std::string>());
       
-      if (!jsObjectName.empty()) {
-        webView->addWebMessageListener(jsObjectName, allowedOriginRules);
+        if (!jsObjectName.empty()) {
+          webView->addWebMessageListener(jsObjectName, allowedOriginRules);
+        }
       }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  // === Web Message Channel Methods ===
-  if (string_equals(methodName, "createWebMessageChannel")) {
-    // Ref the method call for async response
-    g_object_ref(method_call);
+    // === Web Message Channel Methods ===
+    case method_case("createWebMessageChannel"): {
+      // Ref the method call for async response
+      g_object_ref(method_call);
     
-    webView->createWebMessageChannel([method_call](const std::optional<std::string>& channelId) {
-      if (channelId.has_value()) {
-        g_autoptr(FlValue) result = to_fl_map({
-            {"id", make_fl_value(*channelId)},
-        });
-        fl_method_call_respond_success(method_call, result, nullptr);
-      } else {
-        fl_method_call_respond_success(method_call, fl_value_new_null(), nullptr);
-      }
-      g_object_unref(method_call);
-    });
-    return;
-  }
+      webView->createWebMessageChannel([method_call](const std::optional<std::string>& channelId) {
+        if (channelId.has_value()) {
+          g_autoptr(FlValue) result = to_fl_map({
+              {"id", make_fl_value(*channelId)},
+          });
+          fl_method_call_respond_success(method_call, result, nullptr);
+        } else {
+          fl_method_call_respond_success(method_call, fl_value_new_null(), nullptr);
+        }
+        g_object_unref(method_call);
+      });
+      return;
+    }
 
-  if (string_equals(methodName, "postWebMessage")) {
-    FlValue* message_value = get_fl_map_value_raw(args, "message");
-    std::string targetOrigin = get_fl_map_value<std::string>(args, "targetOrigin", "*");
+    case method_case("postWebMessage"): {
+      FlValue* message_value = get_fl_map_value_raw(args, "message");
+      std::string targetOrigin = get_fl_map_value<std::string>(args, "targetOrigin", "*");
     
-    if (message_value != nullptr && fl_value_get_type(message_value) == FL_VALUE_TYPE_MAP) {
-      // Extract message data
-      std::string data = "";
-      int64_t type = 0;  // 0 = string, 1 = arrayBuffer
+      if (message_value != nullptr && fl_value_get_type(message_value) == FL_VALUE_TYPE_MAP) {
+        // Extract message data
+        std::string data = "";
+        int64_t type = 0;  // 0 = string, 1 = arrayBuffer
       
-      FlValue* data_value = fl_value_lookup_string(message_value, "data");
-      FlValue* type_value = fl_value_lookup_string(message_value, "type");
+        FlValue* data_value = fl_value_lookup_string(message_value, "data");
+        FlValue* type_value = fl_value_lookup_string(message_value, "type");
       
-      if (data_value != nullptr && fl_value_get_type(data_value) == FL_VALUE_TYPE_STRING) {
-        data = fl_value_get_string(data_value);
-      }
-      if (type_value != nullptr && fl_value_get_type(type_value) == FL_VALUE_TYPE_INT) {
-        type = fl_value_get_int(type_value);
-      }
+        if (data_value != nullptr && fl_value_get_type(data_value) == FL_VALUE_TYPE_STRING) {
+          data = fl_value_get_string(data_value);
+        }
+        if (type_value != nullptr && fl_value_get_type(type_value) == FL_VALUE_TYPE_INT) {
+          type = fl_value_get_int(type_value);
+        }
       
-      webView->postWebMessage(data, targetOrigin, type);
+        webView->postWebMessage(data, targetOrigin, type);
+      }
+      g_autoptr(FlValue) result = fl_value_new_bool(true);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
     }
-    g_autoptr(FlValue) result = fl_value_new_bool(true);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "isInFullscreen")) {
-    bool fullscreen = webView->isInFullscreen();
-    g_autoptr(FlValue) result = fl_value_new_bool(fullscreen);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("isInFullscreen"): {
+      bool fullscreen = webView->isInFullscreen();
+      g_autoptr(FlValue) result = fl_value_new_bool(fullscreen);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "requestEnterFullscreen")) {
-    webView->requestEnterFullscreen();
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
+    case method_case("requestEnterFullscreen"): {
+      webView->requestEnterFullscreen();
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "requestExitFullscreen")) {
-    webView->requestExitFullscreen();
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
+    case method_case("requestExitFullscreen"): {
+      webView->requestExitFullscreen();
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "setVisible")) {
-    bool visible = true;
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_BOOL) {
-      visible = fl_value_get_bool(args);
-    } else if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
-      visible = fl_value_get_int(args) != 0;
+    case method_case("setVisible"): {
+      bool visible = true;
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_BOOL) {
+        visible = fl_value_get_bool(args);
+      } else if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
+        visible = fl_value_get_int(args) != 0;
+      }
+      webView->setVisible(visible);
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    webView->setVisible(visible);
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "setTargetRefreshRate")) {
-    uint32_t rate = 0;
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
-      rate = static_cast<uint32_t>(fl_value_get_int(args));
+    case method_case("setTargetRefreshRate"): {
+      uint32_t rate = 0;
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
+        rate = static_cast<uint32_t>(fl_value_get_int(args));
+      }
+      webView->setTargetRefreshRate(rate);
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    webView->setTargetRefreshRate(rate);
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "getTargetRefreshRate")) {
-    uint32_t rate = webView->getTargetRefreshRate();
-    g_autoptr(FlValue) result = fl_value_new_int(static_cast<int64_t>(rate));
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("getTargetRefreshRate"): {
+      uint32_t rate = webView->getTargetRefreshRate();
+      g_autoptr(FlValue) result = fl_value_new_int(static_cast<int64_t>(rate));
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "getScreenScale")) {
-    double scale = webView->getScreenScale();
-    g_autoptr(FlValue) result = fl_value_new_float(scale);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("getScreenScale"): {
+      double scale = webView->getScreenScale();
+      g_autoptr(FlValue) result = fl_value_new_float(scale);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "setScreenScale")) {
-    double scale = 1.0;
-    if (fl_value_get_type(args) == FL_VALUE_TYPE_FLOAT) {
-      scale = fl_value_get_float(args);
-    } else if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
-      scale = static_cast<double>(fl_value_get_int(args));
+    case method_case("setScreenScale"): {
+      double scale = 1.0;
+      if (fl_value_get_type(args) == FL_VALUE_TYPE_FLOAT) {
+        scale = fl_value_get_float(args);
+      } else if (fl_value_get_type(args) == FL_VALUE_TYPE_INT) {
+        scale = static_cast<double>(fl_value_get_int(args));
+      }
+      webView->setScreenScale(scale);
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    webView->setScreenScale(scale);
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "isVisible")) {
-    bool visible = webView->isVisible();
-    g_autoptr(FlValue) result = fl_value_new_bool(visible);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("isVisible"): {
+      bool visible = webView->isVisible();
+      g_autoptr(FlValue) result = fl_value_new_bool(visible);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "requestPointerLock")) {
-    bool success = webView->requestPointerLock();
-    g_autoptr(FlValue) result = fl_value_new_bool(success);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("requestPointerLock"): {
+      bool success = webView->requestPointerLock();
+      g_autoptr(FlValue) result = fl_value_new_bool(success);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "requestPointerUnlock")) {
-    bool success = webView->requestPointerUnlock();
-    g_autoptr(FlValue) result = fl_value_new_bool(success);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("requestPointerUnlock"): {
+      bool success = webView->requestPointerUnlock();
+      g_autoptr(FlValue) result = fl_value_new_bool(success);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "hideContextMenu")) {
-    webView->HideContextMenu();
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
+    case method_case("hideContextMenu"): {
+      webView->HideContextMenu();
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-  // === Media Playback Control ===
-  if (string_equals(methodName, "pauseAllMediaPlayback")) {
-    webView->pauseAllMediaPlayback();
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
+    // === Media Playback Control ===
+    case method_case("pauseAllMediaPlayback"): {
+      webView->pauseAllMediaPlayback();
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "setAllMediaPlaybackSuspended")) {
-    bool suspended = get_fl_map_value<bool>(args, "suspended", false);
-    webView->setAllMediaPlaybackSuspended(suspended);
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
+    case method_case("setAllMediaPlaybackSuspended"): {
+      bool suspended = get_fl_map_value<bool>(args, "suspended", false);
+      webView->setAllMediaPlaybackSuspended(suspended);
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "closeAllMediaPresentations")) {
-    webView->closeAllMediaPresentations();
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
+    case method_case("closeAllMediaPresentations"): {
+      webView->closeAllMediaPresentations();
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
+
+    case method_case("requestMediaPlaybackState"): {
+      g_object_ref(method_call);
+      webView->requestMediaPlaybackState([method_call](int state) {
+        g_autoptr(FlValue) result = fl_value_new_int(state);
+        fl_method_call_respond_success(method_call, result, nullptr);
+        g_object_unref(method_call);
+      });
+      return;
+    }
 
-  if (string_equals(methodName, "requestMediaPlaybackState")) {
-    g_object_ref(method_call);
-    webView->requestMediaPlaybackState([method_call](int state) {
+    // === Media Capture State (Camera and Microphone) ===
+    case method_case("getCameraCaptureState"): {
+      int state = webView->getCameraCaptureState();
       g_autoptr(FlValue) result = fl_value_new_int(state);
       fl_method_call_respond_success(method_call, result, nullptr);
-      g_object_unref(method_call);
-    });
-    return;
-  }
+      return;
+    }
 
-  // === Media Capture State (Camera and Microphone) ===
-  if (string_equals(methodName, "getCameraCaptureState")) {
-    int state = webView->getCameraCaptureState();
-    g_autoptr(FlValue) result = fl_value_new_int(state);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("setCameraCaptureState"): {
+      int64_t state = get_fl_map_value<int64_t>(args, "state", 0);
+      webView->setCameraCaptureState(static_cast<int>(state));
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "setCameraCaptureState")) {
-    int64_t state = get_fl_map_value<int64_t>(args, "state", 0);
-    webView->setCameraCaptureState(static_cast<int>(state));
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
+    case method_case("getMicrophoneCaptureState"): {
+      int state = webView->getMicrophoneCaptureState();
+      g_autoptr(FlValue) result = fl_value_new_int(state);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "getMicrophoneCaptureState")) {
-    int state = webView->getMicrophoneCaptureState();
-    g_autoptr(FlValue) result = fl_value_new_int(state);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("setMicrophoneCaptureState"): {
+      int64_t state = get_fl_map_value<int64_t>(args, "state", 0);
+      webView->setMicrophoneCaptureState(static_cast<int>(state));
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "setMicrophoneCaptureState")) {
-    int64_t state = get_fl_map_value<int64_t>(args, "state", 0);
-    webView->setMicrophoneCaptureState(static_cast<int>(state));
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
+    // === Theme Color ===
+    case method_case("getMetaThemeColor"): {
+      auto themeColor = webView->getMetaThemeColor();
+      if (themeColor.has_value()) {
+        g_autoptr(FlValue) result = fl_value_new_string(themeColor->c_str());
+        fl_method_call_respond_success(method_call, result, nullptr);
+      } else {
+        fl_method_call_respond_success(method_call, nullptr, nullptr);
+      }
+      return;
+    }
 
-  // === Theme Color ===
-  if (string_equals(methodName, "getMetaThemeColor")) {
-    auto themeColor = webView->getMetaThemeColor();
-    if (themeColor.has_value()) {
-      g_autoptr(FlValue) result = fl_value_new_string(themeColor->c_str());
+    // === Audio State (Playing and Mute) ===
+    case method_case("isPlayingAudio"): {
+      bool isPlaying = webView->isPlayingAudio();
+      g_autoptr(FlValue) result = fl_value_new_bool(isPlaying);
       fl_method_call_respond_success(method_call, result, nullptr);
-    } else {
-      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
     }
-    return;
-  }
-
-  // === Audio State (Playing and Mute) ===
-  if (string_equals(methodName, "isPlayingAudio")) {
-    bool isPlaying = webView->isPlayingAudio();
-    g_autoptr(FlValue) result = fl_value_new_bool(isPlaying);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
 
-  if (string_equals(methodName, "isMuted")) {
-    bool isMuted = webView->isMuted();
-    g_autoptr(FlValue) result = fl_value_new_bool(isMuted);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
-  }
+    case method_case("isMuted"): {
+      bool isMuted = webView->isMuted();
+      g_autoptr(FlValue) result = fl_value_new_bool(isMuted);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "setMuted")) {
-    bool muted = get_fl_map_value<bool>(args, "muted", false);
-    webView->setMuted(muted);
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
+    case method_case("setMuted"): {
+      bool muted = get_fl_map_value<bool>(args, "muted", false);
+      webView->setMuted(muted);
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-  // === Web Process Control ===
-  if (string_equals(methodName, "terminateWebProcess")) {
-    webView->terminateWebProcess();
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
+    // === Web Process Control ===
+    case method_case("terminateWebProcess"): {
+      webView->terminateWebProcess();
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-  // === Focus Control ===
-  if (string_equals(methodName, "clearFocus")) {
-    webView->clearFocus();
-    fl_method_call_respond_success(method_call, nullptr, nullptr);
-    return;
-  }
+    // === Focus Control ===
+    case method_case("clearFocus"): {
+      webView->clearFocus();
+      fl_method_call_respond_success(method_call, nullptr, nullptr);
+      return;
+    }
 
-  if (string_equals(methodName, "requestFocus")) {
-    bool success = webView->requestFocus();
-    g_autoptr(FlValue) result = fl_value_new_bool(success);
-    fl_method_call_respond_success(method_call, result, nullptr);
-    return;
+    case method_case("requestFocus"): {
+      bool success = webView->requestFocus();
+      g_autoptr(FlValue) result = fl_value_new_bool(success);
+      fl_method_call_respond_success(method_call, result, nullptr);
+      return;
+    }
+    default:
+      break;
   }
 
   fl_method_call_respond_not_implemented(method_call, nullptr);
@@ -1121,6 +1380,19 @@ void WebViewChannelDelegate::onLoadStart(const std::optional<std::string>& url)
   invokeMethod("onLoadStart", args);
 }
 
+void WebViewChannelDelegate::onEvaluateJavascriptResultChunk(int64_t requestId,
+                                                             const char* data,
+                                                             size_t length) const {
+  if (!channel_) {
+    return;
+  }
+
+  g_autoptr(FlValue) args = to_fl_map({{"requestId", make_fl_value(requestId)},
+                                       {"data", fl_value_new_string_sized(data, length)}});
+
+  invokeMethod("onEvaluateJavascriptResultChunk", args);
+}
+
 void WebViewChannelDelegate::onLoadStop(const std::optional<std::string>& url) const {
   if (!channel_) {
     return;
@@ -1136,9 +1408,9 @@ void WebViewChannelDelegate::onProgressChanged(int64_t progress) const {
     return;
   }
 
-  g_autoptr(FlValue) args = to_fl_map({{"progress", make_fl_value(progress)}});
+  progress_changed_payload_.set(0, make_fl_value(progress));
 
-  invokeMethod("onProgressChanged", args);
+  invokeMethod("onProgressChanged", progress_changed_payload_.get());
 }
 
 void WebViewChannelDelegate::onTitleChanged(const std::optional<std::string>& title) const {
@@ -1213,10 +1485,30 @@ void WebViewChannelDelegate::onConsoleMessage(const std::string& message,
     return;
   }
 
+  console_message_payload_.set(0, make_fl_value(message)).set(1, make_fl_value(messageLevel));
+
+  invokeMethod("onConsoleMessage", console_message_payload_.get());
+}
+
+void WebViewChannelDelegate::onConsoleMessages(const std::vector<ConsoleMessageEntry>& messages,
+                                               int64_t droppedCount) const {
+  if (!channel_) {
+    return;
+  }
+
+  FlValue* messageList = fl_value_new_list();
+  for (const auto& entry : messages) {
+    FlValue* item = fl_value_new_map();
+    fl_value_set_interned_take(item, "message", make_fl_value(entry.message));
+    fl_value_set_interned_take(item, "messageLevel", make_fl_value(entry.messageLevel));
+    fl_value_set_interned_take(item, "timestamp", make_fl_value(entry.timestamp));
+    fl_value_append_take(messageList, item);
+  }
+
   g_autoptr(FlValue) args =
-      to_fl_map({{"message", make_fl_value(message)}, {"messageLevel", make_fl_value(messageLevel)}});
+      to_fl_map({{"messages", messageList}, {"droppedCount", make_fl_value(droppedCount)}});
 
-  invokeMethod("onConsoleMessage", args);
+  invokeMethod("onConsoleMessages", args);
 }
 
 void WebViewChannelDelegate::onLoadResource(const std::string& url,
@@ -1227,12 +1519,32 @@ void WebViewChannelDelegate::onLoadResource(const std::string& url,
     return;
   }
 
-  g_autoptr(FlValue) args = to_fl_map({{"url", make_fl_value(url)},
-                                      {"initiatorType", make_fl_value(initiatorType)},
-                                      {"startTime", make_fl_value(startTime)},
-                                      {"duration", make_fl_value(duration)}});
+  load_resource_payload_.set(0, make_fl_value(url))
+      .set(1, make_fl_value(initiatorType))
+      .set(2, make_fl_value(startTime))
+      .set(3, make_fl_value(duration));
+
+  invokeMethod("onLoadResource", load_resource_payload_.get());
+}
+
+void WebViewChannelDelegate::onLoadResources(const std::vector<LoadResourceEntry>& resources) const {
+  if (!channel_) {
+    return;
+  }
+
+  FlValue* resourceList = fl_value_new_list();
+  for (const auto& entry : resources) {
+    FlValue* item = fl_value_new_map();
+    fl_value_set_interned_take(item, "url", make_fl_value(entry.url));
+    fl_value_set_interned_take(item, "initiatorType", make_fl_value(entry.initiatorType));
+    fl_value_set_interned_take(item, "startTime", make_fl_value(entry.startTime));
+    fl_value_set_interned_take(item, "duration", make_fl_value(entry.duration));
+    fl_value_append_take(resourceList, item);
+  }
+
+  g_autoptr(FlValue) args = to_fl_map({{"resources", resourceList}});
 
-  invokeMethod("onLoadResource", args);
+  invokeMethod("onLoadResources", args);
 }
 
 void WebViewChannelDelegate::onReceivedError(std::shared_ptr<WebResourceRequest> request,
@@ -1339,9 +1651,9 @@ void WebViewChannelDelegate::onScrollChanged(int64_t x, int64_t y) const {
     return;
   }
 
-  g_autoptr(FlValue) args = to_fl_map({{"x", make_fl_value(x)}, {"y", make_fl_value(y)}});
+  scroll_changed_payload_.set(0, make_fl_value(x)).set(1, make_fl_value(y));
 
-  invokeMethod("onScrollChanged", args);
+  invokeMethod("onScrollChanged", scroll_changed_payload_.get());
 }
 
 void WebViewChannelDelegate::shouldInterceptRequest(
@@ -1396,13 +1708,17 @@ void WebViewChannelDelegate::onWebViewCreated() const {
   invokeMethod("onWebViewCreated", args);
 }
 
-void WebViewChannelDelegate::onContentSizeChanged(int64_t width, int64_t height) const {
+void WebViewChannelDelegate::onContentSizeChanged(int64_t oldWidth, int64_t oldHeight,
+                                                  int64_t newWidth, int64_t newHeight) const {
   if (!channel_) {
     return;
   }
 
-  g_autoptr(FlValue) args =
-      to_fl_map({{"width", make_fl_value(width)}, {"height", make_fl_value(height)}});
+  g_autoptr(FlValue) args = to_fl_map(
+      {{"oldContentSize",
+        to_fl_map({{"width", make_fl_value(oldWidth)}, {"height", make_fl_value(oldHeight)}})},
+       {"newContentSize",
+        to_fl_map({{"width", make_fl_value(newWidth)}, {"height", make_fl_value(newHeight)}})}});
 
   invokeMethod("onContentSizeChanged", args);
 }
@@ -1973,6 +2289,60 @@ void WebViewChannelDelegate::onLoadResourceWithCustomScheme(
       callbackPtr);
 }
 
+void WebViewChannelDelegate::onCustomSchemeResponseStreamPull(
+    int64_t streamId, std::unique_ptr<CustomSchemeResponseStreamPullCallback> callback) const {
+  if (!channel_) {
+    if (callback) {
+      callback->handleError("CHANNEL_ERROR", "Channel not available");
+    }
+    return;
+  }
+
+  g_autoptr(FlValue) args = to_fl_map({{"streamId", make_fl_value(streamId)}});
+
+  auto* callbackPtr = callback.release();
+
+  invokeMethodWithResult(
+      "onCustomSchemeResponseStreamPull", args,
+      [](GObject* source, GAsyncResult* result, gpointer user_data) {
+        auto* cb = static_cast<CustomSchemeResponseStreamPullCallback*>(user_data);
+        FlMethodChannel* ch = FL_METHOD_CHANNEL(source);
+
+        g_autoptr(GError) error = nullptr;
+        g_autoptr(FlMethodResponse) response =
+            fl_method_channel_invoke_method_finish(ch, result, &error);
+
+        if (error != nullptr) {
+          cb->handleError("CHANNEL_ERROR", error->message);
+        } else if (FL_IS_METHOD_SUCCESS_RESPONSE(response)) {
+          FlValue* returnValue =
+              fl_method_success_response_get_result(FL_METHOD_SUCCESS_RESPONSE(response));
+          cb->handleResult(returnValue);
+        } else if (FL_IS_METHOD_ERROR_RESPONSE(response)) {
+          FlMethodErrorResponse* errorResponse = FL_METHOD_ERROR_RESPONSE(response);
+          cb->handleError(fl_method_error_response_get_code(errorResponse),
+                          fl_method_error_response_get_message(errorResponse));
+        } else {
+          cb->handleNotImplemented();
+        }
+
+        delete cb;
+      },
+      callbackPtr);
+}
+
+void WebViewChannelDelegate::onCustomSchemeResponseStreamClosed(int64_t streamId,
+                                                                bool completed) const {
+  if (!channel_) {
+    return;
+  }
+
+  g_autoptr(FlValue) args =
+      to_fl_map({{"streamId", make_fl_value(streamId)}, {"completed", make_fl_value(completed)}});
+
+  invokeMethod("onCustomSchemeResponseStreamClosed", args);
+}
+
 void WebViewChannelDelegate::onCameraCaptureStateChanged(int oldState, int newState) const {
   if (!channel_) {
     return;
@@ -38,6 +38,7 @@
 #include "../types/web_resource_error.h"
 #include "../types/web_resource_request.h"
 #include "../types/web_resource_response.h"
+#include "../utils/fl_value_pool.h"
 
 namespace flutter_inappwebview_plugin {
 
@@ -45,6 +46,21 @@ class InAppWebView;
 
 enum class NavigationActionPolicy { cancel = 0, allow = 1 };
 
+// A console message collected by the console log plugin script
+struct ConsoleMessageEntry {
+  std::string message;
+  int64_t messageLevel = 1;
+  double timestamp = 0;  // Milliseconds since epoch, as reported by the page
+};
+
+// A resource load reported by the onLoadResource plugin script
+struct LoadResourceEntry {
+  std::string url;
+  std::string initiatorType;
+  double startTime = 0;
+  double duration = 0;
+};
+
 class WebViewChannelDelegate : public ChannelDelegate {
  public:
   InAppWebView* webView;
@@ -186,6 +202,17 @@ class WebViewChannelDelegate : public ChannelDelegate {
     ~LoadResourceWithCustomSchemeCallback() = default;
   };
 
+  /**
+   * Callback for onCustomSchemeResponseStreamPull.
+   * Returns the next chunk (Uint8List, borrowed for the duration of
+   * nonNullSuccess), or null at the end of the body.
+   */
+  class CustomSchemeResponseStreamPullCallback : public BaseCallbackResult<FlValue*> {
+   public:
+    CustomSchemeResponseStreamPullCallback();
+    ~CustomSchemeResponseStreamPullCallback() = default;
+  };
+
   // === Constructors/Destructor ===
 
   WebViewChannelDelegate(InAppWebView* webView, FlBinaryMessenger* messenger);
@@ -213,13 +240,17 @@ class WebViewChannelDelegate : public ChannelDelegate {
   void onReceivedHttpError(std::shared_ptr<WebResourceRequest> request,
                            std::shared_ptr<WebResourceResponse> errorResponse) const;
 
+  void onEvaluateJavascriptResultChunk(int64_t requestId, const char* data, size_t length) const;
   void onConsoleMessage(const std::string& message, int64_t messageLevel) const;
+  void onConsoleMessages(const std::vector<ConsoleMessageEntry>& messages, int64_t droppedCount) const;
 
   void onLoadResource(const std::string& url,
                       const std::string& initiatorType,
                       double startTime,
                       double duration) const;
 
+  void onLoadResources(const std::vector<LoadResourceEntry>& resources) const;
+
   void onCallJsHandler(const std::string& handlerName,
                        std::unique_ptr<JavaScriptHandlerFunctionData> data,
                        std::unique_ptr<CallJsHandlerCallback> callback) const;
@@ -237,7 +268,8 @@ class WebViewChannelDelegate : public ChannelDelegate {
 
   void onWebViewCreated() const;
 
-  void onContentSizeChanged(int64_t width, int64_t height) const;
+  void onContentSizeChanged(int64_t oldWidth, int64_t oldHeight, int64_t newWidth,
+                            int64_t newHeight) const;
 
   void onCreateWindow(std::unique_ptr<CreateWindowAction> createWindowAction,
                       std::unique_ptr<CreateWindowCallback> callback) const;
@@ -289,6 +321,11 @@ class WebViewChannelDelegate : public ChannelDelegate {
   void onLoadResourceWithCustomScheme(
       std::shared_ptr<WebResourceRequest> request,
       std::unique_ptr<LoadResourceWithCustomSchemeCallback> callback) const;
+  // Streamed custom scheme responses: asks Dart for the next body chunk
+  void onCustomSchemeResponseStreamPull(
+      int64_t streamId, std::unique_ptr<CustomSchemeResponseStreamPullCallback> callback) const;
+  // The stream was fully read (completed) or WebKit stopped reading it
+  void onCustomSchemeResponseStreamClosed(int64_t streamId, bool completed) const;
 
   // Context menu callbacks
   void onCreateContextMenu(const HitTestResult& hitTestResult) const;
@@ -353,6 +390,12 @@ class WebViewChannelDelegate : public ChannelDelegate {
   void HandleGetScrollY(FlMethodCall* method_call);
   void HandleGetSettings(FlMethodCall* method_call);
   void HandleSetSettings(FlMethodCall* method_call);
+
+  // Reused argument maps for events sent at a high rate with a fixed shape
+  mutable FlValuePayload scroll_changed_payload_{"x", "y"};
+  mutable FlValuePayload progress_changed_payload_{"progress"};
+  mutable FlValuePayload console_message_payload_{"message", "messageLevel"};
+  mutable FlValuePayload load_resource_payload_{"url", "initiatorType", "startTime", "duration"};
 };
 
 }  // namespace flutter_inappwebview_plugin
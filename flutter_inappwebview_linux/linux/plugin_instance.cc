@@ -1,5 +1,6 @@
 #include "plugin_instance.h"
 
+#include "content_blocker/content_filter_registry.h"
 #include "flutter_inappwebview_linux_plugin_private.h"
 
 namespace flutter_inappwebview_plugin {
@@ -9,8 +10,12 @@ PluginInstance::PluginInstance(FlPluginRegistrar* registrar)
   // Cache the GTK window and FlView now while the registrar is still fully valid
   gtk_window_ = flutter_inappwebview_linux_plugin_get_window(registrar);
   fl_view_ = flutter_inappwebview_linux_plugin_get_view(registrar);
+
+  content_filter_registry_ = std::make_unique<ContentFilterRegistry>();
 }
 
+PluginInstance::~PluginInstance() = default;
+
 FlBinaryMessenger* PluginInstance::messenger() const {
   return fl_plugin_registrar_get_messenger(registrar_);
 }
@@ -4,6 +4,8 @@
 #include <flutter_linux/flutter_linux.h>
 #include <gtk/gtk.h>
 
+#include <memory>
+
 namespace flutter_inappwebview_plugin {
 
 // Forward declarations
@@ -15,6 +17,7 @@ class CredentialDatabase;
 class ProxyManager;
 class WebStorageManager;
 class WebViewEnvironment;
+class ContentFilterRegistry;
 
 /// Plugin instance - provides access to all managers
 /// This is the C++ equivalent of FlutterInappwebviewWindowsPlugin
@@ -25,7 +28,7 @@ class WebViewEnvironment;
 class PluginInstance {
 public:
   explicit PluginInstance(FlPluginRegistrar* registrar);
-  ~PluginInstance() = default;
+  ~PluginInstance();
 
   // Prevent copying
   PluginInstance(const PluginInstance&) = delete;
@@ -46,6 +49,9 @@ public:
   /// Get the Flutter view (may be nullptr for headless scenarios)
   FlView* flView() const { return fl_view_; }
 
+  /// Get the content filters shared by all webviews
+  ContentFilterRegistry* contentFilterRegistry() const { return content_filter_registry_.get(); }
+
   // Manager accessors - set by the main plugin after creation
   InAppWebViewManager* inAppWebViewManager = nullptr;
   HeadlessInAppWebViewManager* headlessInAppWebViewManager = nullptr;
@@ -60,6 +66,8 @@ private:
   FlPluginRegistrar* registrar_ = nullptr;
   GtkWindow* gtk_window_ = nullptr;  // Cached during plugin registration
   FlView* fl_view_ = nullptr;        // Cached during plugin registration
+  // Destroyed after the managers, and so after every webview using it
+  std::unique_ptr<ContentFilterRegistry> content_filter_registry_;
 };
 
 }  // namespace flutter_inappwebview_plugin
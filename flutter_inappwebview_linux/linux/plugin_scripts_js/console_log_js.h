@@ -1,6 +1,7 @@
 #ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_CONSOLE_LOG_JS_H_
 #define FLUTTER_INAPPWEBVIEW_PLUGIN_CONSOLE_LOG_JS_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -28,27 +29,88 @@ class ConsoleLogJS {
    * This code wraps console.log, console.error, console.warn, console.info,
    * and console.debug to send messages to native code.
    *
-   * Must match iOS/macOS implementation - uses JavaScript bridge callHandler.
+   * Messages below minLevel (debug = 0, log/info = 1, warn = 2, error = 3) are
+   * filtered before they reach the bridge. At most maxMessagesPerSecond messages
+   * are kept (0 = unlimited), the rest are only counted. Kept messages are sent
+   * in batches, with a timestamp each, every batchInterval milliseconds.
    */
-  static std::string CONSOLE_LOG_JS_SOURCE() {
-    // Match iOS ConsoleLogJS.swift implementation exactly
+  static std::string CONSOLE_LOG_JS_SOURCE(int64_t minLevel = 0, int64_t maxMessagesPerSecond = 0,
+                                           int64_t batchInterval = 0) {
     return R"JS(
 (function(console) {
+    var bridge = window.)JS" +
+           JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME() + R"JS(;
+    var _setTimeout = window.setTimeout;
+    var _now = Date.now;
+    var levels = {'debug': 0, 'log': 1, 'info': 1, 'warn': 2, 'error': 3};
+    var config = {
+        'minLevel': )JS" + std::to_string(minLevel) + R"JS(,
+        'maxMessagesPerSecond': )JS" + std::to_string(maxMessagesPerSecond) + R"JS(,
+        'batchInterval': )JS" + std::to_string(batchInterval) + R"JS(
+    };
+    var queue = [];
+    var dropped = 0;
+    var flushScheduled = false;
+    var rateWindowStart = 0;
+    var rateWindowCount = 0;
+
+    function _flush() {
+        flushScheduled = false;
+        if (queue.length === 0 && dropped === 0) {
+            return;
+        }
+        var messages = queue;
+        var droppedCount = dropped;
+        queue = [];
+        dropped = 0;
+        try {
+            bridge.callHandler('onConsoleMessages', {'messages': messages, 'dropped': droppedCount});
+        } catch(_) {}
+    }
+
+    function _scheduleFlush() {
+        if (!flushScheduled) {
+            flushScheduled = true;
+            _setTimeout.call(window, _flush, config.batchInterval);
+        }
+    }
 
     function _callHandler(logLevel, args) {
+        if (levels[logLevel] < config.minLevel) {
+            return;
+        }
+        var now = _now();
+        if (config.maxMessagesPerSecond > 0) {
+            if (now - rateWindowStart >= 1000) {
+                rateWindowStart = now;
+                rateWindowCount = 0;
+            }
+            if (rateWindowCount >= config.maxMessagesPerSecond) {
+                dropped++;
+                _scheduleFlush();
+                return;
+            }
+            rateWindowCount++;
+        }
         var message = '';
         for (var i in args) {
             try {
                 message += message === '' ? args[i] : ' ' + args[i];
             } catch(_) {}
         }
-        try {
-            window.)JS" +
-           JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME() +
-           R"JS(.callHandler('onConsoleMessage', {'level': logLevel, 'message': message});
-        } catch(_) {}
+        queue.push({'level': logLevel, 'message': message, 'timestamp': now});
+        _scheduleFlush();
     }
 
+    if (bridge != null) {
+        bridge._configureConsoleLog = function(newConfig) {
+            for (var key in newConfig) {
+                config[key] = newConfig[key];
+            }
+        };
+    }
+    window.addEventListener('pagehide', _flush);
+
     var oldLogs = {
         'consoleLog': console.log,
         'consoleDebug': console.debug,
@@ -70,6 +132,18 @@ class ConsoleLogJS {
 )JS";
   }
 
+  /**
+   * Applies new console options to the current page without reloading it.
+   */
+  static std::string CONSOLE_LOG_CONFIGURE_JS_SOURCE(int64_t minLevel, int64_t maxMessagesPerSecond,
+                                                     int64_t batchInterval) {
+    return "(function() { var bridge = window." + JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME() +
+           "; if (bridge != null && typeof bridge._configureConsoleLog === 'function') {"
+           " bridge._configureConsoleLog({'minLevel': " + std::to_string(minLevel) +
+           ", 'maxMessagesPerSecond': " + std::to_string(maxMessagesPerSecond) +
+           ", 'batchInterval': " + std::to_string(batchInterval) + "}); } })();";
+  }
+
   /**
    * Creates a PluginScript for console log interception.
    *
@@ -77,9 +151,11 @@ class ConsoleLogJS {
    * could cause issues such as https://github.com/pichillilorenzo/flutter_inappwebview/issues/1738
    */
   static std::unique_ptr<PluginScript> CONSOLE_LOG_JS_PLUGIN_SCRIPT(
-      const std::optional<std::vector<std::string>>& allowedOriginRules) {
+      const std::optional<std::vector<std::string>>& allowedOriginRules, int64_t minLevel = 0,
+      int64_t maxMessagesPerSecond = 0, int64_t batchInterval = 0) {
     return std::make_unique<PluginScript>(
-        CONSOLE_LOG_JS_PLUGIN_SCRIPT_GROUP_NAME, CONSOLE_LOG_JS_SOURCE(),
+        CONSOLE_LOG_JS_PLUGIN_SCRIPT_GROUP_NAME,
+        CONSOLE_LOG_JS_SOURCE(minLevel, maxMessagesPerSecond, batchInterval),
         UserScriptInjectionTime::atDocumentStart,
         true,  // forMainFrameOnly
         allowedOriginRules,
@@ -0,0 +1,157 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_STATS_JS_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_STATS_JS_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../types/plugin_script.h"
+#include "javascript_bridge_js.h"
+
+namespace flutter_inappwebview_plugin {
+
+/**
+ * JavaScript for content blocker statistics.
+ *
+ * Reports the resources that failed to load (element error events and
+ * rejected fetch() calls) and the size of the resources that loaded, in
+ * batches, through the 'onContentBlockerResources' bridge message. The
+ * native side decides which failures were blocks by matching their URL
+ * against the block rules. Only injected while instrumentation is enabled.
+ */
+class ContentBlockerStatsJS {
+ public:
+  inline static const std::string CONTENT_BLOCKER_STATS_JS_PLUGIN_SCRIPT_GROUP_NAME =
+      "IN_APP_WEBVIEW_CONTENT_BLOCKER_STATS_JS_PLUGIN_SCRIPT";
+
+  /**
+   * Flag variable name used to stop reporting at runtime.
+   */
+  static std::string FLAG_VARIABLE_FOR_CONTENT_BLOCKER_STATS_JS_SOURCE() {
+    return "window." + JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME() +
+           "._useContentBlockerStats";
+  }
+
+  /**
+   * Milliseconds between two reports.
+   */
+  static constexpr int64_t REPORT_INTERVAL_MS = 1000;
+
+  static std::string CONTENT_BLOCKER_STATS_JS_SOURCE() {
+    const std::string flagVariable = FLAG_VARIABLE_FOR_CONTENT_BLOCKER_STATS_JS_SOURCE();
+    const std::string bridgeName = JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME();
+
+    return flagVariable + R"JS( = true;
+(function() {
+    if (window.)JS" + bridgeName + R"JS(._contentBlockerStatsInstalled) {
+        return;
+    }
+    window.)JS" + bridgeName + R"JS(._contentBlockerStatsInstalled = true;
+
+    var failed = [];
+    var loaded = [];
+    var scheduled = false;
+
+    function isEnabled() {
+        return )JS" + flagVariable + R"JS( == true;
+    }
+
+    function report() {
+        scheduled = false;
+        if (isEnabled() && (failed.length > 0 || loaded.length > 0)) {
+            window.)JS" + bridgeName + R"JS(.callHandler("onContentBlockerResources", {
+                "failed": failed,
+                "loaded": loaded
+            });
+        }
+        failed = [];
+        loaded = [];
+    }
+
+    function schedule() {
+        if (!scheduled) {
+            scheduled = true;
+            setTimeout(report, )JS" + std::to_string(REPORT_INTERVAL_MS) + R"JS();
+        }
+    }
+
+    function addFailed(url) {
+        if (isEnabled() && typeof url === 'string' && url.length > 0 && url.indexOf('data:') !== 0) {
+            failed.push(url);
+            schedule();
+        }
+    }
+
+    // Error events of subresources don't bubble, but are seen while capturing
+    window.addEventListener('error', function(event) {
+        var target = event.target;
+        if (target == null || target === window || target.tagName == null) {
+            return;
+        }
+        addFailed(target.currentSrc || target.src || target.href || target.data);
+    }, true);
+
+    if (typeof window.fetch === 'function') {
+        var originalFetch = window.fetch;
+        window.fetch = function(input, init) {
+            var url = null;
+            try {
+                url = input instanceof Request ? input.url : new URL(String(input), document.baseURI).href;
+            } catch (e) {}
+            return originalFetch.apply(this, arguments).catch(function(error) {
+                // Blocked and network errors both reject with a TypeError
+                if (error instanceof TypeError) {
+                    addFailed(url);
+                }
+                throw error;
+            });
+        };
+    }
+
+    // Sizes of cross-origin resources are 0 without Timing-Allow-Origin
+    try {
+        new PerformanceObserver(function(list) {
+            if (!isEnabled()) {
+                return;
+            }
+            list.getEntries().forEach(function(entry) {
+                var size = entry.encodedBodySize || entry.transferSize;
+                if (size > 0) {
+                    loaded.push({"url": entry.name, "size": size});
+                }
+            });
+            if (loaded.length > 0) {
+                schedule();
+            }
+        }).observe({entryTypes: ['resource']});
+    } catch (e) {}
+})();
+)JS";
+  }
+
+  /**
+   * Creates a PluginScript for content blocker statistics.
+   *
+   * @param allowedOriginRules Optional list of origin rules to restrict script injection.
+   * @param forMainFrameOnly Whether to inject only in main frame.
+   */
+  static std::unique_ptr<PluginScript> CONTENT_BLOCKER_STATS_JS_PLUGIN_SCRIPT(
+      const std::optional<std::vector<std::string>>& allowedOriginRules,
+      bool forMainFrameOnly) {
+    return std::make_unique<PluginScript>(
+        CONTENT_BLOCKER_STATS_JS_PLUGIN_SCRIPT_GROUP_NAME,
+        CONTENT_BLOCKER_STATS_JS_SOURCE(),
+        UserScriptInjectionTime::atDocumentStart,
+        forMainFrameOnly,
+        allowedOriginRules,
+        nullptr,                    // contentWorld
+        false,                      // requiredInAllContentWorlds
+        std::vector<std::string>{}  // no additional message handlers needed
+    );
+  }
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_STATS_JS_H_
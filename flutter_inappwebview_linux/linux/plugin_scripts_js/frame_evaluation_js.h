@@ -0,0 +1,95 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_FRAME_EVALUATION_JS_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_FRAME_EVALUATION_JS_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../types/plugin_script.h"
+#include "javascript_bridge_js.h"
+
+namespace flutter_inappwebview_plugin {
+
+/**
+ * JavaScript agent that lets native code evaluate scripts inside iframes.
+ *
+ * WPE WebKit can only evaluate JavaScript in the main frame from the UI
+ * process, so every subframe keeps one '_frameEvaluation' bridge call pending.
+ * Native code answers that call with a script to run; the agent evaluates it
+ * and reports the result with the next '_frameEvaluation' call, which parks
+ * the frame again. On pagehide the agent detaches itself.
+ */
+class FrameEvaluationJS {
+ public:
+  inline static const std::string FRAME_EVALUATION_JS_PLUGIN_SCRIPT_GROUP_NAME =
+      "IN_APP_WEBVIEW_FRAME_EVALUATION_JS_PLUGIN_SCRIPT";
+
+  static std::string FRAME_EVALUATION_JS_SOURCE() {
+    return R"JS(
+(function() {
+  // Only subframes need an agent, the main frame is evaluated directly
+  if (window.top === window || window._flutterInAppWebViewFrameEvaluationInit) return;
+  window._flutterInAppWebViewFrameEvaluationInit = true;
+
+  var bridge = window.)JS" + JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME() + R"JS(;
+  if (bridge == null || typeof bridge.callHandler !== 'function') return;
+
+  var _eval = window.eval;
+  var token = Math.random().toString(36).slice(2) + Date.now().toString(36);
+  var detached = false;
+
+  function frameInfo() {
+    return {
+      token: token,
+      url: window.location.href,
+      origin: window.location.origin,
+      name: window.name
+    };
+  }
+
+  function poll(result) {
+    if (detached) return;
+    bridge.callHandler('_frameEvaluation', frameInfo(), result).then(function(command) {
+      if (command == null || detached) return;
+      var value;
+      try {
+        value = Promise.resolve(_eval(command.source));
+      } catch (e) {
+        value = Promise.reject(e);
+      }
+      value.then(function(v) {
+        poll({id: command.id, value: v === undefined ? null : v, error: null});
+      }, function(e) {
+        poll({id: command.id, value: null, error: String(e)});
+      });
+    }).catch(function() {});
+  }
+
+  window.addEventListener('pagehide', function() {
+    detached = true;
+    bridge.callHandler('_frameEvaluation', {token: token, detach: true}, null);
+  });
+
+  poll(null);
+})();
+)JS";
+  }
+
+  static std::unique_ptr<PluginScript> FRAME_EVALUATION_JS_PLUGIN_SCRIPT(
+      const std::optional<std::vector<std::string>>& allowedOriginRules) {
+    return std::make_unique<PluginScript>(
+        FRAME_EVALUATION_JS_PLUGIN_SCRIPT_GROUP_NAME, FRAME_EVALUATION_JS_SOURCE(),
+        UserScriptInjectionTime::atDocumentStart,
+        false,  // forMainFrameOnly: the agent only acts in subframes
+        allowedOriginRules,
+        nullptr,                    // contentWorld
+        false,                      // requiredInAllContentWorlds
+        std::vector<std::string>{}  // uses the JavaScript bridge
+    );
+  }
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_FRAME_EVALUATION_JS_H_
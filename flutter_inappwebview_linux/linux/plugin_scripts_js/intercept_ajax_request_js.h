@@ -32,6 +32,15 @@ class InterceptAjaxRequestJS {
            "._useShouldInterceptAjaxRequest";
   }
 
+  /**
+   * Flag variable telling the fetch/AJAX interception scripts to ask the native
+   * rule table first (see setInterceptRequestRules).
+   */
+  static std::string FLAG_VARIABLE_FOR_NATIVE_INTERCEPT_RULES_JS_SOURCE() {
+    return "window." + JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME() +
+           "._useNativeInterceptRules";
+  }
+
   /**
    * Flag variable for onAjaxReadyStateChange callback.
    */
@@ -214,6 +223,7 @@ class InterceptAjaxRequestJS {
     const std::string flagReadyStateChange = FLAG_VARIABLE_FOR_ON_AJAX_READY_STATE_CHANGE();
     const std::string flagProgress = FLAG_VARIABLE_FOR_ON_AJAX_PROGRESS();
     const std::string flagOnlyAsync = FLAG_VARIABLE_FOR_INTERCEPT_ONLY_ASYNC_AJAX_REQUESTS_JS_SOURCE();
+    const std::string flagNativeRules = FLAG_VARIABLE_FOR_NATIVE_INTERCEPT_RULES_JS_SOURCE();
     const std::string utilVarName = JAVASCRIPT_UTIL_VAR_NAME();
     const std::string bridgeName = JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME();
 
@@ -399,6 +409,48 @@ class InterceptAjaxRequestJS {
       this.addEventListener('abort', handleEvent);
       this.addEventListener('timeout', handleEvent);
 
+      if ()JS" + flagNativeRules + R"JS( === true) {
+        // Native rules only need the URL and method, the body is serialized
+        // only if the request falls back to Dart
+        window.)JS" + bridgeName + R"JS(.callHandler('_matchInterceptRequestRule', {
+          requestType: 1,
+          url: self._flutter_inappwebview_url,
+          method: self._flutter_inappwebview_method
+        }).then(function(rule) {
+          if (rule == null || rule.action == null) {
+            interceptWithDart();
+            return;
+          }
+          if (rule.action === 0) {
+            self.abort();
+            return;
+          }
+          if (rule.url != null && rule.url != self._flutter_inappwebview_url) {
+            var previousHeaders = self._flutter_inappwebview_request_headers;
+            self.abort();
+            self.open(self._flutter_inappwebview_method, rule.url, self._flutter_inappwebview_isAsync,
+                      self._flutter_inappwebview_user, self._flutter_inappwebview_password);
+            for (var previousHeader in previousHeaders) {
+              self.setRequestHeader(previousHeader, previousHeaders[previousHeader]);
+            }
+          }
+          if (rule.headers != null) {
+            for (var ruleHeader in rule.headers) {
+              self.setRequestHeader(ruleHeader, rule.headers[ruleHeader]);
+            }
+          }
+          send.call(self, data);
+        }, function() {
+          interceptWithDart();
+        });
+      } else {
+        interceptWithDart();
+      }
+    } else {
+      send.call(this, data);
+    }
+
+    function interceptWithDart() {
       )JS" + utilVarName + R"JS(.convertBodyRequest(data).then(function(convertedData) {
         var ajaxRequest = {
           data: convertedData,
@@ -464,14 +516,34 @@ class InterceptAjaxRequestJS {
           send.call(self, convertedData);
         });
       });
-    } else {
-      send.call(this, data);
     }
   };
 })(window.XMLHttpRequest);
 )JS";
   }
 
+  inline static const std::string INTERCEPT_REQUEST_RULES_JS_PLUGIN_SCRIPT_GROUP_NAME =
+      "IN_APP_WEBVIEW_INTERCEPT_REQUEST_RULES_JS_PLUGIN_SCRIPT";
+
+  /**
+   * Creates a PluginScript that turns on the native rule table lookup in the
+   * fetch/AJAX interception scripts. Only added while rules are set.
+   */
+  static std::unique_ptr<PluginScript> INTERCEPT_REQUEST_RULES_JS_PLUGIN_SCRIPT(
+      const std::optional<std::vector<std::string>>& allowedOriginRules,
+      bool forMainFrameOnly) {
+    return std::make_unique<PluginScript>(
+        INTERCEPT_REQUEST_RULES_JS_PLUGIN_SCRIPT_GROUP_NAME,
+        FLAG_VARIABLE_FOR_NATIVE_INTERCEPT_RULES_JS_SOURCE() + " = true;",
+        UserScriptInjectionTime::atDocumentStart,
+        forMainFrameOnly,
+        allowedOriginRules,
+        nullptr,                    // contentWorld
+        true,                       // requiredInAllContentWorlds
+        std::vector<std::string>{}  // no additional message handlers needed
+    );
+  }
+
   /**
    * Creates a PluginScript for AJAX request interception.
    *
@@ -43,6 +43,8 @@ class InterceptFetchRequestJS {
     const std::string flagIntercept = FLAG_VARIABLE_FOR_SHOULD_INTERCEPT_FETCH_REQUEST_JS_SOURCE();
     const std::string utilVarName = InterceptAjaxRequestJS::JAVASCRIPT_UTIL_VAR_NAME();
     const std::string bridgeName = JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME();
+    const std::string flagNativeRules =
+        InterceptAjaxRequestJS::FLAG_VARIABLE_FOR_NATIVE_INTERCEPT_RULES_JS_SOURCE();
 
     // Ensure utility functions exist (may already be defined by AJAX script)
     std::string utilitySetup = R"JS(
@@ -105,6 +107,47 @@ if (typeof )JS" + utilVarName + R"JS( === 'undefined') {
         fetchRequest.headers = )JS" + utilVarName + R"JS(.convertHeadersToJson(fetchRequest.headers);
       }
       fetchRequest.credentials = )JS" + utilVarName + R"JS(.convertCredentialsToJson(fetchRequest.credentials);
+      if ()JS" + flagNativeRules + R"JS( === true) {
+        // Native rules only need the URL and method, the body is serialized
+        // only if the request falls back to Dart
+        var rule = null;
+        try {
+          rule = await window.)JS" + bridgeName + R"JS(.callHandler('_matchInterceptRequestRule', {
+            requestType: 0,
+            url: fetchRequest.url,
+            method: fetchRequest.method != null ? fetchRequest.method : 'GET'
+          });
+        } catch (e) {}
+        if (rule != null && rule.action === 0) {
+          var blockController = new AbortController();
+          if (init != null) {
+            init.signal = blockController.signal;
+          } else {
+            init = {
+              signal: blockController.signal
+            };
+          }
+          blockController.abort();
+          return fetch(resource, init);
+        }
+        if (rule != null && rule.action != null) {
+          if (rule.headers != null) {
+            var ruleHeaders = new Headers(init != null && init.headers != null ? init.headers :
+                                          (resource instanceof Request ? resource.headers : undefined));
+            for (var ruleHeader in rule.headers) {
+              ruleHeaders.set(ruleHeader, rule.headers[ruleHeader]);
+            }
+            if (init == null) {
+              init = {};
+            }
+            init.headers = ruleHeaders;
+          }
+          if (rule.url != null && rule.url != fetchRequest.url) {
+            resource = resource instanceof Request ? new Request(rule.url, resource) : rule.url;
+          }
+          return fetch(resource, init);
+        }
+      }
       return )JS" + utilVarName + R"JS(.convertBodyRequest(fetchRequest.body).then(function(body) {
         fetchRequest.body = body;
         return window.)JS" + bridgeName + R"JS(.callHandler('shouldInterceptFetchRequest', fetchRequest).then(function(result) {
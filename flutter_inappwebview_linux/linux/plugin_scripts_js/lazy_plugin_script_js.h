@@ -0,0 +1,148 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_LAZY_PLUGIN_SCRIPT_JS_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_LAZY_PLUGIN_SCRIPT_JS_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../types/plugin_script.h"
+#include "javascript_bridge_js.h"
+
+namespace flutter_inappwebview_plugin {
+
+/**
+ * JavaScript stubs for lazily activated plugin scripts.
+ *
+ * In lazy activation mode, a plugin script that only matters once the page
+ * uses its feature (color/date inputs, cursor detection, print interception)
+ * is injected as a small stub. The first time the feature is needed, the stub
+ * asks the native side for the implementation through the
+ * '_loadPluginScript' bridge message and evaluates it in the frame.
+ *
+ * Like the frame evaluation agent, the implementation is run with eval, so
+ * pages whose Content-Security-Policy forbids it don't get the feature.
+ */
+class LazyPluginScriptJS {
+ public:
+  inline static const std::string LOAD_PLUGIN_SCRIPT_HANDLER_NAME = "_loadPluginScript";
+
+  /**
+   * Process-wide mode, applied to webviews created afterwards.
+   */
+  static void set_LAZY_ACTIVATION_ENABLED(bool enabled) { _LAZY_ACTIVATION_ENABLED = enabled; }
+
+  static bool get_LAZY_ACTIVATION_ENABLED() { return _LAZY_ACTIVATION_ENABLED; }
+
+  /**
+   * What makes a stub load its implementation.
+   */
+  struct Trigger {
+    // Activate when a matching element exists once the DOM is ready or the
+    // window loaded, or is the target of one of events ("" = any target)
+    std::string selector;
+    // Document events, listened to in the capture phase
+    std::vector<std::string> events;
+    // window function replaced until activation: calling it activates, then
+    // calls the implementation's version ("" = none)
+    std::string wrappedFunction;
+  };
+
+  static std::string LAZY_PLUGIN_SCRIPT_STUB_JS_SOURCE(const std::string& feature,
+                                                       const Trigger& trigger) {
+    const std::string bridgeName = JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME();
+    // Selectors and names are plugin constants without quotes or backslashes
+    std::string events = "[";
+    for (size_t i = 0; i < trigger.events.size(); i++) {
+      events += (i > 0 ? ", '" : "'") + trigger.events[i] + "'";
+    }
+    events += "]";
+
+    return R"JS(
+(function() {
+  var feature = ')JS" + feature + R"JS(';
+  var bridge = window.)JS" + bridgeName + R"JS(;
+  var initFlag = '_flutterInAppWebViewLazy_' + feature;
+  if (window[initFlag] || bridge == null || typeof bridge.callHandler !== 'function') return;
+  window[initFlag] = true;
+
+  var _eval = window.eval;
+  var selector = ')JS" + trigger.selector + R"JS(';
+  var events = )JS" + events + R"JS(;
+  var wrapped = ')JS" + trigger.wrappedFunction + R"JS(';
+  var original = wrapped ? window[wrapped] : null;
+  var loading = null;
+
+  function activate() {
+    if (loading == null) {
+      events.forEach(function(type) {
+        document.removeEventListener(type, onEvent, true);
+      });
+      loading = bridge.callHandler(')JS" + LOAD_PLUGIN_SCRIPT_HANDLER_NAME + R"JS(', feature).then(function(source) {
+        if (wrapped) window[wrapped] = original;
+        if (typeof source === 'string') _eval(source);
+      }).catch(function(error) {
+        if (wrapped) window[wrapped] = original;
+        console.warn('Failed to activate ' + feature + ':', error);
+      });
+    }
+    return loading;
+  }
+
+  function onEvent(event) {
+    var target = event.target;
+    if (!selector || (target != null && target.nodeType === Node.ELEMENT_NODE && target.matches(selector))) {
+      activate();
+    }
+  }
+
+  if (wrapped && typeof original === 'function') {
+    window[wrapped] = function() {
+      var self = this;
+      var args = arguments;
+      activate().then(function() {
+        window[wrapped].apply(self, args);
+      });
+    };
+  }
+
+  events.forEach(function(type) {
+    document.addEventListener(type, onEvent, { capture: true, passive: true });
+  });
+
+  if (selector) {
+    var check = function() {
+      if (loading == null && document.querySelector(selector) != null) activate();
+    };
+    if (document.readyState === 'loading') {
+      document.addEventListener('DOMContentLoaded', check);
+    } else {
+      check();
+    }
+    window.addEventListener('load', check);
+  }
+})();
+)JS";
+  }
+
+  /**
+   * Creates the stub of implementation, injected like it.
+   */
+  static std::unique_ptr<PluginScript> LAZY_PLUGIN_SCRIPT_STUB_PLUGIN_SCRIPT(
+      const std::string& feature, const Trigger& trigger, const PluginScript& implementation) {
+    return std::make_unique<PluginScript>(
+        implementation.groupName.value_or(""), LAZY_PLUGIN_SCRIPT_STUB_JS_SOURCE(feature, trigger),
+        implementation.injectionTime, implementation.forMainFrameOnly,
+        implementation.allowedOriginRules,
+        nullptr,                    // contentWorld
+        false,                      // requiredInAllContentWorlds
+        std::vector<std::string>{}  // uses the JavaScript bridge
+    );
+  }
+
+ private:
+  inline static bool _LAZY_ACTIVATION_ENABLED = false;
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_LAZY_PLUGIN_SCRIPT_JS_H_
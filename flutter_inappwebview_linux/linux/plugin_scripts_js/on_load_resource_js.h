@@ -36,7 +36,8 @@ class OnLoadResourceJS {
    * JavaScript source code for resource loading observation.
    * Uses PerformanceObserver API to track all resource loads.
    *
-   * Matches iOS OnLoadResourceJS.swift implementation.
+   * Unlike iOS OnLoadResourceJS.swift, the entries of one observer callback
+   * are sent in a single 'onLoadResources' bridge message.
    */
   static std::string ON_LOAD_RESOURCE_JS_SOURCE() {
     const std::string flagVariable = FLAG_VARIABLE_FOR_ON_LOAD_RESOURCE_JS_SOURCE();
@@ -45,17 +46,20 @@ class OnLoadResourceJS {
     return flagVariable + R"JS( = true;
 (function() {
     var observer = new PerformanceObserver(function(list) {
-        list.getEntries().forEach(function(entry) {
-            if ()JS" + flagVariable + R"JS( == null || )JS" + flagVariable + R"JS( == true) {
-                var resource = {
-                    "url": entry.name,
-                    "initiatorType": entry.initiatorType,
-                    "startTime": entry.startTime,
-                    "duration": entry.duration
-                };
-                window.)JS" + bridgeName + R"JS(.callHandler("onLoadResource", resource);
-            }
+        if ()JS" + flagVariable + R"JS( != null && )JS" + flagVariable + R"JS( != true) {
+            return;
+        }
+        var resources = list.getEntries().map(function(entry) {
+            return {
+                "url": entry.name,
+                "initiatorType": entry.initiatorType,
+                "startTime": entry.startTime,
+                "duration": entry.duration
+            };
         });
+        if (resources.length > 0) {
+            window.)JS" + bridgeName + R"JS(.callHandler("onLoadResources", resources);
+        }
     });
     observer.observe({entryTypes: ['resource']});
 })();
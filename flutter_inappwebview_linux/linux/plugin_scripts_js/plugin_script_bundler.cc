@@ -0,0 +1,244 @@
+#include "plugin_script_bundler.h"
+
+#include <algorithm>
+#include <string_view>
+
+#include "color_input_js.h"
+#include "cursor_detection_js.h"
+#include "date_input_js.h"
+#include "frame_evaluation_js.h"
+#include "intercept_ajax_request_js.h"
+#include "intercept_fetch_request_js.h"
+#include "javascript_bridge_js.h"
+#include "lazy_plugin_script_js.h"
+#include "on_load_resource_js.h"
+#include "print_interception_js.h"
+#include "scroll_metrics_js.h"
+
+namespace flutter_inappwebview_plugin {
+
+namespace {
+
+// A plugin script that can be activated lazily
+struct LazyFeature {
+  const char* name;
+  std::unique_ptr<PluginScript> (*create)(bool forMainFrameOnly);
+  LazyPluginScriptJS::Trigger trigger;
+};
+
+const std::vector<LazyFeature>& lazyFeatures() {
+  // Form inputs activate when present or first hovered/focused, so that the
+  // implementation is there before the click
+  static const std::vector<LazyFeature> features = {
+      {"colorInput",
+       [](bool forMainFrameOnly) {
+         return ColorInputJS::COLOR_INPUT_JS_PLUGIN_SCRIPT(std::nullopt, forMainFrameOnly);
+       },
+       {"input[type=\"color\"]", {"mouseover", "focusin", "touchstart"}, ""}},
+      {"dateInput",
+       [](bool forMainFrameOnly) {
+         return DateInputJS::DATE_INPUT_JS_PLUGIN_SCRIPT(std::nullopt, forMainFrameOnly);
+       },
+       {"input[type=\"date\"], input[type=\"datetime-local\"], input[type=\"time\"], "
+        "input[type=\"month\"], input[type=\"week\"]",
+        {"mouseover", "focusin", "touchstart"},
+        ""}},
+      {"cursorDetection",
+       [](bool forMainFrameOnly) {
+         return CursorDetectionJS::CURSOR_DETECTION_JS_PLUGIN_SCRIPT(std::nullopt,
+                                                                     forMainFrameOnly);
+       },
+       {"", {"mousemove"}, ""}},
+      {"printInterception",
+       [](bool forMainFrameOnly) {
+         return PrintInterceptionJS::PRINT_INTERCEPTION_JS_PLUGIN_SCRIPT(std::nullopt,
+                                                                         forMainFrameOnly);
+       },
+       {"", {}, "print"}},
+  };
+  return features;
+}
+
+const LazyFeature* findLazyFeature(const std::string& name) {
+  for (const auto& feature : lazyFeatures()) {
+    if (name == feature.name) {
+      return &feature;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+std::vector<std::unique_ptr<PluginScript>> PluginScriptBundler::bundle(
+    const Options& options, const std::optional<std::vector<std::string>>& allowedOriginRules) {
+  std::string key = cacheKey(options);
+  auto it = cache_.find(key);
+  if (it == cache_.end()) {
+    std::vector<Bundle> bundles;
+    for (const auto& script : collectScripts(options)) {
+      // Scripts with the same injection time and frames share a bundle; the
+      // bundle order is the order of their first script
+      auto target = std::find_if(bundles.begin(), bundles.end(), [&script](const Bundle& b) {
+        return b.injectionTime == script->injectionTime &&
+               b.forMainFrameOnly == script->forMainFrameOnly;
+      });
+      if (target == bundles.end()) {
+        bundles.push_back(Bundle{script->injectionTime, script->forMainFrameOnly});
+        target = bundles.end() - 1;
+      }
+      target->requiredInAllContentWorlds |= script->requiredInAllContentWorlds;
+      for (const auto& name : script->messageHandlerNames) {
+        if (std::find(target->messageHandlerNames.begin(), target->messageHandlerNames.end(),
+                      name) == target->messageHandlerNames.end()) {
+          target->messageHandlerNames.push_back(name);
+        }
+      }
+      // Separate scripts don't stop each other when they throw: keep it that way
+      target->source += "try {\n" + minify(script->source) +
+                        "\n} catch (e) { console.error(e); }\n";
+    }
+    it = cache_.emplace(std::move(key), std::move(bundles)).first;
+  }
+
+  std::vector<std::unique_ptr<PluginScript>> scripts;
+  for (const auto& b : it->second) {
+    scripts.push_back(std::make_unique<PluginScript>(
+        PLUGIN_SCRIPT_BUNDLE_GROUP_NAME, b.source, b.injectionTime, b.forMainFrameOnly,
+        allowedOriginRules, nullptr, b.requiredInAllContentWorlds, b.messageHandlerNames));
+  }
+  return scripts;
+}
+
+std::string PluginScriptBundler::minify(const std::string& source) {
+  // Whitespace inside template literals is content
+  if (source.find('`') != std::string::npos) {
+    return source;
+  }
+
+  std::string result;
+  result.reserve(source.size());
+  bool continued = false;
+  size_t start = 0;
+  while (start <= source.size()) {
+    size_t end = source.find('\n', start);
+    if (end == std::string::npos) {
+      end = source.size();
+    }
+    std::string_view line(source.data() + start, end - start);
+    start = end + 1;
+
+    if (continued) {
+      // The line continues a string literal: leave it alone
+      result.append(line);
+      result += '\n';
+      continued = !line.empty() && line.back() == '\\';
+      continue;
+    }
+
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+      continue;
+    }
+    size_t last = line.find_last_not_of(" \t\r");
+    line = line.substr(first, last - first + 1);
+    if (line.substr(0, 2) == "//") {
+      continue;
+    }
+    result.append(line);
+    result += '\n';
+    continued = line.back() == '\\';
+  }
+  return result;
+}
+
+std::optional<std::string> PluginScriptBundler::lazySource(const std::string& feature) {
+  const LazyFeature* lazyFeature = findLazyFeature(feature);
+  if (lazyFeature == nullptr) {
+    return std::nullopt;
+  }
+  // The sources embed the bridge name, which the app can change
+  std::string key = JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME() + ":" + feature;
+  auto it = lazy_sources_.find(key);
+  if (it == lazy_sources_.end()) {
+    it = lazy_sources_.emplace(std::move(key), minify(lazyFeature->create(false)->source)).first;
+  }
+  return it->second;
+}
+
+std::vector<std::unique_ptr<PluginScript>> PluginScriptBundler::collectScripts(
+    const Options& options) {
+  const bool forMainFrameOnly = options.forMainFrameOnly;
+  std::vector<std::unique_ptr<PluginScript>> scripts;
+
+  // Features that can wait for the page to use them, as stubs in lazy mode
+  auto addFeature = [&options, &scripts, forMainFrameOnly](const char* name) {
+    const LazyFeature* feature = findLazyFeature(name);
+    std::unique_ptr<PluginScript> script = feature->create(forMainFrameOnly);
+    if (options.lazyActivation) {
+      script = LazyPluginScriptJS::LAZY_PLUGIN_SCRIPT_STUB_PLUGIN_SCRIPT(name, feature->trigger,
+                                                                        *script);
+    }
+    scripts.push_back(std::move(script));
+  };
+
+  // WPE WebKit doesn't have the run-color-chooser signal, so we handle <input type="color">
+  // via JavaScript interception
+  addFeature("colorInput");
+
+  // WPE WebKit doesn't have date picker support, so we handle <input type="date/time/etc.>
+  // via JavaScript interception
+  addFeature("dateInput");
+
+  // WPE WebKit renders offscreen so we detect cursor style via JavaScript
+  addFeature("cursorDetection");
+
+  // Pushes scroll offset and content size so the scroll/content size getters
+  // don't need a JavaScript round trip and onScrollChanged/onContentSizeChanged fire
+  scripts.push_back(ScrollMetricsJS::SCROLL_METRICS_JS_PLUGIN_SCRIPT(std::nullopt));
+
+  // Uses PerformanceObserver API to track resource loading
+  if (options.useOnLoadResource) {
+    scripts.push_back(
+        OnLoadResourceJS::ON_LOAD_RESOURCE_JS_PLUGIN_SCRIPT(std::nullopt, forMainFrameOnly));
+  }
+
+  // Intercepts XMLHttpRequest calls for shouldInterceptAjaxRequest, onAjaxReadyStateChange, onAjaxProgress
+  if (options.useShouldInterceptAjaxRequest) {
+    scripts.push_back(InterceptAjaxRequestJS::INTERCEPT_AJAX_REQUEST_JS_PLUGIN_SCRIPT(
+        std::nullopt, forMainFrameOnly, options.useOnAjaxReadyStateChange,
+        options.useOnAjaxProgress));
+  }
+
+  // Intercepts fetch() calls for shouldInterceptFetchRequest
+  if (options.useShouldInterceptFetchRequest) {
+    scripts.push_back(InterceptFetchRequestJS::INTERCEPT_FETCH_REQUEST_JS_PLUGIN_SCRIPT(
+        std::nullopt, forMainFrameOnly));
+  }
+
+  // WPE WebKit doesn't have a native print signal, so we intercept window.print()
+  // via JavaScript and notify the Dart side
+  addFeature("printInterception");
+
+  // WPE WebKit can only evaluate JavaScript in the main frame, so subframes keep a
+  // bridge call pending that evaluateJavascriptInAllFrames answers with the script to run
+  if (options.useFrameEvaluation) {
+    scripts.push_back(FrameEvaluationJS::FRAME_EVALUATION_JS_PLUGIN_SCRIPT(std::nullopt));
+  }
+
+  return scripts;
+}
+
+std::string PluginScriptBundler::cacheKey(const Options& options) {
+  // The sources embed the bridge name, which the app can change
+  std::string key = JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME() + ":";
+  for (bool flag : {options.forMainFrameOnly, options.useOnLoadResource,
+                    options.useShouldInterceptAjaxRequest, options.useOnAjaxReadyStateChange,
+                    options.useOnAjaxProgress, options.useShouldInterceptFetchRequest,
+                    options.useFrameEvaluation, options.lazyActivation}) {
+    key += flag ? '1' : '0';
+  }
+  return key;
+}
+
+}  // namespace flutter_inappwebview_plugin
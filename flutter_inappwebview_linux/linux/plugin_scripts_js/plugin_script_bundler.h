@@ -0,0 +1,92 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_PLUGIN_SCRIPT_BUNDLER_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_PLUGIN_SCRIPT_BUNDLER_H_
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../types/plugin_script.h"
+
+namespace flutter_inappwebview_plugin {
+
+/**
+ * Bundles the plugin scripts every webview gets into as few user scripts as
+ * possible: one per injection time and frame scope.
+ *
+ * Each plugin script is minified and wrapped in its own try block, so that a
+ * failing script doesn't stop the next ones. Bundles are built once per
+ * settings combination and cached for the whole process.
+ *
+ * Only scripts that never change after the webview is created are bundled.
+ * The JavaScript bridge (per-webview secret) and the scripts replaced at
+ * runtime by group name (console log options, intercept request rules,
+ * content blocker statistics) stay separate plugin scripts.
+ *
+ * With lazy activation, the scripts only needed once the page uses their
+ * feature are bundled as LazyPluginScriptJS stubs, and lazySource() provides
+ * their implementation when a stub asks for it.
+ */
+class PluginScriptBundler {
+ public:
+  inline static const std::string PLUGIN_SCRIPT_BUNDLE_GROUP_NAME =
+      "IN_APP_WEBVIEW_PLUGIN_SCRIPT_BUNDLE";
+
+  // The settings that change the bundled scripts
+  struct Options {
+    bool forMainFrameOnly = false;  // pluginScriptsForMainFrameOnly
+    bool useOnLoadResource = false;
+    bool useShouldInterceptAjaxRequest = false;
+    bool useOnAjaxReadyStateChange = false;
+    bool useOnAjaxProgress = false;
+    bool useShouldInterceptFetchRequest = false;
+    bool useFrameEvaluation = false;
+    bool lazyActivation = false;
+  };
+
+  /**
+   * The bundles for options, in injection order. allowedOriginRules is
+   * applied to every bundle.
+   */
+  static std::vector<std::unique_ptr<PluginScript>> bundle(
+      const Options& options, const std::optional<std::vector<std::string>>& allowedOriginRules);
+
+  /**
+   * Drop leading and trailing whitespace, blank lines and full-line comments.
+   * Line breaks are kept, so automatic semicolon insertion is unaffected.
+   * Sources with template literals are returned unchanged.
+   */
+  static std::string minify(const std::string& source);
+
+  /**
+   * Minified implementation of a lazily activated feature, nullopt if there
+   * is no such feature.
+   */
+  static std::optional<std::string> lazySource(const std::string& feature);
+
+ private:
+  struct Bundle {
+    UserScriptInjectionTime injectionTime;
+    bool forMainFrameOnly;
+    bool requiredInAllContentWorlds = false;
+    std::vector<std::string> messageHandlerNames;
+    std::string source;
+  };
+
+  /**
+   * The plugin scripts to bundle for options, in injection order.
+   */
+  static std::vector<std::unique_ptr<PluginScript>> collectScripts(const Options& options);
+
+  static std::string cacheKey(const Options& options);
+
+  // Cache key -> bundles, only touched from the main thread
+  inline static std::map<std::string, std::vector<Bundle>> cache_;
+  // Bridge name and feature -> lazySource()
+  inline static std::map<std::string, std::string> lazy_sources_;
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_PLUGIN_SCRIPT_BUNDLER_H_
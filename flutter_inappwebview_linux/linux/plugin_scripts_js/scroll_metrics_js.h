@@ -0,0 +1,125 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_SCROLL_METRICS_JS_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_SCROLL_METRICS_JS_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../types/plugin_script.h"
+#include "javascript_bridge_js.h"
+
+namespace flutter_inappwebview_plugin {
+
+/**
+ * JavaScript that pushes the main frame scroll offset and content size to
+ * native code.
+ *
+ * Scroll, resize and ResizeObserver notifications are coalesced to one
+ * measurement per animation frame, and only changed metrics are sent, so the
+ * native getters (getScrollX, getContentHeight, ...) can answer from a cache
+ * instead of evaluating JavaScript on every call.
+ */
+class ScrollMetricsJS {
+ public:
+  inline static const std::string SCROLL_METRICS_JS_PLUGIN_SCRIPT_GROUP_NAME =
+      "IN_APP_WEBVIEW_SCROLL_METRICS_JS_PLUGIN_SCRIPT";
+
+  static std::string SCROLL_METRICS_JS_SOURCE() {
+    return R"JS(
+(function() {
+  if (window.top !== window || window._flutterInAppWebViewScrollMetricsInit) return;
+  window._flutterInAppWebViewScrollMetricsInit = true;
+
+  var bridgeName = ')JS" + JavaScriptBridgeJS::get_JAVASCRIPT_BRIDGE_NAME() + R"JS(';
+  var last = null;
+  var scheduled = false;
+  // Native scroll epoch, bumped by scrollTo/scrollBy (see InAppWebView::runScrollScript)
+  var epoch = 0;
+
+  function measure() {
+    var root = document.documentElement;
+    var body = document.body;
+    return {
+      scrollX: Math.round(window.scrollX || window.pageXOffset || (root ? root.scrollLeft : 0) || 0),
+      scrollY: Math.round(window.scrollY || window.pageYOffset || (root ? root.scrollTop : 0) || 0),
+      contentWidth: Math.max(body ? body.scrollWidth : 0, root ? root.scrollWidth : 0),
+      contentHeight: Math.max(body ? body.scrollHeight : 0, root ? root.scrollHeight : 0),
+      viewportWidth: root ? root.clientWidth : 0,
+      viewportHeight: root ? root.clientHeight : 0,
+      epoch: epoch
+    };
+  }
+
+  function flush() {
+    scheduled = false;
+    var bridge = window[bridgeName];
+    if (bridge == null || typeof bridge.callHandler !== 'function') return;
+    var metrics = measure();
+    if (last != null &&
+        last.scrollX === metrics.scrollX && last.scrollY === metrics.scrollY &&
+        last.contentWidth === metrics.contentWidth && last.contentHeight === metrics.contentHeight &&
+        last.viewportWidth === metrics.viewportWidth && last.viewportHeight === metrics.viewportHeight &&
+        last.epoch === metrics.epoch) {
+      return;
+    }
+    last = metrics;
+    try {
+      bridge.callHandler('_scrollMetricsChanged', metrics);
+    } catch (_) {}
+  }
+
+  function schedule() {
+    if (scheduled) return;
+    scheduled = true;
+    window.requestAnimationFrame(flush);
+  }
+
+  // Called after a native scrollTo/scrollBy so the next push is sent even if
+  // the offset didn't change
+  window._flutterInAppWebViewScrollMetricsSync = function(nativeEpoch) {
+    epoch = nativeEpoch;
+    schedule();
+  };
+
+  window.addEventListener('scroll', schedule, { passive: true });
+  window.addEventListener('resize', schedule, { passive: true });
+  window.addEventListener('load', schedule);
+
+  function observe() {
+    if (typeof ResizeObserver !== 'function') return;
+    var observer = new ResizeObserver(schedule);
+    observer.observe(document.documentElement);
+    if (document.body) observer.observe(document.body);
+  }
+
+  if (document.readyState === 'loading') {
+    document.addEventListener('DOMContentLoaded', function() {
+      observe();
+      schedule();
+    });
+  } else {
+    observe();
+    schedule();
+  }
+})();
+)JS";
+  }
+
+  static std::unique_ptr<PluginScript> SCROLL_METRICS_JS_PLUGIN_SCRIPT(
+      const std::optional<std::vector<std::string>>& allowedOriginRules) {
+    return std::make_unique<PluginScript>(
+        SCROLL_METRICS_JS_PLUGIN_SCRIPT_GROUP_NAME, SCROLL_METRICS_JS_SOURCE(),
+        UserScriptInjectionTime::atDocumentStart,
+        true,  // forMainFrameOnly: metrics describe the main frame viewport
+        allowedOriginRules,
+        nullptr,                    // contentWorld
+        false,                      // requiredInAllContentWorlds
+        std::vector<std::string>{}  // uses the JavaScript bridge
+    );
+  }
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_SCROLL_METRICS_JS_H_
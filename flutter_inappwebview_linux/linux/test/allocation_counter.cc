@@ -0,0 +1,75 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<size_t> allocationCount{0};
+std::atomic<size_t> freeCount{0};
+
+inline void countAllocation() {
+  if (counting.load(std::memory_order_relaxed)) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace
+
+extern "C" {
+
+void* malloc(size_t size) noexcept {
+  countAllocation();
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+  countAllocation();
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept {
+  countAllocation();
+  return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) noexcept {
+  if (ptr != nullptr && counting.load(std::memory_order_relaxed)) {
+    freeCount.fetch_add(1, std::memory_order_relaxed);
+  }
+  __libc_free(ptr);
+}
+
+}  // extern "C"
+
+namespace flutter_inappwebview_plugin {
+namespace test {
+
+AllocationCounter::AllocationCounter() {
+  allocationCount = 0;
+  freeCount = 0;
+  counting = true;
+}
+
+AllocationCounter::~AllocationCounter() {
+  counting = false;
+}
+
+size_t AllocationCounter::allocations() const {
+  return allocationCount.load();
+}
+
+size_t AllocationCounter::frees() const {
+  return freeCount.load();
+}
+
+}  // namespace test
+}  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,34 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_TEST_ALLOCATION_COUNTER_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_TEST_ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+
+namespace flutter_inappwebview_plugin {
+namespace test {
+
+/**
+ * Counts the heap allocations made on any thread while it is alive.
+ *
+ * The test runner replaces malloc, calloc, realloc and free with counting
+ * wrappers around the glibc allocator, so this sees the g_malloc() family,
+ * FlValue and GBytes allocations and operator new alike. Only one counter may
+ * be alive at a time.
+ */
+class AllocationCounter {
+ public:
+  AllocationCounter();
+  ~AllocationCounter();
+
+  AllocationCounter(const AllocationCounter&) = delete;
+  AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+  // malloc, calloc and realloc calls so far
+  size_t allocations() const;
+  // free calls of non-null pointers so far
+  size_t frees() const;
+};
+
+}  // namespace test
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_TEST_ALLOCATION_COUNTER_H_
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <nlohmann/json.hpp>
+
+#include "content_blocker/content_blocker_rule_matcher.h"
+#include "content_blocker/content_blocker_rule_normalizer.h"
+
+namespace flutter_inappwebview_plugin {
+namespace test {
+
+using json = nlohmann::json;
+
+namespace {
+
+// {"trigger": {"url-filter": urlFilter}, "action": {"type": actionType}}
+FlValue* newRule(const char* urlFilter, const char* actionType, const char* selector = nullptr) {
+  FlValue* trigger = fl_value_new_map();
+  fl_value_set_string_take(trigger, "url-filter", fl_value_new_string(urlFilter));
+  FlValue* action = fl_value_new_map();
+  fl_value_set_string_take(action, "type", fl_value_new_string(actionType));
+  if (selector != nullptr) {
+    fl_value_set_string_take(action, "selector", fl_value_new_string(selector));
+  }
+  FlValue* rule = fl_value_new_map();
+  fl_value_set_string_take(rule, "trigger", trigger);
+  fl_value_set_string_take(rule, "action", action);
+  return rule;
+}
+
+}  // namespace
+
+TEST(ContentBlockerRuleNormalizer, ValidateUrlFilterAcceptsWebKitSubset) {
+  EXPECT_EQ(ContentBlockerRuleNormalizer::validateUrlFilter(".*"), "");
+  EXPECT_EQ(ContentBlockerRuleNormalizer::validateUrlFilter("^https?://ads\\.example\\.com/"), "");
+  EXPECT_EQ(ContentBlockerRuleNormalizer::validateUrlFilter("[a-z0-9]+\\.js$"), "");
+  EXPECT_EQ(ContentBlockerRuleNormalizer::validateUrlFilter("(?:tracker)+"), "");
+  EXPECT_EQ(ContentBlockerRuleNormalizer::validateUrlFilter("a*?b"), "");
+  EXPECT_EQ(ContentBlockerRuleNormalizer::validateUrlFilter("[]a]"), "");
+}
+
+TEST(ContentBlockerRuleNormalizer, ValidateUrlFilterRejectsUnsupportedSyntax) {
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter(""), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("ads|tracker"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("a{2,3}"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("\\d+"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("[\\w]"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("\\bads"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("(a)\\1"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("a^b"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("a$b"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("(?=a)"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("(a"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("a)"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("[abc"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("*a"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("a\\"), "");
+  EXPECT_NE(ContentBlockerRuleNormalizer::validateUrlFilter("caf\xc3\xa9"), "");
+}
+
+TEST(ContentBlockerRuleNormalizer, NormalizeNonListIsEmpty) {
+  g_autoptr(FlValue) rules = fl_value_new_null();
+  auto output = ContentBlockerRuleNormalizer::normalize(rules);
+
+  EXPECT_TRUE(output.json.empty());
+  EXPECT_EQ(output.result.inputRules, 0);
+  ASSERT_NE(output.matchRules, nullptr);
+  EXPECT_TRUE(output.matchRules->empty());
+}
+
+TEST(ContentBlockerRuleNormalizer, NormalizeDropsInvalidRulesWithDiagnostics) {
+  g_autoptr(FlValue) rules = fl_value_new_list();
+  fl_value_append_take(rules, newRule("ads|tracker", "block"));
+  fl_value_append_take(rules, newRule(".*", "unknown-action"));
+  fl_value_append_take(rules, fl_value_new_string("not a rule"));
+  fl_value_append_take(rules, newRule("ads", "block"));
+
+  auto output = ContentBlockerRuleNormalizer::normalize(rules);
+
+  EXPECT_EQ(output.result.inputRules, 4);
+  EXPECT_EQ(output.result.invalidRules, 3);
+  EXPECT_EQ(output.result.compiledRules, 1);
+  ASSERT_EQ(output.result.diagnostics.size(), 3u);
+  EXPECT_EQ(output.result.diagnostics[0].index, 0);
+  EXPECT_EQ(output.result.diagnostics[1].index, 1);
+  EXPECT_EQ(output.result.diagnostics[2].index, 2);
+
+  json parsed = json::parse(output.json);
+  ASSERT_EQ(parsed.size(), 1u);
+  EXPECT_EQ(parsed[0]["trigger"]["url-filter"], "ads");
+  EXPECT_EQ(parsed[0]["action"]["type"], "block");
+}
+
+TEST(ContentBlockerRuleNormalizer, NormalizeDropsDuplicatesAndMergesSelectors) {
+  g_autoptr(FlValue) rules = fl_value_new_list();
+  fl_value_append_take(rules, newRule("ads", "block"));
+  fl_value_append_take(rules, newRule("ads", "block"));
+  fl_value_append_take(rules, newRule(".*", "css-display-none", ".banner"));
+  fl_value_append_take(rules, newRule(".*", "css-display-none", "#popup"));
+
+  auto output = ContentBlockerRuleNormalizer::normalize(rules);
+
+  EXPECT_EQ(output.result.duplicateRules, 1);
+  EXPECT_EQ(output.result.mergedRules, 1);
+  EXPECT_EQ(output.result.compiledRules, 2);
+  json parsed = json::parse(output.json);
+  ASSERT_EQ(parsed.size(), 2u);
+  EXPECT_EQ(parsed[1]["action"]["selector"], ".banner, #popup");
+}
+
+TEST(ContentBlockerRuleNormalizer, NormalizeKeepsRulesAcrossIgnorePreviousRules) {
+  g_autoptr(FlValue) rules = fl_value_new_list();
+  fl_value_append_take(rules, newRule("ads", "block"));
+  fl_value_append_take(rules, newRule("example\\.com", "ignore-previous-rules"));
+  fl_value_append_take(rules, newRule("ads", "block"));
+
+  auto output = ContentBlockerRuleNormalizer::normalize(rules);
+
+  // The second block rule is not a duplicate: the first one may be ignored
+  EXPECT_EQ(output.result.duplicateRules, 0);
+  EXPECT_EQ(output.result.compiledRules, 3);
+}
+
+TEST(ContentBlockerRuleNormalizer, MatchRulesKeepInputIndexes) {
+  g_autoptr(FlValue) rules = fl_value_new_list();
+  fl_value_append_take(rules, newRule("ads|tracker", "block"));
+  fl_value_append_take(rules, newRule(".*", "css-display-none", ".banner"));
+  fl_value_append_take(rules, newRule("tracker", "block"));
+  fl_value_append_take(rules, newRule("example\\.com", "ignore-previous-rules"));
+
+  auto output = ContentBlockerRuleNormalizer::normalize(rules);
+
+  ASSERT_EQ(output.matchRules->size(), 2u);
+  EXPECT_EQ((*output.matchRules)[0].index, 2);
+  EXPECT_EQ((*output.matchRules)[0].urlFilter, "tracker");
+  EXPECT_FALSE((*output.matchRules)[0].ignorePreviousRules);
+  EXPECT_EQ((*output.matchRules)[1].index, 3);
+  EXPECT_TRUE((*output.matchRules)[1].ignorePreviousRules);
+}
+
+TEST(ContentBlockerRuleMatcher, MatchesOnlyAcceptedRules) {
+  g_autoptr(FlValue) rules = fl_value_new_list();
+  // Rejected by the normalizer, so never reported even though GRegex compiles it
+  fl_value_append_take(rules, newRule("ads|tracker", "block"));
+  fl_value_append_take(rules, newRule("tracker", "block"));
+
+  auto output = ContentBlockerRuleNormalizer::normalize(rules);
+  auto matcher = ContentBlockerRuleMatcher::build(*output.matchRules);
+
+  EXPECT_EQ(matcher->match("https://cdn.test/ads.js"), -1);
+  EXPECT_EQ(matcher->match("https://cdn.test/tracker.js"), 1);
+  EXPECT_EQ(matcher->match("https://cdn.test/TRACKER.js"), 1);
+}
+
+TEST(ContentBlockerRuleMatcher, HonoursIgnorePreviousRules) {
+  g_autoptr(FlValue) rules = fl_value_new_list();
+  fl_value_append_take(rules, newRule("ads", "block"));
+  fl_value_append_take(rules, newRule("example\\.com", "ignore-previous-rules"));
+  fl_value_append_take(rules, newRule("tracker", "block"));
+
+  auto output = ContentBlockerRuleNormalizer::normalize(rules);
+  auto matcher = ContentBlockerRuleMatcher::build(*output.matchRules);
+
+  EXPECT_EQ(matcher->match("https://cdn.test/ads.js"), 0);
+  EXPECT_EQ(matcher->match("https://example.com/ads.js"), -1);
+  EXPECT_EQ(matcher->match("https://example.com/ads/tracker.js"), 2);
+}
+
+}  // namespace test
+}  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "cookie_manager.h"
+
+namespace flutter_inappwebview_plugin {
+namespace test {
+
+namespace {
+
+SoupCookie* newCookie(const char* name, const char* domain, const char* path) {
+  // Session cookie (no max-age)
+  return soup_cookie_new(name, "value", domain, path, -1);
+}
+
+std::vector<std::string> namesForUri(const CookieSnapshot& snapshot, const char* uri) {
+  g_autoptr(GUri) parsed = g_uri_parse(uri, G_URI_FLAGS_NONE, nullptr);
+  std::vector<std::string> names;
+  for (SoupCookie* cookie : snapshot.cookiesForUri(parsed)) {
+    names.emplace_back(soup_cookie_get_name(cookie));
+  }
+  return names;
+}
+
+}  // namespace
+
+TEST(CookieSnapshot, HostOnlyAndDomainCookies) {
+  GList* cookies = nullptr;
+  cookies = g_list_append(cookies, newCookie("host", "www.example.com", "/"));
+  cookies = g_list_append(cookies, newCookie("domain", ".example.com", "/"));
+  cookies = g_list_append(cookies, newCookie("other", "other.com", "/"));
+  CookieSnapshot snapshot(cookies);
+
+  EXPECT_EQ(namesForUri(snapshot, "https://www.example.com/"),
+            (std::vector<std::string>{"host", "domain"}));
+  // Host-only cookies are not sent to subdomains, domain cookies are
+  EXPECT_EQ(namesForUri(snapshot, "https://sub.www.example.com/"),
+            (std::vector<std::string>{"domain"}));
+  EXPECT_EQ(namesForUri(snapshot, "https://example.com/"), (std::vector<std::string>{"domain"}));
+  EXPECT_TRUE(namesForUri(snapshot, "https://notexample.com/").empty());
+  // Host names are case-insensitive
+  EXPECT_EQ(namesForUri(snapshot, "https://OTHER.com/"), (std::vector<std::string>{"other"}));
+}
+
+TEST(CookieSnapshot, MatchesPathsLongestFirst) {
+  GList* cookies = nullptr;
+  cookies = g_list_append(cookies, newCookie("root", "example.com", "/"));
+  cookies = g_list_append(cookies, newCookie("docs", "example.com", "/docs"));
+  cookies = g_list_append(cookies, newCookie("api", "example.com", "/docs/api"));
+  CookieSnapshot snapshot(cookies);
+
+  EXPECT_EQ(namesForUri(snapshot, "https://example.com/docs/api/v1"),
+            (std::vector<std::string>{"api", "docs", "root"}));
+  EXPECT_EQ(namesForUri(snapshot, "https://example.com/docs"),
+            (std::vector<std::string>{"docs", "root"}));
+  EXPECT_EQ(namesForUri(snapshot, "https://example.com/documents"),
+            (std::vector<std::string>{"root"}));
+}
+
+TEST(CookieSnapshot, SkipsExpiredAndSecureOnlyCookies) {
+  SoupCookie* expired = newCookie("expired", "example.com", "/");
+  g_autoptr(GDateTime) past = g_date_time_new_utc(2000, 1, 1, 0, 0, 0);
+  soup_cookie_set_expires(expired, past);
+  SoupCookie* secure = newCookie("secure", "example.com", "/");
+  soup_cookie_set_secure(secure, TRUE);
+
+  GList* cookies = nullptr;
+  cookies = g_list_append(cookies, expired);
+  cookies = g_list_append(cookies, secure);
+  cookies = g_list_append(cookies, newCookie("plain", "example.com", "/"));
+  CookieSnapshot snapshot(cookies);
+
+  EXPECT_EQ(namesForUri(snapshot, "http://example.com/"), (std::vector<std::string>{"plain"}));
+  EXPECT_EQ(namesForUri(snapshot, "https://example.com/"),
+            (std::vector<std::string>{"plain", "secure"}));
+  // Still listed: the snapshot mirrors the store
+  EXPECT_EQ(snapshot.allCookies().size(), 3u);
+}
+
+TEST(CookieSnapshot, KeepsOneCookiePerKey) {
+  GList* cookies = nullptr;
+  cookies = g_list_append(cookies, newCookie("name", "example.com", "/"));
+  cookies = g_list_append(cookies, newCookie("name", "example.com", "/"));
+  cookies = g_list_append(cookies, newCookie("name", "example.com", "/path"));
+  CookieSnapshot snapshot(cookies);
+
+  EXPECT_EQ(snapshot.allCookies().size(), 2u);
+}
+
+TEST(CookieSnapshot, NullUriHasNoCookies) {
+  GList* cookies = g_list_append(nullptr, newCookie("name", "example.com", "/"));
+  CookieSnapshot snapshot(cookies);
+
+  EXPECT_TRUE(snapshot.cookiesForUri(nullptr).empty());
+}
+
+class CookieSnapshotCacheTest : public ::testing::Test {
+ protected:
+  CookieSnapshotCacheTest() : cache_([this]() { loads_++; }) {}
+
+  static std::shared_ptr<const CookieSnapshot> newSnapshot() {
+    return std::make_shared<const CookieSnapshot>(nullptr);
+  }
+
+  // Records the snapshot a lookup got, or that it is still waiting
+  CookieSnapshotCache::Callback lookup(std::optional<const CookieSnapshot*>& result) {
+    result.reset();
+    return [&result](std::shared_ptr<const CookieSnapshot> snapshot) {
+      result = snapshot.get();
+    };
+  }
+
+  int loads_ = 0;
+  CookieSnapshotCache cache_;
+};
+
+TEST_F(CookieSnapshotCacheTest, LoadsOnceForConcurrentLookups) {
+  std::optional<const CookieSnapshot*> first;
+  std::optional<const CookieSnapshot*> second;
+  cache_.request(lookup(first));
+  cache_.request(lookup(second));
+  EXPECT_EQ(loads_, 1);
+
+  auto snapshot = newSnapshot();
+  cache_.finishLoad(snapshot);
+  EXPECT_EQ(first, snapshot.get());
+  EXPECT_EQ(second, snapshot.get());
+  EXPECT_EQ(cache_.current(), snapshot);
+
+  // Served from the cache
+  std::optional<const CookieSnapshot*> third;
+  cache_.request(lookup(third));
+  EXPECT_EQ(third, snapshot.get());
+  EXPECT_EQ(loads_, 1);
+}
+
+// setCookie invalidates twice: once when it completes and once more on the
+// changed signal. A lookup made between the two must still be answered.
+TEST_F(CookieSnapshotCacheTest, ServesLookupsAcrossInterleavedInvalidations) {
+  std::optional<const CookieSnapshot*> before;
+  cache_.request(lookup(before));
+  ASSERT_EQ(loads_, 1);
+
+  cache_.invalidate();
+  std::optional<const CookieSnapshot*> between;
+  cache_.request(lookup(between));
+  cache_.invalidate();
+  EXPECT_EQ(loads_, 1);
+
+  // The first load answers the lookup made before the changes only
+  auto stale = newSnapshot();
+  cache_.finishLoad(stale);
+  EXPECT_EQ(before, stale.get());
+  EXPECT_FALSE(between.has_value());
+  EXPECT_EQ(cache_.current(), nullptr);
+  ASSERT_EQ(loads_, 2);
+
+  std::optional<const CookieSnapshot*> after;
+  cache_.request(lookup(after));
+  EXPECT_EQ(loads_, 2);
+
+  // The reload is of a later generation than the waiting lookup, and answers it
+  auto fresh = newSnapshot();
+  cache_.finishLoad(fresh);
+  EXPECT_EQ(between, fresh.get());
+  EXPECT_EQ(after, fresh.get());
+  EXPECT_EQ(cache_.current(), fresh);
+  EXPECT_EQ(loads_, 2);
+}
+
+TEST_F(CookieSnapshotCacheTest, DoesNotCacheSnapshotChangedWhileLoading) {
+  cache_.prefetch();
+  ASSERT_EQ(loads_, 1);
+  cache_.invalidate();
+
+  cache_.finishLoad(newSnapshot());
+  EXPECT_EQ(cache_.current(), nullptr);
+  // Nothing was waiting for a newer snapshot
+  EXPECT_FALSE(cache_.loading());
+  EXPECT_EQ(loads_, 1);
+}
+
+TEST_F(CookieSnapshotCacheTest, FailedLoadAnswersEveryLookup) {
+  std::optional<const CookieSnapshot*> before;
+  cache_.request(lookup(before));
+  cache_.invalidate();
+  std::optional<const CookieSnapshot*> after;
+  cache_.request(lookup(after));
+
+  cache_.finishLoad(nullptr);
+  EXPECT_EQ(before, nullptr);
+  EXPECT_EQ(after, nullptr);
+  EXPECT_FALSE(cache_.loading());
+  EXPECT_EQ(loads_, 1);
+}
+
+}  // namespace test
+}  // namespace flutter_inappwebview_plugin
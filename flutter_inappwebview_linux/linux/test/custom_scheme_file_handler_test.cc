@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "in_app_webview/custom_scheme_file_handler.h"
+
+namespace flutter_inappwebview_plugin {
+namespace test {
+
+namespace fs = std::filesystem;
+
+TEST(CustomSchemeFileHandlerRange, IgnoresAbsentOrMalformedHeaders) {
+  gsize start = 0;
+  gsize end = 0;
+  bool unsatisfiable = false;
+
+  EXPECT_FALSE(CustomSchemeFileHandler::parseRange(nullptr, 100, start, end, unsatisfiable));
+  EXPECT_FALSE(CustomSchemeFileHandler::parseRange("items=0-10", 100, start, end, unsatisfiable));
+  EXPECT_FALSE(CustomSchemeFileHandler::parseRange("bytes=10", 100, start, end, unsatisfiable));
+  EXPECT_FALSE(CustomSchemeFileHandler::parseRange("bytes=a-b", 100, start, end, unsatisfiable));
+  EXPECT_FALSE(CustomSchemeFileHandler::parseRange("bytes=20-10", 100, start, end, unsatisfiable));
+  EXPECT_FALSE(CustomSchemeFileHandler::parseRange("bytes=-", 100, start, end, unsatisfiable));
+  // Multiple ranges are served as a full response
+  EXPECT_FALSE(
+      CustomSchemeFileHandler::parseRange("bytes=0-1,5-6", 100, start, end, unsatisfiable));
+}
+
+TEST(CustomSchemeFileHandlerRange, ParsesSingleRanges) {
+  gsize start = 0;
+  gsize end = 0;
+  bool unsatisfiable = true;
+
+  ASSERT_TRUE(CustomSchemeFileHandler::parseRange("bytes=10-19", 100, start, end, unsatisfiable));
+  EXPECT_FALSE(unsatisfiable);
+  EXPECT_EQ(start, 10u);
+  EXPECT_EQ(end, 19u);
+
+  // Open-ended
+  ASSERT_TRUE(CustomSchemeFileHandler::parseRange("bytes=90-", 100, start, end, unsatisfiable));
+  EXPECT_EQ(start, 90u);
+  EXPECT_EQ(end, 99u);
+
+  // The end is clamped to the body
+  ASSERT_TRUE(CustomSchemeFileHandler::parseRange("bytes=50-500", 100, start, end, unsatisfiable));
+  EXPECT_EQ(start, 50u);
+  EXPECT_EQ(end, 99u);
+
+  // Suffix: the last N bytes, or the whole body if N is larger
+  ASSERT_TRUE(CustomSchemeFileHandler::parseRange("bytes=-10", 100, start, end, unsatisfiable));
+  EXPECT_EQ(start, 90u);
+  EXPECT_EQ(end, 99u);
+  ASSERT_TRUE(CustomSchemeFileHandler::parseRange("bytes=-500", 100, start, end, unsatisfiable));
+  EXPECT_EQ(start, 0u);
+  EXPECT_EQ(end, 99u);
+}
+
+TEST(CustomSchemeFileHandlerRange, ReportsUnsatisfiableRanges) {
+  gsize start = 0;
+  gsize end = 0;
+  bool unsatisfiable = false;
+
+  ASSERT_TRUE(CustomSchemeFileHandler::parseRange("bytes=100-", 100, start, end, unsatisfiable));
+  EXPECT_TRUE(unsatisfiable);
+  ASSERT_TRUE(CustomSchemeFileHandler::parseRange("bytes=-0", 100, start, end, unsatisfiable));
+  EXPECT_TRUE(unsatisfiable);
+  ASSERT_TRUE(CustomSchemeFileHandler::parseRange("bytes=0-", 0, start, end, unsatisfiable));
+  EXPECT_TRUE(unsatisfiable);
+}
+
+class CustomSchemeFileHandlerResolve : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    g_autofree gchar* dir = g_dir_make_tmp("inappwebview-resolve-XXXXXX", nullptr);
+    ASSERT_NE(dir, nullptr);
+    base_ = fs::canonical(dir);
+    root_ = base_ / "root";
+    fs::create_directories(root_ / "sub");
+    writeFile(root_ / "index.html");
+    writeFile(root_ / "sub" / "index.html");
+    writeFile(root_ / "sub" / "a b.js");
+    writeFile(base_ / "secret.txt");
+  }
+
+  void TearDown() override {
+    std::error_code ec;
+    fs::remove_all(base_, ec);
+  }
+
+  static void writeFile(const fs::path& path) { std::ofstream(path) << "content"; }
+
+  fs::path base_;
+  fs::path root_;
+};
+
+TEST_F(CustomSchemeFileHandlerResolve, MapsPathsInsideRoot) {
+  EXPECT_EQ(CustomSchemeFileHandler::resolve(root_, "/"), root_ / "index.html");
+  EXPECT_EQ(CustomSchemeFileHandler::resolve(root_, nullptr), root_ / "index.html");
+  EXPECT_EQ(CustomSchemeFileHandler::resolve(root_, "/sub"), root_ / "sub" / "index.html");
+  EXPECT_EQ(CustomSchemeFileHandler::resolve(root_, "/sub/a%20b.js"), root_ / "sub" / "a b.js");
+  // Dot segments that stay inside of root are fine
+  EXPECT_EQ(CustomSchemeFileHandler::resolve(root_, "/sub/../index.html"), root_ / "index.html");
+}
+
+TEST_F(CustomSchemeFileHandlerResolve, RejectsMissingFiles) {
+  EXPECT_FALSE(CustomSchemeFileHandler::resolve(root_, "/missing.js").has_value());
+}
+
+TEST_F(CustomSchemeFileHandlerResolve, RejectsPathsEscapingRoot) {
+  EXPECT_FALSE(CustomSchemeFileHandler::resolve(root_, "/../secret.txt").has_value());
+  EXPECT_FALSE(CustomSchemeFileHandler::resolve(root_, "/sub/../../secret.txt").has_value());
+  // Escaped dot segments are decoded before resolving, escaped slashes refused
+  EXPECT_FALSE(CustomSchemeFileHandler::resolve(root_, "/%2e%2e/secret.txt").has_value());
+  EXPECT_FALSE(CustomSchemeFileHandler::resolve(root_, "/..%2fsecret.txt").has_value());
+  // Leading slashes don't make the path absolute
+  std::string absolute = "//" + base_.string() + "/secret.txt";
+  EXPECT_FALSE(CustomSchemeFileHandler::resolve(root_, absolute.c_str()).has_value());
+}
+
+TEST_F(CustomSchemeFileHandlerResolve, RejectsSymlinksLeadingOutsideRoot) {
+  std::error_code ec;
+  fs::create_symlink(base_ / "secret.txt", root_ / "link.txt", ec);
+  if (ec) {
+    GTEST_SKIP() << "symlinks not supported: " << ec.message();
+  }
+  EXPECT_FALSE(CustomSchemeFileHandler::resolve(root_, "/link.txt").has_value());
+}
+
+}  // namespace test
+}  // namespace flutter_inappwebview_plugin
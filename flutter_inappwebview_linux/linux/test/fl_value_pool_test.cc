@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include "test/allocation_counter.h"
+#include "utils/fl_value_pool.h"
+
+namespace flutter_inappwebview_plugin {
+namespace test {
+
+TEST(FlValuePool, InternedKeyIsSharedAcrossCalls) {
+  FlValue* first = fl_value_intern_key("scrollX");
+  FlValue* second = fl_value_intern_key(std::string("scroll") + "X");
+
+  EXPECT_EQ(first, second);
+  EXPECT_STREQ(fl_value_get_string(first), "scrollX");
+  EXPECT_NE(fl_value_intern_key("scrollY"), first);
+}
+
+TEST(FlValuePool, SetInternedTakeUsesInternedKey) {
+  g_autoptr(FlValue) map = fl_value_new_map();
+  fl_value_set_interned_take(map, "url", fl_value_new_string("https://example.com"));
+
+  ASSERT_EQ(fl_value_get_length(map), 1u);
+  EXPECT_EQ(fl_value_get_map_key(map, 0), fl_value_intern_key("url"));
+  EXPECT_STREQ(fl_value_get_string(fl_value_lookup_string(map, "url")), "https://example.com");
+}
+
+// Refilling a payload must not allocate a new map or new key strings; only
+// the values change between events
+TEST(FlValuePool, PayloadReusesMapAndKeys) {
+  FlValuePayload payload{"x", "y"};
+  FlValue* map = payload.get();
+
+  for (int64_t i = 0; i < 1000; i++) {
+    payload.set(0, fl_value_new_int(i)).set(1, fl_value_new_int(-i));
+
+    ASSERT_EQ(payload.get(), map);
+    ASSERT_EQ(fl_value_get_length(map), 2u);
+    ASSERT_EQ(fl_value_get_map_key(map, 0), fl_value_intern_key("x"));
+    ASSERT_EQ(fl_value_get_map_key(map, 1), fl_value_intern_key("y"));
+    ASSERT_EQ(fl_value_get_int(fl_value_get_map_value(map, 0)), i);
+    ASSERT_EQ(fl_value_get_int(fl_value_get_map_value(map, 1)), -i);
+  }
+}
+
+TEST(FlValuePool, PayloadStartsWithNullValues) {
+  FlValuePayload payload{"progress"};
+
+  ASSERT_EQ(fl_value_get_length(payload.get()), 1u);
+  EXPECT_EQ(fl_value_get_type(fl_value_get_map_value(payload.get(), 0)), FL_VALUE_TYPE_NULL);
+}
+
+// Encoding onScrollChanged/onProgressChanged payloads the way invokeMethod
+// does must cost the same allocations every time: the new values and the
+// encoded message, all released again, and nothing that grows with the
+// number of events
+TEST(FlValuePool, EncodingPayloadsKeepsAllocationsFlat) {
+  FlValuePayload scrollPayload{"x", "y"};
+  FlValuePayload progressPayload{"progress"};
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  auto encodeEvents = [&](int64_t i) {
+    // Small values keep the encoded size, and so the buffer growth, constant
+    scrollPayload.set(0, fl_value_new_int(i % 1000)).set(1, fl_value_new_int(-(i % 1000)));
+    g_autoptr(GBytes) scrollMessage =
+        fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), scrollPayload.get(), nullptr);
+    progressPayload.set(0, fl_value_new_int(i % 101));
+    g_autoptr(GBytes) progressMessage =
+        fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), progressPayload.get(), nullptr);
+    return scrollMessage != nullptr && progressMessage != nullptr;
+  };
+
+  // Warm-up: interned keys and allocator caches
+  for (int64_t i = 0; i < 100; i++) {
+    ASSERT_TRUE(encodeEvents(i));
+  }
+
+  size_t perIteration = 0;
+  {
+    AllocationCounter counter;
+    ASSERT_TRUE(encodeEvents(100));
+    perIteration = counter.allocations();
+    EXPECT_EQ(counter.frees(), counter.allocations());
+  }
+
+  AllocationCounter counter;
+  for (int64_t i = 0; i < 1000; i++) {
+    ASSERT_TRUE(encodeEvents(i));
+  }
+  EXPECT_EQ(counter.allocations(), perIteration * 1000);
+  EXPECT_EQ(counter.frees(), counter.allocations());
+}
+
+}  // namespace test
+}  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include "types/http_headers.h"
+#include "utils/fl_value_pool.h"
+
+namespace flutter_inappwebview_plugin {
+namespace test {
+
+namespace {
+
+SoupMessageHeaders* newRequestHeaders() {
+  SoupMessageHeaders* headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_REQUEST);
+  soup_message_headers_append(headers, "Accept", "text/html");
+  soup_message_headers_append(headers, "User-Agent", "test");
+  soup_message_headers_append(headers, "X-Custom-Header", "1");
+  return headers;
+}
+
+}  // namespace
+
+TEST(HttpHeaders, EmptyByDefault) {
+  HttpHeaders headers;
+
+  EXPECT_TRUE(headers.empty());
+  EXPECT_EQ(headers.size(), 0u);
+  EXPECT_FALSE(headers.get("Accept").has_value());
+}
+
+TEST(HttpHeaders, SetReplacesCaseInsensitively) {
+  HttpHeaders headers;
+  headers.set("Content-Type", "text/plain");
+  headers.set("content-type", "text/html");
+
+  ASSERT_EQ(headers.size(), 1u);
+  EXPECT_EQ(headers.get("CONTENT-TYPE"), std::optional<std::string_view>("text/html"));
+}
+
+TEST(HttpHeaders, KeepsInsertionOrder) {
+  HttpHeaders headers;
+  for (int i = 0; i < 20; i++) {
+    headers.set("X-Header-" + std::to_string(i), std::to_string(i));
+  }
+
+  std::vector<std::string> names;
+  headers.forEach([&names](std::string_view name, std::string_view) {
+    names.emplace_back(name);
+  });
+  ASSERT_EQ(names.size(), 20u);
+  EXPECT_EQ(names.front(), "X-Header-0");
+  EXPECT_EQ(names.back(), "X-Header-19");
+}
+
+TEST(HttpHeaders, FromSoupMessageHeaders) {
+  SoupMessageHeaders* soupHeaders = newRequestHeaders();
+  auto headers = HttpHeaders::fromSoupMessageHeaders(soupHeaders);
+  soup_message_headers_unref(soupHeaders);
+
+  ASSERT_TRUE(headers.has_value());
+  EXPECT_EQ(headers->size(), 3u);
+  EXPECT_EQ(headers->get("user-agent"), std::optional<std::string_view>("test"));
+}
+
+TEST(HttpHeaders, FromEmptySoupMessageHeadersIsNullopt) {
+  SoupMessageHeaders* soupHeaders = soup_message_headers_new(SOUP_MESSAGE_HEADERS_REQUEST);
+
+  EXPECT_FALSE(HttpHeaders::fromSoupMessageHeaders(soupHeaders).has_value());
+  EXPECT_FALSE(HttpHeaders::fromSoupMessageHeaders(nullptr).has_value());
+  soup_message_headers_unref(soupHeaders);
+}
+
+// SoupMessageHeaders are encoded without an intermediate std::map, and the
+// map keys are the interned FlValue strings rather than per-request copies
+TEST(HttpHeaders, ToFlValueUsesInternedKeys) {
+  SoupMessageHeaders* soupHeaders = newRequestHeaders();
+  HttpHeaders headers(soupHeaders);
+  soup_message_headers_unref(soupHeaders);
+
+  g_autoptr(FlValue) first = headers.toFlValue();
+  g_autoptr(FlValue) second = headers.toFlValue();
+
+  ASSERT_EQ(fl_value_get_type(first), FL_VALUE_TYPE_MAP);
+  ASSERT_EQ(fl_value_get_length(first), 3u);
+  EXPECT_EQ(fl_value_get_map_key(first, 0), fl_value_intern_key("Accept"));
+  for (size_t i = 0; i < fl_value_get_length(first); i++) {
+    EXPECT_EQ(fl_value_get_map_key(first, i), fl_value_get_map_key(second, i));
+  }
+  EXPECT_STREQ(fl_value_get_string(fl_value_lookup_string(first, "X-Custom-Header")), "1");
+}
+
+TEST(HttpHeaders, FlValueRoundTrip) {
+  g_autoptr(FlValue) map = fl_value_new_map();
+  fl_value_set_string_take(map, "Accept", fl_value_new_string("*/*"));
+  fl_value_set_string_take(map, "X-Ignored", fl_value_new_int(1));
+
+  auto headers = HttpHeaders::fromFlValue(map);
+  ASSERT_TRUE(headers.has_value());
+  EXPECT_EQ(headers->size(), 1u);
+
+  g_autoptr(FlValue) encoded = headers->toFlValue();
+  EXPECT_STREQ(fl_value_get_string(fl_value_lookup_string(encoded, "Accept")), "*/*");
+  g_autoptr(FlValue) null = fl_value_new_null();
+  EXPECT_FALSE(HttpHeaders::fromFlValue(null).has_value());
+}
+
+TEST(HttpHeaders, AppendToSoupMessageHeaders) {
+  HttpHeaders headers(std::map<std::string, std::string>{{"Accept", "text/html"},
+                                                         {"X-Custom-Header", "1"}});
+  SoupMessageHeaders* soupHeaders = soup_message_headers_new(SOUP_MESSAGE_HEADERS_REQUEST);
+  headers.appendTo(soupHeaders);
+
+  EXPECT_STREQ(soup_message_headers_get_one(soupHeaders, "accept"), "text/html");
+  EXPECT_STREQ(soup_message_headers_get_one(soupHeaders, "X-Custom-Header"), "1");
+  soup_message_headers_unref(soupHeaders);
+}
+
+}  // namespace test
+}  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <nlohmann/json.hpp>
+
+#include "types/intercept_request_rule.h"
+
+namespace flutter_inappwebview_plugin {
+namespace test {
+
+using json = nlohmann::json;
+
+namespace {
+
+FlValue* newRuleMap(const char* urlPattern, InterceptRequestRuleAction action) {
+  FlValue* map = fl_value_new_map();
+  fl_value_set_string_take(map, "urlPattern", fl_value_new_string(urlPattern));
+  fl_value_set_string_take(map, "action", fl_value_new_int(static_cast<int64_t>(action)));
+  return map;
+}
+
+}  // namespace
+
+TEST(InterceptRequestRule, MatchesUrlMethodAndRequestType) {
+  g_autoptr(FlValue) map =
+      newRuleMap("^https://api\\.example\\.com/", InterceptRequestRuleAction::block);
+  FlValue* methods = fl_value_new_list();
+  fl_value_append_take(methods, fl_value_new_string("get"));
+  fl_value_set_string_take(map, "methods", methods);
+  FlValue* requestTypes = fl_value_new_list();
+  fl_value_append_take(requestTypes,
+                       fl_value_new_int(static_cast<int64_t>(InterceptRequestType::fetch)));
+  fl_value_set_string_take(map, "requestTypes", requestTypes);
+
+  InterceptRequestRule rule(map);
+
+  ASSERT_TRUE(rule.valid);
+  EXPECT_TRUE(rule.matches(InterceptRequestType::fetch, "https://api.example.com/v1", "GET"));
+  // fetch() defaults to GET
+  EXPECT_TRUE(rule.matches(InterceptRequestType::fetch, "https://api.example.com/v1", ""));
+  EXPECT_FALSE(rule.matches(InterceptRequestType::fetch, "https://api.example.com/v1", "POST"));
+  EXPECT_FALSE(rule.matches(InterceptRequestType::ajax, "https://api.example.com/v1", "GET"));
+  EXPECT_FALSE(rule.matches(InterceptRequestType::fetch, "https://example.com/", "GET"));
+}
+
+TEST(InterceptRequestRule, InvalidPatternNeverMatches) {
+  g_autoptr(FlValue) map = newRuleMap("(unclosed", InterceptRequestRuleAction::block);
+
+  InterceptRequestRule rule(map);
+
+  EXPECT_FALSE(rule.valid);
+  EXPECT_FALSE(rule.matches(InterceptRequestType::fetch, "(unclosed", "GET"));
+}
+
+TEST(InterceptRequestRule, OverlongUrlsNeverMatch) {
+  g_autoptr(FlValue) map = newRuleMap("example", InterceptRequestRuleAction::block);
+
+  InterceptRequestRule rule(map);
+
+  std::string url = "https://example.com/?q=";
+  EXPECT_TRUE(rule.matches(InterceptRequestType::fetch, url, "GET"));
+  url.append(kInterceptRequestRuleMaxUrlLength, 'a');
+  EXPECT_FALSE(rule.matches(InterceptRequestType::fetch, url, "GET"));
+}
+
+TEST(InterceptRequestRule, ReplyJson) {
+  g_autoptr(FlValue) blockMap = newRuleMap("ads", InterceptRequestRuleAction::block);
+  EXPECT_EQ(json::parse(InterceptRequestRule(blockMap).toReplyJson("https://ads.test/")),
+            json({{"action", 0}}));
+
+  g_autoptr(FlValue) modifyMap = newRuleMap("^http://(.*)$", InterceptRequestRuleAction::modify);
+  fl_value_set_string_take(modifyMap, "urlReplacement", fl_value_new_string("https://$1"));
+  FlValue* headers = fl_value_new_map();
+  fl_value_set_string_take(headers, "X-Test", fl_value_new_string("1"));
+  fl_value_set_string_take(modifyMap, "headers", headers);
+
+  json reply = json::parse(InterceptRequestRule(modifyMap).toReplyJson("http://example.com/a"));
+  EXPECT_EQ(reply["action"], 1);
+  EXPECT_EQ(reply["url"], "https://example.com/a");
+  EXPECT_EQ(reply["headers"]["X-Test"], "1");
+
+  // ECMAScript replacement patterns
+  g_autoptr(FlValue) patternsMap =
+      newRuleMap("example\\.(\\w+)", InterceptRequestRuleAction::modify);
+  fl_value_set_string_take(patternsMap, "urlReplacement", fl_value_new_string("$&.$1$$"));
+  json patternsReply =
+      json::parse(InterceptRequestRule(patternsMap).toReplyJson("http://example.org/"));
+  EXPECT_EQ(patternsReply["url"], "http://example.org.org$/");
+}
+
+}  // namespace test
+}  // namespace flutter_inappwebview_plugin
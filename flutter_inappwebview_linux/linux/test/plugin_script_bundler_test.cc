@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+
+#include "plugin_scripts_js/plugin_script_bundler.h"
+
+namespace flutter_inappwebview_plugin {
+namespace test {
+
+TEST(PluginScriptBundler, MinifyDropsBlankLinesAndComments) {
+  std::string source =
+      "(function() {\n"
+      "\n"
+      "  // A comment\n"
+      "    var a = 1;   \n"
+      "\t return a; // trailing comments are kept\n"
+      "})();\n";
+
+  EXPECT_EQ(PluginScriptBundler::minify(source),
+            "(function() {\n"
+            "var a = 1;\n"
+            "return a; // trailing comments are kept\n"
+            "})();\n");
+}
+
+TEST(PluginScriptBundler, MinifyKeepsLineContinuations) {
+  std::string source =
+      "var s = 'a\\\n"
+      "   // not a comment\n"
+      "';\n";
+
+  EXPECT_EQ(PluginScriptBundler::minify(source),
+            "var s = 'a\\\n"
+            "   // not a comment\n"
+            "';\n");
+}
+
+TEST(PluginScriptBundler, MinifyLeavesTemplateLiteralsAlone) {
+  std::string source = "var s = `\n  indented\n\n`;\n";
+
+  EXPECT_EQ(PluginScriptBundler::minify(source), source);
+}
+
+}  // namespace test
+}  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,35 @@
+#include "content_blocker_compile_result.h"
+
+#include "../utils/flutter.h"
+
+namespace flutter_inappwebview_plugin {
+
+ContentBlockerRuleDiagnostic::ContentBlockerRuleDiagnostic(int64_t index, std::string message)
+    : index(index), message(std::move(message)) {}
+
+FlValue* ContentBlockerRuleDiagnostic::toFlValue() const {
+  return to_fl_map({
+      {"index", make_fl_value(index)},
+      {"message", make_fl_value(message)},
+  });
+}
+
+FlValue* ContentBlockerCompileResult::toFlValue() const {
+  FlValue* diagnosticList = fl_value_new_list();
+  for (const auto& diagnostic : diagnostics) {
+    fl_value_append_take(diagnosticList, diagnostic.toFlValue());
+  }
+  return to_fl_map({
+      {"success", make_fl_value(success)},
+      {"inputRules", make_fl_value(inputRules)},
+      {"compiledRules", make_fl_value(compiledRules)},
+      {"invalidRules", make_fl_value(invalidRules)},
+      {"duplicateRules", make_fl_value(duplicateRules)},
+      {"mergedRules", make_fl_value(mergedRules)},
+      {"normalizeTime", make_fl_value(normalizeTime)},
+      {"compileTime", make_fl_value(compileTime)},
+      {"diagnostics", diagnosticList},
+  });
+}
+
+}  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,50 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_COMPILE_RESULT_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_COMPILE_RESULT_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace flutter_inappwebview_plugin {
+
+// Why a content blocker rule was dropped, index being its position in the input list
+class ContentBlockerRuleDiagnostic {
+ public:
+  int64_t index;
+  std::string message;
+
+  ContentBlockerRuleDiagnostic(int64_t index, std::string message);
+  ~ContentBlockerRuleDiagnostic() = default;
+
+  FlValue* toFlValue() const;
+};
+
+// Outcome of normalizing and compiling a content blocker rule list
+class ContentBlockerCompileResult {
+ public:
+  bool success = false;
+  int64_t inputRules = 0;
+  // Rules handed to WebKit, after dropping invalid and duplicate rules and merging
+  int64_t compiledRules = 0;
+  int64_t invalidRules = 0;
+  int64_t duplicateRules = 0;
+  // css-display-none rules folded into a rule with the same trigger
+  int64_t mergedRules = 0;
+  double normalizeTime = 0;  // Milliseconds, on the worker thread
+  double compileTime = 0;    // Milliseconds, loading or compiling the filter
+  // At most kMaxDiagnostics, invalidRules has the full count
+  std::vector<ContentBlockerRuleDiagnostic> diagnostics;
+
+  static constexpr size_t kMaxDiagnostics = 256;
+
+  ContentBlockerCompileResult() = default;
+  ~ContentBlockerCompileResult() = default;
+
+  FlValue* toFlValue() const;
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_COMPILE_RESULT_H_
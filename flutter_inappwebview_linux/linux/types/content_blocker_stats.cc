@@ -0,0 +1,37 @@
+#include "content_blocker_stats.h"
+
+#include "../utils/flutter.h"
+
+namespace flutter_inappwebview_plugin {
+
+FlValue* ContentBlockerShardStats::toFlValue() const {
+  FlValue* hits = fl_value_new_list();
+  for (const auto& [index, count] : ruleHits) {
+    fl_value_append_take(hits, to_fl_map({
+                                   {"index", make_fl_value(index)},
+                                   {"hits", make_fl_value(count)},
+                               }));
+  }
+  return to_fl_map({
+      {"blockedRequests", make_fl_value(blockedRequests)},
+      {"estimatedBytesAvoided", make_fl_value(estimatedBytesAvoided)},
+      {"compiledRules", make_fl_value(compiledRules)},
+      {"compileTime", make_fl_value(compileTime)},
+      {"ruleHits", hits},
+  });
+}
+
+FlValue* ContentBlockerStats::toFlValue() const {
+  FlValue* shardMap = fl_value_new_map();
+  for (const auto& [name, stats] : shards) {
+    fl_value_set_string_take(shardMap, name.c_str(), stats.toFlValue());
+  }
+  return to_fl_map({
+      {"enabled", make_fl_value(enabled)},
+      {"blockedRequests", make_fl_value(blockedRequests)},
+      {"estimatedBytesAvoided", make_fl_value(estimatedBytesAvoided)},
+      {"shards", shardMap},
+  });
+}
+
+}  // namespace flutter_inappwebview_plugin
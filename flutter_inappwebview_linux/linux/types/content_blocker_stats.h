@@ -0,0 +1,49 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_STATS_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_STATS_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace flutter_inappwebview_plugin {
+
+// Requests blocked by the rules of one content blocker shard
+class ContentBlockerShardStats {
+ public:
+  int64_t blockedRequests = 0;
+  // From the size of earlier loads of the same URL, or the average size of
+  // the resources the webview loaded
+  int64_t estimatedBytesAvoided = 0;
+  // Rules of the shard's current filter, and the milliseconds it took to
+  // normalize and compile (or load) them
+  int64_t compiledRules = 0;
+  double compileTime = 0;
+  // Index of the rule in the shard's list -> requests it blocked
+  std::map<int64_t, int64_t> ruleHits;
+
+  ContentBlockerShardStats() = default;
+  ~ContentBlockerShardStats() = default;
+
+  FlValue* toFlValue() const;
+};
+
+// Content blocker statistics of a webview, per shard ("" is the
+// contentBlockers setting)
+class ContentBlockerStats {
+ public:
+  bool enabled = false;
+  int64_t blockedRequests = 0;
+  int64_t estimatedBytesAvoided = 0;
+  std::map<std::string, ContentBlockerShardStats> shards;
+
+  ContentBlockerStats() = default;
+  ~ContentBlockerStats() = default;
+
+  FlValue* toFlValue() const;
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_CONTENT_BLOCKER_STATS_H_
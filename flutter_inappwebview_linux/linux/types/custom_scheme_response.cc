@@ -9,7 +9,13 @@ CustomSchemeResponse::CustomSchemeResponse()
 
 CustomSchemeResponse::CustomSchemeResponse(FlValue* map)
     : contentType(get_fl_map_value<std::string>(map, "contentType", "application/octet-stream")),
-      contentEncoding(get_fl_map_value<std::string>(map, "contentEncoding", "utf-8")) {
+      contentEncoding(get_fl_map_value<std::string>(map, "contentEncoding", "utf-8")),
+      statusCode(get_optional_fl_map_value<int64_t>(map, "statusCode")),
+      reasonPhrase(get_optional_fl_map_value<std::string>(map, "reasonPhrase")),
+      headers(HttpHeaders::fromFlValue(get_fl_map_value_raw(map, "headers"))),
+      stream(get_fl_map_value<bool>(map, "stream", false)),
+      streamId(get_fl_map_value<int64_t>(map, "streamId", 0)),
+      contentLength(get_fl_map_value<int64_t>(map, "contentLength", -1)) {
   // Parse data (Uint8List) - needs special handling for byte arrays
   auto data_opt = get_optional_fl_map_value<std::vector<uint8_t>>(map, "data");
   if (data_opt.has_value()) {
@@ -22,6 +28,12 @@ FlValue* CustomSchemeResponse::toFlValue() const {
       {"data", make_fl_value(data)},
       {"contentType", make_fl_value(contentType)},
       {"contentEncoding", make_fl_value(contentEncoding)},
+      {"statusCode", make_fl_value(statusCode)},
+      {"reasonPhrase", make_fl_value(reasonPhrase)},
+      {"headers", headers.has_value() ? headers->toFlValue() : make_fl_value()},
+      {"stream", make_fl_value(stream)},
+      {"streamId", make_fl_value(streamId)},
+      {"contentLength", make_fl_value(contentLength)},
   });
 }
 
@@ -3,10 +3,13 @@
 
 #include <flutter_linux/flutter_linux.h>
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "http_headers.h"
+
 namespace flutter_inappwebview_plugin {
 
 /**
@@ -26,6 +29,18 @@ class CustomSchemeResponse {
   // Content-Encoding of the data, such as "utf-8"
   std::string contentEncoding;
 
+  // Optional HTTP status line and headers (e.g. 206 and Content-Range for range requests)
+  std::optional<int64_t> statusCode;
+  std::optional<std::string> reasonPhrase;
+  std::optional<HttpHeaders> headers;
+
+  // When true the body is not in data: it is pulled from Dart in chunks
+  // (onCustomSchemeResponseStreamPull) identified by streamId
+  bool stream = false;
+  int64_t streamId = 0;
+  // Length of the whole body, -1 if unknown (streamed responses)
+  int64_t contentLength = -1;
+
   CustomSchemeResponse();
   explicit CustomSchemeResponse(FlValue* map);
   ~CustomSchemeResponse() = default;
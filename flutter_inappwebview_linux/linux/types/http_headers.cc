@@ -0,0 +1,210 @@
+#include "http_headers.h"
+
+#include <deque>
+#include <unordered_map>
+
+#include "../utils/fl_value_pool.h"
+
+namespace flutter_inappwebview_plugin {
+
+namespace {
+
+// Names that are interned up front, in the casing WebKit and most servers use
+constexpr const char* kCommonHeaderNames[] = {
+    "Accept",
+    "Accept-Encoding",
+    "Accept-Language",
+    "Accept-Ranges",
+    "Access-Control-Allow-Origin",
+    "Age",
+    "Authorization",
+    "Cache-Control",
+    "Connection",
+    "Content-Disposition",
+    "Content-Encoding",
+    "Content-Language",
+    "Content-Length",
+    "Content-Security-Policy",
+    "Content-Type",
+    "Cookie",
+    "Date",
+    "ETag",
+    "Expires",
+    "Host",
+    "If-Modified-Since",
+    "If-None-Match",
+    "Last-Modified",
+    "Location",
+    "Origin",
+    "Pragma",
+    "Range",
+    "Referer",
+    "Server",
+    "Set-Cookie",
+    "Strict-Transport-Security",
+    "Transfer-Encoding",
+    "Upgrade-Insecure-Requests",
+    "User-Agent",
+    "Vary",
+    "X-Content-Type-Options",
+    "X-Frame-Options",
+    "X-Requested-With",
+};
+
+// Upper bound on interned names, so that pages sending random header names
+// can't grow the table without limit; further names are stored per entry
+constexpr size_t kMaxInternedHeaderNames = 512;
+
+// Returns the interned copy of name, or nullptr if the table is full.
+// Exact (case-sensitive) match, so names keep the casing they were sent with.
+// Main thread only (see HttpHeaders), the tables are not synchronized.
+const std::string* internHeaderName(std::string_view name) {
+  // Never released; the deque keeps the strings at stable addresses
+  static auto* names = new std::deque<std::string>();
+  static auto* index = [] {
+    auto* table = new std::unordered_map<std::string_view, const std::string*>();
+    for (const char* common : kCommonHeaderNames) {
+      const std::string& stored = names->emplace_back(common);
+      table->emplace(stored, &stored);
+    }
+    return table;
+  }();
+
+  auto it = index->find(name);
+  if (it != index->end()) {
+    return it->second;
+  }
+  if (names->size() >= kMaxInternedHeaderNames) {
+    return nullptr;
+  }
+  const std::string& stored = names->emplace_back(name);
+  index->emplace(stored, &stored);
+  return &stored;
+}
+
+bool headerNameEquals(std::string_view a, std::string_view b) {
+  return a.size() == b.size() && g_ascii_strncasecmp(a.data(), b.data(), a.size()) == 0;
+}
+
+}  // namespace
+
+HttpHeaders::HttpHeaders(SoupMessageHeaders* headers) {
+  if (headers == nullptr) {
+    return;
+  }
+  SoupMessageHeadersIter iter;
+  const char* name;
+  const char* value;
+  soup_message_headers_iter_init(&iter, headers);
+  size_t count = 0;
+  while (soup_message_headers_iter_next(&iter, &name, &value)) {
+    count++;
+  }
+  entries_.reserve(count);
+  soup_message_headers_iter_init(&iter, headers);
+  while (soup_message_headers_iter_next(&iter, &name, &value)) {
+    if (name != nullptr && value != nullptr) {
+      set(name, value);
+    }
+  }
+}
+
+HttpHeaders::HttpHeaders(const std::map<std::string, std::string>& headers) {
+  entries_.reserve(headers.size());
+  for (const auto& [name, value] : headers) {
+    set(name, value);
+  }
+}
+
+std::optional<HttpHeaders> HttpHeaders::fromFlValue(FlValue* value) {
+  if (value == nullptr || fl_value_get_type(value) != FL_VALUE_TYPE_MAP) {
+    return std::nullopt;
+  }
+  HttpHeaders headers;
+  size_t length = fl_value_get_length(value);
+  headers.entries_.reserve(length);
+  for (size_t i = 0; i < length; i++) {
+    FlValue* key = fl_value_get_map_key(value, i);
+    FlValue* item = fl_value_get_map_value(value, i);
+    if (fl_value_get_type(key) == FL_VALUE_TYPE_STRING &&
+        fl_value_get_type(item) == FL_VALUE_TYPE_STRING) {
+      headers.set(fl_value_get_string(key), fl_value_get_string(item));
+    }
+  }
+  return headers;
+}
+
+std::optional<HttpHeaders> HttpHeaders::fromSoupMessageHeaders(SoupMessageHeaders* headers) {
+  HttpHeaders result(headers);
+  if (result.empty()) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+void HttpHeaders::set(std::string_view name, std::string_view value) {
+  for (Entry& entry : entries_) {
+    if (headerNameEquals(entry.name(), name)) {
+      entry.value.assign(value.data(), value.size());
+      return;
+    }
+  }
+
+  Entry& entry = entries_.emplace_back();
+  entry.internedName = internHeaderName(name);
+  if (entry.internedName == nullptr) {
+    entry.ownedName.assign(name.data(), name.size());
+  }
+  entry.value.assign(value.data(), value.size());
+}
+
+std::optional<std::string_view> HttpHeaders::get(std::string_view name) const {
+  for (const Entry& entry : entries_) {
+    if (headerNameEquals(entry.name(), name)) {
+      return std::string_view(entry.value);
+    }
+  }
+  return std::nullopt;
+}
+
+void HttpHeaders::forEach(
+    const std::function<void(std::string_view name, std::string_view value)>& callback) const {
+  for (const Entry& entry : entries_) {
+    callback(entry.name(), entry.value);
+  }
+}
+
+FlValue* HttpHeaders::toFlValue() const {
+  FlValue* map = fl_value_new_map();
+  for (const Entry& entry : entries_) {
+    FlValue* value = fl_value_new_string_sized(entry.value.data(), entry.value.size());
+    if (entry.internedName != nullptr) {
+      // Interned names are bounded, so their FlValue keys can be shared too
+      fl_value_set_interned_take(map, *entry.internedName, value);
+    } else {
+      fl_value_set_string_take(map, entry.ownedName.c_str(), value);
+    }
+  }
+  return map;
+}
+
+void HttpHeaders::appendTo(SoupMessageHeaders* headers) const {
+  if (headers == nullptr) {
+    return;
+  }
+  for (const Entry& entry : entries_) {
+    const std::string& name =
+        entry.internedName != nullptr ? *entry.internedName : entry.ownedName;
+    soup_message_headers_append(headers, name.c_str(), entry.value.c_str());
+  }
+}
+
+std::map<std::string, std::string> HttpHeaders::toMap() const {
+  std::map<std::string, std::string> map;
+  for (const Entry& entry : entries_) {
+    map.emplace(std::string(entry.name()), entry.value);
+  }
+  return map;
+}
+
+}  // namespace flutter_inappwebview_plugin
@@ -0,0 +1,73 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_HTTP_HEADERS_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_HTTP_HEADERS_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <wpe/webkit.h>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace flutter_inappwebview_plugin {
+
+/**
+ * Compact storage for HTTP headers of requests and responses.
+ *
+ * Header names are looked up in a process-wide intern table (seeded with the
+ * common header names and bounded in size), so the same names are not
+ * reallocated for every request. Entries live in a vector that is sized to
+ * the number of headers, so an empty set costs one empty vector.
+ *
+ * Like the std::map based headers it replaces, a name appears at most once;
+ * setting an existing name (compared case-insensitively) replaces its value.
+ *
+ * The intern table is not synchronized: HttpHeaders must only be created and
+ * modified on the main thread, like the FlValue helpers in fl_value_pool.h.
+ */
+class HttpHeaders {
+ public:
+  HttpHeaders() = default;
+  explicit HttpHeaders(SoupMessageHeaders* headers);
+  explicit HttpHeaders(const std::map<std::string, std::string>& headers);
+  ~HttpHeaders() = default;
+
+  // Returns nullopt if value is not a map (e.g. null)
+  static std::optional<HttpHeaders> fromFlValue(FlValue* value);
+  // Returns nullopt if headers is nullptr or has no headers
+  static std::optional<HttpHeaders> fromSoupMessageHeaders(SoupMessageHeaders* headers);
+
+  void set(std::string_view name, std::string_view value);
+  std::optional<std::string_view> get(std::string_view name) const;
+
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  void forEach(const std::function<void(std::string_view name, std::string_view value)>& callback) const;
+
+  FlValue* toFlValue() const;
+  // Appends every header to headers (existing values are kept)
+  void appendTo(SoupMessageHeaders* headers) const;
+  std::map<std::string, std::string> toMap() const;
+
+ private:
+  struct Entry {
+    // Points into the intern table; ownedName is only used when it is full
+    const std::string* internedName = nullptr;
+    std::string ownedName;
+    std::string value;
+
+    std::string_view name() const {
+      return internedName != nullptr ? std::string_view(*internedName) : std::string_view(ownedName);
+    }
+  };
+
+  std::vector<Entry> entries_;
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_HTTP_HEADERS_H_
@@ -0,0 +1,146 @@
+#include "intercept_request_rule.h"
+
+#include <algorithm>
+#include <cctype>
+#include <nlohmann/json.hpp>
+
+#include "../utils/flutter.h"
+#include "../utils/log.h"
+
+namespace flutter_inappwebview_plugin {
+
+using json = nlohmann::json;
+
+namespace {
+
+bool equals_ignore_case(const std::string& a, const std::string& b) {
+  return a.size() == b.size() &&
+         std::equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+           return std::toupper(x) == std::toupper(y);
+         });
+}
+
+// Converts an ECMAScript replacement ($1, $&, $$) into the GRegex syntax
+std::string to_g_regex_replacement(const std::string& replacement) {
+  std::string result;
+  result.reserve(replacement.size());
+  for (size_t i = 0; i < replacement.size(); i++) {
+    char c = replacement[i];
+    if (c == '\\') {
+      result += "\\\\";
+    } else if (c == '$' && i + 1 < replacement.size()) {
+      char next = replacement[i + 1];
+      if (next == '$') {
+        result += '$';
+        i++;
+      } else if (next == '&') {
+        result += "\\0";
+        i++;
+      } else if (std::isdigit(static_cast<unsigned char>(next))) {
+        // $1 to $99
+        size_t end = i + 2;
+        if (end < replacement.size() &&
+            std::isdigit(static_cast<unsigned char>(replacement[end]))) {
+          end++;
+        }
+        result += "\\g<" + replacement.substr(i + 1, end - i - 1) + ">";
+        i = end - 1;
+      } else {
+        result += c;
+      }
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+InterceptRequestRule::InterceptRequestRule(FlValue* map) {
+  if (map == nullptr || fl_value_get_type(map) != FL_VALUE_TYPE_MAP) {
+    return;
+  }
+
+  urlPatternSource = get_fl_map_value<std::string>(map, "urlPattern", "");
+  methods = get_fl_map_value<std::vector<std::string>>(map, "methods", {});
+  action = static_cast<InterceptRequestRuleAction>(
+      get_fl_map_value<int64_t>(map, "action", static_cast<int64_t>(InterceptRequestRuleAction::allow)));
+  urlReplacement = get_optional_fl_map_value<std::string>(map, "urlReplacement");
+  headers = get_optional_fl_map_value<std::map<std::string, std::string>>(map, "headers")
+                .value_or(std::map<std::string, std::string>{});
+
+  FlValue* requestTypesValue = fl_value_lookup_string(map, "requestTypes");
+  if (requestTypesValue != nullptr && fl_value_get_type(requestTypesValue) == FL_VALUE_TYPE_LIST) {
+    for (size_t i = 0; i < fl_value_get_length(requestTypesValue); i++) {
+      FlValue* item = fl_value_get_list_value(requestTypesValue, i);
+      if (fl_value_get_type(item) == FL_VALUE_TYPE_INT) {
+        requestTypes.push_back(static_cast<InterceptRequestType>(fl_value_get_int(item)));
+      }
+    }
+  }
+
+  // Compiled once here, matched for every intercepted request
+  GError* error = nullptr;
+  GRegex* regex = g_regex_new(urlPatternSource.c_str(), G_REGEX_OPTIMIZE,
+                              static_cast<GRegexMatchFlags>(0), &error);
+  if (regex != nullptr) {
+    urlPattern = std::shared_ptr<GRegex>(regex, g_regex_unref);
+    valid = true;
+  } else {
+    errorLog("InterceptRequestRule: invalid urlPattern '" + urlPatternSource +
+             "': " + (error != nullptr ? error->message : ""));
+    if (error != nullptr) {
+      g_error_free(error);
+    }
+  }
+}
+
+bool InterceptRequestRule::matches(InterceptRequestType requestType, const std::string& url,
+                                   const std::string& method) const {
+  if (!valid || url.size() > kInterceptRequestRuleMaxUrlLength) {
+    return false;
+  }
+  if (!requestTypes.empty() &&
+      std::find(requestTypes.begin(), requestTypes.end(), requestType) == requestTypes.end()) {
+    return false;
+  }
+  if (!methods.empty()) {
+    // fetch() and XHR default to GET when no method is given
+    const std::string& requestMethod = method.empty() ? std::string("GET") : method;
+    bool methodMatches = std::any_of(methods.begin(), methods.end(), [&](const std::string& m) {
+      return equals_ignore_case(m, requestMethod);
+    });
+    if (!methodMatches) {
+      return false;
+    }
+  }
+  return g_regex_match(urlPattern.get(), url.c_str(), static_cast<GRegexMatchFlags>(0), nullptr);
+}
+
+std::string InterceptRequestRule::toReplyJson(const std::string& url) const {
+  json reply = json::object();
+  if (action == InterceptRequestRuleAction::block) {
+    reply["action"] = 0;
+    return reply.dump();
+  }
+
+  reply["action"] = 1;
+  if (action == InterceptRequestRuleAction::modify) {
+    if (urlReplacement.has_value()) {
+      std::string replacement = to_g_regex_replacement(urlReplacement.value());
+      g_autofree gchar* replaced =
+          g_regex_replace(urlPattern.get(), url.c_str(), static_cast<gssize>(url.size()), 0,
+                          replacement.c_str(), static_cast<GRegexMatchFlags>(0), nullptr);
+      if (replaced != nullptr) {
+        reply["url"] = replaced;
+      }
+    }
+    if (!headers.empty()) {
+      reply["headers"] = headers;
+    }
+  }
+  return reply.dump();
+}
+
+}  // namespace flutter_inappwebview_plugin
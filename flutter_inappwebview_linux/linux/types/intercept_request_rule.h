@@ -0,0 +1,57 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_INTERCEPT_REQUEST_RULE_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_INTERCEPT_REQUEST_RULE_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace flutter_inappwebview_plugin {
+
+// Matches Dart side
+enum class InterceptRequestRuleAction { block = 0, allow = 1, modify = 2 };
+
+// Matches Dart side
+enum class InterceptRequestType { fetch = 0, ajax = 1 };
+
+// URLs longer than this never match a rule and are left to Dart, which bounds
+// the time a pattern can spend on a single request
+static constexpr size_t kInterceptRequestRuleMaxUrlLength = 8192;
+
+/**
+ * A declarative rule applied to fetch()/XMLHttpRequest requests without
+ * going through Dart (see shouldInterceptFetchRequest/shouldInterceptAjaxRequest).
+ * Rules are only consulted by the interception scripts, so they only apply to
+ * the request types whose useShouldInterceptFetchRequest /
+ * useShouldInterceptAjaxRequest setting is enabled.
+ *
+ * The first rule whose urlPattern (a regex, searched in the URL), methods and
+ * requestTypes match decides the request. modify rewrites the URL
+ * (urlReplacement may use $1... groups from urlPattern) and/or adds headers.
+ */
+class InterceptRequestRule {
+ public:
+  std::string urlPatternSource;
+  std::shared_ptr<GRegex> urlPattern;
+  std::vector<std::string> methods;  // Empty matches every method
+  std::vector<InterceptRequestType> requestTypes;  // Empty matches fetch and ajax
+  InterceptRequestRuleAction action = InterceptRequestRuleAction::allow;
+  std::optional<std::string> urlReplacement;
+  std::map<std::string, std::string> headers;
+  bool valid = false;
+
+  InterceptRequestRule(FlValue* map);
+
+  bool matches(InterceptRequestType requestType, const std::string& url,
+               const std::string& method) const;
+
+  // JSON reply understood by the intercept plugin scripts
+  std::string toReplyJson(const std::string& url) const;
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_INTERCEPT_REQUEST_RULE_H_
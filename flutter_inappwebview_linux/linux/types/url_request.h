@@ -3,22 +3,23 @@
 
 #include <flutter_linux/flutter_linux.h>
 
-#include <map>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "http_headers.h"
+
 namespace flutter_inappwebview_plugin {
 
 class URLRequest {
  public:
   const std::optional<std::string> url;
   const std::optional<std::string> method;
-  const std::optional<std::map<std::string, std::string>> headers;
+  const std::optional<HttpHeaders> headers;
   const std::optional<std::vector<uint8_t>> body;
 
   URLRequest(const std::optional<std::string>& url, const std::optional<std::string>& method,
-             const std::optional<std::map<std::string, std::string>>& headers,
+             const std::optional<HttpHeaders>& headers,
              const std::optional<std::vector<uint8_t>>& body);
 
   URLRequest(FlValue* map);
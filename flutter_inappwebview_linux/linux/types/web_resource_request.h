@@ -2,23 +2,29 @@
 #define FLUTTER_INAPPWEBVIEW_PLUGIN_WEB_RESOURCE_REQUEST_H_
 
 #include <flutter_linux/flutter_linux.h>
+#include <wpe/webkit.h>
 
-#include <map>
 #include <optional>
 #include <string>
 
+#include "http_headers.h"
+
 namespace flutter_inappwebview_plugin {
 
 class WebResourceRequest {
  public:
   std::optional<std::string> url;
   std::optional<std::string> method;
-  std::optional<std::map<std::string, std::string>> headers;
+  std::optional<HttpHeaders> headers;
   std::optional<bool> isForMainFrame;
 
   WebResourceRequest(const std::optional<std::string>& url,
                      const std::optional<std::string>& method,
-                     const std::optional<std::map<std::string, std::string>>& headers,
+                     const std::optional<HttpHeaders>& headers,
+                     const std::optional<bool>& isForMainFrame);
+  WebResourceRequest(const std::optional<std::string>& url,
+                     const std::optional<std::string>& method,
+                     SoupMessageHeaders* headers,
                      const std::optional<bool>& isForMainFrame);
   WebResourceRequest(FlValue* map);
   ~WebResourceRequest() = default;
@@ -8,7 +8,7 @@ WebResourceResponse::WebResourceResponse(
     const std::optional<std::string>& contentType,
     const std::optional<std::string>& contentEncoding, const std::optional<int64_t>& statusCode,
     const std::optional<std::string>& reasonPhrase,
-    const std::optional<std::map<std::string, std::string>>& headers,
+    const std::optional<HttpHeaders>& headers,
     const std::optional<std::vector<uint8_t>>& data)
     : contentType(contentType),
       contentEncoding(contentEncoding),
@@ -22,7 +22,7 @@ WebResourceResponse::WebResourceResponse(FlValue* map)
       contentEncoding(get_optional_fl_map_value<std::string>(map, "contentEncoding")),
       statusCode(get_optional_fl_map_value<int64_t>(map, "statusCode")),
       reasonPhrase(get_optional_fl_map_value<std::string>(map, "reasonPhrase")),
-      headers(get_optional_fl_map_value<std::map<std::string, std::string>>(map, "headers")),
+      headers(HttpHeaders::fromFlValue(get_fl_map_value_raw(map, "headers"))),
       data(get_optional_fl_map_value<std::vector<uint8_t>>(map, "data")) {}
 
 FlValue* WebResourceResponse::toFlValue() const {
@@ -31,7 +31,7 @@ FlValue* WebResourceResponse::toFlValue() const {
       {"contentEncoding", make_fl_value(contentEncoding)},
       {"statusCode", make_fl_value(statusCode)},
       {"reasonPhrase", make_fl_value(reasonPhrase)},
-      {"headers", make_fl_value(headers)},
+      {"headers", headers.has_value() ? headers->toFlValue() : make_fl_value()},
       {"data", make_fl_value(data)},
   });
 }
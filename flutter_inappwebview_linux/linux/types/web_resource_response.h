@@ -4,11 +4,12 @@
 #include <flutter_linux/flutter_linux.h>
 
 #include <cstdint>
-#include <map>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "http_headers.h"
+
 namespace flutter_inappwebview_plugin {
 
 class WebResourceResponse {
@@ -17,7 +18,7 @@ class WebResourceResponse {
   std::optional<std::string> contentEncoding;
   std::optional<int64_t> statusCode;
   std::optional<std::string> reasonPhrase;
-  std::optional<std::map<std::string, std::string>> headers;
+  std::optional<HttpHeaders> headers;
   std::optional<std::vector<uint8_t>> data;
 
   WebResourceResponse(
@@ -25,7 +26,7 @@ class WebResourceResponse {
       const std::optional<std::string>& contentEncoding = std::nullopt,
       const std::optional<int64_t>& statusCode = std::nullopt,
       const std::optional<std::string>& reasonPhrase = std::nullopt,
-      const std::optional<std::map<std::string, std::string>>& headers = std::nullopt,
+      const std::optional<HttpHeaders>& headers = std::nullopt,
       const std::optional<std::vector<uint8_t>>& data = std::nullopt);
   WebResourceResponse(FlValue* map);
   ~WebResourceResponse() = default;
@@ -0,0 +1,93 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_UTIL_FL_VALUE_POOL_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_UTIL_FL_VALUE_POOL_H_
+
+// Helpers to build FlValue payloads for hot-path events without rebuilding
+// the same maps and key strings on every call:
+// - fl_value_intern_key() returns a process-wide FlValue string for a key
+// - FlValuePayload keeps one preallocated map per fixed-shape event and only
+//   swaps the values between invocations
+//
+// All of these must only be used from the main thread.
+
+#include <flutter_linux/flutter_linux.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace flutter_inappwebview_plugin {
+
+/**
+ * Returns the interned FlValue string for key.
+ *
+ * The returned value is borrowed and lives for the whole process; take an
+ * extra reference with fl_value_ref() before handing it to a *_take() call.
+ */
+static inline FlValue* fl_value_intern_key(std::string_view key) {
+  // Views point into the FlValue strings, which are never released
+  static auto* interned = new std::unordered_map<std::string_view, FlValue*>();
+
+  auto it = interned->find(key);
+  if (it != interned->end()) {
+    return it->second;
+  }
+
+  FlValue* value = fl_value_new_string_sized(key.data(), key.size());
+  interned->emplace(std::string_view(fl_value_get_string(value), key.size()), value);
+  return value;
+}
+
+// Sets key in map using the interned key FlValue; takes ownership of value
+static inline void fl_value_set_interned_take(FlValue* map, std::string_view key, FlValue* value) {
+  fl_value_set_take(map, fl_value_ref(fl_value_intern_key(key)), value);
+}
+
+/**
+ * A reusable string-keyed map for events that are always sent with the same
+ * set of keys.
+ *
+ * The map and its keys are created once; set() only replaces the value at a
+ * key index. The payload can be refilled as soon as the method channel call
+ * it was passed to returns, because fl_method_channel_invoke_method() encodes
+ * the arguments synchronously.
+ *
+ * Usage:
+ *   FlValuePayload payload{"x", "y"};
+ *   payload.set(0, fl_value_new_int(x)).set(1, fl_value_new_int(y));
+ *   invokeMethod("onScrollChanged", payload.get());
+ */
+class FlValuePayload {
+ public:
+  FlValuePayload(std::initializer_list<const char*> keys) : map_(fl_value_new_map()) {
+    keys_.reserve(keys.size());
+    for (const char* key : keys) {
+      FlValue* internedKey = fl_value_intern_key(key);
+      keys_.push_back(internedKey);
+      fl_value_set_take(map_, fl_value_ref(internedKey), fl_value_new_null());
+    }
+  }
+
+  ~FlValuePayload() { fl_value_unref(map_); }
+
+  FlValuePayload(const FlValuePayload&) = delete;
+  FlValuePayload& operator=(const FlValuePayload&) = delete;
+
+  // Replaces the value for the key at index, taking ownership of value
+  FlValuePayload& set(size_t index, FlValue* value) {
+    fl_value_set_take(map_, fl_value_ref(keys_[index]), value);
+    return *this;
+  }
+
+  // The payload map, owned by this object
+  FlValue* get() const { return map_; }
+
+ private:
+  FlValue* map_;
+  std::vector<FlValue*> keys_;
+};
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_UTIL_FL_VALUE_POOL_H_
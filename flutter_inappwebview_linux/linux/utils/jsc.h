@@ -0,0 +1,245 @@
+#ifndef FLUTTER_INAPPWEBVIEW_PLUGIN_UTIL_JSC_H_
+#define FLUTTER_INAPPWEBVIEW_PLUGIN_UTIL_JSC_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <jsc/jsc.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace flutter_inappwebview_plugin {
+
+// Maximum nesting depth followed when converting a JSCValue into an FlValue.
+// Deeper values are converted to null.
+static constexpr int kJscToFlValueMaxDepth = 64;
+
+// Maximum number of values converted for a single result. Shared references
+// ({a: o, b: o}) are converted once per reference, like JSON.stringify does,
+// so the budget bounds the work for DAGs that are small in the page.
+static constexpr size_t kJscToFlValueMaxNodes = 1 << 20;
+
+// Largest integer that a JavaScript number can represent exactly (2^53 - 1).
+static constexpr double kJscMaxSafeInteger = 9007199254740991.0;
+
+struct JscToFlValueState {
+  // Objects and arrays on the path from the root to the value being converted.
+  // JSC keeps one JSCValue wrapper per JavaScript value while it is alive, and
+  // the path holds a reference to each of them, so pointers identify objects.
+  std::vector<JSCValue*> path;
+  size_t nodes = 0;
+  // Set once the conversion failed; the partial result is discarded
+  const char* error = nullptr;
+};
+
+static inline FlValue* jsc_value_to_fl_value_internal(JSCValue* value, int depth,
+                                                      JscToFlValueState& state);
+
+static inline FlValue* jsc_typed_array_to_fl_value(JSCValue* value) {
+  gsize length = 0;
+  gpointer data = jsc_value_typed_array_get_data(value, &length);
+  if (data == nullptr) {
+    return fl_value_new_list();
+  }
+
+  switch (jsc_value_typed_array_get_type(value)) {
+    case JSC_TYPED_ARRAY_UINT8:
+    case JSC_TYPED_ARRAY_UINT8_CLAMPED:
+      return fl_value_new_uint8_list(static_cast<const uint8_t*>(data), length);
+    case JSC_TYPED_ARRAY_INT32:
+      return fl_value_new_int32_list(static_cast<const int32_t*>(data), length);
+    case JSC_TYPED_ARRAY_INT64:
+      return fl_value_new_int64_list(static_cast<const int64_t*>(data), length);
+    case JSC_TYPED_ARRAY_FLOAT32:
+      return fl_value_new_float32_list(static_cast<const float*>(data), length);
+    case JSC_TYPED_ARRAY_FLOAT64:
+      return fl_value_new_float_list(static_cast<const double*>(data), length);
+    case JSC_TYPED_ARRAY_INT8: {
+      // There is no signed byte list in the standard codec
+      const auto* items = static_cast<const int8_t*>(data);
+      FlValue* list = fl_value_new_list();
+      for (gsize i = 0; i < length; i++) {
+        fl_value_append_take(list, fl_value_new_int(items[i]));
+      }
+      return list;
+    }
+    case JSC_TYPED_ARRAY_INT16: {
+      const auto* items = static_cast<const int16_t*>(data);
+      FlValue* list = fl_value_new_list();
+      for (gsize i = 0; i < length; i++) {
+        fl_value_append_take(list, fl_value_new_int(items[i]));
+      }
+      return list;
+    }
+    case JSC_TYPED_ARRAY_UINT16: {
+      const auto* items = static_cast<const uint16_t*>(data);
+      FlValue* list = fl_value_new_list();
+      for (gsize i = 0; i < length; i++) {
+        fl_value_append_take(list, fl_value_new_int(items[i]));
+      }
+      return list;
+    }
+    case JSC_TYPED_ARRAY_UINT32: {
+      const auto* items = static_cast<const uint32_t*>(data);
+      FlValue* list = fl_value_new_list();
+      for (gsize i = 0; i < length; i++) {
+        fl_value_append_take(list, fl_value_new_int(items[i]));
+      }
+      return list;
+    }
+    case JSC_TYPED_ARRAY_UINT64: {
+      const auto* items = static_cast<const uint64_t*>(data);
+      FlValue* list = fl_value_new_list();
+      for (gsize i = 0; i < length; i++) {
+        fl_value_append_take(list, fl_value_new_int(static_cast<int64_t>(items[i])));
+      }
+      return list;
+    }
+    default:
+      return fl_value_new_list();
+  }
+}
+
+static inline FlValue* jsc_array_to_fl_value(JSCValue* value, int depth,
+                                             JscToFlValueState& state) {
+  FlValue* list = fl_value_new_list();
+  g_autoptr(JSCValue) length_value = jsc_value_object_get_property(value, "length");
+  if (length_value == nullptr || !jsc_value_is_number(length_value)) {
+    return list;
+  }
+
+  double length = jsc_value_to_double(length_value);
+  for (guint i = 0; i < static_cast<guint>(length) && state.error == nullptr; i++) {
+    g_autoptr(JSCValue) item = jsc_value_object_get_property_at_index(value, i);
+    // Like JSON.stringify, undefined and functions become null inside arrays
+    fl_value_append_take(list, jsc_value_to_fl_value_internal(item, depth + 1, state));
+  }
+  return list;
+}
+
+static inline FlValue* jsc_object_to_fl_value(JSCValue* value, int depth,
+                                              JscToFlValueState& state) {
+  FlValue* map = fl_value_new_map();
+  g_auto(GStrv) properties = jsc_value_object_enumerate_properties(value);
+  if (properties == nullptr) {
+    return map;
+  }
+
+  for (gchar** property = properties; *property != nullptr && state.error == nullptr; property++) {
+    g_autoptr(JSCValue) item = jsc_value_object_get_property(value, *property);
+    // Like JSON.stringify, skip undefined and function members
+    if (item == nullptr || jsc_value_is_undefined(item) || jsc_value_is_function(item)) {
+      continue;
+    }
+    fl_value_set_string_take(map, *property,
+                             jsc_value_to_fl_value_internal(item, depth + 1, state));
+  }
+  return map;
+}
+
+// Converts an object or array, failing like JSON.stringify if it is already
+// being converted further up
+static inline FlValue* jsc_container_to_fl_value(JSCValue* value, int depth,
+                                                 JscToFlValueState& state) {
+  if (std::find(state.path.begin(), state.path.end(), value) != state.path.end()) {
+    state.error = "TypeError: JSON.stringify cannot serialize cyclic structures.";
+    return fl_value_new_null();
+  }
+
+  state.path.push_back(value);
+  FlValue* result = jsc_value_is_array(value) ? jsc_array_to_fl_value(value, depth, state)
+                                              : jsc_object_to_fl_value(value, depth, state);
+  state.path.pop_back();
+  return result;
+}
+
+static inline FlValue* jsc_value_to_fl_value_internal(JSCValue* value, int depth,
+                                                      JscToFlValueState& state) {
+  if (state.error != nullptr || depth > kJscToFlValueMaxDepth) {
+    return fl_value_new_null();
+  }
+  if (++state.nodes > kJscToFlValueMaxNodes) {
+    state.error = "RangeError: The result has too many values to convert.";
+    return fl_value_new_null();
+  }
+
+  // Honour toJSON() (e.g. Date) the same way JSON.stringify does: its result,
+  // object or not, is converted in place of the value, and is not asked for
+  // toJSON() again
+  g_autoptr(JSCValue) json_value = nullptr;
+  if (value != nullptr && jsc_value_is_object(value) && !jsc_value_is_function(value)) {
+    g_autoptr(JSCValue) to_json = jsc_value_object_get_property(value, "toJSON");
+    if (to_json != nullptr && jsc_value_is_function(to_json)) {
+      json_value = jsc_value_object_invoke_method(value, "toJSON", G_TYPE_NONE);
+      value = json_value;
+    }
+  }
+
+  if (value == nullptr || jsc_value_is_undefined(value) || jsc_value_is_null(value) ||
+      jsc_value_is_function(value)) {
+    return fl_value_new_null();
+  }
+
+  if (jsc_value_is_boolean(value)) {
+    return fl_value_new_bool(jsc_value_to_boolean(value));
+  }
+
+  if (jsc_value_is_number(value)) {
+    double number = jsc_value_to_double(value);
+    if (!std::isfinite(number)) {
+      // JSON.stringify serializes NaN and Infinity as null
+      return fl_value_new_null();
+    }
+    if (std::trunc(number) == number && std::fabs(number) <= kJscMaxSafeInteger) {
+      return fl_value_new_int(static_cast<int64_t>(number));
+    }
+    return fl_value_new_float(number);
+  }
+
+  if (jsc_value_is_string(value)) {
+    g_autofree gchar* str = jsc_value_to_string(value);
+    return fl_value_new_string(str != nullptr ? str : "");
+  }
+
+  if (jsc_value_is_typed_array(value)) {
+    return jsc_typed_array_to_fl_value(value);
+  }
+
+  if (jsc_value_is_array_buffer(value)) {
+    gsize size = 0;
+    gpointer data = jsc_value_array_buffer_get_data(value, &size);
+    return data != nullptr ? fl_value_new_uint8_list(static_cast<const uint8_t*>(data), size)
+                           : fl_value_new_uint8_list(nullptr, 0);
+  }
+
+  if (jsc_value_is_object(value)) {
+    return jsc_container_to_fl_value(value, depth, state);
+  }
+
+  return fl_value_new_null();
+}
+
+/**
+ * Converts a JSCValue directly into an FlValue tree without going through a
+ * JSON string. Arrays become lists, plain objects become string-keyed maps,
+ * typed arrays and ArrayBuffers become typed data lists.
+ *
+ * Returns nullptr and sets error for values JSON.stringify would throw on
+ * (cyclic structures), or that exceed kJscToFlValueMaxNodes values.
+ * Otherwise the returned value is a new reference owned by the caller.
+ */
+static inline FlValue* jsc_value_to_fl_value(JSCValue* value, GError** error) {
+  JscToFlValueState state;
+  FlValue* result = jsc_value_to_fl_value_internal(value, 0, state);
+  if (state.error != nullptr) {
+    fl_value_unref(result);
+    g_set_error_literal(error, g_quark_from_static_string("JscToFlValue"), 0, state.error);
+    return nullptr;
+  }
+  return result;
+}
+
+}  // namespace flutter_inappwebview_plugin
+
+#endif  // FLUTTER_INAPPWEBVIEW_PLUGIN_UTIL_JSC_H_
@@ -3,9 +3,11 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstddef>
 #include <cstdint>
 #include <numeric>
 #include <optional>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -172,6 +174,65 @@ constexpr uint32_t string_hash(const std::string_view data) noexcept {
   return hash;
 };
 
+// A fixed set of names sorted by string_hash(), so that finding a name takes a
+// binary search on its hash and a single string compare. Building the set in
+// a constexpr context fails to compile if two names share a hash, or one hashes
+// to 0 (the unknown value).
+template <size_t N>
+class KnownStringHashes {
+ public:
+  constexpr explicit KnownStringHashes(const std::string_view (&names)[N]) {
+    for (size_t i = 0; i < N; i++) {
+      Entry entry{string_hash(names[i]), names[i]};
+      if (entry.hash == 0) {
+        throw std::logic_error("KnownStringHashes: name hashes to 0");
+      }
+      size_t j = i;
+      for (; j > 0 && entries_[j - 1].hash > entry.hash; j--) {
+        entries_[j] = entries_[j - 1];
+      }
+      if (j > 0 && entries_[j - 1].hash == entry.hash) {
+        throw std::logic_error("KnownStringHashes: name hashes collide");
+      }
+      entries_[j] = entry;
+    }
+  }
+
+  // string_hash() of name if it is one of the names, 0 otherwise. A switch on
+  // this value can only reach the case of the exact name.
+  constexpr uint32_t find(const std::string_view name) const noexcept {
+    const uint32_t hash = string_hash(name);
+    size_t low = 0;
+    size_t high = N;
+    while (low < high) {
+      const size_t middle = low + (high - low) / 2;
+      if (entries_[middle].hash < hash) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return low < N && entries_[low].hash == hash && entries_[low].name == name ? hash : 0;
+  }
+
+  // Case label for a switch on find(); doesn't compile for an unknown name
+  constexpr uint32_t caseFor(const std::string_view name) const {
+    const uint32_t hash = find(name);
+    if (hash == 0) {
+      throw std::logic_error("KnownStringHashes: unknown name");
+    }
+    return hash;
+  }
+
+ private:
+  struct Entry {
+    uint32_t hash = 0;
+    std::string_view name;
+  };
+
+  Entry entries_[N] = {};
+};
+
 static inline std::string trim(const std::string& str) {
   size_t first = str.find_first_not_of(" \t\n\r\f\v");
   if (std::string::npos == first) {